@@ -442,6 +442,13 @@ private:
    */
   Poco::Timestamp waitQueueStamp;
 
+  /**
+   * The time the job was added to the wait queue and the time it started
+   * running. Only used for the job statistics of the JobManager.
+   */
+  Poco::Timestamp m_queuedTime;
+  Poco::Timestamp m_runStartTime;
+
   /*
    * The that is currently running this job
    */
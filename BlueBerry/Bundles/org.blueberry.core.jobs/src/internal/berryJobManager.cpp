@@ -50,7 +50,7 @@ bool NullRule::Contains(ISchedulingRule::Pointer dummyRule) const
 
 JobManager::JobManager() :
   sptr_testRule(new NullRule()),m_active(true), m_Pool(new WorkerPool(this)), m_sptr_progressProvider(0),
-      m_JobQueueSleeping(true), m_JobQueueWaiting(false),m_suspended(false), m_waitQueueCounter(0)
+      m_JobQueueSleeping(true), m_JobQueueWaiting(false, true),m_suspended(false), m_waitQueueCounter(0)
 
 {
   m_JobListeners.global.SetExceptionHandler(MessageExceptionHandler<
@@ -482,6 +482,9 @@ void JobManager::ChangeState(InternalJob::Pointer sptr_job, int newState)
     case InternalJob::BLOCKED:
       break;
     case Job::WAITING:
+      // blocked jobs keep the time they were queued first
+      if (tmp_oldState != InternalJob::BLOCKED)
+        sptr_job->m_queuedTime.update();
       m_JobQueueWaiting.Enqueue(sptr_job);
       break;
     case Job::SLEEPING:
@@ -852,6 +855,14 @@ void JobManager::EndJob(InternalJob::Pointer ptr_job, IStatus::Pointer result, b
     //if job is not known then it cannot be done
     if (ptr_job->GetState() == Job::NONE)
        return;
+    if (ptr_job->InternalGetState() == Job::RUNNING)
+    {
+      JobStatistics& statistics = m_JobStatistics[ptr_job->GetClassName()];
+      double runTime = ptr_job->m_runStartTime.elapsed() / 1000.0;
+      ++statistics.numberOfJobs;
+      statistics.totalRunTime += runTime;
+      statistics.maxRunTime = std::max(statistics.maxRunTime, runTime);
+    }
     ptr_job->SetResult(result);
     ptr_job->SetProgressMonitor(IProgressMonitor::Pointer(0));
     ptr_job->SetThread(0);
@@ -1145,6 +1156,11 @@ Job::Pointer JobManager::StartJob()
           internal->SetProgressMonitor(CreateMonitor(job));
           //change from ABOUT_TO_RUN to RUNNING
           internal->InternalSetState(Job::RUNNING);
+          internal->m_runStartTime.update();
+          JobStatistics& statistics = m_JobStatistics[internal->GetClassName()];
+          double waitTime = (internal->m_runStartTime - internal->m_queuedTime) / 1000.0;
+          statistics.totalQueueWaitTime += waitTime;
+          statistics.maxQueueWaitTime = std::max(statistics.maxQueueWaitTime, waitTime);
           break;
         }
         internal->SetAboutToRunCanceled(false);
@@ -1163,6 +1179,24 @@ Job::Pointer JobManager::StartJob()
   return job;
 }
 
+JobManager::JobStatistics::JobStatistics()
+  : numberOfJobs(0), totalQueueWaitTime(0), maxQueueWaitTime(0),
+    totalRunTime(0), maxRunTime(0)
+{
+}
+
+JobManager::JobStatisticsMap JobManager::GetJobStatistics()
+{
+  Poco::ScopedLock<Poco::Mutex> lockMe (m_mutex);
+  return m_JobStatistics;
+}
+
+void JobManager::ResetJobStatistics()
+{
+  Poco::ScopedLock<Poco::Mutex> lockMe (m_mutex);
+  m_JobStatistics.clear();
+}
+
 void JobManager::WakeUp(InternalJob::Pointer job, Poco::Timestamp::TimeDiff delay)
 {
   poco_assert(delay >= 0); // "Scheduling delay is negative"
@@ -39,6 +39,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <string>
 #include <sstream>
+#include <map>
 #include <assert.h>
 
 namespace berry
@@ -199,6 +200,37 @@ public:
 
   void AddJobChangeListener(IJobChangeListener::Pointer listener);
 
+  /**
+   * Timing statistics of the jobs of one job class which were run by
+   * the worker pool. All times are in milliseconds.
+   */
+  struct JobStatistics
+  {
+    JobStatistics();
+
+    /** The number of jobs which finished running */
+    std::size_t numberOfJobs;
+
+    /** The time jobs spent in the wait queue (including the time they were blocked) */
+    double totalQueueWaitTime;
+    double maxQueueWaitTime;
+
+    /** The time jobs spent running */
+    double totalRunTime;
+    double maxRunTime;
+  };
+
+  /** Job statistics by job class name, see Object::GetClassName() */
+  typedef std::map<std::string, JobStatistics> JobStatisticsMap;
+
+  /**
+   * Returns the timing statistics of all jobs run since the job manager
+   * was created or the statistics were reset.
+   */
+  JobStatisticsMap GetJobStatistics();
+
+  void ResetJobStatistics();
+
   //  void beginRule(ISchedulingRule rule, IProgressMonitor monitor) ;
 
 
@@ -354,6 +386,11 @@ private:
    */
   long long m_waitQueueCounter;
 
+  /**
+   * Timing statistics of the jobs run by the worker pool, guarded by m_mutex.
+   */
+  JobStatisticsMap m_JobStatistics;
+
   //  /**
   //   * For debugging purposes only
   //   */
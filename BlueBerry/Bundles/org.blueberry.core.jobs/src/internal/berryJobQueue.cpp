@@ -39,11 +39,38 @@ public:
 
 };
 
-JobQueue::JobQueue(bool allowConflictOvertaking) :
+// the number of job priorities, from Job::INTERACTIVE to Job::DECORATE
+static const std::size_t PRIORITY_CLASSES = 5;
+
+JobQueue::JobQueue(bool allowConflictOvertaking, bool usePriorityClasses) :
   dummy(new DummyJob()), m_allowConflictOvertaking(allowConflictOvertaking)
 {
   dummy->SetNext(dummy);
   dummy->SetPrevious(dummy);
+  if (usePriorityClasses)
+  {
+    m_classDummies.push_back(dummy);
+    for (std::size_t i = 1; i < PRIORITY_CLASSES; ++i)
+    {
+      InternalJob::Pointer classDummy(new DummyJob());
+      classDummy->SetNext(classDummy);
+      classDummy->SetPrevious(classDummy);
+      m_classDummies.push_back(classDummy);
+    }
+  }
+}
+
+InternalJob::Pointer JobQueue::DummyFor(InternalJob::Pointer entry) const
+{
+  if (m_classDummies.empty())
+    return dummy;
+  // Job priorities are INTERACTIVE (10) to DECORATE (50) in steps of ten
+  int priorityClass = entry->GetPriority() / 10 - 1;
+  if (priorityClass < 0)
+    priorityClass = 0;
+  else if (priorityClass >= static_cast<int>(PRIORITY_CLASSES))
+    priorityClass = PRIORITY_CLASSES - 1;
+  return m_classDummies[priorityClass];
 }
 
 //TODO JobQueue Constructor IStatus Implementierung
@@ -62,18 +89,20 @@ JobQueue::JobQueue(bool allowConflictOvertaking) :
 
 
 bool JobQueue::CanOvertake(InternalJob::Pointer newEntry,
-    InternalJob::Pointer queueEntry)
+    InternalJob::Pointer queueEntry, InternalJob::Pointer classDummy)
 {
   //can never go past the end of the queue
 
-  if (queueEntry == dummy.GetPointer())
+  if (queueEntry == classDummy.GetPointer())
     return false;
   //if the new entry was already in the wait queue, ensure it is re-inserted in correct position (bug 211799)
   if (newEntry->GetWaitQueueStamp() > 0 && newEntry->GetWaitQueueStamp()
       < queueEntry->GetWaitQueueStamp())
     return true;
-  //if the new entry has lower priority, there is no need to overtake the existing entry
-  if ((queueEntry == newEntry))
+  //if the new entry has lower priority, there is no need to overtake the existing entry.
+  //Entries are ordered by start time (compareTo of the Java implementation), so the
+  //head of a list is the job which should have been started first
+  if (newEntry->GetStartTime() >= queueEntry->GetStartTime())
     return false;
 
   // the new entry has higher priority, but only overtake the existing entry if the queue allows it
@@ -87,12 +116,22 @@ void JobQueue::Clear()
 
   dummy->SetNext(dummy);
   dummy->SetPrevious(dummy);
+  for (std::size_t i = 1; i < m_classDummies.size(); ++i)
+  {
+    m_classDummies[i]->SetNext(m_classDummies[i]);
+    m_classDummies[i]->SetPrevious(m_classDummies[i]);
+  }
 
 }
 
 // notice: important that the first element in the queue is internally set as a dummy element
 InternalJob::Pointer JobQueue::Dequeue()
 {
+  if (!m_classDummies.empty())
+  {
+    InternalJob::Pointer head = this->Peek();
+    return head == 0 ? head : head->Remove();
+  }
 
   InternalJob::Pointer ptr_dummyPrevious = dummy->Previous();
   // sets previous pointer to 0 if there is only 1 Element in the queue
@@ -106,9 +145,10 @@ InternalJob::Pointer JobQueue::Dequeue()
 
 void JobQueue::Enqueue(InternalJob::Pointer newEntry)
 {
-  InternalJob::Pointer tail = dummy->Next();
+  InternalJob::Pointer classDummy = DummyFor(newEntry);
+  InternalJob::Pointer tail = classDummy->Next();
   //overtake lower priority jobs. Only overtake conflicting jobs if allowed to
-  while (CanOvertake(newEntry, tail))
+  while (CanOvertake(newEntry, tail, classDummy))
     tail = tail->Next();
   InternalJob::Pointer tailPrevious = tail->Previous();
   newEntry->SetNext(tail);
@@ -131,16 +171,33 @@ void JobQueue::Resort(InternalJob::Pointer entry)
 
 bool JobQueue::IsEmpty()
 {
-
+  for (std::size_t i = 1; i < m_classDummies.size(); ++i)
+  {
+    if (m_classDummies[i]->next != m_classDummies[i])
+      return false;
+  }
   return this->dummy->next == dummy;
 }
 
 InternalJob::Pointer JobQueue::Peek()
 {
+  if (m_classDummies.empty())
+  {
+    return dummy->Previous() == dummy ? InternalJob::Pointer(0)
+        : dummy->Previous();
+  }
 
-  return dummy->Previous() == dummy ? InternalJob::Pointer(0)
-      : dummy->Previous();
-
+  // the head of the class which should have been started first
+  InternalJob::Pointer head(0);
+  for (std::size_t i = 0; i < m_classDummies.size(); ++i)
+  {
+    InternalJob::Pointer classHead = m_classDummies[i]->Previous();
+    if (classHead == m_classDummies[i])
+      continue;
+    if (head == 0 || classHead->GetStartTime() < head->GetStartTime())
+      head = classHead;
+  }
+  return head;
 }
 
 }
@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <berryObject.h>
 #include <org_blueberry_core_jobs_Export.h>
 
+#include <vector>
+
 namespace berry
 {
 
@@ -40,6 +42,12 @@ private:
    */
   InternalJob::Pointer dummy;
 
+  /**
+   * If the queue uses priority classes, one dummy entry per class, starting
+   * with the INTERACTIVE class. dummy is the entry of the first class.
+   */
+  std::vector<InternalJob::Pointer> m_classDummies;
+
   /**
    * If true, conflicting jobs will be allowed to overtake others in the
    * queue that have lower priority. If false, higher priority jumps can only
@@ -53,15 +61,25 @@ private:
    * @param queueEntry The existing queue entry
    */
   bool CanOvertake(InternalJob::Pointer newEntry,
-      InternalJob::Pointer queueEntry);
+      InternalJob::Pointer queueEntry, InternalJob::Pointer classDummy);
+
+  /**
+   * Returns the dummy entry of the priority class the given job belongs to.
+   */
+  InternalJob::Pointer DummyFor(InternalJob::Pointer entry) const;
 
 
 public:
 
   /**
    * Create a new job queue.
+   *
+   * If usePriorityClasses is true, jobs are kept in one list per job priority
+   * and a new job only has to be ordered among the jobs of its own priority.
+   * Peek() then returns the list head with the earliest start time, so jobs
+   * of lower priority still run eventually.
    */
-  JobQueue(bool m_allowConflictOvertaking);
+  JobQueue(bool m_allowConflictOvertaking, bool usePriorityClasses = false);
 
   /**
    * remove all elements
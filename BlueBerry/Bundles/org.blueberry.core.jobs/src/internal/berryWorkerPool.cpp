@@ -28,14 +28,15 @@ namespace berry
 {
 
 WorkerPool::WorkerPool(JobManager* myJobManager) :
-  m_ptrManager(myJobManager), m_numThreads(0), m_sleepingThreads(0), m_threads(
-      10), m_busyThreads(0)
+  m_ptrManager(myJobManager), m_numThreads(0), m_sleepingThreads(0), m_busyThreads(0)
 // m_isDaemon(false),
 {
+  m_threads.reserve(10);
 }
 
 const long WorkerPool::BEST_BEFORE = 60000;
 const int WorkerPool::MIN_THREADS = 1;
+const int WorkerPool::MAX_THREADS = 50;
 
 
 void WorkerPool::Shutdown()
@@ -51,6 +52,7 @@ void WorkerPool::Add(Worker::Pointer worker)
 {
   Poco::Mutex::ScopedLock lock(m_mutexOne);
   m_threads.push_back(worker);
+  m_numThreads = static_cast<int>(m_threads.size());
 }
 
 void WorkerPool::DecrementBusyThreads()
@@ -80,7 +82,8 @@ bool WorkerPool::Remove(Worker::Pointer worker)
   std::vector<Worker::Pointer>::iterator end = std::remove(m_threads.begin(),
       m_threads.end(), worker);
   bool removed = end != m_threads.end();
-  m_threads.erase(end);
+  m_threads.erase(end, m_threads.end());
+  m_numThreads = static_cast<int>(m_threads.size());
 
   return removed;
 }
@@ -93,23 +96,27 @@ void WorkerPool::EndWorker(Worker::Pointer sptr_worker)
 
 void WorkerPool::Sleep(long duration)
 {
-  Poco::ScopedLock<Poco::Mutex> lock(m_mutexOne);
-  m_sleepingThreads++;
-  m_busyThreads--;
+  {
+    Poco::ScopedLock<Poco::Mutex> lock(m_mutexOne);
+    m_sleepingThreads++;
+    m_busyThreads--;
+  }
 
+  // m_mutexOne must not be held while waiting, otherwise JobQueued() could
+  // not wake us up and would itself block until the sleep times out. A
+  // notification sent before we started waiting is not lost, it leaves the
+  // event signaled.
   try
   {
     wait(duration);
-    throw FinallyThrowException();
-  } catch (FinallyThrowException&)
-  {
-    m_sleepingThreads--;
-    m_busyThreads++;
   } catch (...)
   {
-    m_sleepingThreads--;
-    m_busyThreads++;
+    // timed out
   }
+
+  Poco::ScopedLock<Poco::Mutex> lock(m_mutexOne);
+  m_sleepingThreads--;
+  m_busyThreads++;
 }
 
 InternalJob::Pointer WorkerPool::StartJob(Worker* worker)
@@ -189,8 +196,9 @@ void WorkerPool::JobQueued()
     notify();
     return;
   }
-  //create a thread if all threads are busy
-  if (m_busyThreads >= m_numThreads)
+  //create a thread if all threads are busy, a busy worker picks up the job
+  //when it is done if the pool is full
+  if (m_busyThreads >= m_numThreads && m_numThreads < MAX_THREADS)
   {
     WorkerPool::WeakPtr wp_WorkerPool(WorkerPool::Pointer(this));
     Worker::Pointer sptr_worker(new Worker(wp_WorkerPool));
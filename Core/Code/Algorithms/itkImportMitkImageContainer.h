@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkImportImageContainer.h>
 #include <mitkImageDataItem.h>
 #include <mitkImageWriteAccessor.h>
+#include <mitkImageReadAccessor.h>
 
 namespace itk
 {
@@ -36,6 +37,10 @@ namespace itk
  *
  * TElement =
  *    The element type stored in the container.
+ *
+ * The container takes ownership of the image accessor and keeps the accessed
+ * image part locked for its lifetime. A container with an ImageReadAccessor
+ * must not be written to.
  */
 
 template <typename TElementIdentifier, typename TElement>
@@ -65,6 +70,9 @@ public:
   //void SetImageDataItem(mitk::ImageDataItem* imageDataItem);
   void SetImageAccessor(mitk::ImageWriteAccessor* imageAccess, size_t noBytes);
 
+  /** \brief Wrap the read-only image part of imageAccess, the container must not be written to */
+  void SetImageAccessor(mitk::ImageReadAccessor* imageAccess, size_t noBytes);
+
 protected:
   ImportMitkImageContainer();
   virtual ~ImportMitkImageContainer();
@@ -79,7 +87,7 @@ private:
   void operator=(const Self&); //purposely not implemented
 
   //mitk::ImageDataItem::Pointer m_ImageDataItem;
-  mitk::ImageWriteAccessor* m_imageAccess;
+  mitk::ImageAccessorBase* m_imageAccess;
 };
 
 } // end namespace itk
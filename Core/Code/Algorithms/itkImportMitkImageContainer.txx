@@ -58,9 +58,24 @@ void
 ImportMitkImageContainer< TElementIdentifier , TElement >
 ::SetImageAccessor(mitk::ImageWriteAccessor* imageAccess, size_t noOfBytes)
 {
+  delete m_imageAccess;
   m_imageAccess = imageAccess;
 
-  this->SetImportPointer( (TElement*) m_imageAccess->GetData(), noOfBytes/sizeof(Element), false);
+  this->SetImportPointer( (TElement*) imageAccess->GetData(), noOfBytes/sizeof(Element), false);
+
+  this->Modified();
+}
+
+template <typename TElementIdentifier, typename TElement>
+void
+ImportMitkImageContainer< TElementIdentifier , TElement >
+::SetImageAccessor(mitk::ImageReadAccessor* imageAccess, size_t noOfBytes)
+{
+  delete m_imageAccess;
+  m_imageAccess = imageAccess;
+
+  // the pixel container of an itk::Image is not const, the caller guarantees read-only use
+  this->SetImportPointer( (TElement*) const_cast<void*>( imageAccess->GetData() ), noOfBytes/sizeof(Element), false);
 
   this->Modified();
 }
@@ -0,0 +1,361 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPolyDataPlaneCutter.h"
+
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkPointData.h>
+#include <vtkCellData.h>
+#include <vtkPlane.h>
+#include <vtkCutter.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// normals which differ by less than this ( 1 - cos(angle) ) share an index
+const double NORMAL_TOLERANCE = 1e-9;
+
+// maximum number of bins of an index
+const vtkIdType MAXIMUM_NUMBER_OF_BINS = 8192;
+
+// average number of polygons per bin
+const vtkIdType CELLS_PER_BIN = 8;
+
+inline double Dot(const double a[3], const double b[3])
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+}
+
+mitk::PolyDataPlaneCutter::PolyDataPlaneCutter()
+: m_Input(NULL),
+  m_InputMTime(0),
+  m_MaximumNumberOfOrientations(3),
+  m_Subset(vtkPolyData::New()),
+  m_Plane(vtkPlane::New()),
+  m_Cutter(vtkCutter::New()),
+  m_NumberOfCutCells(0),
+  m_NumberOfIndexBuilds(0)
+{
+  m_Cutter->SetCutFunction(m_Plane);
+  m_Cutter->GenerateValues(1, 0, 1);
+}
+
+mitk::PolyDataPlaneCutter::~PolyDataPlaneCutter()
+{
+  this->ClearIndices();
+  if (m_Input != NULL)
+  {
+    m_Input->UnRegister(NULL);
+  }
+  m_Subset->Delete();
+  m_Plane->Delete();
+  m_Cutter->Delete();
+}
+
+void mitk::PolyDataPlaneCutter::SetInput(vtkPolyData* input)
+{
+  if (input == m_Input)
+  {
+    return;
+  }
+
+  if (input != NULL)
+  {
+    input->Register(NULL);
+  }
+  if (m_Input != NULL)
+  {
+    m_Input->UnRegister(NULL);
+  }
+  m_Input = input;
+
+  this->ClearIndices();
+  this->Modified();
+}
+
+vtkPolyData* mitk::PolyDataPlaneCutter::GetInput() const
+{
+  return m_Input;
+}
+
+void mitk::PolyDataPlaneCutter::ClearIndices()
+{
+  for (std::list<OrientationIndex*>::iterator iter = m_Indices.begin(); iter != m_Indices.end(); ++iter)
+  {
+    delete *iter;
+  }
+  m_Indices.clear();
+  m_UnindexedOrientations.clear();
+  m_CellLocations.clear();
+  m_PointMap.clear();
+  m_InputMTime = 0;
+}
+
+mitk::PolyDataPlaneCutter::OrientationIndex* mitk::PolyDataPlaneCutter::GetIndex(const double normal[3], double& sign)
+{
+  for (std::list<OrientationIndex*>::iterator iter = m_Indices.begin(); iter != m_Indices.end(); ++iter)
+  {
+    double cosine = Dot((*iter)->normal, normal);
+    if (std::fabs(cosine) >= 1.0 - NORMAL_TOLERANCE)
+    {
+      sign = cosine > 0.0 ? 1.0 : -1.0;
+      OrientationIndex* index = *iter;
+      m_Indices.erase(iter);
+      m_Indices.push_front(index);
+      return index;
+    }
+  }
+
+  sign = 1.0;
+
+  // build the index only for an orientation which is cut repeatedly
+  std::list<Orientation>::iterator unindexed = m_UnindexedOrientations.begin();
+  while (unindexed != m_UnindexedOrientations.end()
+         && std::fabs(Dot(unindexed->normal, normal)) < 1.0 - NORMAL_TOLERANCE)
+  {
+    ++unindexed;
+  }
+  if (unindexed == m_UnindexedOrientations.end())
+  {
+    Orientation orientation;
+    std::copy(normal, normal + 3, orientation.normal);
+    m_UnindexedOrientations.push_front(orientation);
+    while (m_UnindexedOrientations.size() > std::max(m_MaximumNumberOfOrientations, 1u))
+    {
+      m_UnindexedOrientations.pop_back();
+    }
+    return NULL;
+  }
+  m_UnindexedOrientations.erase(unindexed);
+
+  m_Indices.push_front(this->BuildIndex(normal));
+  while (m_Indices.size() > std::max(m_MaximumNumberOfOrientations, 1u))
+  {
+    delete m_Indices.back();
+    m_Indices.pop_back();
+  }
+  return m_Indices.front();
+}
+
+mitk::PolyDataPlaneCutter::OrientationIndex* mitk::PolyDataPlaneCutter::BuildIndex(const double normal[3])
+{
+  ++m_NumberOfIndexBuilds;
+
+  if (m_CellLocations.empty())
+  {
+    vtkCellArray* polys = m_Input->GetPolys();
+    m_CellLocations.reserve(polys->GetNumberOfCells());
+    vtkIdType npts;
+    vtkIdType* pts;
+    for (polys->InitTraversal(); polys->GetNextCell(npts, pts); )
+    {
+      m_CellLocations.push_back(polys->GetTraversalLocation(npts));
+    }
+    m_PointMap.assign(m_Input->GetNumberOfPoints(), -1);
+  }
+
+  OrientationIndex* index = new OrientationIndex;
+  std::copy(normal, normal + 3, index->normal);
+
+  // signed distances of all points along the normal
+  vtkPoints* points = m_Input->GetPoints();
+  vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  std::vector<double> distances(numberOfPoints);
+  double point[3];
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+  {
+    points->GetPoint(i, point);
+    distances[i] = Dot(normal, point);
+  }
+
+  // distance interval of every polygon
+  vtkIdType* connectivity = m_Input->GetPolys()->GetPointer();
+  vtkIdType numberOfCells = static_cast<vtkIdType>(m_CellLocations.size());
+  index->cellMinimum.resize(numberOfCells);
+  index->cellMaximum.resize(numberOfCells);
+  double minimum = 0.0;
+  double maximum = 0.0;
+  for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+  {
+    const vtkIdType* cell = connectivity + m_CellLocations[cellId];
+    double cellMinimum = distances[cell[1]];
+    double cellMaximum = cellMinimum;
+    for (vtkIdType p = 2; p <= cell[0]; ++p)
+    {
+      cellMinimum = std::min(cellMinimum, distances[cell[p]]);
+      cellMaximum = std::max(cellMaximum, distances[cell[p]]);
+    }
+    index->cellMinimum[cellId] = cellMinimum;
+    index->cellMaximum[cellId] = cellMaximum;
+    if (cellId == 0 || cellMinimum < minimum)
+      minimum = cellMinimum;
+    if (cellId == 0 || cellMaximum > maximum)
+      maximum = cellMaximum;
+  }
+
+  vtkIdType numberOfBins = std::max<vtkIdType>(1, std::min(numberOfCells / CELLS_PER_BIN, MAXIMUM_NUMBER_OF_BINS));
+  index->minimum = minimum;
+  index->binWidth = (maximum > minimum) ? (maximum - minimum) / numberOfBins : 1.0;
+
+  // sort the polygons into all bins which their interval overlaps, counting first
+  std::vector<vtkIdType> firstBin(numberOfCells);
+  std::vector<vtkIdType> lastBin(numberOfCells);
+  index->binStart.assign(numberOfBins + 1, 0);
+  for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+  {
+    firstBin[cellId] = std::min(numberOfBins - 1, static_cast<vtkIdType>((index->cellMinimum[cellId] - minimum) / index->binWidth));
+    lastBin[cellId] = std::min(numberOfBins - 1, static_cast<vtkIdType>((index->cellMaximum[cellId] - minimum) / index->binWidth));
+    for (vtkIdType bin = firstBin[cellId]; bin <= lastBin[cellId]; ++bin)
+    {
+      ++index->binStart[bin + 1];
+    }
+  }
+  for (vtkIdType bin = 0; bin < numberOfBins; ++bin)
+  {
+    index->binStart[bin + 1] += index->binStart[bin];
+  }
+
+  index->cells.resize(index->binStart[numberOfBins]);
+  std::vector<vtkIdType> binFill(index->binStart.begin(), index->binStart.end() - 1);
+  for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+  {
+    for (vtkIdType bin = firstBin[cellId]; bin <= lastBin[cellId]; ++bin)
+    {
+      index->cells[binFill[bin]++] = cellId;
+    }
+  }
+
+  return index;
+}
+
+vtkPolyData* mitk::PolyDataPlaneCutter::Cut(const double origin[3], const double normal[3])
+{
+  m_Plane->SetOrigin(const_cast<double*>(origin));
+  m_Plane->SetNormal(const_cast<double*>(normal));
+
+  if (m_Input == NULL)
+  {
+    m_NumberOfCutCells = 0;
+    m_Subset->Initialize();
+    m_Cutter->SetInput(m_Subset);
+    m_Cutter->Update();
+    return m_Cutter->GetOutput();
+  }
+
+  // the index covers polygons only, other meshes are cut completely
+  if (m_Input->GetNumberOfVerts() > 0 || m_Input->GetNumberOfLines() > 0 || m_Input->GetNumberOfStrips() > 0
+      || m_Input->GetPoints() == NULL)
+  {
+    m_NumberOfCutCells = m_Input->GetNumberOfCells();
+    m_Cutter->SetInput(m_Input);
+    m_Cutter->Update();
+    return m_Cutter->GetOutput();
+  }
+
+  if (m_Input->GetMTime() != m_InputMTime)
+  {
+    this->ClearIndices();
+    m_InputMTime = m_Input->GetMTime();
+  }
+
+  double unitNormal[3] = { normal[0], normal[1], normal[2] };
+  double length = std::sqrt(Dot(unitNormal, unitNormal));
+  if (length > 0.0)
+  {
+    unitNormal[0] /= length;
+    unitNormal[1] /= length;
+    unitNormal[2] /= length;
+  }
+
+  double sign;
+  OrientationIndex* index = this->GetIndex(unitNormal, sign);
+  if (index == NULL)
+  {
+    m_NumberOfCutCells = m_Input->GetNumberOfCells();
+    m_Cutter->SetInput(m_Input);
+    m_Cutter->Update();
+    return m_Cutter->GetOutput();
+  }
+
+  double distance = sign * Dot(unitNormal, origin);
+
+  // copy the polygons of the bin which contain the plane
+  vtkPoints* inputPoints = m_Input->GetPoints();
+  vtkPointData* inputPointData = m_Input->GetPointData();
+  vtkCellData* inputCellData = m_Input->GetCellData();
+
+  vtkPoints* points = vtkPoints::New(inputPoints->GetDataType());
+  vtkCellArray* polys = vtkCellArray::New();
+  m_Subset->Initialize();
+  m_Subset->GetPointData()->CopyAllocate(inputPointData);
+  m_Subset->GetCellData()->CopyAllocate(inputCellData);
+
+  std::vector<vtkIdType> usedPoints;
+  m_NumberOfCutCells = 0;
+
+  double relative = (distance - index->minimum) / index->binWidth;
+  vtkIdType numberOfBins = static_cast<vtkIdType>(index->binStart.size()) - 1;
+  if (relative >= 0.0 && relative <= numberOfBins)
+  {
+    vtkIdType bin = std::min(numberOfBins - 1, static_cast<vtkIdType>(relative));
+    vtkIdType* connectivity = m_Input->GetPolys()->GetPointer();
+    for (vtkIdType i = index->binStart[bin]; i < index->binStart[bin + 1]; ++i)
+    {
+      vtkIdType cellId = index->cells[i];
+      if (index->cellMinimum[cellId] > distance || index->cellMaximum[cellId] < distance)
+      {
+        continue;
+      }
+
+      const vtkIdType* cell = connectivity + m_CellLocations[cellId];
+      vtkIdType newCellId = polys->InsertNextCell(cell[0]);
+      for (vtkIdType p = 1; p <= cell[0]; ++p)
+      {
+        vtkIdType& mapped = m_PointMap[cell[p]];
+        if (mapped < 0)
+        {
+          mapped = points->InsertNextPoint(inputPoints->GetPoint(cell[p]));
+          m_Subset->GetPointData()->CopyData(inputPointData, cell[p], mapped);
+          usedPoints.push_back(cell[p]);
+        }
+        polys->InsertCellPoint(mapped);
+      }
+      // without vertices and lines, the cell ids of the polygons start at 0
+      m_Subset->GetCellData()->CopyData(inputCellData, cellId, newCellId);
+      ++m_NumberOfCutCells;
+    }
+  }
+
+  for (std::vector<vtkIdType>::const_iterator iter = usedPoints.begin(); iter != usedPoints.end(); ++iter)
+  {
+    m_PointMap[*iter] = -1;
+  }
+
+  m_Subset->SetPoints(points);
+  m_Subset->SetPolys(polys);
+  points->Delete();
+  polys->Delete();
+
+  m_Cutter->SetInput(m_Subset);
+  m_Cutter->Update();
+  return m_Cutter->GetOutput();
+}
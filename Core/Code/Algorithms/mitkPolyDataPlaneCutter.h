@@ -0,0 +1,159 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKPOLYDATAPLANECUTTER_H
+#define MITKPOLYDATAPLANECUTTER_H
+
+#include <MitkExports.h>
+#include "mitkCommon.h"
+
+#include <itkObject.h>
+#include <vtkType.h>
+
+#include <list>
+#include <vector>
+
+class vtkPolyData;
+class vtkPlane;
+class vtkCutter;
+
+namespace mitk {
+
+/**
+ * \brief Cuts a vtkPolyData by planes, passing only the intersected cells to a vtkCutter.
+ *
+ * For every plane orientation, the cutter keeps an index of the signed distance
+ * intervals [min, max] of all polygons along the plane normal. The intervals are
+ * sorted into equally sized bins over the distance range of the mesh. A cut looks
+ * up the bin of the plane, copies the polygons whose interval contains the plane
+ * into a small vtkPolyData and cuts only this one. Moving a plane along its normal,
+ * as when scrolling through slices, thus only touches the intersected polygons.
+ *
+ * The first cut with an orientation is done by the vtkCutter on the whole mesh, as
+ * building the index costs more than one cut. The index is built when the orientation
+ * is cut again. The indices of the last MaximumNumberOfOrientations orientations are
+ * kept (default 3, one per standard view). All indices are discarded if the input or
+ * its points are modified.
+ *
+ * Meshes with vertices, lines or triangle strips are cut by the vtkCutter directly.
+ */
+class MITK_CORE_EXPORT PolyDataPlaneCutter : public itk::Object
+{
+public:
+
+  mitkClassMacro(PolyDataPlaneCutter, itk::Object);
+
+  itkNewMacro(Self);
+
+  /**
+   * \brief Set the mesh to cut.
+   */
+  void SetInput(vtkPolyData* input);
+
+  vtkPolyData* GetInput() const;
+
+  /**
+   * \brief Number of plane orientations whose index is kept.
+   */
+  itkSetMacro(MaximumNumberOfOrientations, unsigned int);
+  itkGetConstMacro(MaximumNumberOfOrientations, unsigned int);
+
+  /**
+   * \brief Cuts the input by the plane through origin with the given normal.
+   *
+   * @return the contour lines, owned by the cutter and valid until the next call of Cut()
+   */
+  vtkPolyData* Cut(const double origin[3], const double normal[3]);
+
+  /**
+   * \brief Number of cells which were passed to the vtkCutter by the last Cut().
+   */
+  itkGetConstMacro(NumberOfCutCells, vtkIdType);
+
+  /**
+   * \brief Number of orientation indices built since the construction of the cutter.
+   */
+  itkGetConstMacro(NumberOfIndexBuilds, unsigned int);
+
+protected:
+
+  PolyDataPlaneCutter();
+
+  virtual ~PolyDataPlaneCutter();
+
+  /** Distance intervals of the polygons along one plane normal */
+  struct OrientationIndex
+  {
+    double normal[3];
+    double minimum;
+    double binWidth;
+    /** the cells of bin i are cells[binStart[i]] to cells[binStart[i+1]-1] */
+    std::vector<vtkIdType> binStart;
+    std::vector<vtkIdType> cells;
+    std::vector<double> cellMinimum;
+    std::vector<double> cellMaximum;
+  };
+
+  /**
+   * Returns the index of the given orientation. sign is -1 if the normal is flipped.
+   * The index is built on the second cut with an orientation, NULL is returned for the first one.
+   */
+  OrientationIndex* GetIndex(const double normal[3], double& sign);
+
+  OrientationIndex* BuildIndex(const double normal[3]);
+
+  void ClearIndices();
+
+  vtkPolyData* m_Input;
+
+  unsigned long m_InputMTime;
+
+  unsigned int m_MaximumNumberOfOrientations;
+
+  /** most recently used first */
+  std::list<OrientationIndex*> m_Indices;
+
+  struct Orientation
+  {
+    double normal[3];
+  };
+
+  /** orientations cut once without an index, most recent first */
+  std::list<Orientation> m_UnindexedOrientations;
+
+  /** offsets of the polygons in the connectivity array of the input */
+  std::vector<vtkIdType> m_CellLocations;
+
+  /** maps input point ids to the point ids of m_Subset, -1 for unused points */
+  std::vector<vtkIdType> m_PointMap;
+
+  vtkPolyData* m_Subset;
+  vtkPlane* m_Plane;
+  vtkCutter* m_Cutter;
+
+  vtkIdType m_NumberOfCutCells;
+
+  unsigned int m_NumberOfIndexBuilds;
+
+private:
+
+  PolyDataPlaneCutter(const Self&); // purposely not implemented
+  void operator=(const Self&); // purposely not implemented
+};
+
+} // namespace mitk
+
+#endif // MITKPOLYDATAPLANECUTTER_H
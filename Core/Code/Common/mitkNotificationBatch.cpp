@@ -0,0 +1,253 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNotificationBatch.h"
+
+#include <itkSimpleFastMutexLock.h>
+#include <itkMutexLockHolder.h>
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <vector>
+
+#if defined(ITK_USE_PTHREADS)
+  #include <pthread.h>
+#elif defined(ITK_USE_WIN32_THREADS)
+  #include <windows.h>
+#endif
+
+namespace {
+
+#if defined(ITK_USE_WIN32_THREADS)
+typedef DWORD ThreadIdType;
+ThreadIdType CurrentThreadId() { return GetCurrentThreadId(); }
+bool EqualThreadIds(ThreadIdType a, ThreadIdType b) { return a == b; }
+#elif defined(ITK_USE_PTHREADS)
+typedef pthread_t ThreadIdType;
+ThreadIdType CurrentThreadId() { return pthread_self(); }
+bool EqualThreadIds(ThreadIdType a, ThreadIdType b) { return pthread_equal(a, b) != 0; }
+#else
+typedef int ThreadIdType;
+ThreadIdType CurrentThreadId() { return 0; }
+bool EqualThreadIds(ThreadIdType a, ThreadIdType b) { return a == b; }
+#endif
+
+struct NotificationKey
+{
+  const void* sender;
+  const void* target;
+  const char* eventName;
+
+  bool operator<(const NotificationKey& other) const
+  {
+    if (sender != other.sender) return sender < other.sender;
+    if (target != other.target) return target < other.target;
+    return std::strcmp(eventName, other.eventName) < 0;
+  }
+};
+
+struct PendingNotification
+{
+  NotificationKey key;
+  mitk::NotificationBatch::Notification* notification;
+};
+
+struct ThreadBatch
+{
+  ThreadIdType thread;
+  unsigned int depth;
+  bool delivering;
+  std::set<NotificationKey> keys;
+  std::vector<PendingNotification> pending;
+};
+
+typedef itk::MutexLockHolder<itk::SimpleFastMutexLock> MutexLocker;
+
+itk::SimpleFastMutexLock s_Mutex;
+std::vector<ThreadBatch*> s_Batches;
+
+// number of threads with an open batch and size of s_Batches; read without
+// locking to make IsActive(), Defer() and Discard() cheap if no batch exists
+volatile int s_NumberOfActiveBatches = 0;
+volatile int s_NumberOfBatches = 0;
+
+std::size_t s_NumberOfCoalescedNotifications = 0;
+
+ThreadBatch* FindBatch_unlocked(ThreadIdType thread)
+{
+  for (std::vector<ThreadBatch*>::const_iterator iter = s_Batches.begin(); iter != s_Batches.end(); ++iter)
+  {
+    if (EqualThreadIds((*iter)->thread, thread))
+    {
+      return *iter;
+    }
+  }
+  return NULL;
+}
+
+}
+
+namespace mitk {
+
+NotificationBatch::Notification::~Notification()
+{
+}
+
+NotificationBatch::NotificationBatch()
+{
+  MutexLocker lock(s_Mutex);
+
+  ThreadIdType thread = CurrentThreadId();
+  ThreadBatch* batch = FindBatch_unlocked(thread);
+  if (batch == NULL)
+  {
+    batch = new ThreadBatch;
+    batch->thread = thread;
+    batch->depth = 0;
+    batch->delivering = false;
+    s_Batches.push_back(batch);
+    ++s_NumberOfBatches;
+  }
+  if (batch->depth++ == 0)
+  {
+    ++s_NumberOfActiveBatches;
+  }
+}
+
+NotificationBatch::~NotificationBatch()
+{
+  ThreadBatch* batch = NULL;
+  {
+    MutexLocker lock(s_Mutex);
+    batch = FindBatch_unlocked(CurrentThreadId());
+    if (batch == NULL || --batch->depth > 0)
+    {
+      return;
+    }
+    --s_NumberOfActiveBatches;
+    if (batch->delivering)
+    {
+      // a listener opened and closed a batch while we are delivering, its
+      // notifications are picked up by the loop below
+      return;
+    }
+    batch->delivering = true;
+    batch->keys.clear();
+  }
+
+  // Deliver one notification at a time without holding the lock. Listeners
+  // may destroy objects, which calls Discard() on the remaining entries.
+  for (std::size_t i = 0; ; ++i)
+  {
+    Notification* notification = NULL;
+    {
+      MutexLocker lock(s_Mutex);
+      if (i >= batch->pending.size())
+      {
+        break;
+      }
+      notification = batch->pending[i].notification;
+      batch->pending[i].notification = NULL;
+    }
+
+    if (notification != NULL)
+    {
+      notification->Deliver();
+      delete notification;
+    }
+  }
+
+  MutexLocker lock(s_Mutex);
+  s_Batches.erase(std::find(s_Batches.begin(), s_Batches.end(), batch));
+  --s_NumberOfBatches;
+  delete batch;
+}
+
+bool NotificationBatch::IsActive()
+{
+  if (s_NumberOfActiveBatches == 0)
+  {
+    return false;
+  }
+
+  MutexLocker lock(s_Mutex);
+  ThreadBatch* batch = FindBatch_unlocked(CurrentThreadId());
+  return batch != NULL && batch->depth > 0;
+}
+
+bool NotificationBatch::Defer(const void* sender, const void* target, const char* eventName, Notification* notification)
+{
+  if (s_NumberOfActiveBatches == 0)
+  {
+    return false;
+  }
+
+  MutexLocker lock(s_Mutex);
+  ThreadBatch* batch = FindBatch_unlocked(CurrentThreadId());
+  if (batch == NULL || batch->depth == 0)
+  {
+    return false;
+  }
+
+  PendingNotification entry;
+  entry.key.sender = sender;
+  entry.key.target = target;
+  entry.key.eventName = eventName;
+  entry.notification = notification;
+
+  if (batch->keys.insert(entry.key).second)
+  {
+    batch->pending.push_back(entry);
+  }
+  else
+  {
+    ++s_NumberOfCoalescedNotifications;
+    delete notification;
+  }
+  return true;
+}
+
+void NotificationBatch::Discard(const void* object)
+{
+  if (s_NumberOfBatches == 0)
+  {
+    return;
+  }
+
+  MutexLocker lock(s_Mutex);
+  for (std::vector<ThreadBatch*>::iterator batchIter = s_Batches.begin(); batchIter != s_Batches.end(); ++batchIter)
+  {
+    ThreadBatch* batch = *batchIter;
+    for (std::vector<PendingNotification>::iterator iter = batch->pending.begin(); iter != batch->pending.end(); ++iter)
+    {
+      if (iter->notification != NULL && (iter->key.sender == object || iter->key.target == object))
+      {
+        batch->keys.erase(iter->key);
+        delete iter->notification;
+        iter->notification = NULL;
+      }
+    }
+  }
+}
+
+std::size_t NotificationBatch::GetNumberOfCoalescedNotifications()
+{
+  MutexLocker lock(s_Mutex);
+  return s_NumberOfCoalescedNotifications;
+}
+
+}
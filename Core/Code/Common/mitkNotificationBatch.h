@@ -0,0 +1,145 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNOTIFICATIONBATCH_H
+#define MITKNOTIFICATIONBATCH_H
+
+#include <MitkExports.h>
+#include "mitkMessage.h"
+
+#include <cstddef>
+
+namespace mitk {
+
+/**
+ * \brief Scoped batching of change notifications.
+ *
+ * While a NotificationBatch object exists on the calling thread, notifications
+ * which are sent through this class are not delivered immediately but
+ * collected. Duplicates, i.e. notifications with the same sender, target and
+ * event name, are coalesced into one. All collected notifications are
+ * delivered once, in the order in which they were first sent, when the
+ * outermost batch of the thread is destroyed.
+ *
+ * Batches nest; only the outermost one triggers the delivery. Batches on
+ * other threads do not influence the current thread.
+ *
+ * \code
+ * {
+ *   mitk::NotificationBatch batch;
+ *   for (...)
+ *     node->SetOpacity(0.5f); // DataStorage::ChangedNodeEvent is sent once per node
+ * } // notifications are delivered here
+ * \endcode
+ *
+ * DataNode (property list modifications), DataStorage (ChangedNodeEvent) and
+ * RenderingManager::RequestUpdateAll() defer their notifications through
+ * this class. Note that a deferred DataNode::Modified() also means that the
+ * modification time of the node is not updated before the batch ends.
+ *
+ * Objects which may be the sender or target of a deferred notification must
+ * call Discard() in their destructor.
+ */
+class MITK_CORE_EXPORT NotificationBatch
+{
+public:
+
+  /**
+   * \brief A notification which can be deferred until the end of a batch.
+   */
+  class MITK_CORE_EXPORT Notification
+  {
+  public:
+    virtual ~Notification();
+    virtual void Deliver() = 0;
+  };
+
+  NotificationBatch();
+  ~NotificationBatch();
+
+  /**
+   * \brief Returns true if a batch is active on the calling thread.
+   */
+  static bool IsActive();
+
+  /**
+   * \brief Defers a notification if a batch is active on the calling thread.
+   *
+   * If the method returns true, the batch took ownership of \a notification
+   * (and deleted it immediately if an equal notification was already pending).
+   * If it returns false, no batch is active, \a notification is left untouched
+   * and the caller has to deliver it itself.
+   *
+   * \a eventName must point to a string which outlives the batch, typically a
+   * string literal.
+   */
+  static bool Defer(const void* sender, const void* target, const char* eventName, Notification* notification);
+
+  /**
+   * \brief Drops all pending notifications whose sender or target is \a object.
+   */
+  static void Discard(const void* object);
+
+  /**
+   * \brief Sends \a message with argument \a t, deferred if a batch is active.
+   *
+   * The notification is identified by the message and the argument, so the
+   * argument must be a pointer. The pointed-to object has to call Discard()
+   * when it is destroyed.
+   */
+  template <typename T, typename A>
+  static void Send(Message1<T*, A>& message, T* t)
+  {
+    if (!IsActive() || !Defer(t, &message, "mitk::Message1", new MessageNotification<T, A>(message, t)))
+    {
+      message.Send(t);
+    }
+  }
+
+  /**
+   * \brief Returns the number of notifications which were dropped because an
+   * equal notification was already pending.
+   */
+  static std::size_t GetNumberOfCoalescedNotifications();
+
+private:
+
+  template <typename T, typename A>
+  class MessageNotification : public Notification
+  {
+  public:
+    MessageNotification(Message1<T*, A>& message, T* t)
+      : m_Message(message), m_Argument(t)
+    {}
+
+    virtual void Deliver()
+    {
+      m_Message.Send(m_Argument);
+    }
+
+  private:
+    Message1<T*, A>& m_Message;
+    T* m_Argument;
+  };
+
+  // purposely not implemented
+  NotificationBatch(const NotificationBatch&);
+  NotificationBatch& operator=(const NotificationBatch&);
+};
+
+}
+
+#endif // MITKNOTIFICATIONBATCH_H
@@ -26,12 +26,47 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkAffineGeometryFrame.h>
 #include <itkScalableAffineTransform.h>
 #include <mitkVtkPropRenderer.h>
+#include "mitkNotificationBatch.h"
 
 #include <algorithm>
 
 namespace mitk
 {
 
+namespace
+{
+  // requests an update of all render windows of one type at the end of a notification batch
+  class RequestUpdateAllNotification : public NotificationBatch::Notification
+  {
+  public:
+    RequestUpdateAllNotification(RenderingManager* manager, RenderingManager::RequestType type)
+      : m_Manager(manager), m_Type(type)
+    {}
+
+    virtual void Deliver()
+    {
+      m_Manager->RequestUpdateAll(m_Type);
+    }
+
+  private:
+    RenderingManager* m_Manager;
+    RenderingManager::RequestType m_Type;
+  };
+
+  const char* RequestUpdateAllEventName(RenderingManager::RequestType type)
+  {
+    switch (type)
+    {
+    case RenderingManager::REQUEST_UPDATE_2DWINDOWS:
+      return "mitk::RenderingManager::RequestUpdateAll(2D)";
+    case RenderingManager::REQUEST_UPDATE_3DWINDOWS:
+      return "mitk::RenderingManager::RequestUpdateAll(3D)";
+    default:
+      return "mitk::RenderingManager::RequestUpdateAll";
+    }
+  }
+}
+
 RenderingManager::Pointer RenderingManager::s_Instance = 0;
 RenderingManagerFactory *RenderingManager::s_RenderingManagerFactory = 0;
 
@@ -59,6 +94,8 @@ RenderingManager
 RenderingManager
 ::~RenderingManager()
 {
+  NotificationBatch::Discard(this);
+
   // Decrease reference counts of all registered vtkRenderWindows for
   // proper destruction
   RenderWindowVector::iterator it;
@@ -301,6 +338,12 @@ void
 RenderingManager
 ::RequestUpdateAll( RequestType type )
 {
+  if ( NotificationBatch::IsActive() &&
+       NotificationBatch::Defer( this, this, RequestUpdateAllEventName(type), new RequestUpdateAllNotification(this, type) ) )
+  {
+    return;
+  }
+
   RenderWindowList::iterator it;
   for ( it = m_RenderWindowList.begin(); it != m_RenderWindowList.end(); ++it )
   {
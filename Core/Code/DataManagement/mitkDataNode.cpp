@@ -28,6 +28,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkLevelWindowProperty.h"
 #include "mitkGeometry3D.h"
 #include "mitkRenderingManager.h"
+#include "mitkNotificationBatch.h"
 #include "mitkGlobalInteraction.h"
 #include "mitkEventMapper.h"
 #include "mitkGenericProperty.h"
@@ -87,6 +88,24 @@ void mitk::DataNode::SetInteractor(mitk::Interactor* interactor)
     m_Interactor->SetDataNode(this);
 }
 
+namespace
+{
+  // calls Modified() on a node at the end of a notification batch
+  class NodeModifiedNotification : public mitk::NotificationBatch::Notification
+  {
+  public:
+    NodeModifiedNotification(mitk::DataNode* node) : m_Node(node) {}
+
+    virtual void Deliver()
+    {
+      m_Node->Modified();
+    }
+
+  private:
+    mitk::DataNode* m_Node;
+  };
+}
+
 mitk::DataNode::DataNode() : m_Data(NULL), m_PropertyListModifiedObserverTag(0)
 {
   m_Mappers.resize(10);
@@ -107,6 +126,13 @@ mitk::DataNode::~DataNode()
     // remove modified event listener
     m_PropertyList->RemoveObserver(m_PropertyListModifiedObserverTag);
 
+  for(MapOfPropertyLists::iterator it = m_MapOfPropertyLists.begin(); it != m_MapOfPropertyLists.end(); ++it)
+  {
+    std::map<const mitk::BaseRenderer*, unsigned long>::const_iterator tagIt = m_RendererPropertyListModifiedObserverTags.find(it->first);
+    if(it->second.IsNotNull() && tagIt != m_RendererPropertyListModifiedObserverTags.end())
+      it->second->RemoveObserver(tagIt->second);
+  }
+
   Interactor* interactor = this->GetInteractor();
 
   if ( interactor )
@@ -114,6 +140,8 @@ mitk::DataNode::~DataNode()
     mitk::GlobalInteraction::GetInstance()->RemoveInteractor( interactor );
   }
   m_Mappers.clear();
+
+  mitk::NotificationBatch::Discard(this);
   m_Data = NULL;
 }
 
@@ -163,6 +191,8 @@ void mitk::DataNode::SetMapper(MapperSlotId id, mitk::Mapper* mapper)
 
   if (mapper!=NULL)
     mapper->SetDataNode(this);
+
+  Modified();
 }
 
 void mitk::DataNode::UpdateOutputInformation()
@@ -202,8 +232,16 @@ mitk::PropertyList* mitk::DataNode::GetPropertyList(const mitk::BaseRenderer* re
   mitk::PropertyList::Pointer & propertyList = m_MapOfPropertyLists[renderer];
 
   if(propertyList.IsNull())
+  {
     propertyList = mitk::PropertyList::New();
 
+    // renderer specific changes modify the node like changes of the common list
+    itk::MemberCommand<mitk::DataNode>::Pointer _PropertyListModifiedCommand =
+      itk::MemberCommand<mitk::DataNode>::New();
+    _PropertyListModifiedCommand->SetCallbackFunction(const_cast<mitk::DataNode*>(this), &mitk::DataNode::PropertyListModified);
+    m_RendererPropertyListModifiedObserverTags[renderer] = propertyList->AddObserver(itk::ModifiedEvent(), _PropertyListModifiedCommand);
+  }
+
   assert(m_MapOfPropertyLists[renderer].IsNotNull());
 
   return propertyList;
@@ -252,6 +290,24 @@ mitk::BaseProperty* mitk::DataNode::GetProperty(const char *propertyKey, const m
   return NULL;
 }
 
+mitk::BaseProperty* mitk::DataNode::GetProperty(const PropertyKey& propertyKey, const mitk::BaseRenderer* renderer) const
+{
+  //renderer specified? check for the renderer specific property first
+  if (renderer)
+  {
+    std::map<const mitk::BaseRenderer*,mitk::PropertyList::Pointer>::const_iterator it = m_MapOfPropertyLists.find(renderer);
+    if(it!=m_MapOfPropertyLists.end())
+    {
+      mitk::BaseProperty* property = it->second->GetProperty(propertyKey);
+      if(property != NULL)
+        return property;
+    }
+  }
+
+  //return the renderer unspecific property if there is one
+  return m_PropertyList->GetProperty(propertyKey);
+}
+
 mitk::DataNode::GroupTagList mitk::DataNode::GetGroupTags() const
 {
   GroupTagList groups;
@@ -281,6 +337,16 @@ bool mitk::DataNode::GetBoolProperty(const char* propertyKey, bool& boolValue, m
   return true;
 }
 
+bool mitk::DataNode::GetBoolProperty(const PropertyKey& propertyKey, bool& boolValue, mitk::BaseRenderer* renderer) const
+{
+  mitk::BoolProperty* boolprop = PropertyList::PropertyCast<mitk::BoolProperty>(GetProperty(propertyKey, renderer));
+  if(boolprop == NULL)
+    return false;
+
+  boolValue = boolprop->GetValue();
+  return true;
+}
+
 bool mitk::DataNode::GetIntProperty(const char* propertyKey, int &intValue, mitk::BaseRenderer* renderer) const
 {
   mitk::IntProperty::Pointer intprop = dynamic_cast<mitk::IntProperty*>(GetProperty(propertyKey, renderer));
@@ -291,6 +357,16 @@ bool mitk::DataNode::GetIntProperty(const char* propertyKey, int &intValue, mitk
   return true;
 }
 
+bool mitk::DataNode::GetIntProperty(const PropertyKey& propertyKey, int &intValue, mitk::BaseRenderer* renderer) const
+{
+  mitk::IntProperty* intprop = PropertyList::PropertyCast<mitk::IntProperty>(GetProperty(propertyKey, renderer));
+  if(intprop == NULL)
+    return false;
+
+  intValue = intprop->GetValue();
+  return true;
+}
+
 bool mitk::DataNode::GetFloatProperty(const char* propertyKey, float &floatValue, mitk::BaseRenderer* renderer) const
 {
   mitk::FloatProperty::Pointer floatprop = dynamic_cast<mitk::FloatProperty*>(GetProperty(propertyKey, renderer));
@@ -301,6 +377,16 @@ bool mitk::DataNode::GetFloatProperty(const char* propertyKey, float &floatValue
   return true;
 }
 
+bool mitk::DataNode::GetFloatProperty(const PropertyKey& propertyKey, float &floatValue, mitk::BaseRenderer* renderer) const
+{
+  mitk::FloatProperty* floatprop = PropertyList::PropertyCast<mitk::FloatProperty>(GetProperty(propertyKey, renderer));
+  if(floatprop == NULL)
+    return false;
+
+  floatValue = floatprop->GetValue();
+  return true;
+}
+
 bool mitk::DataNode::GetStringProperty(const char* propertyKey, std::string& string, mitk::BaseRenderer* renderer) const
 {
   mitk::StringProperty::Pointer stringProp = dynamic_cast<mitk::StringProperty*>(GetProperty(propertyKey, renderer));
@@ -326,6 +412,16 @@ bool mitk::DataNode::GetColor(float rgb[3], mitk::BaseRenderer* renderer, const
   return true;
 }
 
+bool mitk::DataNode::GetColor(float rgb[3], mitk::BaseRenderer* renderer, const PropertyKey& propertyKey) const
+{
+  mitk::ColorProperty* colorprop = PropertyList::PropertyCast<mitk::ColorProperty>(GetProperty(propertyKey, renderer));
+  if(colorprop == NULL)
+    return false;
+
+  memcpy(rgb, colorprop->GetColor().GetDataPointer(), 3*sizeof(float));
+  return true;
+}
+
 bool mitk::DataNode::GetOpacity(float &opacity, mitk::BaseRenderer* renderer, const char* propertyKey) const
 {
   mitk::FloatProperty::Pointer opacityprop = dynamic_cast<mitk::FloatProperty*>(GetProperty(propertyKey, renderer));
@@ -336,6 +432,11 @@ bool mitk::DataNode::GetOpacity(float &opacity, mitk::BaseRenderer* renderer, co
   return true;
 }
 
+bool mitk::DataNode::GetOpacity(float &opacity, mitk::BaseRenderer* renderer, const PropertyKey& propertyKey) const
+{
+  return GetFloatProperty(propertyKey, opacity, renderer);
+}
+
 bool mitk::DataNode::GetLevelWindow(mitk::LevelWindow &levelWindow, mitk::BaseRenderer* renderer, const char* propertyKey) const
 {
   mitk::LevelWindowProperty::Pointer levWinProp = dynamic_cast<mitk::LevelWindowProperty*>(GetProperty(propertyKey, renderer));
@@ -563,6 +664,11 @@ mitk::DataInteractor::Pointer mitk::DataNode::GetDataInteractor() const
 
 void mitk::DataNode::PropertyListModified( const itk::Object* /*caller*/, const itk::EventObject& )
 {
-  Modified();
+  // coalesce property changes within a notification batch into one Modified() per node
+  if (!NotificationBatch::IsActive() ||
+      !NotificationBatch::Defer(this, this, "mitk::DataNode::PropertyListModified", new NodeModifiedNotification(this)))
+  {
+    Modified();
+  }
 }
 
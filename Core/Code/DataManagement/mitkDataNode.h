@@ -201,6 +201,15 @@ public:
   //## @sa m_MapOfPropertyLists
   mitk::BaseProperty* GetProperty(const char *propertyKey, const mitk::BaseRenderer* renderer = NULL) const;
 
+  //##Documentation
+  //## @brief Get the property with the interned key @a propertyKey from the PropertyList
+  //## of the @a renderer, if available there, otherwise use the BaseRenderer-independent PropertyList.
+  //##
+  //## Same semantics as GetProperty(const char*, const mitk::BaseRenderer*), but
+  //## without string comparisons. Meant for hot paths like rendering.
+  //## @sa PropertyKey
+  mitk::BaseProperty* GetProperty(const PropertyKey& propertyKey, const mitk::BaseRenderer* renderer = NULL) const;
+
   //##Documentation
   //## @brief Get the property of type T with key @a propertyKey from the PropertyList
   //## of the @a renderer, if available there, otherwise use the BaseRenderer-independent PropertyList.
@@ -260,18 +269,33 @@ public:
   //## @return @a true property was found
   bool GetBoolProperty(const char* propertyKey, bool &boolValue, mitk::BaseRenderer* renderer = NULL) const;
 
+  //##Documentation
+  //## @brief Convenience access method for bool properties by an interned key
+  //## @return @a true property was found
+  bool GetBoolProperty(const PropertyKey& propertyKey, bool &boolValue, mitk::BaseRenderer* renderer = NULL) const;
+
   //##Documentation
   //## @brief Convenience access method for int properties (instances of
   //## IntProperty)
   //## @return @a true property was found
   bool GetIntProperty(const char* propertyKey, int &intValue, mitk::BaseRenderer* renderer=NULL) const;
 
+  //##Documentation
+  //## @brief Convenience access method for int properties by an interned key
+  //## @return @a true property was found
+  bool GetIntProperty(const PropertyKey& propertyKey, int &intValue, mitk::BaseRenderer* renderer = NULL) const;
+
   //##Documentation
   //## @brief Convenience access method for float properties (instances of
   //## FloatProperty)
   //## @return @a true property was found
   bool GetFloatProperty(const char* propertyKey, float &floatValue, mitk::BaseRenderer* renderer = NULL) const;
 
+  //##Documentation
+  //## @brief Convenience access method for float properties by an interned key
+  //## @return @a true property was found
+  bool GetFloatProperty(const PropertyKey& propertyKey, float &floatValue, mitk::BaseRenderer* renderer = NULL) const;
+
   //##Documentation
   //## @brief Convenience access method for string properties (instances of
   //## StringProperty)
@@ -284,6 +308,11 @@ public:
   //## @return @a true property was found
   bool GetColor(float rgb[3], mitk::BaseRenderer* renderer = NULL, const char* propertyKey = "color") const;
 
+  //##Documentation
+  //## @brief Convenience access method for color properties by an interned key
+  //## @return @a true property was found
+  bool GetColor(float rgb[3], mitk::BaseRenderer* renderer, const PropertyKey& propertyKey) const;
+
   //##Documentation
   //## @brief Convenience access method for level-window properties (instances of
   //## LevelWindowProperty)
@@ -355,12 +384,25 @@ public:
     return GetBoolProperty(propertyKey, visible, renderer);
   }
 
+  //##Documentation
+  //## @brief Convenience access method for visibility properties by an interned key
+  //## @return @a true property was found
+  bool GetVisibility(bool &visible, mitk::BaseRenderer* renderer, const PropertyKey& propertyKey) const
+  {
+    return GetBoolProperty(propertyKey, visible, renderer);
+  }
+
   //##Documentation
   //## @brief Convenience access method for opacity properties (instances of
   //## FloatProperty)
   //## @return @a true property was found
   bool GetOpacity(float &opacity, mitk::BaseRenderer* renderer, const char* propertyKey = "opacity") const;
 
+  //##Documentation
+  //## @brief Convenience access method for opacity properties by an interned key
+  //## @return @a true property was found
+  bool GetOpacity(float &opacity, mitk::BaseRenderer* renderer, const PropertyKey& propertyKey) const;
+
   //##Documentation
   //## @brief Convenience access method for boolean properties (instances
   //## of BoolProperty). Return value is the value of the property. If the property is
@@ -482,7 +524,8 @@ protected:
   virtual ~DataNode();
 
   //##
-  //## Invoked when the property list was modified. Calls Modified() of the DataNode
+  //## Invoked when the property list or one of the BaseRenderer-specific property lists
+  //## was modified. Calls Modified() of the DataNode
   virtual void PropertyListModified(const itk::Object *caller, const itk::EventObject &event);
 
   //##Documentation
@@ -517,6 +560,10 @@ protected:
   itk::TimeStamp m_DataReferenceChangedTime;
 
   unsigned long m_PropertyListModifiedObserverTag;
+
+  //##Documentation
+  //## @brief Tags of the observers of the BaseRenderer-specific PropertyLists
+  mutable std::map<const mitk::BaseRenderer*, unsigned long> m_RendererPropertyListModifiedObserverTags;
 };
 
 
@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkNodePredicateBase.h"
 #include "mitkNodePredicateProperty.h"
 #include "mitkGroupTagProperty.h"
+#include "mitkNotificationBatch.h"
 #include "itkMutexLockHolder.h"
 
 #include "itkCommand.h"
@@ -34,6 +35,8 @@ mitk::DataStorage::DataStorage() : itk::Object()
 
 mitk::DataStorage::~DataStorage()
 {
+  NotificationBatch::Discard(&ChangedNodeEvent);
+
   ///// we can not call GetAll() in destructor, because it is implemented in a subclass
   //SetOfObjects::ConstPointer all = this->GetAll();
   //for (SetOfObjects::ConstIterator it = all->Begin(); it != all->End(); ++it)
@@ -207,7 +210,7 @@ void mitk::DataStorage::OnNodeModifiedOrDeleted( const itk::Object *caller, cons
   {
     const itk::ModifiedEvent* modEvent = dynamic_cast<const itk::ModifiedEvent*>(&event);
     if(modEvent)
-      ChangedNodeEvent.Send(_Node);
+      NotificationBatch::Send(ChangedNodeEvent, _Node);
     else
       DeleteNodeEvent.Send(_Node);
   }
@@ -29,7 +29,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 mitk::Image::Image() :
 m_Dimension(0), m_Dimensions(NULL), m_ImageDescriptor(NULL), m_OffsetTable(NULL), m_CompleteData(NULL),
-  m_ImageStatistics(NULL)
+  m_ImageStatistics(NULL), m_ReadWriteCondition(itk::ConditionVariable::New())
 {
    m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
    FILL_C_ARRAY( m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
@@ -38,7 +38,8 @@ m_Dimension(0), m_Dimensions(NULL), m_ImageDescriptor(NULL), m_OffsetTable(NULL)
 }
 
 mitk::Image::Image(const Image &other) : SlicedData(other), m_Dimension(0), m_Dimensions(NULL),
-m_ImageDescriptor(NULL), m_OffsetTable(NULL), m_CompleteData(NULL), m_ImageStatistics(NULL)
+m_ImageDescriptor(NULL), m_OffsetTable(NULL), m_CompleteData(NULL), m_ImageStatistics(NULL),
+  m_ReadWriteCondition(itk::ConditionVariable::New())
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
   FILL_C_ARRAY( m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
@@ -31,6 +31,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #ifndef __itkHistogram_h
 #include <itkHistogram.h>
 #endif
+#include <itkConditionVariable.h>
 
 
 class vtkImageData;
@@ -623,7 +624,9 @@ private:
   std::vector<ImageAccessorBase*> m_VtkReaders;
 
   /** A mutex, which needs to be locked to manage m_Readers and m_Writers */
-  itk::SimpleFastMutexLock m_ReadWriteLock;
+  itk::SimpleMutexLock m_ReadWriteLock;
+  /** Signaled whenever an ImageReadAccessor or ImageWriteAccessor is released, used with m_ReadWriteLock */
+  itk::ConditionVariable::Pointer m_ReadWriteCondition;
   /** A mutex, which needs to be locked to manage m_VtkReaders */
   itk::SimpleFastMutexLock m_VtkReadersLock;
 
@@ -17,6 +17,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageAccessorBase.h"
 #include "mitkImage.h"
 
+#include <algorithm>
+
 mitk::ImageAccessorBase::ThreadIDType mitk::ImageAccessorBase::CurrentThreadHandle()
 {
   #ifdef ITK_USE_SPROC
@@ -50,10 +52,6 @@ bool mitk::ImageAccessorBase::CompareThreadHandles(mitk::ImageAccessorBase::Thre
     {
       m_Thread = CurrentThreadHandle();
 
-      // Initialize WaitLock
-      m_WaitLock = new ImageAccessorWaitLock();
-      m_WaitLock->m_WaiterCount = 0;
-
       // Check validity of ImageAccessor
 
       // Is there an Image?
@@ -148,24 +146,37 @@ bool mitk::ImageAccessorBase::CompareThreadHandles(mitk::ImageAccessorBase::Thre
     return false;
   }
 
-  /** \brief Uses the WaitLock to wait for another ImageAccessor*/
-  void mitk::ImageAccessorBase::WaitForReleaseOf(ImageAccessorWaitLock* wL) {
-    wL->m_Mutex.Lock();
-
-    // Decrement
-    wL->m_WaiterCount -= 1;
-
-    // If there are no more waiting ImageAccessors, delete the Mutex
-    // (Der Letzte macht das Licht aus!)
-    if(wL->m_WaiterCount <= 0)
+  mitk::ImageAccessorBase* mitk::ImageAccessorBase::GetOverlappingAccessor(const std::vector<ImageAccessorBase*>& accessors)
+  {
+    for(std::vector<ImageAccessorBase*>::const_iterator it = accessors.begin(); it != accessors.end(); ++it)
     {
-      wL->m_Mutex.Unlock();
-      delete wL;
+      if(Overlap(*it))
+      {
+        return *it;
+      }
     }
-    else
+    return NULL;
+  }
+
+  void mitk::ImageAccessorBase::WaitForRelease()
+  {
+    // Every released ImageAccessor wakes up all waiting ones, which check
+    // again whether their image part is available now.
+    m_Image->m_ReadWriteCondition->Wait(&m_Image->m_ReadWriteLock);
+  }
+
+  void mitk::ImageAccessorBase::Release(std::vector<ImageAccessorBase*>& accessors)
+  {
+    m_Image->m_ReadWriteLock.Lock();
+
+    std::vector<ImageAccessorBase*>::iterator it = std::find(accessors.begin(), accessors.end(), this);
+    if(it != accessors.end())
     {
-      wL->m_Mutex.Unlock();
+      accessors.erase(it);
     }
+    m_Image->m_ReadWriteCondition->Broadcast();
+
+    m_Image->m_ReadWriteLock.Unlock();
   }
 
   void mitk::ImageAccessorBase::PreventRecursiveMutexLock(mitk::ImageAccessorBase* iAB)
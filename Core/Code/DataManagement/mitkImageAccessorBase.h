@@ -23,6 +23,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkSmartPointer.h>
 #include <itkMultiThreader.h>
 
+#include <vector>
+
 #include "mitkImageDataItem.h"
 
 namespace mitk {
@@ -30,20 +32,17 @@ namespace mitk {
 //##Documentation
 //## @brief The ImageAccessorBase class provides a lock mechanism for all inheriting image accessors.
 //##
+//## Accessors lock only the image part they were created for. Read accessors
+//## share their image part with other read accessors, write accessors have
+//## exclusive access. Accessors for disjoint parts, e.g. different time steps
+//## obtained by Image::GetVolumeData(t) or slices obtained by
+//## Image::GetSliceData(s,t), never block each other.
+//##
 //## @ingroup Data
 
 class Image;
 typedef itk::SmartPointer<mitk::Image> ImagePointer;
 
-/** \brief This struct allows to make ImageAccessors wait for this particular ImageAccessor object*/
-struct ImageAccessorWaitLock {
-  /** \brief Holds the number of ImageAccessors, which are waiting until the represented ImageAccessor is released. */
-  unsigned int m_WaiterCount;
-
-  /** \brief A mutex that allows other ImageAccessors to wait for the represented ImageAccessor. */
-  itk::SimpleFastMutexLock m_Mutex;
-};
-
 // Defs to assure dead lock prevention only in case of possible thread handling.
 #if defined(ITK_USE_SPROC) || defined(ITK_USE_PTHREADS) || defined(ITK_USE_WIN32_THREADS)
   #define MITK_USE_RECURSIVE_MUTEX_PREVENTION
@@ -121,22 +120,25 @@ typedef pthread_t ThreadIDType;
   /** Defines if the accessed image part lies coherently in memory */
   bool m_CoherentMemory;
 
-  /** \brief Pointer to a WaitLock struct, that allows other ImageAccessors to wait for this ImageAccessor */
-  ImageAccessorWaitLock* m_WaitLock;
-
-  /** \brief Increments m_WaiterCount. A call of this method is prohibited unless the Mutex m_ReadWriteLock in the mitk::Image class is Locked. */
-  inline void Increment()
-  {
-    m_WaitLock->m_WaiterCount += 1;
-  }
-
   /** \brief Computes if there is an Overlap of the image part between this instantiation and another ImageAccessor object
     * \throws mitk::Exception if memory area is incoherent (not supported yet)
     */
   bool Overlap(const ImageAccessorBase* iAB);
 
-  /** \brief Uses the WaitLock to wait for another ImageAccessor*/
-  void WaitForReleaseOf(ImageAccessorWaitLock* wL);
+  /** \brief Returns the first of the given ImageAccessors whose image part overlaps with this one, or NULL.
+    * A call of this method is prohibited unless the Mutex m_ReadWriteLock in the mitk::Image class is Locked.
+    */
+  ImageAccessorBase* GetOverlappingAccessor(const std::vector<ImageAccessorBase*>& accessors);
+
+  /** \brief Waits until another ImageAccessor of the image is released. m_ReadWriteLock in the mitk::Image
+    * class has to be locked, it is released while waiting and locked again afterwards.
+    */
+  void WaitForRelease();
+
+  /** \brief Removes this ImageAccessor from the given list and wakes up waiting ImageAccessors.
+    * Locks m_ReadWriteLock in the mitk::Image class.
+    */
+  void Release(std::vector<ImageAccessorBase*>& accessors);
 
   ThreadIDType m_Thread;
 
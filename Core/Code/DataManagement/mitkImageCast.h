@@ -33,6 +33,14 @@ namespace mitk
 
  //##Documentation
  //## @brief Cast an mitk::Image to an itk::Image with a specific type. You don't have to initialize the itk::Image<..>::Pointer.
+ //##
+ //## If the mitk::Image already has the pixel type and dimension of the itk::Image, the itk::Image
+ //## shares the buffer of the mitk::Image and holds an mitk::ImageWriteAccessor while it exists, so
+ //## writing to it changes the mitk::Image. No other reader or writer can access the mitk::Image until
+ //## the itk::Image is released. Otherwise the pixels are cast into a new buffer.
+ //##
+ //## Code that only reads the pixels should wrap the mitk::Image with ImageToItk::ConstInputOn()
+ //## instead, which holds an mitk::ImageReadAccessor and lets other readers access the image.
  //## @ingroup Adaptor
  template <typename ItkOutputImageType> extern void MITK_CORE_EXPORT CastToItkImage(const mitk::Image * mitkImage, itk::SmartPointer<ItkOutputImageType>& itkOutputImage);
 }
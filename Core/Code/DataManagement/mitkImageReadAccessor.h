@@ -68,24 +68,8 @@ public:
   {
     // Future work: In case of non-coherent memory, copied area needs to be deleted
 
-    m_Image->m_ReadWriteLock.Lock();
-
     // delete self from list of ImageReadAccessors in Image
-    std::vector<ImageAccessorBase*>::iterator it = std::find(m_Image->m_Readers.begin(),m_Image->m_Readers.end(),this);
-    m_Image->m_Readers.erase(it);
-
-    // delete lock, if there are no waiting ImageAccessors
-    if(m_WaitLock->m_WaiterCount <= 0)
-    {
-      m_WaitLock->m_Mutex.Unlock();
-      delete m_WaitLock;
-    }
-    else
-    {
-      m_WaitLock->m_Mutex.Unlock();
-    }
-
-    m_Image->m_ReadWriteLock.Unlock();
+    Release(m_Image->m_Readers);
   }
 
 protected:
@@ -99,53 +83,29 @@ private:
   {
     m_Image->m_ReadWriteLock.Lock();
 
-    // Check, if there is any Write-Access going on
-    if(m_Image->m_Writers.size() > 0)
+    // Read accesses never conflict with each other, so only write accesses to
+    // an overlapping image part have to be waited for.
+    while(ImageAccessorBase* w = GetOverlappingAccessor(m_Image->m_Writers))
     {
-      // Check for every WriteAccessors, if the Region of this ImageAccessors overlaps
-      // make sure this iterator is not used, when m_ReadWriteLock is Unlocked!
-      std::vector<ImageAccessorBase*>::iterator it = m_Image->m_Writers.begin();
+      PreventRecursiveMutexLock(w);
 
-      for(; it!=m_Image->m_Writers.end(); ++it)
+      // An Overlap was detected. There are two possibilities to deal with this situation:
+      // Throw an exception or wait until the WriteAccessor w is released and check again.
+      if(m_Options & ExceptionIfLocked)
       {
-        ImageAccessorBase* w = *it;
-        if( Overlap(w) )
-        {
-          // An Overlap was detected. There are two possibilities to deal with this situation:
-          // Throw an exception or wait for the WriteAccessor w until it is released and start again with the request afterwards.
-          if(!(m_Options & ExceptionIfLocked))
-          {
-            PreventRecursiveMutexLock(w);
-
-            // WAIT
-            w->Increment();
-            m_Image->m_ReadWriteLock.Unlock();
-            ImageAccessorBase::WaitForReleaseOf(w->m_WaitLock);
-
-            //after waiting for the WriteAccessor w, start this method again
-            OrganizeReadAccess();
-            return;
-          }
-          else
-          {
-            // THROW EXCEPTION
-            m_Image->m_ReadWriteLock.Unlock();
-            mitkThrowException(mitk::MemoryIsLockedException) << "The image part being ordered by the ImageAccessor is already in use and locked";
-            return;
-          }
-        } // if
-      } // for
-    } // if
+        // THROW EXCEPTION
+        m_Image->m_ReadWriteLock.Unlock();
+        mitkThrowException(mitk::MemoryIsLockedException) << "The image part being ordered by the ImageAccessor is already in use and locked";
+      }
 
-    // Now, we know, that there is no conflict with a Write-Access
-    // Lock the Mutex in ImageAccessorBase, to make sure that every other ImageAccessor has to wait if it locks the mutex
-    m_WaitLock->m_Mutex.Lock();
+      // WAIT
+      WaitForRelease();
+    }
 
+    // Now, we know, that there is no conflict with a Write-Access
     // insert self into readers list in Image
     m_Image->m_Readers.push_back(this);
 
-    //printf("ReadAccess %d %d\n",(int) m_Image->m_Readers.size(),(int) m_Image->m_Writers.size());
-    //fflush(0);
     m_Image->m_ReadWriteLock.Unlock();
   }
 
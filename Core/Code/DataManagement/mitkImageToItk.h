@@ -27,6 +27,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImage.h"
 #include "mitkImageDataItem.h"
 #include "mitkImageWriteAccessor.h"
+#include "mitkImageReadAccessor.h"
 
 namespace mitk
 {
@@ -34,6 +35,22 @@ namespace mitk
  * Create itk::ImageSource for mitk::Image
  * \ingroup Adaptor
  *
+ * By default, the output wraps the buffer of the input image without copying it
+ * and holds an ImageWriteAccessor as long as the output pixel container exists,
+ * so filters may work on the output in place.
+ *
+ * With ConstInputOn(), the output wraps the buffer under an ImageReadAccessor
+ * instead. Any number of such read-only views and ImageReadAccessors of an image
+ * may exist at the same time, which is what most algorithms reading an image need.
+ * The output should not be modified then: ITK cannot enforce this, and writes
+ * are not guarded against concurrent readers.
+ *
+ * With CopyMemFlagOn(), the buffer is copied into a newly allocated output. The
+ * input is only locked for reading while it is copied.
+ *
+ * \warning An image part cannot be accessed for writing while a view of it exists,
+ * release the output image before writing to the mitk::Image.
+ *
  * \warning 2D MITK images will get a 2D identity matrix in ITK
  * \todo Get clear about how to handle directed ITK 2D images in ITK
  */
@@ -78,12 +95,17 @@ public:
   itkGetMacro( CopyMemFlag, bool );
   itkBooleanMacro( CopyMemFlag );
 
+  /** \brief Wrap the input under an ImageReadAccessor for read-only use of the output (default false) */
+  itkSetMacro( ConstInput, bool );
+  itkGetMacro( ConstInput, bool );
+  itkBooleanMacro( ConstInput );
+
 protected:
   using itk::ProcessObject::SetInput;
   mitk::Image * GetInput(void);
   mitk::Image * GetInput(unsigned int idx);
 
-  ImageToItk(): m_CopyMemFlag(false), m_Channel(0)
+  ImageToItk(): m_CopyMemFlag(false), m_ConstInput(false), m_Channel(0)
   {
   }
 
@@ -100,6 +122,7 @@ protected:
 
 private:
   bool m_CopyMemFlag;
+  bool m_ConstInput;
   int m_Channel;
 
   //ImageToItk(const Self&); //purposely not implemented
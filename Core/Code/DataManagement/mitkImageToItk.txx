@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkBaseProcess.h"
 #include "itkImportMitkImageContainer.h"
 #include "mitkImageWriteAccessor.h"
+#include "mitkImageReadAccessor.h"
 #include "mitkException.h"
 
 
@@ -93,13 +94,29 @@ template<class TOutputImage>
     noBytes = noBytes * input->GetDimension(i);
   }
 
-  mitk::ImageWriteAccessor* imageAccess = new mitk::ImageWriteAccessor(input);
+  // copying and read-only views only need read access, which does not block other readers
+  mitk::ImageReadAccessor* readAccess = NULL;
+  mitk::ImageWriteAccessor* writeAccess = NULL;
+  const void* data = NULL;
+  if (m_CopyMemFlag || m_ConstInput)
+  {
+    readAccess = new mitk::ImageReadAccessor(input);
+    data = readAccess->GetData();
+  }
+  else
+  {
+    writeAccess = new mitk::ImageWriteAccessor(input);
+    data = writeAccess->GetData();
+  }
 
   // hier wird momentan wohl nur der erste Channel verwendet??!!
-  if(imageAccess->GetData() == NULL)
+  if(data == NULL)
   {
     itkWarningMacro(<< "no image data to import in ITK image");
 
+    delete readAccess;
+    delete writeAccess;
+
     RegionType bufferedRegion;
     output->SetBufferedRegion(bufferedRegion);
     return;
@@ -111,9 +128,9 @@ template<class TOutputImage>
 
     output->Allocate();
 
-    memcpy( (PixelType *) output->GetBufferPointer(), imageAccess->GetData(), sizeof(PixelType)*noBytes);
+    memcpy( (PixelType *) output->GetBufferPointer(), data, sizeof(PixelType)*noBytes);
 
-    delete imageAccess;
+    delete readAccess;
   }
   else
   {
@@ -126,7 +143,14 @@ template<class TOutputImage>
 
     itkDebugMacro( << "size of container = " << import->Size() );
     //import->SetImageDataItem(m_ImageDataItem);
-    import->SetImageAccessor(imageAccess,sizeof(PixelType)*noBytes);
+    if (readAccess != NULL)
+    {
+      import->SetImageAccessor(readAccess,sizeof(PixelType)*noBytes);
+    }
+    else
+    {
+      import->SetImageAccessor(writeAccess,sizeof(PixelType)*noBytes);
+    }
 
     output->SetPixelContainer(import);
     itkDebugMacro( << "size of container = " << import->Size() );
@@ -253,6 +277,8 @@ template<class TOutputImage>
   ::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os,indent);
+  os << indent << "CopyMemFlag: " << m_CopyMemFlag << std::endl;
+  os << indent << "ConstInput: " << m_ConstInput << std::endl;
 }
 
 #endif //IMAGETOITK_TXX_INCLUDED_C1C2FCD2
@@ -0,0 +1,76 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#include "mitkPropertyKey.h"
+
+#include <itkSimpleFastMutexLock.h>
+
+#include <map>
+#include <vector>
+
+namespace
+{
+  // names are never unregistered, so references to the map keys stay valid
+  typedef std::map<std::string, mitk::PropertyKey::IdType> KeyMapType;
+
+  struct PropertyKeyRegistry
+  {
+    KeyMapType ids;
+    std::vector<const std::string*> names;
+    itk::SimpleFastMutexLock mutex;
+  };
+
+  PropertyKeyRegistry& GetRegistry()
+  {
+    static PropertyKeyRegistry registry;
+    return registry;
+  }
+}
+
+mitk::PropertyKey::PropertyKey(const char* name)
+  : m_Id(Intern(name != NULL ? std::string(name) : std::string()))
+{
+}
+
+mitk::PropertyKey::PropertyKey(const std::string& name)
+  : m_Id(Intern(name))
+{
+}
+
+const std::string& mitk::PropertyKey::GetName() const
+{
+  PropertyKeyRegistry& registry = GetRegistry();
+  registry.mutex.Lock();
+  const std::string& name = *registry.names[m_Id];
+  registry.mutex.Unlock();
+  return name;
+}
+
+mitk::PropertyKey::IdType mitk::PropertyKey::Intern(const std::string& name)
+{
+  PropertyKeyRegistry& registry = GetRegistry();
+  registry.mutex.Lock();
+  KeyMapType::iterator it = registry.ids.find(name);
+  if (it == registry.ids.end())
+  {
+    it = registry.ids.insert(std::make_pair(name, static_cast<IdType>(registry.names.size()))).first;
+    registry.names.push_back(&it->first);
+  }
+  IdType id = it->second;
+  registry.mutex.Unlock();
+  return id;
+}
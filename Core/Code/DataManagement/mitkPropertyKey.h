@@ -0,0 +1,81 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#ifndef MITKPROPERTYKEY_H_HEADER_INCLUDED
+#define MITKPROPERTYKEY_H_HEADER_INCLUDED
+
+#include <MitkExports.h>
+
+#include <string>
+
+namespace mitk {
+
+/**
+ * @brief Interned name of a property
+ *
+ * Every distinct property name is mapped once to a small integer id. PropertyList
+ * keeps an index of its properties sorted by these ids, so looking up a property by
+ * PropertyKey compares integers instead of strings. The string based API of
+ * PropertyList and DataNode is unaffected.
+ *
+ * Creating a key takes a global lock, so keys should be created once and reused
+ * on hot paths (e.g. in mappers):
+ *
+ * \code
+ * static const mitk::PropertyKey visibleKey("visible");
+ * bool visible = true;
+ * node->GetVisibility(visible, renderer, visibleKey);
+ * \endcode
+ *
+ * @ingroup DataManagement
+ */
+class MITK_CORE_EXPORT PropertyKey
+{
+  public:
+
+    typedef unsigned int IdType;
+
+    explicit PropertyKey(const char* name);
+    explicit PropertyKey(const std::string& name);
+
+    /**
+     * @brief The id shared by all keys with the same name.
+     */
+    IdType GetId() const { return m_Id; }
+
+    /**
+     * @brief The name this key was created from.
+     */
+    const std::string& GetName() const;
+
+    /**
+     * @brief Returns the id of @a name, registering the name if it is new.
+     */
+    static IdType Intern(const std::string& name);
+
+    bool operator==(const PropertyKey& other) const { return m_Id == other.m_Id; }
+    bool operator!=(const PropertyKey& other) const { return m_Id != other.m_Id; }
+    bool operator<(const PropertyKey& other) const { return m_Id < other.m_Id; }
+
+  private:
+
+    IdType m_Id;
+};
+
+} // namespace mitk
+
+#endif /* MITKPROPERTYKEY_H_HEADER_INCLUDED */
@@ -21,6 +21,49 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkStringProperty.h"
 #include "mitkVector.h"
 
+#include <algorithm>
+
+namespace
+{
+  struct IndexEntryLess
+  {
+    bool operator()(const mitk::PropertyList::PropertyIndexType::value_type& entry, mitk::PropertyKey::IdType id) const
+    {
+      return entry.first < id;
+    }
+  };
+}
+
+
+mitk::BaseProperty* mitk::PropertyList::GetProperty(const PropertyKey& propertyKey) const
+{
+  PropertyIndexType::const_iterator it = std::lower_bound(m_Index.begin(), m_Index.end(), propertyKey.GetId(), IndexEntryLess());
+  if (it != m_Index.end() && it->first == propertyKey.GetId())
+    return it->second;
+  else
+    return NULL;
+}
+
+
+void mitk::PropertyList::AddToIndex(const std::string& propertyKey, BaseProperty* property)
+{
+  PropertyKey::IdType id = PropertyKey::Intern(propertyKey);
+  PropertyIndexType::iterator it = std::lower_bound(m_Index.begin(), m_Index.end(), id, IndexEntryLess());
+  if (it != m_Index.end() && it->first == id)
+    it->second = property;
+  else
+    m_Index.insert(it, std::make_pair(id, property));
+}
+
+
+void mitk::PropertyList::RemoveFromIndex(const std::string& propertyKey)
+{
+  PropertyKey::IdType id = PropertyKey::Intern(propertyKey);
+  PropertyIndexType::iterator it = std::lower_bound(m_Index.begin(), m_Index.end(), id, IndexEntryLess());
+  if (it != m_Index.end() && it->first == id)
+    m_Index.erase(it);
+}
+
 
 mitk::BaseProperty* mitk::PropertyList::GetProperty(const std::string& propertyKey) const
 {
@@ -77,6 +120,7 @@ void mitk::PropertyList::SetProperty(const std::string& propertyKey, BasePropert
   newProp.first = propertyKey;
   newProp.second = property;
   m_Properties.insert ( newProp );
+  this->AddToIndex(propertyKey, property);
   this->Modified();
 }
 
@@ -99,6 +143,7 @@ void mitk::PropertyList::ReplaceProperty(const std::string& propertyKey, BasePro
   newProp.first = propertyKey;
   newProp.second = property;
   m_Properties.insert ( newProp );
+  this->AddToIndex(propertyKey, property);
   Modified();
 }
 
@@ -113,7 +158,9 @@ mitk::PropertyList::PropertyList(const mitk::PropertyList& other)
   for (PropertyMap::const_iterator i = other.m_Properties.begin();
        i != other.m_Properties.end(); ++i)
   {
-    m_Properties.insert(std::make_pair(i->first, i->second->Clone()));
+    BaseProperty::Pointer clone = i->second->Clone();
+    m_Properties.insert(std::make_pair(i->first, clone));
+    this->AddToIndex(i->first, clone);
   }
 }
 
@@ -158,6 +205,7 @@ bool mitk::PropertyList::DeleteProperty(const std::string& propertyKey)
   {
     it->second=NULL;
     m_Properties.erase(it);
+    this->RemoveFromIndex(propertyKey);
     Modified();
     return true;
   }
@@ -174,6 +222,7 @@ void mitk::PropertyList::Clear()
     ++it;
   }
   m_Properties.clear();
+  m_Index.clear();
 }
 
 itk::LightObject::Pointer mitk::PropertyList::InternalClone() const
@@ -220,6 +269,42 @@ bool mitk::PropertyList::GetBoolProperty(const char* propertyKey, bool& boolValu
 }
 
 
+bool mitk::PropertyList::GetBoolProperty(const PropertyKey& propertyKey, bool& boolValue) const
+{
+  BoolProperty *gp = PropertyCast<BoolProperty>( GetProperty(propertyKey) );
+  if ( gp != NULL )
+  {
+    boolValue = gp->GetValue();
+    return true;
+  }
+  return false;
+}
+
+
+bool mitk::PropertyList::GetIntProperty(const PropertyKey& propertyKey, int &intValue) const
+{
+  IntProperty *gp = PropertyCast<IntProperty>( GetProperty(propertyKey) );
+  if ( gp != NULL )
+  {
+    intValue = gp->GetValue();
+    return true;
+  }
+  return false;
+}
+
+
+bool mitk::PropertyList::GetFloatProperty(const PropertyKey& propertyKey, float &floatValue) const
+{
+  FloatProperty *gp = PropertyCast<FloatProperty>( GetProperty(propertyKey) );
+  if ( gp != NULL )
+  {
+    floatValue = gp->GetValue();
+    return true;
+  }
+  return false;
+}
+
+
 bool mitk::PropertyList::GetIntProperty(const char* propertyKey, int &intValue) const
 {
   IntProperty *gp = dynamic_cast<IntProperty*>( GetProperty(propertyKey) );
@@ -20,12 +20,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkExports.h>
 #include "mitkBaseProperty.h"
 #include "mitkGenericProperty.h"
+#include "mitkPropertyKey.h"
 #include "mitkUIDGenerator.h"
 
 #include <itkObjectFactory.h>
 
 #include <string>
 #include <map>
+#include <typeinfo>
+#include <vector>
 
 namespace mitk {
 
@@ -59,6 +62,9 @@ class XMLWriter;
  * method will try to change the value of an existing property and will
  * not allow you to replace e.g. a ColorProperty with an IntProperty.
  *
+ * Besides the string keys, properties can be looked up by an interned
+ * PropertyKey, which is considerably faster on hot paths like rendering.
+ *
  * @ingroup DataManagement
  */
 class MITK_CORE_EXPORT PropertyList : public itk::Object
@@ -80,11 +86,40 @@ class MITK_CORE_EXPORT PropertyList : public itk::Object
     typedef std::map< std::string, BaseProperty::Pointer> PropertyMap;
     typedef std::pair< std::string, BaseProperty::Pointer> PropertyMapElementType;
 
+    /**
+     * Index of the properties sorted by the id of their interned key. The
+     * properties are owned by the PropertyMap.
+     */
+    typedef std::vector< std::pair< PropertyKey::IdType, BaseProperty* > > PropertyIndexType;
+
     /**
      * @brief Get a property by its name.
      */
     mitk::BaseProperty* GetProperty(const std::string& propertyKey) const;
 
+    /**
+     * @brief Get a property by its interned key.
+     *
+     * Equivalent to GetProperty(propertyKey.GetName()), but without string comparisons.
+     */
+    mitk::BaseProperty* GetProperty(const PropertyKey& propertyKey) const;
+
+    /**
+     * @brief Casts @a property to T, trying an exact type match before falling back to dynamic_cast.
+     *
+     * Almost all properties are instances of exactly the requested type, for which
+     * the typeid comparison is much cheaper than a dynamic_cast.
+     */
+    template <typename T>
+    static T* PropertyCast(BaseProperty* property)
+    {
+      if ( property == NULL )
+        return NULL;
+      if ( typeid(*property) == typeid(T) )
+        return static_cast<T*>(property);
+      return dynamic_cast<T*>(property);
+    }
+
     /**
      * @brief Set a property in the list/map by value.
      *
@@ -131,6 +166,11 @@ class MITK_CORE_EXPORT PropertyList : public itk::Object
     */
     bool GetBoolProperty(const char* propertyKey, bool& boolValue) const;
 
+    /**
+    * @brief Convenience method to access the value of a BoolProperty by an interned key
+    */
+    bool GetBoolProperty(const PropertyKey& propertyKey, bool& boolValue) const;
+
     /**
     * @brief Convenience method to set the value of a BoolProperty
     */
@@ -141,6 +181,11 @@ class MITK_CORE_EXPORT PropertyList : public itk::Object
     */
     bool GetIntProperty(const char* propertyKey, int &intValue) const;
 
+    /**
+    * @brief Convenience method to access the value of an IntProperty by an interned key
+    */
+    bool GetIntProperty(const PropertyKey& propertyKey, int &intValue) const;
+
     /**
     * @brief Convenience method to set the value of an IntProperty
     */
@@ -151,6 +196,11 @@ class MITK_CORE_EXPORT PropertyList : public itk::Object
     */
     bool GetFloatProperty(const char* propertyKey, float &floatValue) const;
 
+    /**
+    * @brief Convenience method to access the value of a FloatProperty by an interned key
+    */
+    bool GetFloatProperty(const PropertyKey& propertyKey, float &floatValue) const;
+
     /**
     * @brief Convenience method to set the value of a FloatProperty
     */
@@ -197,6 +247,14 @@ class MITK_CORE_EXPORT PropertyList : public itk::Object
      */
     PropertyMap m_Properties;
 
+    /**
+     * @brief m_Properties indexed by interned key, kept in sync by all modifying methods.
+     */
+    PropertyIndexType m_Index;
+
+    void AddToIndex(const std::string& propertyKey, BaseProperty* property);
+    void RemoveFromIndex(const std::string& propertyKey);
+
   private:
 
     virtual itk::LightObject::Pointer InternalClone() const;
@@ -24,9 +24,208 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkImageIOBase.h>
 #include <itkImageIOFactory.h>
+#include <itkMultiThreader.h>
+#include <itksys/SystemTools.hxx>
 
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+  // size of the independently deflated parts of a NRRD payload
+  const size_t CompressionBlockSize = 4 * 1024 * 1024;
+
+  struct CompressionBlock
+  {
+    const unsigned char* data;
+    size_t size;
+    bool last;
+    uLong crc;
+    std::vector<unsigned char> output;
+    bool error;
+  };
+
+  struct CompressionThreadData
+  {
+    std::vector<CompressionBlock> blocks;
+    int level;
+  };
+
+  // Deflates one block as raw deflate data. All but the last block end with a sync flush, so the
+  // concatenated blocks form a single deflate stream (the scheme used by pigz).
+  void DeflateBlock( CompressionBlock& block, int level )
+  {
+    block.crc = crc32( crc32( 0L, Z_NULL, 0 ), block.data, static_cast<uInt>( block.size ) );
+
+    z_stream stream;
+    memset( &stream, 0, sizeof(stream) );
+    if ( deflateInit2( &stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+    {
+      block.error = true;
+      return;
+    }
+
+    block.output.resize( deflateBound( &stream, static_cast<uLong>( block.size ) ) + 16 ); // + sync flush marker
+    stream.next_in = const_cast<Bytef*>( block.data );
+    stream.avail_in = static_cast<uInt>( block.size );
+    stream.next_out = &block.output[0];
+    stream.avail_out = static_cast<uInt>( block.output.size() );
+
+    int result = deflate( &stream, block.last ? Z_FINISH : Z_SYNC_FLUSH );
+    block.error = block.last ? ( result != Z_STREAM_END ) : ( result != Z_OK || stream.avail_in != 0 || stream.avail_out == 0 );
+    block.output.resize( block.output.size() - stream.avail_out );
+
+    deflateEnd( &stream );
+  }
+
+  ITK_THREAD_RETURN_TYPE DeflateBlocksThreaderCallback( void* arg )
+  {
+    itk::MultiThreader::ThreadInfoStruct* info = static_cast< itk::MultiThreader::ThreadInfoStruct* >( arg );
+    CompressionThreadData* data = static_cast< CompressionThreadData* >( info->UserData );
+
+    for ( unsigned int k = info->ThreadID; k < data->blocks.size(); k += info->NumberOfThreads )
+    {
+      DeflateBlock( data->blocks[k], data->level );
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  void WriteLittleEndian32( std::ostream& out, uLong value )
+  {
+    for ( unsigned int i = 0; i < 4; ++i )
+    {
+      out.put( static_cast<char>( ( value >> ( 8 * i ) ) & 0xff ) );
+    }
+  }
+
+  /**
+   * Completes a NRRD file which ITK has written uncompressed for a single pixel with the same
+   * pixel type and geometry: the sizes of the header are replaced by the given dimensions and
+   * the pixel by a gzip stream of the given data that is deflated block-parallel. Returns false
+   * and leaves the file untouched if it does not have the expected layout.
+   */
+  bool WriteCompressedNrrdPayload( const std::string& fileName, const unsigned int* dimensions, unsigned int dimension,
+                                   const void* data, size_t size, size_t pixelSize, int level, unsigned int numberOfThreads )
+  {
+    // read and patch the header, it ends with an empty line
+    std::string header;
+    bool rawEncoding(false);
+    bool sizesPatched(false);
+    {
+      std::ifstream in( fileName.c_str(), std::ios::binary );
+      std::string line;
+      while ( std::getline( in, line ) && !line.empty() && line != "\r" )
+      {
+        if ( line.compare( 0, 9, "encoding:" ) == 0 )
+        {
+          if ( line.find( "raw" ) == std::string::npos )
+          {
+            return false;
+          }
+          line = "encoding: gzip";
+          rawEncoding = true;
+        }
+        else if ( line.compare( 0, 6, "sizes:" ) == 0 )
+        {
+          // a leading axis of the pixel components is kept
+          std::istringstream sizes( line.substr( 6 ) );
+          std::vector<std::string> axes;
+          std::string axis;
+          while ( sizes >> axis )
+          {
+            axes.push_back( axis );
+          }
+          if ( axes.size() < dimension )
+          {
+            return false;
+          }
+          std::ostringstream patched;
+          patched << "sizes:";
+          for ( size_t i = 0; i < axes.size() - dimension; ++i )
+          {
+            patched << " " << axes[i];
+          }
+          for ( unsigned int i = 0; i < dimension; ++i )
+          {
+            patched << " " << dimensions[i];
+          }
+          line = patched.str();
+          sizesPatched = true;
+        }
+        header += line + "\n";
+      }
+      header += "\n";
+
+      std::streamoff payloadStart = in.tellg();
+      in.seekg( 0, std::ios::end );
+      if ( !rawEncoding || !sizesPatched || !in.good() || static_cast<size_t>( in.tellg() - payloadStart ) != pixelSize )
+      {
+        return false;
+      }
+    }
+
+    CompressionThreadData threadData;
+    threadData.level = level;
+    const unsigned char* bytes = static_cast<const unsigned char*>( data );
+    for ( size_t offset = 0; offset < size || threadData.blocks.empty(); offset += CompressionBlockSize )
+    {
+      CompressionBlock block;
+      block.data = bytes + offset;
+      block.size = std::min( CompressionBlockSize, size - offset );
+      block.last = ( offset + block.size >= size );
+      block.crc = 0;
+      block.error = false;
+      threadData.blocks.push_back( block );
+    }
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    if ( numberOfThreads > 0 )
+      threader->SetNumberOfThreads( numberOfThreads );
+    if ( threadData.blocks.size() < static_cast<unsigned int>( threader->GetNumberOfThreads() ) )
+      threader->SetNumberOfThreads( threadData.blocks.size() );
+    threader->SetSingleMethod( DeflateBlocksThreaderCallback, &threadData );
+    threader->SingleMethodExecute();
+
+    uLong crc = crc32( 0L, Z_NULL, 0 );
+    for ( std::vector<CompressionBlock>::const_iterator iter = threadData.blocks.begin(); iter != threadData.blocks.end(); ++iter )
+    {
+      if ( iter->error )
+      {
+        return false;
+      }
+      crc = crc32_combine( crc, iter->crc, static_cast<z_off_t>( iter->size ) );
+    }
+
+    std::ofstream out( fileName.c_str(), std::ios::binary | std::ios::trunc );
+    out << header;
+
+    // gzip member header: magic, deflate, no flags, no mtime, extra flags, OS unknown
+    const unsigned char gzipHeader[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, static_cast<unsigned char>( level == 9 ? 2 : ( level == 1 ? 4 : 0 ) ), 0xff };
+    out.write( reinterpret_cast<const char*>( gzipHeader ), sizeof(gzipHeader) );
+    for ( std::vector<CompressionBlock>::const_iterator iter = threadData.blocks.begin(); iter != threadData.blocks.end(); ++iter )
+    {
+      out.write( reinterpret_cast<const char*>( &iter->output[0] ), iter->output.size() );
+    }
+    WriteLittleEndian32( out, crc );
+    WriteLittleEndian32( out, static_cast<uLong>( size & 0xffffffffUL ) );
+
+    if ( !out.good() )
+    {
+      itkGenericExceptionMacro( << "Error while writing compressed data to " << fileName );
+    }
+    return true;
+  }
+}
 
 mitk::ImageWriter::ImageWriter()
+: m_CompressionLevel(-1)
+, m_NumberOfThreads(0)
 {
   this->SetNumberOfRequiredInputs( 1 );
   m_MimeType = "";
@@ -158,8 +357,11 @@ void mitk::ImageWriter::WriteByITK(mitk::Image* image, const std::string& fileNa
   mitk::Vector3D spacing = image->GetGeometry()->GetSpacing();
   mitk::Point3D origin = image->GetGeometry()->GetOrigin();
 
-  itk::ImageIOBase::Pointer imageIO = itk::ImageIOFactory::CreateImageIO( fileName.c_str(),
-    itk::ImageIOFactory::WriteMode );
+  itk::ImageIOBase::Pointer imageIO = m_ImageIO;
+  if(imageIO.IsNull())
+  {
+    imageIO = itk::ImageIOFactory::CreateImageIO( fileName.c_str(), itk::ImageIOFactory::WriteMode );
+  }
 
   if(imageIO.IsNull())
   {
@@ -174,6 +376,11 @@ void mitk::ImageWriter::WriteByITK(mitk::Image* image, const std::string& fileNa
                              itk::ImageIOBase::UNKNOWNCOMPONENTTYPE);
   imageIO->SetNumberOfComponents( pixelType.GetNumberOfComponents() );
 
+  // NRRD files are compressed by MITK, since ITK deflates in a single thread. ITK only writes the
+  // header, for a single pixel, and WriteCompressedNrrdPayload() completes it. All other formats
+  // use the compression of ITK, if available.
+  bool compressNrrd = m_CompressionLevel != 0 && itksys::SystemTools::GetFilenameLastExtension(fileName) == ".nrrd";
+
   itk::ImageIORegion ioRegion( dimension );
 
   for(unsigned int i=0; i<dimension; i++)
@@ -195,13 +402,41 @@ void mitk::ImageWriter::WriteByITK(mitk::Image* image, const std::string& fileNa
     ioRegion.SetIndex(i, image->GetLargestPossibleRegion().GetIndex(i) );
   }
 
-  //use compression if available
-  imageIO->UseCompressionOn();
+  imageIO->SetUseCompression( m_CompressionLevel != 0 && !compressNrrd );
 
   imageIO->SetIORegion(ioRegion);
   imageIO->SetFileName(fileName);
 
   ImageReadAccessor imageAccess(image);
+
+  if ( compressNrrd )
+  {
+    size_t imageSizeInBytes = imageIO->GetImageSizeInBytes();
+
+    itk::ImageIORegion pixelRegion( ioRegion );
+    for(unsigned int i=0; i<dimension; i++)
+    {
+      imageIO->SetDimensions(i, 1);
+      pixelRegion.SetSize(i, 1);
+    }
+    imageIO->SetIORegion(pixelRegion);
+    imageIO->Write(imageAccess.GetData());
+
+    if ( WriteCompressedNrrdPayload( fileName, dimensions, dimension, imageAccess.GetData(), imageSizeInBytes,
+                                     imageIO->GetImageSizeInBytes(), m_CompressionLevel, m_NumberOfThreads ) )
+    {
+      return;
+    }
+
+    MITK_WARN << "Could not compress " << fileName << " block-parallel, it is compressed by ITK.";
+    for(unsigned int i=0; i<dimension; i++)
+    {
+      imageIO->SetDimensions(i, dimensions[i]);
+    }
+    imageIO->SetIORegion(ioRegion);
+    imageIO->SetUseCompression(true);
+  }
+
   imageIO->Write(imageAccess.GetData());
 }
 
@@ -345,7 +580,8 @@ void mitk::ImageWriter::GenerateData()
 
   try
   {
-    setlocale(LC_ALL, currLocale.c_str());
+    if ( locale.compare(currLocale)!=0 )
+      setlocale(LC_ALL, currLocale.c_str());
   }
   catch(...)
   {
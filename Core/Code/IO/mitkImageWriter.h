@@ -20,6 +20,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkFileWriterWithInformation.h>
 
+#include <itkImageIOBase.h>
+
 
 namespace mitk
 {
@@ -93,6 +95,35 @@ public:
      */
     itkGetStringMacro( FilePattern );
 
+    /**
+     * \brief Set the compression level for formats that support compression.
+     *
+     * 0 writes uncompressed data, 1 (fastest) to 9 (smallest) select the
+     * gzip level, -1 (default) uses the default level of zlib.
+     * NRRD files are compressed block-parallel, other formats use the
+     * compression of their ITK ImageIO.
+     */
+    itkSetClampMacro( CompressionLevel, int, -1, 9 );
+    itkGetConstMacro( CompressionLevel, int );
+
+    /**
+     * \brief Set the number of threads that compress NRRD files (0, the default, uses the global default of itk::MultiThreader)
+     *
+     * Writers that run in parallel should share the threads instead of each using all of them.
+     */
+    itkSetMacro( NumberOfThreads, unsigned int );
+    itkGetConstMacro( NumberOfThreads, unsigned int );
+
+    /**
+     * \brief Write the image with this ImageIO instead of one created by itk::ImageIOFactory
+     *
+     * The factory is not thread safe. Writers that run in worker threads get their ImageIO
+     * from the calling thread. It is used for volume images only, picture formats
+     * like .png are still written by itk::ImageFileWriter.
+     */
+    itkSetObjectMacro( ImageIO, itk::ImageIOBase );
+    itkGetObjectMacro( ImageIO, itk::ImageIOBase );
+
     /**
      * Sets the 0'th input object for the filter.
      * @param input the first input for the filter.
@@ -163,6 +194,12 @@ protected:
     std::string m_Extension;
 
     std::string m_MimeType;
+
+    int m_CompressionLevel;
+
+    unsigned int m_NumberOfThreads;
+
+    itk::ImageIOBase::Pointer m_ImageIO;
 };
 
 }
@@ -66,7 +66,11 @@ void mitk::ItkImageFileReader::GenerateData()
     return ;
   }
 
-  itk::ImageIOBase::Pointer imageIO = itk::ImageIOFactory::CreateImageIO( m_FileName.c_str(), itk::ImageIOFactory::ReadMode );
+  itk::ImageIOBase::Pointer imageIO = m_ImageIO;
+  if ( imageIO.IsNull() )
+  {
+    imageIO = itk::ImageIOFactory::CreateImageIO( m_FileName.c_str(), itk::ImageIOFactory::ReadMode );
+  }
   if ( imageIO.IsNull() )
   {
     //itkWarningMacro( << "File Type not supported!" );
@@ -169,7 +173,8 @@ void mitk::ItkImageFileReader::GenerateData()
 
   try
   {
-    setlocale(LC_ALL, currLocale.c_str());
+    if ( locale.compare(currLocale)!=0 )
+      setlocale(LC_ALL, currLocale.c_str());
   }
   catch(...)
   {
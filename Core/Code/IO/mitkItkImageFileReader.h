@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkFileReader.h"
 #include "mitkImageSource.h"
 
+#include <itkImageIOBase.h>
+
 namespace mitk {
 //##Documentation
 //## @brief Reader to read file formats supported by itk
@@ -43,6 +45,15 @@ public:
     itkSetStringMacro(FilePattern);
     itkGetStringMacro(FilePattern);
 
+    /**
+     * \brief Read the file with this ImageIO instead of one created by itk::ImageIOFactory
+     *
+     * The factory is not thread safe. Readers that are updated in worker threads get
+     * their ImageIO from the calling thread.
+     */
+    itkSetObjectMacro(ImageIO, itk::ImageIOBase);
+    itkGetObjectMacro(ImageIO, itk::ImageIOBase);
+
     static bool CanReadFile(const std::string filename, const std::string filePrefix, const std::string filePattern);
 
 protected:
@@ -59,6 +70,8 @@ protected:
 
     std::string m_FilePattern;
 
+    itk::ImageIOBase::Pointer m_ImageIO;
+
 };
 
 } // namespace mitk
@@ -19,9 +19,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkSimpleFastMutexLock.h"
 #include <itkOutputWindow.h>
+#include <itkMultiThreader.h>
+#include <itkConditionVariable.h>
 
 #include <iostream>
 #include <fstream>
+#include <deque>
+#include <algorithm>
 
 static itk::SimpleFastMutexLock logMutex;
 static mitk::LoggingBackend *mitkLogBackend = 0;
@@ -30,6 +34,95 @@ static std::string logFileName = "";
 static std::stringstream *outputWindow = 0;
 static bool logOutputWindow = false;
 
+// state of the asynchronous logging, guarded by queueMutex
+typedef std::deque< std::pair<mbilog::LogMessage, int> > MessageQueueType;
+static itk::SimpleMutexLock queueMutex;
+static itk::ConditionVariable::Pointer messagesQueued;  // signaled by ProcessMessage()
+static itk::ConditionVariable::Pointer messagesWritten; // signaled by the writer thread
+static MessageQueueType messageQueue;
+static unsigned int messageQueueSize = 0;
+static mitk::LoggingBackend::OverflowPolicy overflowPolicy = mitk::LoggingBackend::DropMessages;
+static unsigned long droppedMessages = 0;
+static unsigned long reportedDroppedMessages = 0;
+static bool writerRunning = false;
+static bool writerBusy = false;
+static itk::MultiThreader::Pointer writerThreader;
+static int writerThreadID = -1;
+
+namespace mitk
+{
+  /*!
+    \brief Writes the messages queued by LoggingBackend::ProcessMessage() until asynchronous logging is disabled
+   */
+  class LoggingBackendWriterThread
+  {
+    public:
+
+      static ITK_THREAD_RETURN_TYPE Run(void*)
+      {
+        MessageQueueType batch;
+
+        queueMutex.Lock();
+        while(true)
+        {
+          while(writerRunning && messageQueue.empty() && droppedMessages == reportedDroppedMessages)
+          {
+            messagesQueued->Wait(&queueMutex);
+          }
+          if(!writerRunning && messageQueue.empty() && droppedMessages == reportedDroppedMessages)
+          {
+            break;
+          }
+
+          // take all queued messages at once, so producers only wait for the swap
+          batch.swap(messageQueue);
+          unsigned long newlyDropped = droppedMessages - reportedDroppedMessages;
+          reportedDroppedMessages = droppedMessages;
+          writerBusy = true;
+          messagesWritten->Broadcast();
+          queueMutex.Unlock();
+
+          for(MessageQueueType::const_iterator iter = batch.begin(); iter != batch.end(); ++iter)
+          {
+            mitkLogBackend->WriteMessage(iter->first, iter->second);
+          }
+          batch.clear();
+
+          if(newlyDropped)
+          {
+            std::stringstream text;
+            text << newlyDropped << " log messages were dropped because the logging queue was full";
+            mbilog::LogMessage droppedMessage(mbilog::Warn, __FILE__, __LINE__, __FUNCTION__);
+            droppedMessage.moduleName = MBILOG_MODULENAME;
+            droppedMessage.message = text.str();
+            mitkLogBackend->WriteMessage(droppedMessage, 0);
+          }
+
+          queueMutex.Lock();
+          writerBusy = false;
+          messagesWritten->Broadcast();
+        }
+        queueMutex.Unlock();
+
+        return ITK_THREAD_RETURN_VALUE;
+      }
+  };
+}
+
+namespace
+{
+  // stops the writer thread before the static state above is destroyed
+  struct AsynchronousLoggingGuard
+  {
+    ~AsynchronousLoggingGuard()
+    {
+      mitk::LoggingBackend::EnableAsynchronousLogging(false);
+    }
+  };
+}
+
+static AsynchronousLoggingGuard asynchronousLoggingGuard;
+
 void mitk::LoggingBackend::EnableAdditionalConsoleWindow(bool enable)
 {
   logOutputWindow = enable;
@@ -38,20 +131,44 @@ void mitk::LoggingBackend::EnableAdditionalConsoleWindow(bool enable)
 
 void mitk::LoggingBackend::ProcessMessage(const mbilog::LogMessage& l )
 {
-  logMutex.Lock();
   #ifdef _WIN32
-    FormatSmart( l, (int)GetCurrentThreadId() );
+    int threadID = (int)GetCurrentThreadId();
   #else
-    FormatSmart( l );
+    int threadID = 0;
   #endif
 
+  queueMutex.Lock();
+  while(writerRunning && overflowPolicy == BlockCaller && messageQueue.size() >= messageQueueSize)
+  {
+    messagesWritten->Wait(&queueMutex);
+  }
+  if(writerRunning)
+  {
+    if(messageQueue.size() < messageQueueSize)
+    {
+      messageQueue.push_back(std::make_pair(l, threadID));
+      messagesQueued->Signal();
+    }
+    else
+    {
+      ++droppedMessages;
+    }
+    queueMutex.Unlock();
+    return;
+  }
+  queueMutex.Unlock();
+
+  WriteMessage( l, threadID );
+}
+
+void mitk::LoggingBackend::WriteMessage(const mbilog::LogMessage& l, int threadID)
+{
+  logMutex.Lock();
+  FormatSmart( l, threadID );
+
   if(logFile)
   {
-    #ifdef _WIN32
-      FormatFull( *logFile, l, (int)GetCurrentThreadId() );
-    #else
-      FormatFull( *logFile, l );
-    #endif
+    FormatFull( *logFile, l, threadID );
   }
   if(logOutputWindow)
   {
@@ -59,16 +176,76 @@ void mitk::LoggingBackend::ProcessMessage(const mbilog::LogMessage& l )
     {  outputWindow = new std::stringstream();}
     outputWindow->str("");
     outputWindow->clear();
-    #ifdef _WIN32
-      FormatFull( *outputWindow, l, (int)GetCurrentThreadId() );
-    #else
-      FormatFull( *outputWindow, l );
-    #endif
+    FormatFull( *outputWindow, l, threadID );
     itk::OutputWindow::GetInstance()->DisplayText(outputWindow->str().c_str());
   }
   logMutex.Unlock();
 }
 
+void mitk::LoggingBackend::EnableAsynchronousLogging(bool enable, unsigned int queueSize, OverflowPolicy policy)
+{
+  queueMutex.Lock();
+  messageQueueSize = std::max(queueSize, 1u);
+  overflowPolicy = policy;
+  if(enable == writerRunning)
+  {
+    queueMutex.Unlock();
+    return;
+  }
+
+  if(enable)
+  {
+    if(messagesQueued.IsNull())
+    {
+      messagesQueued = itk::ConditionVariable::New();
+      messagesWritten = itk::ConditionVariable::New();
+    }
+    writerRunning = true;
+    queueMutex.Unlock();
+
+    writerThreader = itk::MultiThreader::New();
+    writerThreadID = writerThreader->SpawnThread(&LoggingBackendWriterThread::Run, NULL);
+  }
+  else
+  {
+    // the writer thread empties the queue before it ends
+    writerRunning = false;
+    messagesQueued->Signal();
+    messagesWritten->Broadcast(); // wake callers that wait for room in the queue
+    queueMutex.Unlock();
+
+    writerThreader->TerminateThread(writerThreadID);
+    writerThreader = NULL;
+    writerThreadID = -1;
+  }
+}
+
+bool mitk::LoggingBackend::IsAsynchronousLoggingEnabled()
+{
+  queueMutex.Lock();
+  bool enabled = writerRunning;
+  queueMutex.Unlock();
+  return enabled;
+}
+
+unsigned long mitk::LoggingBackend::GetNumberOfDroppedMessages()
+{
+  queueMutex.Lock();
+  unsigned long dropped = droppedMessages;
+  queueMutex.Unlock();
+  return dropped;
+}
+
+void mitk::LoggingBackend::Flush()
+{
+  queueMutex.Lock();
+  while(writerRunning && (!messageQueue.empty() || writerBusy || droppedMessages != reportedDroppedMessages))
+  {
+    messagesWritten->Wait(&queueMutex);
+  }
+  queueMutex.Unlock();
+}
+
 void mitk::LoggingBackend::Register()
 {
   if(mitkLogBackend)
@@ -81,6 +258,7 @@ void mitk::LoggingBackend::Unregister()
 {
   if(mitkLogBackend)
   {
+    EnableAsynchronousLogging(false);
     SetLogFile(0);
     mbilog::UnregisterBackend( mitkLogBackend );
     delete mitkLogBackend;
@@ -90,6 +268,9 @@ void mitk::LoggingBackend::Unregister()
 
 void mitk::LoggingBackend::SetLogFile(const char *file)
 {
+  // queued messages belong to the old logfile
+  Flush();
+
   // closing old logfile
   {
     bool closed = false;
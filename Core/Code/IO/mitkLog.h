@@ -24,6 +24,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 namespace mitk
 {
 
+  class LoggingBackendWriterThread;
+
   /*!
     \brief mbilog backend implementation for mitk
    */
@@ -31,6 +33,14 @@ namespace mitk
   {
     public:
 
+     /** \brief Behavior of ProcessMessage() when the queue of the asynchronous logging is full
+      */
+      enum OverflowPolicy
+      {
+        DropMessages, ///< discard the message, dropped messages are counted and reported by the writer thread
+        BlockCaller   ///< wait until the writer thread has made room in the queue
+      };
+
      /** \brief overloaded method for receiving log message from mbilog
       */
       void ProcessMessage(const mbilog::LogMessage& );
@@ -61,6 +71,32 @@ namespace mitk
       */
       static void CatchLogFileCommandLineParameter(int &argc,char **argv);
 
+     /** \brief Formats and writes messages in a dedicated writer thread instead of the logging thread
+      *
+      * Messages are queued (at most queueSize of them), so threads with timing constraints (tracking, ToF acquisition)
+      * do not wait for console or file output. Disabling writes all queued messages and stops the writer thread.
+      */
+      static void EnableAsynchronousLogging(bool enable, unsigned int queueSize = 4096, OverflowPolicy policy = DropMessages);
+
+     /** @return Returns whether messages are written by the writer thread.
+      */
+      static bool IsAsynchronousLoggingEnabled();
+
+     /** @return Returns the number of messages that were discarded because the queue was full.
+      */
+      static unsigned long GetNumberOfDroppedMessages();
+
+     /** \brief Blocks until all queued messages have been written
+      */
+      static void Flush();
+
+    protected:
+
+      friend class LoggingBackendWriterThread;
+
+     /** \brief Formats and writes a message to the console, the log file and the output window
+      */
+      void WriteMessage(const mbilog::LogMessage& l, int threadID);
   };
 
 }
@@ -31,7 +31,7 @@ void mitk::GLMapper::MitkRender(mitk::BaseRenderer* renderer, mitk::VtkPropRende
 {
   bool visible = true;
 
-  GetDataNode()->GetVisibility(visible, renderer, "visible");
+  GetDataNode()->GetVisibility(visible, renderer, GetVisibleKey());
 
   if(!visible)
     return;
@@ -52,9 +52,9 @@ void mitk::GLMapper::ApplyColorAndOpacityProperties(mitk::BaseRenderer* renderer
 {
     float rgba[4]={1.0f,1.0f,1.0f,1.0f};
     // check for color prop and use it for rendering if it exists
-    GetDataNode()->GetColor(rgba, renderer, "color");
+    GetDataNode()->GetColor(rgba, renderer, GetColorKey());
     // check for opacity prop and use it for rendering if it exists
-    GetDataNode()->GetOpacity(rgba[3], renderer, "opacity");
+    GetDataNode()->GetOpacity(rgba[3], renderer, GetOpacityKey());
 
     glColor4fv(rgba);
 }
@@ -89,6 +89,25 @@ bool mitk::Mapper::IsVisible(mitk::BaseRenderer* renderer, const char* name) con
 }
 
 
+const mitk::PropertyKey& mitk::Mapper::GetVisibleKey()
+{
+  static const PropertyKey visibleKey("visible");
+  return visibleKey;
+}
+
+const mitk::PropertyKey& mitk::Mapper::GetColorKey()
+{
+  static const PropertyKey colorKey("color");
+  return colorKey;
+}
+
+const mitk::PropertyKey& mitk::Mapper::GetOpacityKey()
+{
+  static const PropertyKey opacityKey("opacity");
+  return opacityKey;
+}
+
+
 void mitk::Mapper::CalculateTimeStep( mitk::BaseRenderer *renderer )
 {
   if ( ( renderer != NULL ) && ( m_DataNode != NULL ) )
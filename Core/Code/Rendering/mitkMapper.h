@@ -39,6 +39,7 @@ namespace mitk {
   class BaseRenderer;
   class BaseData;
   class DataNode;
+  class PropertyKey;
 
 
   /** \brief Base class of all mappers, Vtk as well as OpenGL mappers
@@ -190,6 +191,11 @@ namespace mitk {
     */
     virtual void ResetMapper( BaseRenderer* /*renderer*/ ) { }
 
+    /** \brief Interned keys of the properties queried for every mapper in every render pass */
+    static const PropertyKey& GetVisibleKey();
+    static const PropertyKey& GetColorKey();
+    static const PropertyKey& GetOpacityKey();
+
     mitk::DataNode * m_DataNode;
 
 
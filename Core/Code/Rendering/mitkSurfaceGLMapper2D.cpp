@@ -28,8 +28,6 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkLookupTableProperty.h"
 
 #include <vtkPolyData.h>
-#include <vtkPlane.h>
-#include <vtkCutter.h>
 #include <vtkPoints.h>
 #include <vtkCellArray.h>
 #include <vtkLookupTable.h>
@@ -43,8 +41,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 
 mitk::SurfaceGLMapper2D::SurfaceGLMapper2D()
-: m_Plane( vtkPlane::New() ),
-  m_Cutter( vtkCutter::New() ),
+: m_PlaneCutter( PolyDataPlaneCutter::New() ),
   m_LUT( vtkLookupTable::New() ),
   m_PointLocator( vtkPKdTree::New() ),
   m_Stripper( vtkStripper::New() ),
@@ -70,9 +67,6 @@ mitk::SurfaceGLMapper2D::SurfaceGLMapper2D()
   m_LineColor[2] = 0.0;
   m_LineColor[3] = 1.0;
 
-  m_Cutter->SetCutFunction(m_Plane);
-  m_Cutter->GenerateValues(1,0,1);
-
   m_LUT->SetTableRange(0,255);
   m_LUT->SetNumberOfColors(255);
   m_LUT->SetRampToLinear();
@@ -81,8 +75,6 @@ mitk::SurfaceGLMapper2D::SurfaceGLMapper2D()
 
 mitk::SurfaceGLMapper2D::~SurfaceGLMapper2D()
 {
-  m_Plane->Delete();
-  m_Cutter->Delete();
   m_LUT->Delete();
   m_PointLocator->Delete();
   m_Stripper->Delete();
@@ -237,7 +229,6 @@ void mitk::SurfaceGLMapper2D::Paint(mitk::BaseRenderer * renderer)
       // set up vtkPlane according to worldGeometry
       point=worldPlaneGeometry->GetOrigin();
       normal=worldPlaneGeometry->GetNormal(); normal.Normalize();
-      m_Plane->SetTransform((vtkAbstractTransform*)NULL);
     }
     else
     {
@@ -252,12 +243,8 @@ void mitk::SurfaceGLMapper2D::Paint(mitk::BaseRenderer * renderer)
         }
         else
         {
-          //@FIXME: does not work correctly. Does m_Plane->SetTransform really transforms a "flat plane" into a "curved plane"?
+          //@FIXME: cutting by a curved plane is not supported, a transformed vtkPlane does not describe it
           return;
-          // set up vtkPlane according to worldGeometry
-          point=const_cast<BoundingBox*>(worldAbstractGeometry->GetParametricBoundingBox())->GetMinimum();
-          FillVector3D(normal, 0, 0, 1);
-          m_Plane->SetTransform(worldAbstractGeometry->GetVtkAbstractTransform()->GetInverse());
         }
       }
       else
@@ -277,25 +264,20 @@ void mitk::SurfaceGLMapper2D::Paint(mitk::BaseRenderer * renderer)
     inversetransform->TransformPoint(vp, vp);
     inversetransform->TransformNormalAtPoint(vp, vnormal, vnormal);
 
-    m_Plane->SetOrigin(vp);
-    m_Plane->SetNormal(vnormal);
-
-    //set data into cutter
-    m_Cutter->SetInput(vtkpolydata);
-    m_Cutter->Update();
-    //    m_Cutter->GenerateCutScalarsOff();
-    //    m_Cutter->SetSortByToSortByCell();
+    //set data into cutter, the index of the polygons is only rebuilt if the mesh or the plane orientation changes
+    m_PlaneCutter->SetInput(vtkpolydata);
+    vtkPolyData* contour = m_PlaneCutter->Cut(vp, vnormal);
 
     if (m_DrawNormals)
     {
-      m_Stripper->SetInput( m_Cutter->GetOutput() );
+      m_Stripper->SetInput( contour );
       // calculate the cut
       m_Stripper->Update();
       PaintCells(renderer, m_Stripper->GetOutput(), worldGeometry, renderer->GetDisplayGeometry(), vtktransform, lut, vtkpolydata);
     }
     else
     {
-      PaintCells(renderer, m_Cutter->GetOutput(), worldGeometry, renderer->GetDisplayGeometry(), vtktransform, lut, vtkpolydata);
+      PaintCells(renderer, contour, worldGeometry, renderer->GetDisplayGeometry(), vtktransform, lut, vtkpolydata);
     }
   }
 }
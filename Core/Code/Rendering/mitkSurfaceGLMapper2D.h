@@ -21,9 +21,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkExports.h>
 #include "mitkGLMapper.h"
 #include "mitkSurface.h"
+#include "mitkPolyDataPlaneCutter.h"
 
-class vtkCutter;
-class vtkPlane;
 class vtkLookupTable;
 class vtkLinearTransform;
 class vtkPKdTree;
@@ -42,7 +41,9 @@ class DisplayGeometry;
  * is basically done in two steps:
  *
  * 1. Cut a slice out of a (input) vtkPolyData object. The slice may be a flat plane (PlaneGeometry)
- *    or a curved plane (ThinPlateSplineCurvedGeometry). The actual cutting is done by a vtkCutter.
+ *    or a curved plane (ThinPlateSplineCurvedGeometry). The actual cutting is done by a
+ *    PolyDataPlaneCutter, which indexes the polygons per plane orientation and passes only
+ *    the polygons intersecting the plane to a vtkCutter.
  *    The result of cutting is a (3D) vtkPolyData object, which contains only points and lines
  *    describing the cut.
  *
@@ -127,8 +128,7 @@ protected:
 
   virtual ~SurfaceGLMapper2D();
 
-  vtkPlane*  m_Plane;
-  vtkCutter* m_Cutter;
+  PolyDataPlaneCutter::Pointer m_PlaneCutter;
 
   Surface::ConstPointer m_Surface;
 
@@ -33,6 +33,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkActor.h>
 #include <vtkProperty.h>
 #include <vtkVolumeRayCastMapper.h>
+#include <vtkFixedPointVolumeRayCastMapper.h>
 
 #include <vtkVolumeTextureMapper2D.h>
 #include <vtkVolume.h>
@@ -113,6 +114,16 @@ mitk::VolumeDataVtkMapper3D::VolumeDataVtkMapper3D()
 
   m_MedResID = m_VolumeLOD->AddLOD(m_HiResMapper,m_VolumePropertyMed,0.0); // RayCast
 
+  // Tile-parallel ray casting with space leaping; the sample distances are set per LOD in SelectLOD()
+  m_FixedPointMapper = vtkFixedPointVolumeRayCastMapper::New();
+  m_FixedPointMapper->SetSampleDistance(1.0);
+  m_FixedPointMapper->SetImageSampleDistance(1.0);
+  m_FixedPointMapper->AutoAdjustSampleDistancesOff();
+  m_FixedPointMapper->IntermixIntersectingGeometryOn();
+  m_FixedPointMapper->SetNumberOfThreads( itk::MultiThreader::GetGlobalDefaultNumberOfThreads() );
+
+  m_FixedPointMedResID = m_VolumeLOD->AddLOD(m_FixedPointMapper,m_VolumePropertyMed,0.0);
+  m_FixedPointHiResID = m_VolumeLOD->AddLOD(m_FixedPointMapper,m_VolumePropertyHigh,0.0);
 
   m_Resampler = vtkImageResample::New();
   m_Resampler->SetAxisMagnificationFactor(0,0.25);
@@ -159,6 +170,7 @@ mitk::VolumeDataVtkMapper3D::VolumeDataVtkMapper3D()
 
   this->m_Resampler->SetInput( this->m_UnitSpacingImageFilter->GetOutput() );
   this->m_HiResMapper->SetInput( this->m_UnitSpacingImageFilter->GetOutput() );
+  this->m_FixedPointMapper->SetInput( this->m_UnitSpacingImageFilter->GetOutput() );
 
 //  m_T2DMapper->SetInput(m_Resampler->GetOutput());
 
@@ -177,6 +189,7 @@ mitk::VolumeDataVtkMapper3D::~VolumeDataVtkMapper3D()
   m_ImageCast->Delete();
 //  m_T2DMapper->Delete();
   m_HiResMapper->Delete();
+  m_FixedPointMapper->Delete();
   m_Resampler->Delete();
   m_VolumePropertyLow->Delete();
   m_VolumePropertyMed->Delete();
@@ -280,6 +293,7 @@ void mitk::VolumeDataVtkMapper3D::GenerateDataForRenderer( mitk::BaseRenderer *r
                   vtkVolumeRayCastMIPFunction* mipFunction = vtkVolumeRayCastMIPFunction::New();
                   m_HiResMapper->SetVolumeRayCastFunction(mipFunction);
                   mipFunction->Delete();
+                  m_FixedPointMapper->SetBlendModeToMaximumIntensity();
                   MITK_INFO <<"in switch" <<std::endl;
                   break;
               }
@@ -290,6 +304,7 @@ void mitk::VolumeDataVtkMapper3D::GenerateDataForRenderer( mitk::BaseRenderer *r
                   compositeFunction->SetCompositeMethodToClassifyFirst();
                   m_HiResMapper->SetVolumeRayCastFunction(compositeFunction);
                   compositeFunction->Delete();
+                  m_FixedPointMapper->SetBlendModeToComposite();
                   break;
               }
               default:
@@ -301,20 +316,8 @@ void mitk::VolumeDataVtkMapper3D::GenerateDataForRenderer( mitk::BaseRenderer *r
   }
 
   this->SetPreferences();
-/*
-  switch ( mitk::RenderingManager::GetInstance()->GetNextLOD( renderer ) )
-  {
-  case 0:
-    m_VolumeLOD->SetSelectedLODID(m_MedResID);  m_LowResID );
-    break;
-
-  default:
-  case 1:
-    m_VolumeLOD->SetSelectedLODID( m_HiResID );
-    break;
-  }
-*/
-  m_VolumeLOD->SetSelectedLODID( m_HiResID );
+
+  this->SelectLOD( renderer );
 
   assert(input->GetTimeSlicedGeometry());
 
@@ -338,11 +341,13 @@ void mitk::VolumeDataVtkMapper3D::GenerateDataForRenderer( mitk::BaseRenderer *r
     this->m_ImageMaskFilter->SetImageInput(this->m_UnitSpacingImageFilter->GetOutput());
     this->m_Resampler->SetInput(this->m_ImageMaskFilter->GetOutput());
     this->m_HiResMapper->SetInput(this->m_ImageMaskFilter->GetOutput());
+    this->m_FixedPointMapper->SetInput(this->m_ImageMaskFilter->GetOutput());
   }
   else
   {
     this->m_Resampler->SetInput(this->m_UnitSpacingImageFilter->GetOutput());
     this->m_HiResMapper->SetInput(this->m_UnitSpacingImageFilter->GetOutput());
+    this->m_FixedPointMapper->SetInput(this->m_UnitSpacingImageFilter->GetOutput());
   }
 
   this->UpdateTransferFunctions( renderer );
@@ -523,6 +528,29 @@ void mitk::VolumeDataVtkMapper3D::SetPreferences()
 
 }
 
+/* Interactive (LOD 0) or still (LOD 1) rendering */
+void mitk::VolumeDataVtkMapper3D::SelectLOD( mitk::BaseRenderer *renderer )
+{
+  // while interacting, the RenderingManager requests LOD 0 and renders LOD 1 after the interaction
+  bool interactive = this->IsLODEnabled( renderer ) && mitk::RenderingManager::GetInstance()->GetNextLOD( renderer ) == 0;
+
+  bool useFixedPoint = false;
+  this->GetDataNode()->GetBoolProperty( "volumerendering.usefixedpoint", useFixedPoint, renderer );
+
+  if ( useFixedPoint )
+  {
+    // one ray for every 3.5 x 3.5 pixels, the others are interpolated
+    m_FixedPointMapper->SetImageSampleDistance( interactive ? 3.5 : 1.0 );
+    m_FixedPointMapper->SetSampleDistance( interactive ? 1.25 : 1.0 );
+    m_VolumeLOD->SetSelectedLODID( interactive ? m_FixedPointMedResID : m_FixedPointHiResID );
+  }
+  else
+  {
+    m_HiResMapper->SetImageSampleDistance( interactive ? 4.0 : 1.0 );
+    m_VolumeLOD->SetSelectedLODID( interactive ? m_MedResID : m_HiResID );
+  }
+}
+
 /* Adds A Clipping Plane to the Mapper */
 void mitk::VolumeDataVtkMapper3D::SetClippingPlane(vtkRenderWindowInteractor* interactor)
 {
@@ -546,6 +574,7 @@ void mitk::VolumeDataVtkMapper3D::SetClippingPlane(vtkRenderWindowInteractor* in
 
 //    m_T2DMapper->AddClippingPlane(m_ClippingPlane);
     m_HiResMapper->AddClippingPlane(m_ClippingPlane);
+    m_FixedPointMapper->AddClippingPlane(m_ClippingPlane);
     }
 
     m_PlaneWidget->GetPlane(m_ClippingPlane);
@@ -567,6 +596,7 @@ void mitk::VolumeDataVtkMapper3D::DelClippingPlane()
 {
 //  m_T2DMapper->RemoveAllClippingPlanes();
   m_HiResMapper->RemoveAllClippingPlanes();
+  m_FixedPointMapper->RemoveAllClippingPlanes();
   m_PlaneSet = false;
 }
 
@@ -575,6 +605,8 @@ void mitk::VolumeDataVtkMapper3D::SetDefaultProperties(mitk::DataNode* node, mit
 {
   node->AddProperty( "volumerendering", mitk::BoolProperty::New( false ), renderer, overwrite );
   node->AddProperty( "volumerendering configuration", mitk::VtkVolumeRenderingProperty::New( 1 ), renderer, overwrite );
+  node->AddProperty( "volumerendering.usefixedpoint", mitk::BoolProperty::New( false ), renderer, overwrite );
+  node->AddProperty( "volumerendering.uselod", mitk::BoolProperty::New( false ), renderer, overwrite );
   node->AddProperty( "binary", mitk::BoolProperty::New( false ), renderer, overwrite );
 
   mitk::Image::Pointer image = dynamic_cast<mitk::Image*>(node->GetData());
@@ -617,17 +649,13 @@ void mitk::VolumeDataVtkMapper3D::SetDefaultProperties(mitk::DataNode* node, mit
 }
 
 
-bool mitk::VolumeDataVtkMapper3D::IsLODEnabled( mitk::BaseRenderer * /*renderer*/ ) const
+bool mitk::VolumeDataVtkMapper3D::IsLODEnabled( mitk::BaseRenderer * renderer ) const
 {
-  return false;
-
-
-  // Volume mapper is LOD enabled if volumerendering is enabled
-  /*
-  return
-    dynamic_cast<mitk::BoolProperty*>(GetDataNode()->GetProperty("volumerendering",renderer)) != NULL &&
-    dynamic_cast<mitk::BoolProperty*>(GetDataNode()->GetProperty("volumerendering",renderer))->GetValue() == true;
-  */
+  // Volume mapper is LOD enabled if volumerendering and LOD are enabled
+  bool volumeRendering = false;
+  bool lod = false;
+  return GetDataNode()->GetBoolProperty("volumerendering",volumeRendering,renderer) && volumeRendering
+      && GetDataNode()->GetBoolProperty("volumerendering.uselod",lod,renderer) && lod;
 }
 
 
@@ -55,6 +55,12 @@ namespace mitk {
   * - \b "level window": for the level window of the volume data
   * - \b "LookupTable" : for the lookup table of the volume data
   * - \b "TransferFunction" (mitk::TransferFunctionProperty): for the used transfer function of the volume data
+  * - \b "volumerendering.usefixedpoint" (mitk::BoolProperty): render with the multi-threaded
+  *   vtkFixedPointVolumeRayCastMapper instead of the vtkVolumeRayCastMapper. The fixed point
+  *   mapper splits the image into tiles for all threads and skips empty space by a min/max
+  *   volume of 4x4x4 voxel cells, which is built once per volume.
+  * - \b "volumerendering.uselod" (mitk::BoolProperty): render with a coarser image and sample
+  *   distance while interacting and refine the rendering when the interaction stops
   ************************************************************************/
 
 //##Documentation
@@ -101,6 +107,9 @@ protected:
 
   void SetPreferences();
 
+  /** Selects the LOD of m_VolumeLOD and sets the sample distances of its mapper */
+  void SelectLOD( mitk::BaseRenderer *renderer );
+
   void SetClippingPlane(vtkRenderWindowInteractor* interactor);
   void DelClippingPlane();
 
@@ -111,6 +120,7 @@ protected:
   vtkVolumeProperty* m_VolumePropertyHigh;
   vtkVolumeTextureMapper2D* m_T2DMapper;
   vtkVolumeRayCastMapper* m_HiResMapper;
+  vtkFixedPointVolumeRayCastMapper* m_FixedPointMapper;
   vtkImageResample* m_Resampler;
 
   vtkLODProp3D* m_VolumeLOD;
@@ -134,6 +144,8 @@ protected:
   int m_LowResID;
   int m_MedResID;
   int m_HiResID;
+  int m_FixedPointMedResID;
+  int m_FixedPointHiResID;
   bool m_PlaneSet;
   double m_PlaneNormalA;
   double m_PlaneNormalB;
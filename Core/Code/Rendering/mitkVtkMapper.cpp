@@ -44,7 +44,7 @@ void mitk::VtkMapper::MitkRenderOverlay(BaseRenderer* renderer)
 {
 
   bool visible = true;
-  GetDataNode()->GetVisibility(visible, renderer, "visible");
+  GetDataNode()->GetVisibility(visible, renderer, GetVisibleKey());
   if ( !visible) return;
 
   if ( this->GetVtkProp(renderer)->GetVisibility() )
@@ -57,7 +57,7 @@ void mitk::VtkMapper::MitkRenderOpaqueGeometry(BaseRenderer* renderer)
 {
   bool visible = true;
 
-  GetDataNode()->GetVisibility(visible, renderer, "visible");
+  GetDataNode()->GetVisibility(visible, renderer, GetVisibleKey());
   if ( !visible) return;
 
   if ( this->GetVtkProp(renderer)->GetVisibility() )
@@ -69,7 +69,7 @@ void mitk::VtkMapper::MitkRenderOpaqueGeometry(BaseRenderer* renderer)
 void mitk::VtkMapper::MitkRenderTranslucentGeometry(BaseRenderer* renderer)
 {
   bool visible = true;
-  GetDataNode()->GetVisibility(visible, renderer, "visible");
+  GetDataNode()->GetVisibility(visible, renderer, GetVisibleKey());
   if ( !visible) return;
 
   if ( this->GetVtkProp(renderer)->GetVisibility() )
@@ -81,7 +81,7 @@ void mitk::VtkMapper::MitkRenderTranslucentGeometry(BaseRenderer* renderer)
 void mitk::VtkMapper::MitkRenderVolumetricGeometry(BaseRenderer* renderer)
 {
   bool visible = true;
-  GetDataNode()->GetVisibility(visible, renderer, "visible");
+  GetDataNode()->GetVisibility(visible, renderer, GetVisibleKey());
   if ( !visible) return;
 
   if ( GetVtkProp(renderer)->GetVisibility() )
@@ -119,9 +119,9 @@ void mitk::VtkMapper::ApplyColorAndOpacityProperties(BaseRenderer* renderer, vtk
   DataNode * node = GetDataNode();
 
   // check for color prop and use it for rendering if it exists
-  node->GetColor(rgba, renderer, "color");
+  node->GetColor(rgba, renderer, GetColorKey());
   // check for opacity prop and use it for rendering if it exists
-  node->GetOpacity(rgba[3], renderer, "opacity");
+  node->GetOpacity(rgba[3], renderer, GetOpacityKey());
 
   double drgba[4]={rgba[0],rgba[1],rgba[2],rgba[3]};
   actor->GetProperty()->SetColor(drgba);
@@ -59,14 +59,29 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransform.h>
 #include <vtkInteractorStyleTrackballCamera.h>
 
+// ITK
+#include <itkTimeProbe.h>
+
+#include <algorithm>
+#include <functional>
+
 
 mitk::VtkPropRenderer::VtkPropRenderer( const char* name, vtkRenderWindow * renWin, mitk::RenderingManager* rm )
   : BaseRenderer(name,renWin, rm),
   m_VtkMapperPresent(false),
-  m_CameraInitializedForMapperID(0)
+  m_CameraInitializedForMapperID(0),
+  m_MapperQueueMapperID(0),
+  m_MapperQueueNeedsRebuild(true),
+  m_MapperQueueNeedsSorting(true),
+  m_LastMapperQueuePreparationTime(0.0),
+  m_TotalMapperQueuePreparationTime(0.0),
+  m_NumberOfMapperQueuePreparations(0)
 {
   didCount=false;
 
+  m_MapperQueueModifiedCommand = itk::MemberCommand<VtkPropRenderer>::New();
+  m_MapperQueueModifiedCommand->SetCallbackFunction(this, &VtkPropRenderer::MapperQueueObjectModified);
+
   m_WorldPointPicker = vtkWorldPointPicker::New();
 
   m_PointPicker = vtkPointPicker::New();
@@ -100,6 +115,15 @@ mitk::VtkPropRenderer::~VtkPropRenderer()
     checkState();
   }
 
+  this->ClearMapperQueue();
+  if ( m_DataStorage.IsNotNull() )
+  {
+    m_DataStorage->AddNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const mitk::DataNode*>( this, &VtkPropRenderer::MapperQueueNodeAdded ) );
+    m_DataStorage->RemoveNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const mitk::DataNode*>( this, &VtkPropRenderer::MapperQueueNodeRemoved ) );
+  }
+
   if (m_LightKit != NULL)
     m_LightKit->Delete();
 
@@ -130,8 +154,25 @@ void mitk::VtkPropRenderer::SetDataStorage(  mitk::DataStorage* storage  )
   if ( storage == NULL )
     return;
 
+  /* remove listeners of old DataStorage */
+  this->ClearMapperQueue();
+  if ( m_DataStorage.IsNotNull() )
+  {
+    m_DataStorage->AddNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const mitk::DataNode*>( this, &VtkPropRenderer::MapperQueueNodeAdded ) );
+    m_DataStorage->RemoveNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const mitk::DataNode*>( this, &VtkPropRenderer::MapperQueueNodeRemoved ) );
+  }
+
   BaseRenderer::SetDataStorage(storage);
 
+  /* the mapper queue follows the new DataStorage incrementally */
+  m_DataStorage->AddNodeEvent.AddListener(
+    MessageDelegate1<VtkPropRenderer, const mitk::DataNode*>( this, &VtkPropRenderer::MapperQueueNodeAdded ) );
+  m_DataStorage->RemoveNodeEvent.AddListener(
+    MessageDelegate1<VtkPropRenderer, const mitk::DataNode*>( this, &VtkPropRenderer::MapperQueueNodeRemoved ) );
+  m_MapperQueueNeedsRebuild = true;
+
   static_cast<mitk::Geometry2DDataVtkMapper3D*>(m_CurrentWorldGeometry2DMapper.GetPointer())->SetDataStorageForTexture( m_DataStorage.GetPointer() );
 
   // Compute the geometry from the current data tree bounds and set it as world geometry
@@ -226,14 +267,18 @@ int mitk::VtkPropRenderer::Render(mitk::VtkPropRenderer::RenderType type)
 }
 
 /*!
-\brief PrepareMapperQueue iterates the datatree
+\brief PrepareMapperQueue updates the mappers and the sorted mapper queue
 
-PrepareMapperQueue iterates the datatree in order to find mappers which shall be rendered. Also, it sortes the mappers wrt to their layer.
+PrepareMapperQueue updates the mappers which shall be rendered and sorts them wrt to their layer.
+The queue itself is kept between frames and only changes when the DataStorage or the
+"visible"/"layer" properties of its nodes change (see UpdateMapperQueue()).
 */
 void mitk::VtkPropRenderer::PrepareMapperQueue()
 {
-  // variable for counting LOD-enabled mappers
-  m_NumberOfVisibleLODEnabledMappers = 0;
+  itk::TimeProbe clock;
+  clock.Start();
+
+  this->UpdateMapperQueue();
 
   // Do we have to update the mappers ?
   if ( m_LastUpdateTime < GetMTime() || m_LastUpdateTime < GetDisplayGeometry()->GetMTime() ) {
@@ -251,42 +296,295 @@ void mitk::VtkPropRenderer::PrepareMapperQueue()
   }
   m_TextCollection.clear();
 
+  if ( m_MapperQueueNeedsSorting )
+    this->SortMapperQueue();
+
+  clock.Stop();
+  m_LastMapperQueuePreparationTime = clock.GetTotal();
+  m_TotalMapperQueuePreparationTime += m_LastMapperQueuePreparationTime;
+  ++m_NumberOfMapperQueuePreparations;
+  MITK_DEBUG << "Mapper queue of " << this->GetName() << " (" << m_MappersMap.size() << " mappers) prepared in "
+             << m_LastMapperQueuePreparationTime * 1000.0 << " ms";
+}
+
+
+namespace
+{
+  // order of the mapper queue: by layer, within a layer by node like the DataStorage sorts them
+  struct MapperQueueNodeLess
+  {
+    template < typename TEntry >
+    bool operator()( const TEntry& left, const TEntry& right ) const
+    {
+      if ( left.layer != right.layer )
+        return left.layer < right.layer;
+      return std::less< const mitk::DataNode* >()( left.node, right.node );
+    }
+  };
+}
+
+
+void mitk::VtkPropRenderer::UpdateMapperQueue()
+{
+  if ( m_DataStorage.IsNull() )
+  {
+    if ( !m_MapperQueue.empty() )
+      this->ClearMapperQueue();
+    return;
+  }
+
+  if ( m_MapperQueueMapperID != m_MapperID )
+  {
+    m_MapperQueueMapperID = m_MapperID;
+    m_MapperQueueNeedsRebuild = true;
+  }
+
+  if ( m_MapperQueueNeedsRebuild )
+  {
+    this->ClearMapperQueue();
+
+    DataStorage::SetOfObjects::ConstPointer allObjects = m_DataStorage->GetAll();
+    m_MapperQueue.reserve( allObjects->Size() );
+    for (DataStorage::SetOfObjects::ConstIterator it = allObjects->Begin();  it != allObjects->End(); ++it)
+    {
+      DataNode* node = it->Value();
+      if ( node == NULL )
+        continue;
+
+      MapperQueueNode entry;
+      entry.node = node;
+      this->UpdateMapperQueueNode( entry );
+      m_MapperQueue.push_back( entry );
+
+      MapperQueueNodeState& state = m_MapperQueueNodeStates[node];
+      state.queued = true;
+      state.layer = entry.layer;
+      this->AddMapperQueueObservers( node, state );
+    }
+    std::stable_sort( m_MapperQueue.begin(), m_MapperQueue.end(), MapperQueueNodeLess() );
+
+    m_MapperQueueNeedsRebuild = false;
+    m_MapperQueueNeedsSorting = true;
+    return;
+  }
+
+  // observers may fire again while the modified nodes are re-read
+  std::set< const DataNode* > modifiedNodes;
+  modifiedNodes.swap( m_ModifiedMapperQueueNodes );
+
+  for ( std::set< const DataNode* >::const_iterator nodeIt = modifiedNodes.begin(); nodeIt != modifiedNodes.end(); ++nodeIt )
+  {
+    MapperQueueNodeStateMap::iterator stateIt = m_MapperQueueNodeStates.find( *nodeIt );
+    if ( stateIt == m_MapperQueueNodeStates.end() )
+      continue;
+    MapperQueueNodeState& state = stateIt->second;
+
+    MapperQueueNode entry;
+    entry.node = const_cast<DataNode*>( *nodeIt );
+    entry.mapper = NULL;
+    entry.layer = state.layer;
+    entry.visible = true;
+    MapperQueueType::iterator queued = m_MapperQueue.end();
+    if ( state.queued )
+    {
+      queued = this->FindMapperQueueNode( entry.node, state.layer );
+      if ( queued != m_MapperQueue.end() )
+        entry = *queued;
+    }
+
+    // properties may have been replaced, so observe the current ones
+    this->RemoveMapperQueueObservers( entry.node, state );
+    this->AddMapperQueueObservers( entry.node, state );
+
+    Mapper* mapper = entry.mapper;
+    this->UpdateMapperQueueNode( entry );
+
+    if ( queued != m_MapperQueue.end() && entry.layer == state.layer )
+    {
+      // the position is unchanged, the map only has to be rebuilt for a new mapper
+      *queued = entry;
+      if ( entry.mapper != mapper )
+        m_MapperQueueNeedsSorting = true;
+      continue;
+    }
+
+    if ( queued != m_MapperQueue.end() )
+      m_MapperQueue.erase( queued );
+    m_MapperQueue.insert( std::upper_bound( m_MapperQueue.begin(), m_MapperQueue.end(), entry, MapperQueueNodeLess() ), entry );
+    state.queued = true;
+    state.layer = entry.layer;
+    m_MapperQueueNeedsSorting = true;
+  }
+}
+
+
+mitk::VtkPropRenderer::MapperQueueType::iterator mitk::VtkPropRenderer::FindMapperQueueNode( const DataNode* node, int layer )
+{
+  MapperQueueNode key;
+  key.node = const_cast<DataNode*>( node );
+  key.layer = layer;
+  MapperQueueType::iterator it = std::lower_bound( m_MapperQueue.begin(), m_MapperQueue.end(), key, MapperQueueNodeLess() );
+  if ( it != m_MapperQueue.end() && it->node == node )
+    return it;
+  return m_MapperQueue.end();
+}
+
+
+void mitk::VtkPropRenderer::UpdateMapperQueueNode( MapperQueueNode& entry )
+{
+  entry.mapper = entry.node->GetMapper(m_MapperID);
+
+  entry.visible = true;
+  static const PropertyKey visibleKey("visible");
+  entry.node->GetVisibility(entry.visible, this, visibleKey);
+
+  // mapper without a layer property get layer number 1
+  entry.layer = 1;
+  static const PropertyKey layerKey("layer");
+  entry.node->GetIntProperty(layerKey, entry.layer, this);
+}
+
+
+void mitk::VtkPropRenderer::SortMapperQueue()
+{
   // clear priority_queue
   m_MappersMap.clear();
 
   int mapperNo = 0;
+  for (MapperQueueType::const_iterator it = m_MapperQueue.begin(); it != m_MapperQueue.end(); ++it)
+  {
+    if ( it->mapper == NULL )
+      continue;
 
-  //DataStorage
-  if( m_DataStorage.IsNull() )
-    return;
+    int nr = (it->layer<<16) + mapperNo;
+    m_MappersMap.insert( m_MappersMap.end(), std::pair< int, Mapper * >( nr, it->mapper ) );
+    mapperNo++;
+  }
+
+  m_MapperQueueNeedsSorting = false;
+}
 
-  DataStorage::SetOfObjects::ConstPointer allObjects = m_DataStorage->GetAll();
 
-  for (DataStorage::SetOfObjects::ConstIterator it = allObjects->Begin();  it != allObjects->End(); ++it)
+void mitk::VtkPropRenderer::ClearMapperQueue()
+{
+  for (MapperQueueNodeStateMap::iterator it = m_MapperQueueNodeStates.begin(); it != m_MapperQueueNodeStates.end(); ++it)
+    this->RemoveMapperQueueObservers( it->first, it->second );
+
+  m_MapperQueue.clear();
+  m_MapperQueueNodeStates.clear();
+  m_MapperQueueObservedObjects.clear();
+  m_ModifiedMapperQueueNodes.clear();
+  m_MappersMap.clear();
+  m_MapperQueueNeedsRebuild = true;
+  m_MapperQueueNeedsSorting = true;
+}
+
+
+void mitk::VtkPropRenderer::AddMapperQueueObservers( const DataNode* node, MapperQueueNodeState& state )
+{
+  // The node is modified when one of its property lists (including the renderer specific
+  // ones) or its data or mappers change. The "visible" and "layer" properties in effect are
+  // observed themselves because their values are changed in place. GetProperty() does not
+  // create renderer specific property lists as GetPropertyList(this) would.
+  static const PropertyKey visibleKey("visible");
+  static const PropertyKey layerKey("layer");
+  itk::Object* observed[3] = { const_cast<DataNode*>(node), node->GetProperty(visibleKey, this), node->GetProperty(layerKey, this) };
+  for ( unsigned int i = 0; i < 3; ++i )
   {
-    DataNode::Pointer node = it->Value();
-    if ( node.IsNull() )
+    if ( observed[i] == NULL )
       continue;
-    mitk::Mapper::Pointer mapper = node->GetMapper(m_MapperID);
 
-    if ( mapper.IsNull() )
-      continue;
+    unsigned long tag = observed[i]->AddObserver( itk::ModifiedEvent(), m_MapperQueueModifiedCommand );
+    state.observers.push_back( std::make_pair( itk::Object::Pointer(observed[i]), tag ) );
+    m_MapperQueueObservedObjects.insert( std::make_pair( observed[i], node ) );
+  }
+}
 
-    bool visible = true;
-    node->GetVisibility(visible, this, "visible");
 
-    // The information about LOD-enabled mappers is required by RenderingManager
-    if ( mapper->IsLODEnabled( this ) && visible )
+void mitk::VtkPropRenderer::RemoveMapperQueueObservers( const DataNode* node, MapperQueueNodeState& state )
+{
+  for ( unsigned int i = 0; i < state.observers.size(); ++i )
+  {
+    itk::Object* observed = state.observers[i].first;
+    observed->RemoveObserver( state.observers[i].second );
+
+    // properties may be shared between nodes, only forget the one of this node
+    typedef std::multimap< const itk::Object*, const DataNode* >::iterator ObservedIterator;
+    std::pair<ObservedIterator, ObservedIterator> range = m_MapperQueueObservedObjects.equal_range( observed );
+    for ( ObservedIterator it = range.first; it != range.second; ++it )
     {
-      ++m_NumberOfVisibleLODEnabledMappers;
+      if ( it->second == node )
+      {
+        m_MapperQueueObservedObjects.erase( it );
+        break;
+      }
     }
-    // mapper without a layer property get layer number 1
-    int layer = 1;
-    node->GetIntProperty("layer", layer, this);
-    int nr = (layer<<16) + mapperNo;
-    m_MappersMap.insert( std::pair< int, Mapper * >( nr, mapper ) );
-    mapperNo++;
   }
+  state.observers.clear();
+}
+
+
+void mitk::VtkPropRenderer::MapperQueueNodeAdded( const mitk::DataNode* node )
+{
+  if ( node == NULL || m_MapperQueueNeedsRebuild )
+    return;
+
+  // the node is inserted at its sorted position by the next UpdateMapperQueue(),
+  // so additions during a pass over the queue do not shift it
+  MapperQueueNodeState& state = m_MapperQueueNodeStates[node];
+  if ( state.observers.empty() )
+  {
+    state.queued = false;
+    state.layer = 1;
+    this->AddMapperQueueObservers( node, state );
+  }
+  m_ModifiedMapperQueueNodes.insert( node );
+}
+
+
+void mitk::VtkPropRenderer::MapperQueueNodeRemoved( const mitk::DataNode* node )
+{
+  if ( node == NULL || m_MapperQueueNeedsRebuild )
+    return;
+
+  MapperQueueNodeStateMap::iterator stateIt = m_MapperQueueNodeStates.find( node );
+  if ( stateIt == m_MapperQueueNodeStates.end() )
+    return;
+
+  if ( stateIt->second.queued )
+  {
+    MapperQueueType::iterator queued = this->FindMapperQueueNode( node, stateIt->second.layer );
+    if ( queued != m_MapperQueue.end() )
+      m_MapperQueue.erase( queued );
+    m_MapperQueueNeedsSorting = true;
+  }
+
+  this->RemoveMapperQueueObservers( node, stateIt->second );
+  m_MapperQueueNodeStates.erase( stateIt );
+  m_ModifiedMapperQueueNodes.erase( node );
+}
+
+
+void mitk::VtkPropRenderer::MapperQueueObjectModified( const itk::Object* caller, const itk::EventObject& )
+{
+  typedef std::multimap< const itk::Object*, const DataNode* >::const_iterator ObservedIterator;
+  std::pair<ObservedIterator, ObservedIterator> range = m_MapperQueueObservedObjects.equal_range( caller );
+  for ( ObservedIterator it = range.first; it != range.second; ++it )
+    m_ModifiedMapperQueueNodes.insert( it->second );
+}
+
+
+double mitk::VtkPropRenderer::GetLastMapperQueuePreparationTime() const
+{
+  return m_LastMapperQueuePreparationTime;
+}
+
+
+double mitk::VtkPropRenderer::GetMeanMapperQueuePreparationTime() const
+{
+  if ( m_NumberOfMapperQueuePreparations == 0 )
+    return 0.0;
+  return m_TotalMapperQueuePreparationTime / m_NumberOfMapperQueuePreparations;
 }
 
 /*!
@@ -416,9 +714,31 @@ void mitk::VtkPropRenderer::Update()
     return;
 
   m_VtkMapperPresent = false;
-  mitk::DataStorage::SetOfObjects::ConstPointer all = m_DataStorage->GetAll();
-  for (mitk::DataStorage::SetOfObjects::ConstIterator it = all->Begin(); it != all->End(); ++it)
-    Update(it->Value());
+  this->UpdateMapperQueue();
+
+  // mapper updates may add or remove nodes, so walk a snapshot which keeps the nodes alive
+  std::vector< DataNode::Pointer > nodes;
+  std::vector< bool > visible;
+  nodes.reserve( m_MapperQueue.size() );
+  visible.reserve( m_MapperQueue.size() );
+  for (MapperQueueType::const_iterator it = m_MapperQueue.begin(); it != m_MapperQueue.end(); ++it)
+  {
+    nodes.push_back( it->node );
+    visible.push_back( it->visible );
+  }
+
+  // The information about LOD-enabled mappers is required by RenderingManager. Mappers
+  // decide it from properties which are not observed by the queue (e.g. "volumerendering.uselod"),
+  // so it is counted along with the mapper updates.
+  m_NumberOfVisibleLODEnabledMappers = 0;
+  for ( std::size_t i = 0; i < nodes.size(); ++i )
+  {
+    Update(nodes[i]);
+
+    Mapper* mapper = nodes[i]->GetMapper(m_MapperID);
+    if ( mapper != NULL && visible[i] && mapper->IsLODEnabled( this ) )
+      ++m_NumberOfVisibleLODEnabledMappers;
+  }
 
   Modified();
   m_LastUpdateTime = GetMTime();
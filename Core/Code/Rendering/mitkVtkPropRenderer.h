@@ -26,7 +26,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkCommand.h>
 
 #include <map>
+#include <set>
 #include <utility>
+#include <vector>
 
 class vtkRenderWindow;
 class vtkLight;
@@ -140,6 +142,12 @@ public:
 
   MappersMapType GetMappersMap() const;
 
+  /** \brief Time in seconds the last PrepareMapperQueue() call of this renderer took. */
+  double GetLastMapperQueuePreparationTime() const;
+
+  /** \brief Mean time in seconds PrepareMapperQueue() took since the renderer was created. */
+  double GetMeanMapperQueuePreparationTime() const;
+
   static bool useImmediateModeRendering();
 
 protected:
@@ -213,6 +221,48 @@ private:
   // prepare all mitk::mappers for rendering
   void PrepareMapperQueue();
 
+  /** \brief Brings the persistent mapper queue up to date.
+   *
+   * The queue is only rebuilt from the DataStorage after the mapper slot has changed.
+   * Otherwise only the nodes which have been added or modified (see MapperQueueObjectModified())
+   * are re-read and moved to their sorted position, so frames without changes do not touch the queue.
+   */
+  void UpdateMapperQueue();
+
+  /** \brief Rebuilds the sorted m_MappersMap from the mapper queue. */
+  void SortMapperQueue();
+
+  void ClearMapperQueue();
+
+  // DataStorage and property observers keeping the mapper queue up to date
+  void MapperQueueNodeAdded( const mitk::DataNode* node );
+  void MapperQueueNodeRemoved( const mitk::DataNode* node );
+  void MapperQueueObjectModified( const itk::Object* caller, const itk::EventObject& event );
+
+  struct MapperQueueNode
+  {
+    DataNode* node;
+    Mapper* mapper;
+    int layer;
+    bool visible;
+  };
+  /** sorted by layer and, within a layer, by node like the DataStorage returns them */
+  typedef std::vector< MapperQueueNode > MapperQueueType;
+
+  typedef std::vector< std::pair< itk::Object::Pointer, unsigned long > > MapperQueueObserverList;
+  struct MapperQueueNodeState
+  {
+    bool queued;
+    int layer;
+    MapperQueueObserverList observers;
+  };
+  typedef std::map< const DataNode*, MapperQueueNodeState > MapperQueueNodeStateMap;
+
+  MapperQueueType::iterator FindMapperQueueNode( const DataNode* node, int layer );
+  void AddMapperQueueObservers( const DataNode* node, MapperQueueNodeState& state );
+  void RemoveMapperQueueObservers( const DataNode* node, MapperQueueNodeState& state );
+  void UpdateMapperQueueNode( MapperQueueNode& entry );
+
   /** \brief Set parallel projection, remove the interactor and the lights of VTK. */
   bool Initialize2DvtkCamera();
 
@@ -236,6 +286,20 @@ private:
   // sorted list of mappers
   MappersMapType m_MappersMap;
 
+  // all nodes of the DataStorage sorted by layer, with their cached render state
+  MapperQueueType m_MapperQueue;
+  MapperQueueNodeStateMap m_MapperQueueNodeStates;
+  MapperSlotId m_MapperQueueMapperID;
+  bool m_MapperQueueNeedsRebuild;
+  bool m_MapperQueueNeedsSorting;
+  std::set< const DataNode* > m_ModifiedMapperQueueNodes;
+  std::multimap< const itk::Object*, const DataNode* > m_MapperQueueObservedObjects;
+  itk::MemberCommand< VtkPropRenderer >::Pointer m_MapperQueueModifiedCommand;
+
+  double m_LastMapperQueuePreparationTime;
+  double m_TotalMapperQueuePreparationTime;
+  unsigned long m_NumberOfMapperQueuePreparations;
+
   // rendering of text
   vtkRenderer * m_TextRenderer;
   typedef std::map<unsigned int,vtkTextActor*> TextMapType;
@@ -25,6 +25,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itksys/SystemTools.hxx>
 #include "itkBarrier.h"
 #include <itkMultiThreader.h>
+#include <itkTimeProbe.h>
 #include <stdlib.h>
 #include <time.h>
 #include <fstream>
@@ -172,6 +173,87 @@ ITK_THREAD_RETURN_TYPE ThreadMethod(void* data)
 
 
 
+struct ContentionData
+{
+   std::vector<mitk::Image::ImageDataItemPointer> m_Volumes;  // the time steps readers may access
+   mitk::Image::Pointer m_Image;
+   unsigned int m_NumberOfAccesses;
+   bool m_Successful;
+};
+
+// Reads time steps of an image while another time step is write locked
+ITK_THREAD_RETURN_TYPE ReaderThreadMethod(void* data)
+{
+   struct itk::MultiThreader::ThreadInfoStruct * pInfo =
+      (struct itk::MultiThreader::ThreadInfoStruct*)data;
+   ContentionData* contentionData = (ContentionData*) pInfo->UserData;
+
+   try
+   {
+      for(unsigned int i = 0; i < contentionData->m_NumberOfAccesses; ++i)
+      {
+         mitk::ImageDataItem* volume = contentionData->m_Volumes[(pInfo->ThreadID + i) % contentionData->m_Volumes.size()];
+         mitk::ImageReadAccessor readAccessor(contentionData->m_Image, volume, mitk::ImageAccessorBase::ExceptionIfLocked);
+         if(readAccessor.GetData() == NULL)
+         {
+            contentionData->m_Successful = false;
+         }
+      }
+   }
+   catch(mitk::Exception& e)
+   {
+      contentionData->m_Successful = false;
+      e.Print(std::cout);
+   }
+   return ITK_THREAD_RETURN_VALUE;
+}
+
+static void TestConcurrentTimeStepAccess()
+{
+   // A 4D image, the last time step is edited while the others are read
+   unsigned int dimensions[4] = {64, 64, 32, 4};
+   mitk::Image::Pointer image = mitk::Image::New();
+   image->Initialize(mitk::MakeScalarPixelType<short>(), 4, dimensions);
+
+   ContentionData contentionData;
+   contentionData.m_Image = image;
+   contentionData.m_NumberOfAccesses = 20000;
+   contentionData.m_Successful = true;
+   for(unsigned int t = 0; t < dimensions[3] - 1; ++t)
+   {
+      contentionData.m_Volumes.push_back(image->GetVolumeData(t));
+   }
+
+   itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+   threader->SetNumberOfThreads(4);
+   threader->SetSingleMethod(ReaderThreadMethod, &contentionData);
+
+   itk::TimeProbe probe;
+   {
+      mitk::ImageWriteAccessor writeAccessor(image, image->GetVolumeData(dimensions[3] - 1));
+
+      probe.Start();
+      threader->SingleMethodExecute();
+      probe.Stop();
+
+      // a reader of the write locked time step is rejected
+      MITK_TEST_FOR_EXCEPTION_BEGIN(mitk::Exception)
+        mitk::ImageReadAccessor lockedAccessor(image, image->GetVolumeData(dimensions[3] - 1), mitk::ImageAccessorBase::ExceptionIfLocked);
+      MITK_TEST_FOR_EXCEPTION_END(mitk::Exception)
+   }
+
+   MITK_TEST_CONDITION_REQUIRED(contentionData.m_Successful, "Time steps can be read while another time step is write locked");
+
+   const double numberOfAccesses = static_cast<double>(contentionData.m_NumberOfAccesses) * threader->GetNumberOfThreads();
+   MITK_TEST_OUTPUT( << threader->GetNumberOfThreads() << " reader threads acquired " << numberOfAccesses
+                     << " read accessors in " << probe.GetMean() << "s ("
+                     << (probe.GetMean() > 0 ? numberOfAccesses / probe.GetMean() : 0) << " accessors/s)");
+
+   // after the writer is released, the time step can be read again
+   mitk::ImageReadAccessor readAccessor(image, image->GetVolumeData(dimensions[3] - 1), mitk::ImageAccessorBase::ExceptionIfLocked);
+   MITK_TEST_CONDITION(readAccessor.GetData() != NULL, "Released time step can be read");
+}
+
 int mitkImageAccessorTest(int argc, char* argv[])
 {
    MITK_TEST_BEGIN("mitkImageAccessorTest");
@@ -257,5 +339,7 @@ int mitkImageAccessorTest(int argc, char* argv[])
 
    MITK_TEST_CONDITION_REQUIRED( TestSuccessful, "Testing image access from multiple threads");
 
+   TestConcurrentTimeStepAccess();
+
    MITK_TEST_END();
 }
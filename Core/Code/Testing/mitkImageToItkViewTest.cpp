@@ -0,0 +1,171 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImageToItk.h"
+#include "mitkImageCast.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
+#include "mitkTestingMacros.h"
+
+#include <itkImage.h>
+#include <itkTimeProbe.h>
+
+#include <algorithm>
+
+namespace {
+
+typedef itk::Image<float, 3> ImageType;
+typedef mitk::ImageToItk<ImageType> ImageToItkType;
+
+mitk::Image::Pointer CreateImage(unsigned int size)
+{
+  unsigned int dim[3] = { size, size, size };
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize(mitk::MakeScalarPixelType<float>(), 3, dim);
+
+  mitk::ImageWriteAccessor accessor(image);
+  float* data = static_cast<float*>(accessor.GetData());
+  for (unsigned int i = 0; i < size * size * size; ++i)
+  {
+    data[i] = static_cast<float>(i % 1000);
+  }
+  return image;
+}
+
+ImageType::Pointer CreateView(mitk::Image* image, bool constInput, bool copyMem)
+{
+  ImageToItkType::Pointer imageToItk = ImageToItkType::New();
+  imageToItk->SetInput(image);
+  imageToItk->SetConstInput(constInput);
+  imageToItk->SetCopyMemFlag(copyMem);
+  imageToItk->Update();
+  return imageToItk->GetOutput();
+}
+
+// tries to access the image without waiting for locks
+bool CanAccess(mitk::Image* image, bool write)
+{
+  try
+  {
+    if (write)
+    {
+      mitk::ImageWriteAccessor accessor(image, NULL, mitk::ImageAccessorBase::ExceptionIfLocked);
+    }
+    else
+    {
+      mitk::ImageReadAccessor accessor(image, NULL, mitk::ImageAccessorBase::ExceptionIfLocked);
+    }
+  }
+  catch (const mitk::Exception&)
+  {
+    return false;
+  }
+  return true;
+}
+
+const void* GetImageData(mitk::Image* image)
+{
+  mitk::ImageReadAccessor accessor(image);
+  return accessor.GetData();
+}
+
+void TestViews(mitk::Image* image)
+{
+  const void* data = GetImageData(image);
+
+  {
+    ImageType::Pointer view = CreateView(image, true, false);
+    MITK_TEST_CONDITION(view->GetBufferPointer() == data, "Read view shares the buffer of the image")
+    MITK_TEST_CONDITION(CanAccess(image, false), "Image can be read while a read view exists")
+    MITK_TEST_CONDITION(!CanAccess(image, true), "Image cannot be written while a read view exists")
+
+    ImageType::Pointer secondView = CreateView(image, true, false);
+    MITK_TEST_CONDITION(secondView->GetBufferPointer() == data, "Two read views exist at the same time")
+  }
+  MITK_TEST_CONDITION(CanAccess(image, true), "Image can be written after the read views are released")
+
+  {
+    ImageType::Pointer view = CreateView(image, false, false);
+    MITK_TEST_CONDITION(view->GetBufferPointer() == data, "Write view shares the buffer of the image")
+    MITK_TEST_CONDITION(!CanAccess(image, false), "Image cannot be read while a write view exists")
+  }
+
+  {
+    ImageType::Pointer copy = CreateView(image, false, true);
+    MITK_TEST_CONDITION(copy->GetBufferPointer() != data, "Copy has its own buffer")
+    MITK_TEST_CONDITION(std::equal(copy->GetBufferPointer(), copy->GetBufferPointer() + 1000, static_cast<const float*>(data)),
+                        "Copy has the pixels of the image")
+    MITK_TEST_CONDITION(CanAccess(image, true), "Image is not locked after copying")
+  }
+
+  {
+    ImageType::Pointer cast;
+    mitk::CastToItkImage(image, cast);
+    MITK_TEST_CONDITION(cast->GetBufferPointer() == data, "CastToItkImage to the same type does not copy")
+    MITK_TEST_CONDITION(!CanAccess(image, false), "CastToItkImage to the same type holds a write view")
+  }
+  MITK_TEST_CONDITION(CanAccess(image, true), "Image can be written after the cast is released")
+
+  {
+    itk::Image<double, 3>::Pointer doubleCast;
+    mitk::CastToItkImage(image, doubleCast);
+    MITK_TEST_CONDITION(doubleCast->GetPixel(doubleCast->GetLargestPossibleRegion().GetIndex()) == static_cast<const float*>(data)[0],
+                        "CastToItkImage to another type casts the pixels")
+  }
+}
+
+void BenchmarkViews(mitk::Image* image, unsigned int size)
+{
+  const double megaBytes = static_cast<double>(size) * size * size * sizeof(float) / (1024.0 * 1024.0);
+
+  itk::TimeProbe viewProbe;
+  itk::TimeProbe copyProbe;
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    viewProbe.Start();
+    ImageType::Pointer view = CreateView(image, true, false);
+    viewProbe.Stop();
+
+    copyProbe.Start();
+    ImageType::Pointer copy = CreateView(image, false, true);
+    copyProbe.Stop();
+  }
+
+  MITK_INFO << "ImageToItk of " << megaBytes << " MB: " << viewProbe.GetMean() << "s and 0 MB additional memory for a read view, "
+            << copyProbe.GetMean() << "s and " << megaBytes << " MB for a copy ("
+            << copyProbe.GetMean() * 2048.0 / megaBytes << "s extrapolated to 2 GB)";
+}
+
+}
+
+/**
+ * Tests the read, write and copy modes of ImageToItk, their locking and CastToItkImage,
+ * and compares the time and memory of a view and a copy.
+ */
+int mitkImageToItkViewTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("ImageToItkView")
+
+  mitk::Image::Pointer image = CreateImage(32);
+  TestViews(image);
+
+  // a 2 GB volume is too large for the test machines, the copy time is extrapolated from about 256 MB
+  const unsigned int size = 406;
+  mitk::Image::Pointer largeImage = CreateImage(size);
+  BenchmarkViews(largeImage, size);
+
+  MITK_TEST_END()
+}
@@ -22,9 +22,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkExtractSliceFilter.h>
 #include "mitkIOUtil.h"
+#include "mitkImageReadAccessor.h"
+
+#include <itkTimeProbe.h>
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <cstring>
 
 #ifdef WIN32
 #include "process.h"
@@ -150,6 +155,57 @@ void TestPictureWriting(mitk::Image* image, const std::string& filename, const s
 
 }
 
+/*
+Write NRRD files with all kinds of compression, check that the pixel data is restored exactly,
+and report the write throughput of each compression level.
+*/
+void TestCompressionLevels(mitk::Image* image, const std::string& filename)
+{
+  size_t imageSize = image->GetPixelType().GetSize();
+  for ( unsigned int i = 0; i < image->GetDimension(); ++i )
+  {
+    imageSize *= image->GetDimension(i);
+  }
+  mitk::ImageReadAccessor imageAccess(image);
+
+  const int levels[] = { 0, 1, -1, 9 };
+  for ( unsigned int i = 0; i < sizeof(levels) / sizeof(levels[0]); ++i )
+  {
+    mitk::ImageWriter::Pointer writer = mitk::ImageWriter::New();
+    writer->SetInput(image);
+    writer->SetFileName(filename);
+    writer->SetExtension(".nrrd");
+    writer->SetCompressionLevel(levels[i]);
+    MITK_TEST_CONDITION_REQUIRED(writer->GetCompressionLevel() == levels[i], "test Set/GetCompressionLevel()");
+
+    try
+    {
+      itk::TimeProbe probe;
+      probe.Start();
+      writer->Update();
+      probe.Stop();
+
+      std::ifstream written( AppendExtension(filename, ".nrrd").c_str(), std::ios::binary | std::ios::ate );
+      double fileSize = static_cast<double>( written.tellg() );
+      written.close();
+      MITK_TEST_OUTPUT(<< "Compression level " << levels[i] << ": " << imageSize / ( 1024.0 * 1024.0 ) / std::max( probe.GetTotal(), 1e-6 )
+                       << " MB/s, " << fileSize / imageSize * 100.0 << "% of the pixel data size");
+
+      mitk::Image::Pointer compareImage = mitk::IOUtil::LoadImage( AppendExtension(filename, ".nrrd") );
+      MITK_TEST_CONDITION_REQUIRED(compareImage.IsNotNull(), "Image stored with compression level " << levels[i] << " was succesfully loaded again");
+      MITK_TEST_CONDITION(CompareImageMetaData(image, compareImage), "Image meta data unchanged after writing and loading again");
+
+      mitk::ImageReadAccessor compareAccess(compareImage);
+      MITK_TEST_CONDITION(memcmp(imageAccess.GetData(), compareAccess.GetData(), imageSize) == 0, "Pixel data unchanged after writing and loading again");
+    }
+    catch (itk::ExceptionObject& e)
+    {
+      MITK_TEST_FAILED_MSG(<< "Exception during .nrrd file writing with compression level " << levels[i] << ": " << e.what());
+    }
+    remove(AppendExtension(filename, ".nrrd").c_str());
+  }
+}
+
 /**
 *  test for "ImageWriter".
 *
@@ -263,6 +319,8 @@ int mitkImageWriterTest(int  argc , char* argv[])
     MITK_TEST_FAILED_MSG(<< "Exception during .nrrd file writing");
   }
 
+  TestCompressionLevels(image, filename);
+
   TestPictureWriting(image, filename, ".png");
   TestPictureWriting(image, filename, ".jpg");
   TestPictureWriting(image, filename, ".tiff");
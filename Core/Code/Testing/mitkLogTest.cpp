@@ -107,6 +107,24 @@ void Stop()
 
 };
 
+/** Documentation
+ *
+ *  @brief Backend that only counts the messages it receives.
+ */
+class CountingBackend : public mbilog::BackendBase
+{
+public:
+
+  CountingBackend() : NumberOfMessages(0) {}
+
+  void ProcessMessage(const mbilog::LogMessage&)
+  {
+    ++NumberOfMessages;
+  }
+
+  unsigned int NumberOfMessages;
+};
+
 /** Documentation
  *
  *  @brief This class holds static test methods to sturcture the test of the mitk logging mechanism.
@@ -166,9 +184,15 @@ static void TestObjectInfoLogging()
 
 
 
-static void TestThreadSaveLog(bool toFile)
+static void TestThreadSaveLog(bool toFile, bool asynchronous = false)
     {
     bool testSucceded = true;
+    unsigned int totalNumberOfMessages = 0;
+
+    if (asynchronous)
+    {
+      mitk::LoggingBackend::EnableAsynchronousLogging(true, 4096, mitk::LoggingBackend::DropMessages);
+    }
 
 
     try
@@ -219,8 +243,13 @@ static void TestThreadSaveLog(bool toFile)
           //Wait for all threads to end
           multiThreader->TerminateThread(threadIDs[threadIdx]);
           std::cout << "Terminated " << threadIdx << ". thread (" << threads[threadIdx]->NumberOfMessages << " messages)." << std::endl;
+          totalNumberOfMessages += threads[threadIdx]->NumberOfMessages;
         }
 
+        std::cout << (asynchronous ? "Asynchronous" : "Synchronous") << " logging" << (toFile ? " to file" : "")
+                  << " from " << numberOfThreads << " threads: "
+                  << totalNumberOfMessages / ( threadRuntimeInMilliseconds / 1000.0 ) << " log calls per second" << std::endl;
+
       }
     catch(std::exception e)
       {
@@ -233,10 +262,36 @@ static void TestThreadSaveLog(bool toFile)
         testSucceded = false;
       }
 
+    if (asynchronous)
+    {
+      mitk::LoggingBackend::Flush();
+      std::cout << mitk::LoggingBackend::GetNumberOfDroppedMessages() << " messages dropped." << std::endl;
+      mitk::LoggingBackend::EnableAsynchronousLogging(false);
+      MITK_TEST_CONDITION(!mitk::LoggingBackend::IsAsynchronousLoggingEnabled(), "Asynchronous logging disabled again.");
+    }
+
     //if no error occured until now, everything is ok
     MITK_TEST_CONDITION_REQUIRED(testSucceded,"Test logging in different threads.");
     }
 
+static void TestLevelFiltering()
+    {
+    CountingBackend countingBackend;
+    mbilog::RegisterBackend(&countingBackend);
+
+    MITK_INFO << "Test info stream.";
+    MITK_TEST_CONDITION(countingBackend.NumberOfMessages == 1, "Enabled level reaches the backend.");
+
+    mbilog::SetLevelEnabled(mbilog::Info, false);
+    MITK_TEST_CONDITION(!mbilog::IsLevelEnabled(mbilog::Info) && mbilog::IsLevelEnabled(mbilog::Warn), "Disable single level.");
+    MITK_INFO << "Test disabled info stream.";
+    MITK_WARN << "Test warning stream.";
+    MITK_TEST_CONDITION(countingBackend.NumberOfMessages == 2, "Disabled level does not reach the backend.");
+
+    mbilog::SetLevelEnabled(mbilog::Info, true);
+    mbilog::UnregisterBackend(&countingBackend);
+    }
+
 static void TestLoggingToFile()
     {
     std::string filename = mitk::StandardFileLocations::GetInstance()->GetOptionDirectory() + "/testlog.log";
@@ -279,6 +334,9 @@ int mitkLogTest(int /* argc */, char* /*argv*/[])
   mitkLogTestClass::TestAddAndRemoveBackends();
   mitkLogTestClass::TestThreadSaveLog( false ); // false = to console
   mitkLogTestClass::TestThreadSaveLog( true );  // true = to file
+  mitkLogTestClass::TestThreadSaveLog( false, true ); // asynchronous, to console
+  mitkLogTestClass::TestThreadSaveLog( true, true );  // asynchronous, to file
+  mitkLogTestClass::TestLevelFiltering();
   // TODO actually test file somehow?
 
   // always end with this!
@@ -0,0 +1,169 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNotificationBatch.h"
+#include "mitkStandaloneDataStorage.h"
+#include "mitkDataNode.h"
+#include "mitkProperties.h"
+#include "mitkTestingMacros.h"
+
+#include <itkTimeProbe.h>
+
+#include <vector>
+
+namespace {
+
+class ChangedNodeCounter
+{
+public:
+
+  ChangedNodeCounter() : m_Count(0) {}
+
+  void OnChanged(const mitk::DataNode*)
+  {
+    ++m_Count;
+  }
+
+  unsigned int m_Count;
+};
+
+const unsigned int NUMBER_OF_NODES = 1000;
+
+void ChangeProperties(std::vector<mitk::DataNode::Pointer>& nodes, int value)
+{
+  for (std::vector<mitk::DataNode::Pointer>::iterator iter = nodes.begin(); iter != nodes.end(); ++iter)
+  {
+    (*iter)->SetOpacity(0.5f + 0.001f * value);
+    (*iter)->SetVisibility((value % 2) == 0);
+    (*iter)->SetIntProperty("layer", value);
+    (*iter)->SetName((value % 2) == 0 ? "even" : "odd");
+  }
+}
+
+void TestBulkPropertyChanges()
+{
+  mitk::StandaloneDataStorage::Pointer storage = mitk::StandaloneDataStorage::New();
+  std::vector<mitk::DataNode::Pointer> nodes;
+  for (unsigned int i = 0; i < NUMBER_OF_NODES; ++i)
+  {
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    storage->Add(node);
+    nodes.push_back(node);
+  }
+
+  ChangedNodeCounter counter;
+  storage->ChangedNodeEvent.AddListener(
+        mitk::MessageDelegate1<ChangedNodeCounter, const mitk::DataNode*>(&counter, &ChangedNodeCounter::OnChanged));
+
+  itk::TimeProbe unbatchedProbe;
+  unbatchedProbe.Start();
+  ChangeProperties(nodes, 1);
+  unbatchedProbe.Stop();
+  unsigned int unbatchedCount = counter.m_Count;
+
+  MITK_TEST_CONDITION(unbatchedCount >= 4 * NUMBER_OF_NODES, "Every property change is sent without a batch")
+
+  counter.m_Count = 0;
+  std::size_t coalescedBefore = mitk::NotificationBatch::GetNumberOfCoalescedNotifications();
+  itk::TimeProbe batchedProbe;
+  batchedProbe.Start();
+  {
+    mitk::NotificationBatch batch;
+    MITK_TEST_CONDITION(mitk::NotificationBatch::IsActive(), "Batch is active")
+    ChangeProperties(nodes, 2);
+    MITK_TEST_CONDITION(counter.m_Count == 0, "No event is sent within the batch")
+  }
+  batchedProbe.Stop();
+
+  MITK_TEST_CONDITION(!mitk::NotificationBatch::IsActive(), "Batch is inactive after scope exit")
+  MITK_TEST_CONDITION(counter.m_Count == NUMBER_OF_NODES, "One ChangedNodeEvent per node after the batch (got " << counter.m_Count << ")")
+  MITK_TEST_CONDITION(mitk::NotificationBatch::GetNumberOfCoalescedNotifications() > coalescedBefore, "Duplicate notifications were coalesced")
+
+  float opacity = 0.0f;
+  nodes.front()->GetOpacity(opacity, NULL);
+  MITK_TEST_CONDITION(opacity == 0.5f + 0.002f, "Property values are set immediately within a batch")
+
+  MITK_INFO << "Changing 4 properties on " << NUMBER_OF_NODES << " nodes: "
+            << unbatchedCount << " events in " << unbatchedProbe.GetTotal() << "s without batch, "
+            << counter.m_Count << " events in " << batchedProbe.GetTotal() << "s with batch";
+
+  storage->ChangedNodeEvent.RemoveListener(
+        mitk::MessageDelegate1<ChangedNodeCounter, const mitk::DataNode*>(&counter, &ChangedNodeCounter::OnChanged));
+}
+
+void TestNestedBatches()
+{
+  mitk::StandaloneDataStorage::Pointer storage = mitk::StandaloneDataStorage::New();
+  mitk::DataNode::Pointer node = mitk::DataNode::New();
+  storage->Add(node);
+
+  ChangedNodeCounter counter;
+  storage->ChangedNodeEvent.AddListener(
+        mitk::MessageDelegate1<ChangedNodeCounter, const mitk::DataNode*>(&counter, &ChangedNodeCounter::OnChanged));
+
+  {
+    mitk::NotificationBatch outer;
+    node->SetOpacity(0.1f);
+    {
+      mitk::NotificationBatch inner;
+      node->SetOpacity(0.2f);
+    }
+    MITK_TEST_CONDITION(counter.m_Count == 0, "Inner batch does not deliver")
+    node->SetOpacity(0.3f);
+  }
+  MITK_TEST_CONDITION(counter.m_Count == 1, "Outer batch delivers once")
+
+  storage->ChangedNodeEvent.RemoveListener(
+        mitk::MessageDelegate1<ChangedNodeCounter, const mitk::DataNode*>(&counter, &ChangedNodeCounter::OnChanged));
+}
+
+void TestNodeDeletedWithinBatch()
+{
+  mitk::StandaloneDataStorage::Pointer storage = mitk::StandaloneDataStorage::New();
+  mitk::DataNode::Pointer node = mitk::DataNode::New();
+  mitk::DataNode::Pointer otherNode = mitk::DataNode::New();
+  storage->Add(node);
+  storage->Add(otherNode);
+
+  ChangedNodeCounter counter;
+  storage->ChangedNodeEvent.AddListener(
+        mitk::MessageDelegate1<ChangedNodeCounter, const mitk::DataNode*>(&counter, &ChangedNodeCounter::OnChanged));
+
+  {
+    mitk::NotificationBatch batch;
+    node->SetOpacity(0.5f);
+    otherNode->SetOpacity(0.5f);
+    storage->Remove(node);
+    node = NULL; // node is destroyed here, its pending notifications must be dropped
+  }
+  MITK_TEST_CONDITION(counter.m_Count == 1, "Notifications of a destroyed node are discarded")
+
+  storage->ChangedNodeEvent.RemoveListener(
+        mitk::MessageDelegate1<ChangedNodeCounter, const mitk::DataNode*>(&counter, &ChangedNodeCounter::OnChanged));
+}
+
+}
+
+int mitkNotificationBatchTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("NotificationBatch")
+
+  TestBulkPropertyChanges();
+  TestNestedBatches();
+  TestNodeDeletedWithinBatch();
+
+  MITK_TEST_END()
+}
@@ -0,0 +1,175 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPolyDataPlaneCutter.h"
+#include "mitkTestingMacros.h"
+
+#include <vtkSphereSource.h>
+#include <vtkPolyData.h>
+#include <vtkPlane.h>
+#include <vtkCutter.h>
+#include <vtkPoints.h>
+
+#include <itkTimeProbe.h>
+
+namespace {
+
+vtkPolyData* CreateSphere(int resolution)
+{
+  vtkSphereSource* sphere = vtkSphereSource::New();
+  sphere->SetRadius(50.0);
+  sphere->SetThetaResolution(resolution);
+  sphere->SetPhiResolution(resolution);
+  sphere->Update();
+
+  vtkPolyData* polydata = sphere->GetOutput();
+  polydata->Register(NULL);
+  polydata->SetSource(NULL);
+  sphere->Delete();
+  return polydata;
+}
+
+void TestCutMatchesVtkCutter(vtkPolyData* polydata)
+{
+  mitk::PolyDataPlaneCutter::Pointer cutter = mitk::PolyDataPlaneCutter::New();
+  cutter->SetInput(polydata);
+
+  vtkPlane* plane = vtkPlane::New();
+  vtkCutter* reference = vtkCutter::New();
+  reference->SetCutFunction(plane);
+  reference->SetInput(polydata);
+
+  const double normals[3][3] = { { 0, 0, 1 }, { 0, 1, 0 }, { 1, 1, 0 } };
+  bool matches = true;
+  bool firstCutsUnindexed = true;
+  for (unsigned int n = 0; n < 3; ++n)
+  {
+    for (double offset = -49.5; offset < 50.0; offset += 7.3)
+    {
+      bool firstCut = (offset == -49.5);
+      double origin[3] = { offset * normals[n][0], offset * normals[n][1], offset * normals[n][2] };
+      vtkPolyData* contour = cutter->Cut(origin, normals[n]);
+
+      plane->SetOrigin(origin);
+      plane->SetNormal(const_cast<double*>(normals[n]));
+      reference->Update();
+
+      matches = matches
+          && contour->GetNumberOfLines() == reference->GetOutput()->GetNumberOfLines()
+          && contour->GetNumberOfPoints() == reference->GetOutput()->GetNumberOfPoints()
+          && (firstCut || cutter->GetNumberOfCutCells() < polydata->GetNumberOfCells());
+      if (firstCut)
+      {
+        firstCutsUnindexed = firstCutsUnindexed
+            && cutter->GetNumberOfIndexBuilds() == n
+            && cutter->GetNumberOfCutCells() == polydata->GetNumberOfCells();
+      }
+    }
+  }
+  MITK_TEST_CONDITION(firstCutsUnindexed, "First cut with an orientation cuts the whole mesh without building an index")
+  MITK_TEST_CONDITION(matches, "Contours match vtkCutter and only a part of the cells is cut once indexed")
+  MITK_TEST_CONDITION(cutter->GetNumberOfIndexBuilds() == 3, "One index per orientation")
+
+  double origin[3] = { 0, 0, 0 };
+  cutter->Cut(origin, normals[0]);
+  MITK_TEST_CONDITION(cutter->GetNumberOfIndexBuilds() == 3, "Indices of three orientations are kept")
+
+  const double flipped[3] = { 0, 0, -1 };
+  cutter->Cut(origin, flipped);
+  MITK_TEST_CONDITION(cutter->GetNumberOfIndexBuilds() == 3, "Flipped normal reuses the index")
+
+  // moving a point invalidates the indices
+  double point[3];
+  polydata->GetPoints()->GetPoint(0, point);
+  point[2] += 1.0;
+  polydata->GetPoints()->SetPoint(0, point);
+  polydata->GetPoints()->Modified();
+  cutter->Cut(origin, normals[0]);
+  MITK_TEST_CONDITION(cutter->GetNumberOfIndexBuilds() == 3, "Modified mesh is cut without an index first")
+  cutter->Cut(origin, normals[0]);
+  MITK_TEST_CONDITION(cutter->GetNumberOfIndexBuilds() == 4, "Modified mesh rebuilds the index on the next cut")
+
+  reference->Delete();
+  plane->Delete();
+}
+
+void BenchmarkCuts(int resolution)
+{
+  vtkPolyData* polydata = CreateSphere(resolution);
+
+  mitk::PolyDataPlaneCutter::Pointer cutter = mitk::PolyDataPlaneCutter::New();
+  cutter->SetInput(polydata);
+
+  vtkPlane* plane = vtkPlane::New();
+  vtkCutter* reference = vtkCutter::New();
+  reference->SetCutFunction(plane);
+  reference->SetInput(polydata);
+
+  const double normal[3] = { 0, 0, 1 };
+  const unsigned int numberOfSlices = 50;
+
+  // the first cut is done by vtkCutter, the second one builds the index
+  itk::TimeProbe buildProbe;
+  double origin[3] = { 0, 0, -50.0 };
+  cutter->Cut(origin, normal);
+  buildProbe.Start();
+  cutter->Cut(origin, normal);
+  buildProbe.Stop();
+
+  itk::TimeProbe cutterProbe;
+  itk::TimeProbe referenceProbe;
+  for (unsigned int i = 0; i < numberOfSlices; ++i)
+  {
+    origin[2] = -50.0 + 100.0 * (i + 0.5) / numberOfSlices;
+
+    cutterProbe.Start();
+    cutter->Cut(origin, normal);
+    cutterProbe.Stop();
+
+    plane->SetOrigin(origin);
+    plane->SetNormal(const_cast<double*>(normal));
+    referenceProbe.Start();
+    reference->Update();
+    referenceProbe.Stop();
+  }
+
+  MITK_INFO << polydata->GetNumberOfCells() << " triangles: index built in " << buildProbe.GetTotal() << "s, "
+            << cutterProbe.GetMean() << "s per cut with index, " << referenceProbe.GetMean() << "s per cut with vtkCutter";
+
+  reference->Delete();
+  plane->Delete();
+  polydata->Delete();
+}
+
+}
+
+/**
+ * Compares the contours of PolyDataPlaneCutter to vtkCutter and times the cuts of spheres of increasing size.
+ */
+int mitkPolyDataPlaneCutterTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("PolyDataPlaneCutter")
+
+  vtkPolyData* sphere = CreateSphere(60);
+  TestCutMatchesVtkCutter(sphere);
+  sphere->Delete();
+
+  BenchmarkCuts(50);
+  BenchmarkCuts(200);
+  BenchmarkCuts(700);
+
+  MITK_TEST_END()
+}
@@ -18,7 +18,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkProperties.h"
 #include "mitkLookupTables.h"
 #include "mitkStringProperty.h"
+#include "mitkPropertyKey.h"
+#include <itkTimeProbe.h>
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 
 int mitkPropertyListTest(int /*argc*/, char* /*argv*/[])
 {
@@ -236,6 +240,81 @@ int mitkPropertyListTest(int /*argc*/, char* /*argv*/[])
     }
   }
 
+  {
+    std::cout << "Testing GetProperty(PropertyKey) after SetProperty/ReplaceProperty/DeleteProperty: ";
+    mitk::PropertyKey testKey("test");
+    mitk::PropertyKey unknownKey("interned but never set");
+    mitk::IntProperty::Pointer prop = mitk::IntProperty::New(42);
+    propList->ReplaceProperty("test", prop);
+    bool ok = propList->GetProperty(testKey) == prop.GetPointer()
+           && propList->GetProperty(unknownKey) == NULL
+           && testKey == mitk::PropertyKey(std::string("test"))
+           && testKey.GetName() == "test";
+    int v = 0;
+    ok = ok && propList->GetIntProperty(testKey, v) && v == 42;
+    bool bv = false;
+    ok = ok && !propList->GetBoolProperty(testKey, bv);
+    mitk::PropertyList::Pointer clonedList = propList->Clone();
+    ok = ok && clonedList->GetProperty(testKey) != NULL && clonedList->GetProperty(testKey) != prop.GetPointer();
+    propList->DeleteProperty("test");
+    ok = ok && propList->GetProperty(testKey) == NULL && clonedList->GetIntProperty(testKey, v) && v == 42;
+    if (ok)
+      std::cout << "[PASSED]" << std::endl;
+    else
+    {
+      std::cout << "[FAILED]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  {
+    // micro-benchmark: a list with as many properties as a typical image node
+    mitk::PropertyList::Pointer list = mitk::PropertyList::New();
+    std::vector<std::string> names;
+    for (int i = 0; i < 60; ++i)
+    {
+      std::ostringstream name;
+      name << "benchmark property " << i;
+      names.push_back(name.str());
+      list->SetBoolProperty(name.str().c_str(), i % 2 == 0);
+    }
+    std::vector<mitk::PropertyKey> keys;
+    for (unsigned int i = 0; i < names.size(); ++i)
+      keys.push_back(mitk::PropertyKey(names[i]));
+
+    const unsigned int repetitions = 20000;
+    unsigned int stringHits = 0, keyHits = 0;
+    bool value = false;
+
+    itk::TimeProbe stringClock;
+    stringClock.Start();
+    for (unsigned int r = 0; r < repetitions; ++r)
+      for (unsigned int i = 0; i < names.size(); ++i)
+        if (list->GetBoolProperty(names[i].c_str(), value) && value)
+          ++stringHits;
+    stringClock.Stop();
+
+    itk::TimeProbe keyClock;
+    keyClock.Start();
+    for (unsigned int r = 0; r < repetitions; ++r)
+      for (unsigned int i = 0; i < keys.size(); ++i)
+        if (list->GetBoolProperty(keys[i], value) && value)
+          ++keyHits;
+    keyClock.Stop();
+
+    double lookups = static_cast<double>(repetitions) * names.size();
+    std::cout << "String key lookups per second: " << lookups / std::max(stringClock.GetTotal(), 1e-9) << std::endl;
+    std::cout << "Interned key lookups per second: " << lookups / std::max(keyClock.GetTotal(), 1e-9) << std::endl;
+
+    std::cout << "Testing interned and string lookups agree: ";
+    if (stringHits == keyHits && keyHits == repetitions * names.size() / 2)
+      std::cout << "[PASSED]" << std::endl;
+    else
+    {
+      std::cout << "[FAILED]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   std::cout << "[TEST DONE]" << std::endl;
   return EXIT_SUCCESS;
 }
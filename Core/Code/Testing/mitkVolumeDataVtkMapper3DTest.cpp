@@ -0,0 +1,135 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+//MITK
+#include "mitkTestingMacros.h"
+#include "mitkRenderingTestHelper.h"
+#include "mitkVolumeDataVtkMapper3D.h"
+#include "mitkImageWriteAccessor.h"
+#include "mitkRenderingManager.h"
+
+#include <itkTimeProbe.h>
+
+#include <cmath>
+
+namespace {
+
+/** A ball of varying intensity in the middle of an empty volume, as a segmented organ or a CT without air */
+mitk::Image::Pointer CreateBallImage(unsigned int size)
+{
+  unsigned int dim[3] = { size, size, size };
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize(mitk::MakeScalarPixelType<unsigned short>(), 3, dim);
+
+  mitk::ImageWriteAccessor accessor(image);
+  unsigned short* data = static_cast<unsigned short*>(accessor.GetData());
+  const double center = 0.5 * size;
+  const double radius = 0.3 * size;
+  for (unsigned int z = 0; z < size; ++z)
+  {
+    for (unsigned int y = 0; y < size; ++y)
+    {
+      for (unsigned int x = 0; x < size; ++x)
+      {
+        double dx = x - center;
+        double dy = y - center;
+        double dz = z - center;
+        double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        *data++ = distance < radius ? static_cast<unsigned short>(100 + (x + y + z) % 155) : 0;
+      }
+    }
+  }
+  return image;
+}
+
+/** Renders numberOfFrames frames and returns the mean time of a frame */
+double MeasureFrameTime(mitk::RenderingTestHelper& renderingHelper, unsigned int numberOfFrames)
+{
+  itk::TimeProbe probe;
+  for (unsigned int i = 0; i < numberOfFrames; ++i)
+  {
+    probe.Start();
+    renderingHelper.Render();
+    probe.Stop();
+  }
+  return probe.GetMean();
+}
+
+void BenchmarkMapper(mitk::RenderingTestHelper& renderingHelper, mitk::DataNode* node, bool fixedPoint)
+{
+  const unsigned int numberOfFrames = 5;
+  mitk::BaseRenderer* renderer = mitk::BaseRenderer::GetInstance(renderingHelper.GetVtkRenderWindow());
+  node->SetBoolProperty("volumerendering.usefixedpoint", fixedPoint);
+
+  // the first frame creates the gradients and, for the fixed point mapper, the min/max volume
+  node->SetBoolProperty("volumerendering.uselod", false);
+  itk::TimeProbe firstFrameProbe;
+  firstFrameProbe.Start();
+  renderingHelper.Render();
+  firstFrameProbe.Stop();
+  MITK_TEST_CONDITION(renderer->GetNumberOfVisibleLODEnabledMappers() == 0, "Mapper is not LOD enabled without volumerendering.uselod")
+
+  double stillFrameTime = MeasureFrameTime(renderingHelper, numberOfFrames);
+
+  // without a pending high resolution request, the rendering manager renders LOD 0 as while interacting
+  node->SetBoolProperty("volumerendering.uselod", true);
+  double interactiveFrameTime = MeasureFrameTime(renderingHelper, numberOfFrames);
+  MITK_TEST_CONDITION(renderer->GetNumberOfVisibleLODEnabledMappers() == 1, "Mapper is LOD enabled with volumerendering.uselod")
+  MITK_TEST_CONDITION(mitk::RenderingManager::GetInstance()->GetNextLOD(renderer) == 0, "Interaction renders LOD 0")
+
+  // after the interaction, the rendering manager refines the rendering with LOD 1
+  mitk::RenderingManager::GetInstance()->ExecutePendingHighResRenderingRequest();
+  MITK_TEST_CONDITION(mitk::RenderingManager::GetInstance()->GetNextLOD(renderer) == 1, "High resolution request renders LOD 1")
+  itk::TimeProbe refinementProbe;
+  refinementProbe.Start();
+  renderingHelper.Render();
+  refinementProbe.Stop();
+  MITK_TEST_CONDITION(mitk::RenderingManager::GetInstance()->GetNextLOD(renderer) == 0, "Next interaction renders LOD 0 again")
+
+  MITK_INFO << (fixedPoint ? "vtkFixedPointVolumeRayCastMapper: " : "vtkVolumeRayCastMapper: ")
+            << firstFrameProbe.GetTotal() << "s first frame, "
+            << stillFrameTime << "s per still frame (" << 1.0 / stillFrameTime << " fps), "
+            << interactiveFrameTime << "s per interactive frame (" << 1.0 / interactiveFrameTime << " fps), "
+            << refinementProbe.GetTotal() << "s refinement";
+}
+
+}
+
+/**
+ * Renders a synthetic volume with the ray cast and the fixed point mapper of VolumeDataVtkMapper3D,
+ * checks the LOD switching of the RenderingManager and reports the frame times of both mappers.
+ */
+int mitkVolumeDataVtkMapper3DTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("mitkVolumeDataVtkMapper3DTest")
+
+  mitk::RenderingTestHelper renderingHelper(640, 480);
+  renderingHelper.SetMapperIDToRender3D();
+
+  mitk::DataNode::Pointer node = mitk::DataNode::New();
+  node->SetData(CreateBallImage(256));
+  mitk::VolumeDataVtkMapper3D::SetDefaultProperties(node);
+  node->SetBoolProperty("volumerendering", true);
+  renderingHelper.AddNodeToStorage(node);
+
+  MITK_TEST_CONDITION_REQUIRED(dynamic_cast<mitk::VolumeDataVtkMapper3D*>(node->GetMapper(mitk::BaseRenderer::Standard3D)) != NULL,
+                               "Image is rendered by a VolumeDataVtkMapper3D")
+
+  BenchmarkMapper(renderingHelper, node, false);
+  BenchmarkMapper(renderingHelper, node, true);
+
+  MITK_TEST_END();
+}
@@ -0,0 +1,212 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+//MITK
+#include "mitkTestingMacros.h"
+#include "mitkRenderingTestHelper.h"
+#include "mitkVtkPropRenderer.h"
+#include "mitkVolumeDataVtkMapper3D.h"
+#include "mitkSurface.h"
+#include "mitkProperties.h"
+
+//VTK
+#include <vtkSphereSource.h>
+#include <vtkSmartPointer.h>
+
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+mitk::DataNode::Pointer CreateSphereNode(const std::string& name, int layer)
+{
+  vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetRadius(10.0 + layer);
+  sphere->Update();
+
+  mitk::Surface::Pointer surface = mitk::Surface::New();
+  surface->SetVtkPolyData(sphere->GetOutput());
+
+  mitk::DataNode::Pointer node = mitk::DataNode::New();
+  node->SetData(surface);
+  node->SetName(name);
+  node->SetIntProperty("layer", layer);
+  return node;
+}
+
+mitk::DataNode::Pointer CreateImageNode()
+{
+  unsigned int dim[3] = { 16, 16, 16 };
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 3, dim);
+
+  mitk::DataNode::Pointer node = mitk::DataNode::New();
+  node->SetData(image);
+  node->SetName("image");
+  mitk::VolumeDataVtkMapper3D::SetDefaultProperties(node);
+  node->SetBoolProperty("volumerendering", false);
+  node->SetBoolProperty("volumerendering.uselod", true);
+  return node;
+}
+
+/** The mappers in the order PrepareMapperQueue() sorted them from GetAll() for every frame before the queue was cached */
+std::vector<mitk::Mapper*> ComputeMapperOrder(mitk::DataStorage* storage, mitk::BaseRenderer* renderer)
+{
+  std::multimap<int, mitk::Mapper*> mappersByLayer;
+  mitk::DataStorage::SetOfObjects::ConstPointer allObjects = storage->GetAll();
+  for (mitk::DataStorage::SetOfObjects::ConstIterator it = allObjects->Begin(); it != allObjects->End(); ++it)
+  {
+    mitk::DataNode* node = it->Value();
+    if (node == NULL)
+      continue;
+
+    mitk::Mapper* mapper = node->GetMapper(renderer->GetMapperID());
+    if (mapper == NULL)
+      continue;
+
+    int layer = 1;
+    node->GetIntProperty("layer", layer, renderer);
+    mappersByLayer.insert(std::make_pair(layer, mapper));
+  }
+
+  std::vector<mitk::Mapper*> mappers;
+  for (std::multimap<int, mitk::Mapper*>::const_iterator it = mappersByLayer.begin(); it != mappersByLayer.end(); ++it)
+    mappers.push_back(it->second);
+  return mappers;
+}
+
+std::vector<mitk::Mapper*> GetMapperOrder(mitk::VtkPropRenderer* renderer)
+{
+  std::vector<mitk::Mapper*> mappers;
+  const mitk::VtkPropRenderer::MappersMapType& mappersMap = renderer->GetMappersMap();
+  for (mitk::VtkPropRenderer::MappersMapType::const_iterator it = mappersMap.begin(); it != mappersMap.end(); ++it)
+    mappers.push_back(it->second);
+  return mappers;
+}
+
+unsigned int CountVisibleLODEnabledMappers(mitk::DataStorage* storage, mitk::BaseRenderer* renderer)
+{
+  unsigned int count = 0;
+  mitk::DataStorage::SetOfObjects::ConstPointer allObjects = storage->GetAll();
+  for (mitk::DataStorage::SetOfObjects::ConstIterator it = allObjects->Begin(); it != allObjects->End(); ++it)
+  {
+    mitk::Mapper* mapper = it->Value()->GetMapper(renderer->GetMapperID());
+    bool visible = true;
+    it->Value()->GetVisibility(visible, renderer);
+    if (mapper != NULL && visible && mapper->IsLODEnabled(renderer))
+      ++count;
+  }
+  return count;
+}
+
+void CheckMapperQueue(mitk::RenderingTestHelper& renderingHelper, mitk::VtkPropRenderer* renderer, const std::string& step)
+{
+  renderingHelper.Render();
+
+  MITK_TEST_CONDITION(GetMapperOrder(renderer) == ComputeMapperOrder(renderingHelper.GetDataStorage(), renderer),
+                      "Cached mapper queue equals the queue built from the DataStorage " << step)
+  MITK_TEST_CONDITION(renderer->GetNumberOfVisibleLODEnabledMappers() == CountVisibleLODEnabledMappers(renderingHelper.GetDataStorage(), renderer),
+                      "Number of visible LOD enabled mappers is up to date " << step)
+}
+
+}
+
+/**
+ * Changes the DataStorage and the properties of its nodes between frames and checks that the mapper
+ * queue cached by VtkPropRenderer always equals the queue built from scratch.
+ */
+int mitkVtkPropRendererMapperQueueTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("mitkVtkPropRendererMapperQueueTest")
+
+  mitk::RenderingTestHelper renderingHelper(640, 480);
+  renderingHelper.SetMapperIDToRender3D();
+
+  mitk::VtkPropRenderer* renderer = dynamic_cast<mitk::VtkPropRenderer*>(mitk::BaseRenderer::GetInstance(renderingHelper.GetVtkRenderWindow()));
+  MITK_TEST_CONDITION_REQUIRED(renderer != NULL, "Render window is rendered by a VtkPropRenderer")
+
+  std::vector<mitk::DataNode::Pointer> spheres;
+  for (int i = 0; i < 8; ++i)
+  {
+    std::ostringstream name;
+    name << "sphere" << i;
+    spheres.push_back(CreateSphereNode(name.str(), i % 3));
+    renderingHelper.AddNodeToStorage(spheres.back());
+  }
+  CheckMapperQueue(renderingHelper, renderer, "after the initial rebuild");
+
+  // nodes added after the rebuild are inserted incrementally
+  for (int i = 8; i < 16; ++i)
+  {
+    std::ostringstream name;
+    name << "sphere" << i;
+    spheres.push_back(CreateSphereNode(name.str(), i % 3));
+    renderingHelper.AddNodeToStorage(spheres.back());
+    CheckMapperQueue(renderingHelper, renderer, "after adding " + name.str());
+  }
+
+  // several nodes added between two frames are inserted at once
+  for (int i = 16; i < 24; ++i)
+  {
+    std::ostringstream name;
+    name << "sphere" << i;
+    spheres.push_back(CreateSphereNode(name.str(), i % 5));
+    renderingHelper.AddNodeToStorage(spheres.back());
+  }
+  CheckMapperQueue(renderingHelper, renderer, "after adding several nodes at once");
+
+  renderingHelper.GetDataStorage()->Remove(spheres[3]);
+  renderingHelper.GetDataStorage()->Remove(spheres[12]);
+  CheckMapperQueue(renderingHelper, renderer, "after removing nodes");
+
+  // properties changed in place
+  dynamic_cast<mitk::IntProperty*>(spheres[5]->GetProperty("layer"))->SetValue(7);
+  CheckMapperQueue(renderingHelper, renderer, "after changing a layer in place");
+
+  spheres[6]->SetIntProperty("layer", 4);
+  CheckMapperQueue(renderingHelper, renderer, "after replacing a layer property");
+
+  spheres[7]->SetIntProperty("layer", 2, renderer);
+  CheckMapperQueue(renderingHelper, renderer, "after setting a renderer specific layer");
+
+  // LOD state of a volume changed in place
+  mitk::DataNode::Pointer imageNode = CreateImageNode();
+  renderingHelper.AddNodeToStorage(imageNode);
+  CheckMapperQueue(renderingHelper, renderer, "after adding a volume");
+  MITK_TEST_CONDITION(renderer->GetNumberOfVisibleLODEnabledMappers() == 0, "Volume is not LOD enabled without volumerendering")
+
+  dynamic_cast<mitk::BoolProperty*>(imageNode->GetProperty("volumerendering"))->SetValue(true);
+  CheckMapperQueue(renderingHelper, renderer, "after enabling volumerendering in place");
+  MITK_TEST_CONDITION(renderer->GetNumberOfVisibleLODEnabledMappers() == 1, "Volume is LOD enabled after enabling volumerendering in place")
+
+  dynamic_cast<mitk::BoolProperty*>(imageNode->GetProperty("volumerendering.uselod"))->SetValue(false);
+  CheckMapperQueue(renderingHelper, renderer, "after disabling volumerendering.uselod in place");
+  MITK_TEST_CONDITION(renderer->GetNumberOfVisibleLODEnabledMappers() == 0, "Volume is not LOD enabled after disabling volumerendering.uselod in place")
+
+  dynamic_cast<mitk::BoolProperty*>(imageNode->GetProperty("volumerendering.uselod"))->SetValue(true);
+  imageNode->SetVisibility(false);
+  CheckMapperQueue(renderingHelper, renderer, "after hiding the volume");
+  MITK_TEST_CONDITION(renderer->GetNumberOfVisibleLODEnabledMappers() == 0, "Hidden volume is not counted as LOD enabled")
+
+  // mapper slot change rebuilds the queue
+  renderingHelper.SetMapperIDToRender2D();
+  CheckMapperQueue(renderingHelper, renderer, "after switching to 2D");
+  renderingHelper.SetMapperIDToRender3D();
+  CheckMapperQueue(renderingHelper, renderer, "after switching back to 3D");
+
+  MITK_TEST_END();
+}
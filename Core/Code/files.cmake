@@ -94,6 +94,7 @@ set(CPP_FILES
   Algorithms/mitkUIDGenerator.cpp
   Algorithms/mitkVolumeCalculator.cpp
   Algorithms/mitkClippedSurfaceBoundsCalculator.cpp
+  Algorithms/mitkPolyDataPlaneCutter.cpp
   Algorithms/mitkExtractSliceFilter.cpp
   Algorithms/mitkConvert2Dto3DImageFilter.cpp
 
@@ -180,6 +181,7 @@ set(CPP_FILES
   DataManagement/mitkPointOperation.cpp
   DataManagement/mitkPointSet.cpp
   DataManagement/mitkProperties.cpp
+  DataManagement/mitkPropertyKey.cpp
   DataManagement/mitkPropertyList.cpp
   DataManagement/mitkRestorePlanePositionOperation.cpp
   DataManagement/mitkRotationOperation.cpp
@@ -357,6 +359,7 @@ set(CPP_FILES
   Common/mitkCoreObjectFactoryBase.cpp
   Common/mitkCoreObjectFactory.cpp
   Common/mitkCoreServices.cpp
+  Common/mitkNotificationBatch.cpp
 )
 
 list(APPEND CPP_FILES ${CppMicroServices_SOURCES})
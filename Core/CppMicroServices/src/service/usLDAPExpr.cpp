@@ -213,27 +213,19 @@ bool LDAPExpr::GetMatchedObjectClasses(ObjectClassSet& objClasses) const
         {
           // if AND op and classes in several operands,
           // then only the intersection is possible.
-          LDAPExpr::ObjectClassSet::iterator it1 = objClasses.begin();
-          LDAPExpr::ObjectClassSet::iterator it2 = r.begin();
-          while ( (it1 != objClasses.end()) && (it2 != r.end()) )
+          // (the sets are unordered, so look each class up)
+          for (LDAPExpr::ObjectClassSet::iterator it = objClasses.begin();
+               it != objClasses.end(); )
           {
-            if (*it1 < *it2)
+            if (r.find(*it) == r.end())
             {
-              objClasses.erase(it1++);
-            }
-            else if (*it2 < *it1)
-            {
-              ++it2;
+              objClasses.erase(it++);
             }
             else
-            { // *it1 == *it2
-              ++it1;
-              ++it2;
+            {
+              ++it;
             }
           }
-          // Anything left in set_1 from here on did not appear in set_2,
-          // so we remove it.
-          objClasses.erase(it1, objClasses.end());
         }
       }
     }
@@ -259,6 +251,24 @@ bool LDAPExpr::GetMatchedObjectClasses(ObjectClassSet& objClasses) const
   return false;
 }
 
+void LDAPExpr::GetRequiredEqualities(EqualityList& equalities) const
+{
+  if (d->m_operator == EQ)
+  {
+    if (d->m_attrValue.find(WILDCARD) == std::string::npos)
+    {
+      equalities.push_back(std::make_pair(ToLower(d->m_attrName), d->m_attrValue));
+    }
+  }
+  else if (d->m_operator == AND)
+  {
+    for (std::size_t i = 0; i < d->m_args.size(); i++)
+    {
+      d->m_args[i].GetRequiredEqualities(equalities);
+    }
+  }
+}
+
 std::string LDAPExpr::ToLower(const std::string& str)
 {
   std::string lowerStr(str);
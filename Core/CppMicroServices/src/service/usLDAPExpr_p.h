@@ -57,6 +57,7 @@ public:
   typedef std::vector<std::string> StringList;
   typedef std::vector<StringList> LocalCache;
   typedef US_UNORDERED_SET_TYPE<std::string> ObjectClassSet;
+  typedef std::vector<std::pair<std::string, std::string> > EqualityList;
 
 
   /**
@@ -83,6 +84,16 @@ public:
    */
   bool GetMatchedObjectClasses(ObjectClassSet& objClasses) const;
 
+  /**
+   * Get the equality terms which every matching set of properties must satisfy.
+   * These are the terms <code>(<it>name</it>=<it>value</it>)</code> without
+   * wildcards which are either the expression itself or (recursively) an
+   * operand of an AND expression.
+   *
+   * \param equalities Pairs of lower case attribute names and values will be added to equalities.
+   */
+  void GetRequiredEqualities(EqualityList& equalities) const;
+
   /**
    * Checks if this LDAP expression is "simple". The definition of
    * a simple filter is:
@@ -42,7 +42,7 @@ ServiceListeners::ServiceListeners()
 void ServiceListeners::AddServiceListener(ModuleContext* mc, const ServiceListenerEntry::ServiceListener& listener,
                                           void* data, const std::string& filter)
 {
-  MutexLocker lock(mutex);
+  WriteLocker lock(rwLock);
 
   ServiceListenerEntry sle(mc->GetModule(), listener, data, filter);
   if (serviceSet.find(sle) != serviceSet.end())
@@ -58,7 +58,7 @@ void ServiceListeners::RemoveServiceListener(ModuleContext* mc, const ServiceLis
 {
   ServiceListenerEntry entryToRemove(mc->GetModule(), listener, data);
 
-  MutexLocker lock(mutex);
+  WriteLocker lock(rwLock);
   RemoveServiceListener_unlocked(entryToRemove);
 }
 
@@ -110,7 +110,7 @@ void ServiceListeners::ModuleChanged(const ModuleEvent& evt)
 void ServiceListeners::RemoveAllListeners(ModuleContext* mc)
 {
   {
-    MutexLocker lock(mutex);
+    WriteLocker lock(rwLock);
     for (ServiceListenerEntries::iterator it = serviceSet.begin();
          it != serviceSet.end(); )
     {
@@ -178,7 +178,10 @@ void ServiceListeners::ServiceChanged(const ServiceListenerEntries& receivers,
 void ServiceListeners::GetMatchingServiceListeners(const ServiceReferenceBase& sr, ServiceListenerEntries& set,
                                                    bool lockProps)
 {
-  MutexLocker lock(mutex);
+  ReadLocker lock(rwLock);
+
+  const std::vector<std::string> c(any_cast<std::vector<std::string> >
+                                 (sr.d->GetProperty(ServiceConstants::OBJECTCLASS(), lockProps)));
 
   // Check complicated or empty listener filters
   int n = 0;
@@ -194,12 +197,30 @@ void ServiceListeners::GetMatchingServiceListeners(const ServiceReferenceBase& s
     }
   }
 
+  // Check complicated listener filters which require one of the object classes
+  // of the service
+  for (std::vector<std::string>::const_iterator objClass = c.begin();
+       objClass != c.end(); ++objClass)
+  {
+    CacheType::const_iterator sles = objectClassListeners.find(*objClass);
+    if (sles == objectClassListeners.end()) continue;
+
+    for (std::list<ServiceListenerEntry>::const_iterator sse = sles->second.begin();
+         sse != sles->second.end(); ++sse)
+    {
+      ++n;
+      if (set.find(*sse) == set.end() &&
+          sse->GetLDAPExpr().Evaluate(sr.d->GetProperties(), false))
+      {
+        set.insert(*sse);
+      }
+    }
+  }
+
   //US_DEBUG << "Added " << set.size() << " out of " << n
   //         << " listeners with complicated filters";
 
   // Check the cache
-  const std::vector<std::string> c(any_cast<std::vector<std::string> >
-                                 (sr.d->GetProperty(ServiceConstants::OBJECTCLASS(), lockProps)));
   for (std::vector<std::string>::const_iterator objClass = c.begin();
        objClass != c.end(); ++objClass)
   {
@@ -234,7 +255,26 @@ void ServiceListeners::RemoveFromCache(const ServiceListenerEntry& sle)
   }
   else
   {
-    complicatedListeners.remove(sle);
+    LDAPExpr::ObjectClassSet objectClasses;
+    if (!sle.GetLDAPExpr().IsNull() &&
+        sle.GetLDAPExpr().GetMatchedObjectClasses(objectClasses) && !objectClasses.empty())
+    {
+      for (LDAPExpr::ObjectClassSet::const_iterator objClass = objectClasses.begin();
+           objClass != objectClasses.end(); ++objClass)
+      {
+        CacheType::iterator sles = objectClassListeners.find(*objClass);
+        if (sles == objectClassListeners.end()) continue;
+        sles->second.remove(sle);
+        if (sles->second.empty())
+        {
+          objectClassListeners.erase(sles);
+        }
+      }
+    }
+    else
+    {
+      complicatedListeners.remove(sle);
+    }
   }
 }
 
@@ -262,17 +302,30 @@ void ServiceListeners::RemoveFromCache(const ServiceListenerEntry& sle)
      else
      {
        //US_DEBUG << "Too complicated filter: " << sle.GetFilter();
-       complicatedListeners.push_back(sle);
+       LDAPExpr::ObjectClassSet objectClasses;
+       if (sle.GetLDAPExpr().GetMatchedObjectClasses(objectClasses) && !objectClasses.empty())
+       {
+         for (LDAPExpr::ObjectClassSet::const_iterator objClass = objectClasses.begin();
+              objClass != objectClasses.end(); ++objClass)
+         {
+           objectClassListeners[*objClass].push_back(sle);
+         }
+       }
+       else
+       {
+         complicatedListeners.push_back(sle);
+       }
      }
    }
  }
 
 void ServiceListeners::AddToSet(ServiceListenerEntries& set,
-                                int cache_ix, const std::string& val)
+                                int cache_ix, const std::string& val) const
 {
-  std::list<ServiceListenerEntry>& l = cache[cache_ix][val];
-  if (!l.empty())
+  CacheType::const_iterator iter = cache[cache_ix].find(val);
+  if (iter != cache[cache_ix].end())
   {
+    const std::list<ServiceListenerEntry>& l = iter->second;
     //US_DEBUG << hashedServiceKeys[cache_ix] << " matches " << l.size();
 
     for (std::list<ServiceListenerEntry>::const_iterator entry = l.begin();
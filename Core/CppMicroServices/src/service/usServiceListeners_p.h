@@ -66,12 +66,18 @@ private:
   /* Service listeners with complicated or empty filters */
   std::list<ServiceListenerEntry> complicatedListeners;
 
+  /* Service listeners with complicated filters which can only match services
+   * of certain object classes, by object class. */
+  CacheType objectClassListeners;
+
   /* Service listeners with "simple" filters are cached. */
   CacheType cache[2];
 
   ServiceListenerEntries serviceSet;
 
-  MutexType mutex;
+  /* Guards the service listener entries and caches. Dispatching events
+   * only reads them. */
+  ReadWriteLock rwLock;
 
 public:
 
@@ -167,7 +173,7 @@ private:
    */
   void CheckSimple(const ServiceListenerEntry& sle);
 
-  void AddToSet(ServiceListenerEntries& set, int cache_ix, const std::string& val);
+  void AddToSet(ServiceListenerEntries& set, int cache_ix, const std::string& val) const;
 
 };
 
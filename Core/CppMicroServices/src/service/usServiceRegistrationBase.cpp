@@ -124,7 +124,9 @@ void ServiceRegistrationBase::SetProperties(const ServiceProperties& props)
         d->module->coreCtx->listeners.GetMatchingServiceListeners(d->reference, before, false);
         classes = ref_any_cast<std::vector<std::string> >(d->properties.Value(ServiceConstants::OBJECTCLASS()));
         long int sid = any_cast<long int>(d->properties.Value(ServiceConstants::SERVICE_ID()));
+        const ServicePropertiesImpl oldProperties = d->properties;
         d->properties = ServiceRegistry::CreateServiceProperties(props, classes, false, false, sid);
+        d->module->coreCtx->services.UpdatePropertyIndices(*this, oldProperties);
 
         {
           const Any& any = d->properties.Value(ServiceConstants::SERVICE_RANKING());
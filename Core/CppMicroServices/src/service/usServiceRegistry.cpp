@@ -21,7 +21,9 @@
 
 #include <usConfig.h>
 
+#include <algorithm>
 #include <iterator>
+#include <list>
 #include <stdexcept>
 
 #include "usServiceRegistry_p.h"
@@ -35,7 +37,12 @@
 
 US_BEGIN_NAMESPACE
 
-typedef MutexLock<ServiceRegistry::MutexType> MutexLocker;
+typedef MutexLock<Mutex> MutexLocker;
+
+// The number of parsed filters kept in the filter cache. Filters are usually
+// literals in client code, so a small cache covers them. The cache is
+// dropped when full, to stay bounded for filters built from varying values.
+static const std::size_t MaxCachedFilters = 256;
 
 
 ServicePropertiesImpl ServiceRegistry::CreateServiceProperties(const ServiceProperties& in,
@@ -85,6 +92,11 @@ void ServiceRegistry::Clear()
   services.clear();
   serviceRegistrations.clear();
   classServices.clear();
+  propertyIndices.clear();
+  {
+    MutexLocker lock(filterCacheMutex);
+    filterCache.clear();
+  }
   core = 0;
 }
 
@@ -116,7 +128,7 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
   ServiceRegistrationBase res(module, service,
                               CreateServiceProperties(properties, classes, isFactory, isPrototypeFactory));
   {
-    MutexLocker lock(mutex);
+    WriteLocker lock(rwLock);
     services.insert(std::make_pair(res, classes));
     serviceRegistrations.push_back(res);
     for (std::vector<std::string>::const_iterator i = classes.begin();
@@ -127,6 +139,11 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
           std::lower_bound(s.begin(), s.end(), res);
       s.insert(ip, res);
     }
+    for (PropertyIndexMap::iterator i = propertyIndices.begin();
+         i != propertyIndices.end(); ++i)
+    {
+      AddToPropertyIndex(i->second, i->first, res, res.d->properties);
+    }
   }
 
   ServiceReferenceBase r = res.GetReference(std::string());
@@ -140,7 +157,7 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
 void ServiceRegistry::UpdateServiceRegistrationOrder(const ServiceRegistrationBase& sr,
                                                      const std::vector<std::string>& classes)
 {
-  MutexLocker lock(mutex);
+  WriteLocker lock(rwLock);
   for (std::vector<std::string>::const_iterator i = classes.begin();
        i != classes.end(); ++i)
   {
@@ -153,7 +170,7 @@ void ServiceRegistry::UpdateServiceRegistrationOrder(const ServiceRegistrationBa
 void ServiceRegistry::Get(const std::string& clazz,
                           std::vector<ServiceRegistrationBase>& serviceRegs) const
 {
-  MutexLocker lock(mutex);
+  ReadLocker lock(rwLock);
   MapClassServices::const_iterator i = classServices.find(clazz);
   if (i != classServices.end())
   {
@@ -163,11 +180,11 @@ void ServiceRegistry::Get(const std::string& clazz,
 
 ServiceReferenceBase ServiceRegistry::Get(ModulePrivate* module, const std::string& clazz) const
 {
-  MutexLocker lock(mutex);
+  ReadLocker lock(rwLock);
   try
   {
     std::vector<ServiceReferenceBase> srs;
-    Get_unlocked(clazz, "", module, srs);
+    Get_unlocked(clazz, LDAPExpr(), module, srs);
     US_DEBUG << "get service ref " << clazz << " for module "
              << module->info.name << " = " << srs.size() << " refs";
 
@@ -185,22 +202,221 @@ ServiceReferenceBase ServiceRegistry::Get(ModulePrivate* module, const std::stri
 void ServiceRegistry::Get(const std::string& clazz, const std::string& filter,
                           ModulePrivate* module, std::vector<ServiceReferenceBase>& res) const
 {
-  MutexLocker lock(mutex);
-  Get_unlocked(clazz, filter, module, res);
+  LDAPExpr ldap;
+  if (!filter.empty())
+  {
+    ldap = GetCompiledFilter(filter);
+    CreatePropertyIndices(ldap);
+  }
+
+  ReadLocker lock(rwLock);
+  Get_unlocked(clazz, ldap, module, res);
+}
+
+LDAPExpr ServiceRegistry::GetCompiledFilter(const std::string& filter) const
+{
+  {
+    MutexLocker lock(filterCacheMutex);
+    FilterCacheType::const_iterator iter = filterCache.find(filter);
+    if (iter != filterCache.end())
+    {
+      return iter->second;
+    }
+  }
+
+  // Throws std::invalid_argument for malformed filters, which are not cached
+  LDAPExpr ldap(filter);
+
+  MutexLocker lock(filterCacheMutex);
+  if (filterCache.size() >= MaxCachedFilters)
+  {
+    filterCache.clear();
+  }
+  filterCache.insert(std::make_pair(filter, ldap));
+  return ldap;
+}
+
+void ServiceRegistry::CreatePropertyIndices(const LDAPExpr& ldap) const
+{
+  LDAPExpr::EqualityList equalities;
+  ldap.GetRequiredEqualities(equalities);
+
+  std::vector<std::string> missing;
+  {
+    ReadLocker lock(rwLock);
+    for (LDAPExpr::EqualityList::const_iterator i = equalities.begin();
+         i != equalities.end(); ++i)
+    {
+      // object classes are already indexed by classServices
+      if (i->first != ServiceConstants::OBJECTCLASS() &&
+          propertyIndices.find(i->first) == propertyIndices.end())
+      {
+        missing.push_back(i->first);
+      }
+    }
+  }
+  if (missing.empty()) return;
+
+  WriteLocker lock(rwLock);
+  for (std::vector<std::string>::const_iterator key = missing.begin();
+       key != missing.end(); ++key)
+  {
+    if (propertyIndices.find(*key) != propertyIndices.end()) continue;
+
+    PropertyIndex& index = propertyIndices[*key];
+    for (std::vector<ServiceRegistrationBase>::const_iterator sr = serviceRegistrations.begin();
+         sr != serviceRegistrations.end(); ++sr)
+    {
+      AddToPropertyIndex(index, *key, *sr, sr->d->properties);
+    }
+  }
+}
+
+bool ServiceRegistry::GetIndexedCandidates_unlocked(const LDAPExpr& ldap, std::size_t maxCandidates,
+                                                    std::vector<ServiceRegistrationBase>& candidates) const
+{
+  LDAPExpr::EqualityList equalities;
+  ldap.GetRequiredEqualities(equalities);
+
+  const PropertyIndex* bestIndex = NULL;
+  const std::vector<ServiceRegistrationBase>* bestValues = NULL;
+  std::size_t bestSize = maxCandidates;
+  for (LDAPExpr::EqualityList::const_iterator i = equalities.begin();
+       i != equalities.end(); ++i)
+  {
+    PropertyIndexMap::const_iterator index = propertyIndices.find(i->first);
+    if (index == propertyIndices.end()) continue;
+
+    US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> >::const_iterator values =
+        index->second.values.find(i->second);
+    std::size_t size = index->second.unindexed.size();
+    if (values != index->second.values.end())
+    {
+      size += values->second.size();
+    }
+    if (size < bestSize)
+    {
+      bestIndex = &index->second;
+      bestValues = values != index->second.values.end() ? &values->second : NULL;
+      bestSize = size;
+    }
+  }
+
+  if (bestIndex == NULL) return false;
+
+  candidates.clear();
+  candidates.reserve(bestSize);
+  if (bestValues != NULL)
+  {
+    candidates.insert(candidates.end(), bestValues->begin(), bestValues->end());
+  }
+  candidates.insert(candidates.end(), bestIndex->unindexed.begin(), bestIndex->unindexed.end());
+  std::sort(candidates.begin(), candidates.end());
+  return true;
+}
+
+void ServiceRegistry::AddToPropertyIndex(PropertyIndex& index, const std::string& key,
+                                         const ServiceRegistrationBase& sr, const ServicePropertiesImpl& props)
+{
+  const int i = props.Find(key);
+  if (i < 0) return;
+
+  const Any& value = props.Value(i);
+  const std::type_info& valueType = value.Type();
+  if (valueType == typeid(std::string))
+  {
+    index.values[ref_any_cast<std::string>(value)].push_back(sr);
+  }
+  else if (valueType == typeid(std::vector<std::string>))
+  {
+    const std::vector<std::string>& list = ref_any_cast<std::vector<std::string> >(value);
+    for (std::vector<std::string>::const_iterator iter = list.begin(); iter != list.end(); ++iter)
+    {
+      std::vector<ServiceRegistrationBase>& regs = index.values[*iter];
+      if (std::find(regs.begin(), regs.end(), sr) == regs.end()) regs.push_back(sr);
+    }
+  }
+  else if (valueType == typeid(std::list<std::string>))
+  {
+    const std::list<std::string>& list = ref_any_cast<std::list<std::string> >(value);
+    for (std::list<std::string>::const_iterator iter = list.begin(); iter != list.end(); ++iter)
+    {
+      std::vector<ServiceRegistrationBase>& regs = index.values[*iter];
+      if (std::find(regs.begin(), regs.end(), sr) == regs.end()) regs.push_back(sr);
+    }
+  }
+  else
+  {
+    index.unindexed.push_back(sr);
+  }
 }
 
-void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string& filter,
+void ServiceRegistry::RemoveFromPropertyIndex(PropertyIndex& index, const std::string& key,
+                                              const ServiceRegistrationBase& sr, const ServicePropertiesImpl& props)
+{
+  const int i = props.Find(key);
+  if (i < 0) return;
+
+  std::vector<std::string> values;
+  const Any& value = props.Value(i);
+  const std::type_info& valueType = value.Type();
+  if (valueType == typeid(std::string))
+  {
+    values.push_back(ref_any_cast<std::string>(value));
+  }
+  else if (valueType == typeid(std::vector<std::string>))
+  {
+    values = ref_any_cast<std::vector<std::string> >(value);
+  }
+  else if (valueType == typeid(std::list<std::string>))
+  {
+    const std::list<std::string>& list = ref_any_cast<std::list<std::string> >(value);
+    values.assign(list.begin(), list.end());
+  }
+  else
+  {
+    index.unindexed.erase(std::remove(index.unindexed.begin(), index.unindexed.end(), sr),
+                          index.unindexed.end());
+    return;
+  }
+
+  for (std::vector<std::string>::const_iterator iter = values.begin(); iter != values.end(); ++iter)
+  {
+    US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> >::iterator regs =
+        index.values.find(*iter);
+    if (regs == index.values.end()) continue;
+    regs->second.erase(std::remove(regs->second.begin(), regs->second.end(), sr), regs->second.end());
+    if (regs->second.empty())
+    {
+      index.values.erase(regs);
+    }
+  }
+}
+
+void ServiceRegistry::UpdatePropertyIndices(const ServiceRegistrationBase& sr,
+                                            const ServicePropertiesImpl& oldProperties)
+{
+  WriteLocker lock(rwLock);
+  if (propertyIndices.empty()) return;
+
+  for (PropertyIndexMap::iterator i = propertyIndices.begin();
+       i != propertyIndices.end(); ++i)
+  {
+    RemoveFromPropertyIndex(i->second, i->first, sr, oldProperties);
+    AddToPropertyIndex(i->second, i->first, sr, sr.d->properties);
+  }
+}
+
+void ServiceRegistry::Get_unlocked(const std::string& clazz, const LDAPExpr& ldap,
                           ModulePrivate* /*module*/, std::vector<ServiceReferenceBase>& res) const
 {
   std::vector<ServiceRegistrationBase>::const_iterator s;
   std::vector<ServiceRegistrationBase>::const_iterator send;
   std::vector<ServiceRegistrationBase> v;
-  LDAPExpr ldap;
   if (clazz.empty())
   {
-    if (!filter.empty())
+    if (!ldap.IsNull())
     {
-      ldap = LDAPExpr(filter);
       LDAPExpr::ObjectClassSet matched;
       if (ldap.GetMatchedObjectClasses(matched))
       {
@@ -248,17 +464,39 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
     {
       return;
     }
-    if (!filter.empty())
+  }
+
+  // Narrow the candidates down to the services which can satisfy the most
+  // selective equality term of the filter. The filter is still evaluated.
+  std::vector<ServiceRegistrationBase> indexed;
+  if (!ldap.IsNull() &&
+      GetIndexedCandidates_unlocked(ldap, static_cast<std::size_t>(send - s), indexed))
+  {
+    std::vector<ServiceRegistrationBase> narrowed;
+    for (std::vector<ServiceRegistrationBase>::const_iterator sr = indexed.begin();
+         sr != indexed.end(); ++sr)
     {
-      ldap = LDAPExpr(filter);
+      if (!clazz.empty())
+      {
+        MapServiceClasses::const_iterator classes = services.find(*sr);
+        if (classes == services.end() ||
+            std::find(classes->second.begin(), classes->second.end(), clazz) == classes->second.end())
+        {
+          continue;
+        }
+      }
+      narrowed.push_back(*sr);
     }
+    v.swap(narrowed);
+    s = v.begin();
+    send = v.end();
   }
 
   for (; s != send; ++s)
   {
     ServiceReferenceBase sri = s->GetReference(clazz);
 
-    if (filter.empty() || ldap.Evaluate(s->d->properties, false))
+    if (ldap.IsNull() || ldap.Evaluate(s->d->properties, false))
     {
       res.push_back(sri);
     }
@@ -267,7 +505,7 @@ void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string&
 
 void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& sr)
 {
-  MutexLocker lock(mutex);
+  WriteLocker lock(rwLock);
 
   const std::vector<std::string>& classes = ref_any_cast<std::vector<std::string> >(
         sr.d->properties.Value(ServiceConstants::OBJECTCLASS()));
@@ -287,12 +525,18 @@ void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& s
       classServices.erase(*i);
     }
   }
+
+  for (PropertyIndexMap::iterator i = propertyIndices.begin();
+       i != propertyIndices.end(); ++i)
+  {
+    RemoveFromPropertyIndex(i->second, i->first, sr, sr.d->properties);
+  }
 }
 
 void ServiceRegistry::GetRegisteredByModule(ModulePrivate* p,
                                             std::vector<ServiceRegistrationBase>& res) const
 {
-  MutexLocker lock(mutex);
+  ReadLocker lock(rwLock);
 
   for (std::vector<ServiceRegistrationBase>::const_iterator i = serviceRegistrations.begin();
        i != serviceRegistrations.end(); ++i)
@@ -307,7 +551,7 @@ void ServiceRegistry::GetRegisteredByModule(ModulePrivate* p,
 void ServiceRegistry::GetUsedByModule(Module* p,
                                       std::vector<ServiceRegistrationBase>& res) const
 {
-  MutexLocker lock(mutex);
+  ReadLocker lock(rwLock);
 
   for (std::vector<ServiceRegistrationBase>::const_iterator i = serviceRegistrations.begin();
        i != serviceRegistrations.end(); ++i)
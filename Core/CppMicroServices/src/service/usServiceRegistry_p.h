@@ -25,9 +25,13 @@
 
 #include "usServiceInterface.h"
 #include "usServiceRegistration.h"
+#include "usServicePropertiesImpl_p.h"
+#include "usLDAPExpr_p.h"
 
 #include "usThreads_p.h"
 
+#include <map>
+
 US_BEGIN_NAMESPACE
 
 class CoreModuleContext;
@@ -43,9 +47,11 @@ class ServiceRegistry
 
 public:
 
-  typedef Mutex MutexType;
-
-  mutable MutexType mutex;
+  /**
+   * Guards the maps of registered services and the property indices.
+   * Lookups only read, so they do not serialize against each other.
+   */
+  mutable ReadWriteLock rwLock;
 
   /**
    * Creates a new ServiceProperties object containing <code>in</code>
@@ -146,6 +152,15 @@ public:
   void Get(const std::string& clazz, const std::string& filter,
            ModulePrivate* module, std::vector<ServiceReferenceBase>& serviceRefs) const;
 
+  /**
+   * The properties of a registered service changed, update the property
+   * indices used for filtered lookups.
+   *
+   * @param sr The ServiceRegistration object whose properties changed.
+   * @param oldProperties The properties before the change.
+   */
+  void UpdatePropertyIndices(const ServiceRegistrationBase& sr, const ServicePropertiesImpl& oldProperties);
+
   /**
    * Remove a registered service.
    *
@@ -171,7 +186,53 @@ public:
 
 private:
 
-  void Get_unlocked(const std::string& clazz, const std::string& filter,
+  /**
+   * Registered services by the value of one property. Only string (and
+   * string list) values are indexed, services with other values for the
+   * property are candidates for every value.
+   */
+  struct PropertyIndex
+  {
+    US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > values;
+    std::vector<ServiceRegistrationBase> unindexed;
+  };
+
+  /**
+   * Indices for all properties which appeared in an equality term of a lookup
+   * filter, by lower case property name. Guarded by rwLock.
+   */
+  typedef std::map<std::string, PropertyIndex> PropertyIndexMap;
+  mutable PropertyIndexMap propertyIndices;
+
+  /**
+   * Parsed lookup filters, so repeated lookups do not parse their filter again.
+   */
+  typedef std::map<std::string, LDAPExpr> FilterCacheType;
+  mutable FilterCacheType filterCache;
+  mutable Mutex filterCacheMutex;
+
+  LDAPExpr GetCompiledFilter(const std::string& filter) const;
+
+  /**
+   * Creates the property indices for the equality terms of ldap which are not indexed yet.
+   */
+  void CreatePropertyIndices(const LDAPExpr& ldap) const;
+
+  /**
+   * Get the services which can satisfy the most selective indexed equality term
+   * of ldap, sorted like the lists in classServices.
+   *
+   * @return <code>false</code> if no indexed term selects less than maxCandidates services.
+   */
+  bool GetIndexedCandidates_unlocked(const LDAPExpr& ldap, std::size_t maxCandidates,
+                                     std::vector<ServiceRegistrationBase>& candidates) const;
+
+  static void AddToPropertyIndex(PropertyIndex& index, const std::string& key,
+                                 const ServiceRegistrationBase& sr, const ServicePropertiesImpl& props);
+  static void RemoveFromPropertyIndex(PropertyIndex& index, const std::string& key,
+                                      const ServiceRegistrationBase& sr, const ServicePropertiesImpl& props);
+
+  void Get_unlocked(const std::string& clazz, const LDAPExpr& ldap,
                     ModulePrivate* module, std::vector<ServiceReferenceBase>& serviceRefs) const;
 
   // purposely not implemented
@@ -273,6 +273,97 @@ private:
 #endif
 };
 
+/**
+ * \brief A lock which admits either any number of readers or a single writer.
+ *
+ * Waiting writers are preferred, i.e. new readers wait while a writer waits
+ * for the current readers to finish. The lock is not recursive.
+ */
+class ReadWriteLock
+{
+public:
+
+  ReadWriteLock() : m_Readers(0), m_WaitingWriters(0), m_Writing(false) {}
+
+  void LockForRead()
+  {
+    MutexLock<> lock(m_Mtx);
+    while (m_Writing || m_WaitingWriters > 0)
+    {
+      m_Cond.Wait(m_Mtx);
+    }
+    ++m_Readers;
+  }
+
+  void UnlockRead()
+  {
+    MutexLock<> lock(m_Mtx);
+    if (--m_Readers == 0)
+    {
+      m_Cond.NotifyAll();
+    }
+  }
+
+  void LockForWrite()
+  {
+    MutexLock<> lock(m_Mtx);
+    ++m_WaitingWriters;
+    while (m_Writing || m_Readers > 0)
+    {
+      m_Cond.Wait(m_Mtx);
+    }
+    --m_WaitingWriters;
+    m_Writing = true;
+  }
+
+  void UnlockWrite()
+  {
+    MutexLock<> lock(m_Mtx);
+    m_Writing = false;
+    m_Cond.NotifyAll();
+  }
+
+private:
+
+  // purposely not implemented
+  ReadWriteLock(const ReadWriteLock&);
+  ReadWriteLock& operator=(const ReadWriteLock&);
+
+  Mutex m_Mtx;
+  WaitCondition m_Cond;
+  int m_Readers;
+  int m_WaitingWriters;
+  bool m_Writing;
+};
+
+class ReadLocker
+{
+public:
+  ReadLocker(ReadWriteLock& lock) : m_Lock(&lock) { m_Lock->LockForRead(); }
+  ~ReadLocker() { m_Lock->UnlockRead(); }
+
+private:
+  ReadWriteLock* m_Lock;
+
+  // purposely not implemented
+  ReadLocker(const ReadLocker&);
+  ReadLocker& operator=(const ReadLocker&);
+};
+
+class WriteLocker
+{
+public:
+  WriteLocker(ReadWriteLock& lock) : m_Lock(&lock) { m_Lock->LockForWrite(); }
+  ~WriteLocker() { m_Lock->UnlockWrite(); }
+
+private:
+  ReadWriteLock* m_Lock;
+
+  // purposely not implemented
+  WriteLocker(const WriteLocker&);
+  WriteLocker& operator=(const WriteLocker&);
+};
+
 US_END_NAMESPACE
 
 #ifdef US_ENABLE_THREADING_SUPPORT
@@ -180,14 +180,18 @@ private:
   ModuleContext* mc;
 
   int nListeners;
+  int nOtherListeners;
   int nServices;
+  int nLookups;
 
   std::size_t nRegistered;
   std::size_t nUnregistering;
   std::size_t nModified;
+  std::size_t nOtherEvents;
 
   std::vector<ServiceRegistration<IPerfTestService> > regs;
   std::vector<MyServiceListener*> listeners;
+  std::vector<MyServiceListener*> otherListeners;
   std::vector<IPerfTestService*> services;
 
 public:
@@ -200,6 +204,8 @@ public:
   void TestAddListeners();
   void TestRegisterServices();
 
+  void TestFilteredLookups();
+
   void TestModifyServices();
   void TestUnregisterServices();
 
@@ -211,6 +217,7 @@ private:
   }
 
   void AddListeners(int n);
+  void AddOtherListeners(int n);
   void RegisterServices(int n);
   void ModifyServices();
   void UnregisterServices();
@@ -231,6 +238,11 @@ public:
   {
   }
 
+  void OtherServiceChanged(const ServiceEvent /*ev*/)
+  {
+    ts->nOtherEvents++;
+  }
+
   void ServiceChanged(const ServiceEvent ev)
   {
     switch(ev.GetType())
@@ -254,10 +266,13 @@ public:
 ServiceRegistryPerformanceTest::ServiceRegistryPerformanceTest(ModuleContext* context)
   : mc(context)
   , nListeners(100)
+  , nOtherListeners(100)
   , nServices(1000)
+  , nLookups(20000)
   , nRegistered(0)
   , nUnregistering(0)
   , nModified(0)
+  , nOtherEvents(0)
 {
 }
 
@@ -268,6 +283,7 @@ void ServiceRegistryPerformanceTest::InitTestCase()
   nRegistered    = 0;
   nUnregistering = 0;
   nModified      = 0;
+  nOtherEvents   = 0;
 }
 
 void ServiceRegistryPerformanceTest::CleanupTestCase()
@@ -288,11 +304,27 @@ void ServiceRegistryPerformanceTest::CleanupTestCase()
     }
   }
   listeners.clear();
+
+  for(std::size_t i = 0; i < otherListeners.size(); i++)
+  {
+    try
+    {
+      MyServiceListener* l = otherListeners[i];
+      mc->RemoveServiceListener(l, &MyServiceListener::OtherServiceChanged);
+      delete l;
+    }
+    catch (const std::exception& e)
+    {
+      Log() << e.what();
+    }
+  }
+  otherListeners.clear();
 }
 
 void ServiceRegistryPerformanceTest::TestAddListeners()
 {
   AddListeners(nListeners);
+  AddOtherListeners(nOtherListeners);
 }
 
 void ServiceRegistryPerformanceTest::AddListeners(int n)
@@ -314,6 +346,28 @@ void ServiceRegistryPerformanceTest::AddListeners(int n)
   Log() << "listener count=" << listeners.size() << "\n";
 }
 
+void ServiceRegistryPerformanceTest::AddOtherListeners(int n)
+{
+  // Listeners with filters which are too complicated for the simple listener
+  // cache, but can only match services of another object class.
+  Log() << "adding " << n << " service listeners for other services\n";
+  for(int i = 0; i < n; i++)
+  {
+    MyServiceListener* l = new MyServiceListener(this);
+    try
+    {
+      otherListeners.push_back(l);
+      mc->AddServiceListener(l, &MyServiceListener::OtherServiceChanged,
+                             "(&(objectclass=org.cppmicroservices.test.IOtherPerfTestService)(perf.service.value>=0))");
+    }
+    catch (const std::exception& e)
+    {
+      Log() << e.what();
+    }
+  }
+  Log() << "other listener count=" << otherListeners.size() << "\n";
+}
+
 void ServiceRegistryPerformanceTest::TestRegisterServices()
 {
   Log() << "Register services, and check that we get #of services ("
@@ -328,6 +382,48 @@ void ServiceRegistryPerformanceTest::TestRegisterServices()
   Log() << "register took " << ms << "ms\n";
   US_TEST_CONDITION_REQUIRED(nServices * listeners.size() == nRegistered,
                              "# REGISTERED events must be same as # of registered services  * # of listeners");
+  US_TEST_CONDITION_REQUIRED(nOtherEvents == 0, "No events for listeners of other services");
+}
+
+void ServiceRegistryPerformanceTest::TestFilteredLookups()
+{
+  Log() << "Look up " << nLookups << " services by their service.pid property\n";
+
+  std::vector<std::string> filters;
+  for(int i = 0; i < nServices; i++)
+  {
+    std::stringstream ss;
+    ss << "(service.pid=my.service." << i << ")";
+    filters.push_back(ss.str());
+  }
+
+  std::size_t nFound = 0;
+  HighPrecisionTimer t;
+  t.Start();
+  for(int i = 0; i < nLookups; i++)
+  {
+    std::vector<ServiceReference<IPerfTestService> > refs =
+        mc->GetServiceReferences<IPerfTestService>(filters[i % filters.size()]);
+    nFound += refs.size();
+  }
+  long long us = t.ElapsedMicro();
+  Log() << nLookups << " filtered lookups took " << us/1000 << "ms ("
+        << (us > 0 ? nLookups * 1000000LL / us : 0) << " lookups/s)\n";
+  US_TEST_CONDITION_REQUIRED(nFound == static_cast<std::size_t>(nLookups),
+                             "Each filtered lookup must find exactly one service");
+
+  // A filter on a property which is not a string cannot use the property index
+  t.Start();
+  nFound = 0;
+  for(int i = 0; i < nLookups / 10; i++)
+  {
+    nFound += mc->GetServiceReferences<IPerfTestService>("(perf.service.value=1)").size();
+  }
+  us = t.ElapsedMicro();
+  Log() << nLookups / 10 << " unindexed lookups took " << us/1000 << "ms ("
+        << (us > 0 ? nLookups / 10 * 1000000LL / us : 0) << " lookups/s)\n";
+  US_TEST_CONDITION_REQUIRED(nFound == static_cast<std::size_t>(nLookups / 10),
+                             "Each unindexed lookup must find exactly one service");
 }
 
 void ServiceRegistryPerformanceTest::RegisterServices(int n)
@@ -366,6 +462,12 @@ void ServiceRegistryPerformanceTest::TestModifyServices()
   Log() << "modify took " << ms << "ms\n";
   US_TEST_CONDITION_REQUIRED(nServices * listeners.size() == nModified,
                              "# MODIFIED events must be same as # of modified services  * # of listeners");
+
+  // The service.pid property was removed by the modification above
+  US_TEST_CONDITION_REQUIRED(mc->GetServiceReferences<IPerfTestService>("(service.pid=my.service.0)").empty(),
+                             "Property index must be updated for modified services");
+  US_TEST_CONDITION_REQUIRED(mc->GetServiceReferences<IPerfTestService>("(perf.service.value=2)").size() == 1,
+                             "Modified services must be found by their new properties");
 }
 
 void ServiceRegistryPerformanceTest::ModifyServices()
@@ -416,6 +518,7 @@ int usServiceRegistryPerformanceTest(int /*argc*/, char* /*argv*/[])
   perfTest.InitTestCase();
   perfTest.TestAddListeners();
   perfTest.TestRegisterServices();
+  perfTest.TestFilteredLookups();
   perfTest.TestModifyServices();
   perfTest.TestUnregisterServices();
   perfTest.CleanupTestCase();
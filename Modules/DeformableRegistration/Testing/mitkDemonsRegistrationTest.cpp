@@ -17,6 +17,95 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImage.h"
 #include "mitkDemonsRegistration.h"
 #include "mitkImageWriteAccessor.h"
+#include "mitkImageReadAccessor.h"
+
+#include <itkTimeProbe.h>
+
+#include <cmath>
+#include <vector>
+
+// Creates a 3D image of a sphere with smooth edges, shifted by shift voxels along x.
+static mitk::Image::Pointer CreateSphereImage(unsigned int size, double shift)
+{
+  unsigned int dim[]={size,size,size};
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize(mitk::MakeScalarPixelType<int>(), 3, dim);
+
+  mitk::ImageWriteAccessor accessor(image);
+  int* p = (int*) accessor.GetData();
+  double center = 0.5 * size;
+  double radius = 0.25 * size;
+  for (unsigned int z=0; z<size; ++z)
+    for (unsigned int y=0; y<size; ++y)
+      for (unsigned int x=0; x<size; ++x, ++p)
+      {
+        double dx = x - center - shift;
+        double dy = y - center;
+        double dz = z - center;
+        double distance = std::sqrt(dx*dx + dy*dy + dz*dz);
+        *p = static_cast<int>(1000.0 / (1.0 + std::exp(distance - radius)));
+      }
+  return image;
+}
+
+static double MeanAbsoluteDifference(mitk::Image* image1, mitk::Image* image2)
+{
+  mitk::ImageReadAccessor accessor1(image1);
+  mitk::ImageReadAccessor accessor2(image2);
+  const int* p1 = (const int*) accessor1.GetData();
+  const int* p2 = (const int*) accessor2.GetData();
+  unsigned int size = image1->GetDimension(0) * image1->GetDimension(1) * image1->GetDimension(2);
+  double sum = 0.0;
+  for (unsigned int i=0; i<size; ++i)
+  {
+    sum += std::abs(p1[i] - p2[i]);
+  }
+  return sum / size;
+}
+
+// Registers a shifted sphere at full resolution and coarse-to-fine, reports runtime and remaining difference.
+static bool TestSyntheticDeformation()
+{
+  mitk::Image::Pointer fixedImage = CreateSphereImage(64, 0.0);
+  mitk::Image::Pointer movingImage = CreateSphereImage(64, 4.0);
+  double initialDifference = MeanAbsoluteDifference(fixedImage, movingImage);
+
+  std::cout << "Synthetic deformation, initial mean absolute difference: " << initialDifference << std::endl;
+
+  double differences[2];
+  for (unsigned int levels=1; levels<=3; levels+=2)
+  {
+    mitk::DemonsRegistration::Pointer registration = mitk::DemonsRegistration::New();
+    registration->SetReferenceImage(fixedImage);
+    registration->SetInput(movingImage);
+    registration->SetSaveDeformationField(false);
+    registration->SetSaveResult(false);
+    registration->SetStandardDeviation(1.0);
+    registration->SetNumberOfIterations(50);
+    registration->SetMaximumRMSError(0.01);
+    registration->SetNumberOfLevels(levels);
+    if (levels > 1)
+    {
+      std::vector<unsigned int> iterations;
+      iterations.push_back(50);
+      iterations.push_back(30);
+      iterations.push_back(10);
+      registration->SetNumberOfIterationsPerLevel(iterations);
+    }
+
+    itk::TimeProbe probe;
+    probe.Start();
+    registration->Update();
+    probe.Stop();
+
+    double difference = MeanAbsoluteDifference(fixedImage, registration->GetOutput());
+    differences[levels/2] = difference;
+    std::cout << levels << " level(s): " << probe.GetTotal() << "s, mean absolute difference " << difference
+              << ", last RMS change " << registration->GetRMSChange() << std::endl;
+  }
+
+  return differences[0] < initialDifference && differences[1] < initialDifference;
+}
 
 
 int mitkDemonsRegistrationTest(int /*argc*/, char* /*argv*/[])
@@ -127,5 +216,13 @@ int mitkDemonsRegistrationTest(int /*argc*/, char* /*argv*/[])
   itk::Image<class itk::Vector<float, 3>,3>::Pointer deformationField = demonsRegistration->GetDeformationField();
   std::cout<<"[PASSED]"<<std::endl;
 
+  std::cout << "Register synthetic deformation: ";
+  if (!TestSyntheticDeformation())
+  {
+    std::cout<<"[FAILED]"<<std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout<<"[PASSED]"<<std::endl;
+
   return EXIT_SUCCESS;
 }
@@ -23,6 +23,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkRegistrationBase.h"
 #include "mitkImageAccessByItk.h"
 
+#include <vector>
+
 namespace mitk
 {
 
@@ -51,6 +53,37 @@ namespace mitk
     */
     void SetNumberOfIterations(int iterations);
 
+    /*!
+    * \brief Sets the number of resolution levels, 1 (default) registers at full resolution only.
+    *
+    * With more than one level the images are registered coarse-to-fine by an image pyramid, every level
+    * is shrunk by a factor of two against the next finer one. The deformation field of a level initializes
+    * the next finer level.
+    */
+    void SetNumberOfLevels(unsigned int levels);
+
+    /*!
+    * \brief Sets the number of iterations per resolution level, from the coarsest to the finest level.
+    *
+    * If fewer values than levels are given, the missing levels use the number of iterations set by SetNumberOfIterations().
+    */
+    void SetNumberOfIterationsPerLevel(const std::vector<unsigned int>& iterations);
+
+    /*!
+    * \brief Sets the RMS change of the deformation field below which the iterations of a level stop early, 0 (default) disables early stopping.
+    */
+    void SetMaximumRMSError(double maximumRMSError);
+
+    /*!
+    * \brief Sets the number of threads of the update steps, 0 (default) uses the ITK default.
+    */
+    void SetNumberOfThreads(unsigned int threads);
+
+    /*!
+    * \brief Returns the RMS change of the deformation field in the last iteration.
+    */
+    double GetRMSChange() const;
+
     /*!
     * \brief Sets the standard deviation used by the demons registration.
     */
@@ -113,6 +146,11 @@ namespace mitk
 
     int m_Iterations;
     float m_StandardDeviation;
+    unsigned int m_NumberOfLevels;
+    std::vector<unsigned int> m_IterationsPerLevel;
+    double m_MaximumRMSError;
+    unsigned int m_NumberOfThreads;
+    double m_RMSChange;
     const char* m_FieldName;
     const char* m_ResultName;
     bool m_SaveField;
@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkImageFileWriter.h"
 #include "itkWarpImageFilter.h"
+#include "itkMultiResolutionPDEDeformableRegistration.h"
 
 #include "itkInverseDisplacementFieldImageFilter.h"
 
@@ -29,6 +30,10 @@ namespace mitk {
   SymmetricForcesDemonsRegistration::SymmetricForcesDemonsRegistration():
     m_Iterations(50),
     m_StandardDeviation(1.0),
+    m_NumberOfLevels(1),
+    m_MaximumRMSError(0.0),
+    m_NumberOfThreads(0),
+    m_RMSChange(0.0),
     m_FieldName("newField.mhd"),
     m_ResultName("deformedImage.mhd"),
     m_SaveField(true),
@@ -52,6 +57,31 @@ namespace mitk {
     m_StandardDeviation = deviation;
   }
 
+  void SymmetricForcesDemonsRegistration::SetNumberOfLevels(unsigned int levels)
+  {
+    m_NumberOfLevels = levels > 0 ? levels : 1;
+  }
+
+  void SymmetricForcesDemonsRegistration::SetNumberOfIterationsPerLevel(const std::vector<unsigned int>& iterations)
+  {
+    m_IterationsPerLevel = iterations;
+  }
+
+  void SymmetricForcesDemonsRegistration::SetMaximumRMSError(double maximumRMSError)
+  {
+    m_MaximumRMSError = maximumRMSError;
+  }
+
+  void SymmetricForcesDemonsRegistration::SetNumberOfThreads(unsigned int threads)
+  {
+    m_NumberOfThreads = threads;
+  }
+
+  double SymmetricForcesDemonsRegistration::GetRMSChange() const
+  {
+    return m_RMSChange;
+  }
+
   void SymmetricForcesDemonsRegistration::SetSaveDeformationField(bool saveField)
   {
     m_SaveField = saveField;
@@ -95,6 +125,11 @@ namespace mitk {
                                   InternalImageType,
                                   InternalImageType,
                                   DeformationFieldType>   RegistrationFilterType;
+    typedef typename itk::MultiResolutionPDEDeformableRegistration<
+                                  InternalImageType,
+                                  InternalImageType,
+                                  DeformationFieldType,
+                                  InternalPixelType>   MultiResolutionRegistrationType;
     typedef typename itk::WarpImageFilter<
                             MovingImageType,
                             MovingImageType,
@@ -126,13 +161,41 @@ namespace mitk {
 
       typename FixedImageCasterType::Pointer fixedImageCaster = FixedImageCasterType::New();
       fixedImageCaster->SetInput(fixedImage);
-      filter->SetFixedImage( fixedImageCaster->GetOutput() );
       typename MovingImageCasterType::Pointer movingImageCaster = MovingImageCasterType::New();
       movingImageCaster->SetInput(movingImage);
-      filter->SetMovingImage(movingImageCaster->GetOutput());
-      filter->SetNumberOfIterations( m_Iterations );
       filter->SetStandardDeviations( m_StandardDeviation );
-      filter->Update();
+      // the update steps of the finite difference solver are split over the threads,
+      // the iterations of a level stop as soon as the RMS change drops below m_MaximumRMSError
+      filter->SetMaximumRMSError( m_MaximumRMSError );
+      if (m_NumberOfThreads > 0)
+      {
+        filter->SetNumberOfThreads( m_NumberOfThreads );
+      }
+
+      typename DeformationFieldType::Pointer deformationField;
+      if (m_NumberOfLevels > 1)
+      {
+        std::vector<unsigned int> iterations(m_IterationsPerLevel);
+        iterations.resize(m_NumberOfLevels, m_Iterations);
+
+        typename MultiResolutionRegistrationType::Pointer multiResolutionFilter = MultiResolutionRegistrationType::New();
+        multiResolutionFilter->SetRegistrationFilter( filter );
+        multiResolutionFilter->SetNumberOfLevels( m_NumberOfLevels );
+        multiResolutionFilter->SetNumberOfIterations( &iterations[0] );
+        multiResolutionFilter->SetFixedImage( fixedImageCaster->GetOutput() );
+        multiResolutionFilter->SetMovingImage( movingImageCaster->GetOutput() );
+        multiResolutionFilter->Update();
+        deformationField = multiResolutionFilter->GetOutput();
+      }
+      else
+      {
+        filter->SetFixedImage( fixedImageCaster->GetOutput() );
+        filter->SetMovingImage( movingImageCaster->GetOutput() );
+        filter->SetNumberOfIterations( m_Iterations );
+        filter->Update();
+        deformationField = filter->GetOutput();
+      }
+      m_RMSChange = filter->GetRMSChange();
 
       typename WarperType::Pointer warper = WarperType::New();
       typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
@@ -141,7 +204,7 @@ namespace mitk {
       warper->SetInterpolator( interpolator );
       warper->SetOutputSpacing( fixedImage->GetSpacing() );
       warper->SetOutputOrigin( fixedImage->GetOrigin() );
-      warper->SetDisplacementField( filter->GetOutput() );
+      warper->SetDisplacementField( deformationField );
       warper->Update();
       typename WriterType::Pointer      writer =  WriterType::New();
       typename CastFilterType::Pointer  caster =  CastFilterType::New();
@@ -162,7 +225,7 @@ namespace mitk {
         typedef DeformationFieldType  VectorImage2DType;
         typedef typename DeformationFieldType::PixelType Vector2DType;
 
-        typename VectorImage2DType::ConstPointer vectorImage2D = filter->GetOutput();
+        typename VectorImage2DType::ConstPointer vectorImage2D = deformationField.GetPointer();
 
         typename VectorImage2DType::RegionType  region2D = vectorImage2D->GetBufferedRegion();
         typename VectorImage2DType::IndexType   index2D  = region2D.GetIndex();
@@ -251,9 +314,9 @@ namespace mitk {
       {
         typename FieldWriterType::Pointer      fieldwriter =  FieldWriterType::New();
         fieldwriter->SetFileName( m_FieldName );
-        fieldwriter->SetInput( filter->GetOutput() );
+        fieldwriter->SetInput( deformationField );
         //m_DeformationField = filter->GetOutput();
-        m_DeformationField = (itk::Image<itk::Vector<float, 3>,3> *)(filter->GetOutput()); //see BUG #3732
+        m_DeformationField = (itk::Image<itk::Vector<float, 3>,3> *)(deformationField.GetPointer()); //see BUG #3732
         if(m_SaveField)
         {
           fieldwriter->Update();
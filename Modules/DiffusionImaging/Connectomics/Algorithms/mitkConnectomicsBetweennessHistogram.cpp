@@ -45,7 +45,7 @@ mitk::ConnectomicsBetweennessHistogram::BetweennessCalculationMode mitk::Connect
 
 void mitk::ConnectomicsBetweennessHistogram::ComputeFromConnectomicsNetwork( ConnectomicsNetwork* source )
 {
-  NetworkType* boostGraph = source->GetBoostGraph();
+  const NetworkType* boostGraph = source->GetBoostGraph();
   IteratorType vertex_iterator_begin, vertex_iterator_end;
 
   m_CentralityMap.clear();
@@ -55,7 +55,8 @@ void mitk::ConnectomicsBetweennessHistogram::ComputeFromConnectomicsNetwork( Con
   {
   case UnweightedUndirectedMode:
     {
-      CalculateUnweightedUndirectedBetweennessCentrality( boostGraph, vertex_iterator_begin, vertex_iterator_end );
+      // computed in parallel and cached by the network
+      m_CentralityMap = source->GetNodeBetweennessVector();
       break;
     }
   case WeightedUndirectedMode:
@@ -68,20 +69,8 @@ void mitk::ConnectomicsBetweennessHistogram::ComputeFromConnectomicsNetwork( Con
   ConvertCentralityMapToHistogram();
 }
 
-void mitk::ConnectomicsBetweennessHistogram::CalculateUnweightedUndirectedBetweennessCentrality(
-  NetworkType* boostGraph, IteratorType vertex_iterator_begin, IteratorType vertex_iterator_end )
-{
-  boost::brandes_betweenness_centrality(
-    *boostGraph,
-    boost::centrality_map(
-    boost::make_iterator_property_map( m_CentralityMap.begin(), boost::get( &mitk::ConnectomicsNetwork::NetworkNode::id, *boostGraph ), double() )
-    ).vertex_index_map( boost::get( &mitk::ConnectomicsNetwork::NetworkNode::id, *boostGraph ) )
-    );
-
-}
-
 void mitk::ConnectomicsBetweennessHistogram::CalculateWeightedUndirectedBetweennessCentrality(
-  NetworkType* boostGraph, IteratorType vertex_iterator_begin, IteratorType vertex_iterator_end )
+  const NetworkType* boostGraph, IteratorType vertex_iterator_begin, IteratorType vertex_iterator_end )
 {
   MBI_WARN << mitk::ConnectomicsConstantsManager::CONNECTOMICS_WARNING_UNIMPLEMENTED_FEATURE;
 }
@@ -59,11 +59,8 @@ namespace mitk {
     /** @brief Creates a new histogram from the network source. */
     virtual void ComputeFromConnectomicsNetwork( ConnectomicsNetwork* source );
 
-    /** Calculate betweenness centrality ignoring the weight of the edges */
-    void CalculateUnweightedUndirectedBetweennessCentrality( NetworkType*, IteratorType, IteratorType );
-
     /** Calculate betweenness centrality taking into consideration the weight of the edges */
-    void CalculateWeightedUndirectedBetweennessCentrality( NetworkType*, IteratorType, IteratorType );
+    void CalculateWeightedUndirectedBetweennessCentrality( const NetworkType*, IteratorType, IteratorType );
 
     /** Converts the centrality map to a histogram by binning */
     void ConvertCentralityMapToHistogram();
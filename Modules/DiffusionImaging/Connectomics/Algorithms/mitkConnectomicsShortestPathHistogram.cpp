@@ -19,6 +19,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 
+#include <limits>
+
 #include "mitkConnectomicsConstantsManager.h"
 
 mitk::ConnectomicsShortestPathHistogram::ConnectomicsShortestPathHistogram()
@@ -45,13 +47,13 @@ mitk::ConnectomicsShortestPathHistogram::ShortestPathCalculationMode mitk::Conne
 void mitk::ConnectomicsShortestPathHistogram::ComputeFromConnectomicsNetwork( ConnectomicsNetwork* source )
 {
 
-  NetworkType* boostGraph = source->GetBoostGraph();
+  const NetworkType* boostGraph = source->GetBoostGraph();
 
   switch( m_Mode )
   {
   case UnweightedUndirectedMode:
     {
-      CalculateUnweightedUndirectedShortestPaths( boostGraph );
+      CalculateUnweightedUndirectedShortestPaths( source );
       break;
     }
   case WeightedUndirectedMode:
@@ -64,27 +66,32 @@ void mitk::ConnectomicsShortestPathHistogram::ComputeFromConnectomicsNetwork( Co
     ConvertDistanceMapToHistogram();
 }
 
-void mitk::ConnectomicsShortestPathHistogram::CalculateUnweightedUndirectedShortestPaths( NetworkType* boostGraph )
+void mitk::ConnectomicsShortestPathHistogram::CalculateUnweightedUndirectedShortestPaths( ConnectomicsNetwork* source )
 {
-  std::vector< DescriptorType > predecessorMap( boost::num_vertices( *boostGraph ) );
-  int numberOfNodes( boost::num_vertices( *boostGraph ) );
+  // computed in parallel and cached by the network
+  std::vector< std::vector< double > > distances = source->GetShortestDistanceMatrix();
+  int numberOfNodes( distances.size() );
 
   m_DistanceMatrix.resize( numberOfNodes );
   for( int index(0); index < m_DistanceMatrix.size(); index++ )
   {
     m_DistanceMatrix[ index ].resize( numberOfNodes );
-  }
-
-  IteratorType iterator, end;
-  boost::tie(iterator, end) = boost::vertices( *boostGraph );
-
-  for ( int index(0) ; iterator != end; ++iterator, index++)
-  {
-          boost::dijkstra_shortest_paths(*boostGraph, *iterator, boost::predecessor_map(&predecessorMap[ 0 ]).distance_map(&m_DistanceMatrix[ index ][ 0 ]).weight_map( boost::get( &mitk::ConnectomicsNetwork::NetworkEdge::edge_weight ,*boostGraph ) ) ) ;
+    for( int innerIndex(0); innerIndex < numberOfNodes; innerIndex++ )
+    {
+      // unconnected nodes have an infinite distance
+      if( distances[ index ][ innerIndex ] < std::numeric_limits< int >::max() )
+      {
+        m_DistanceMatrix[ index ][ innerIndex ] = distances[ index ][ innerIndex ] + 0.5;
+      }
+      else
+      {
+        m_DistanceMatrix[ index ][ innerIndex ] = std::numeric_limits< int >::max();
+      }
+    }
   }
 }
 
-void mitk::ConnectomicsShortestPathHistogram::CalculateWeightedUndirectedShortestPaths( NetworkType* boostGraph )
+void mitk::ConnectomicsShortestPathHistogram::CalculateWeightedUndirectedShortestPaths( const NetworkType* boostGraph )
 {
   MBI_WARN << mitk::ConnectomicsConstantsManager::CONNECTOMICS_WARNING_UNIMPLEMENTED_FEATURE;
 }
@@ -63,10 +63,10 @@ namespace mitk {
     virtual void ComputeFromConnectomicsNetwork( ConnectomicsNetwork* source );
 
     /** Calculate shortest paths ignoring the weight of the edges */
-    void CalculateUnweightedUndirectedShortestPaths( NetworkType* boostGraph );
+    void CalculateUnweightedUndirectedShortestPaths( ConnectomicsNetwork* source );
 
     /** Calculate shortest paths taking into consideration the weight of the edges */
-    void CalculateWeightedUndirectedShortestPaths( NetworkType* boostGraph );
+    void CalculateWeightedUndirectedShortestPaths( const NetworkType* boostGraph );
 
     /** Converts the distance map to a histogram */
     void ConvertDistanceMapToHistogram();
@@ -34,7 +34,6 @@ double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::Evaluate( mit
 double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::CalculateModularity( mitk::ConnectomicsNetwork::Pointer network, ToModuleMapType* vertexToModuleMap ) const
 {
   double modularity( 0.0 );
-  int numberOfModules = getNumberOfModules( vertexToModuleMap );
 
   if( network->GetNumberOfVertices() != vertexToModuleMap->size() )
   {
@@ -42,45 +41,75 @@ double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::CalculateModu
     return modularity;
   }
 
-  int numberOfLinksInNetwork( 0 );
-  std::vector< int > numberOfLinksInModule, sumOfDegreesInModule;
-  numberOfLinksInModule.resize( numberOfModules, 0 );
-  sumOfDegreesInModule.resize( numberOfModules, 0 );
   // get vector of all vertex descriptors in the network
 
   const std::vector< VertexDescriptorType > allNodesVector
     = network->GetVectorOfAllVertexDescriptors();
 
+  std::map< VertexDescriptorType, int > vertexToIndexMap;
   for( int nodeNumber( 0 ); nodeNumber < allNodesVector.size() ; nodeNumber++)
   {
-    int correspondingModule = vertexToModuleMap->find( allNodesVector[ nodeNumber ] )->second;
+    vertexToIndexMap.insert( std::pair< VertexDescriptorType, int >( allNodesVector[ nodeNumber ], nodeNumber ) );
+  }
+
+  AdjacencyListType adjacency( allNodesVector.size() );
+  std::vector< int > modules( allNodesVector.size() );
+
+  for( int nodeNumber( 0 ); nodeNumber < allNodesVector.size() ; nodeNumber++)
+  {
+    modules[ nodeNumber ] = vertexToModuleMap->find( allNodesVector[ nodeNumber ] )->second;
     const std::vector< VertexDescriptorType > adjacentNodexVector
       = network->GetVectorOfAdjacentNodes( allNodesVector[ nodeNumber ] );
-    numberOfLinksInNetwork += adjacentNodexVector.size();
-    sumOfDegreesInModule[ correspondingModule ] += adjacentNodexVector.size();
 
     for( int adjacentNodeNumber( 0 ); adjacentNodeNumber < adjacentNodexVector.size() ; adjacentNodeNumber++)
     {
-      if( correspondingModule == vertexToModuleMap->find( adjacentNodexVector[ adjacentNodeNumber ] )->second )
-      {
-        numberOfLinksInModule[ correspondingModule ]++;
-      }
+      adjacency[ nodeNumber ].push_back( vertexToIndexMap.find( adjacentNodexVector[ adjacentNodeNumber ] )->second );
     }
   }
 
-  // the numbers for links have to be halved, as each edge was counted twice
-  numberOfLinksInNetwork = numberOfLinksInNetwork / 2;
+  ModuleStatistics statistics;
+  CalculateModuleStatistics( adjacency, modules, &statistics );
 
-  // if the network contains no links return 0
-  if( numberOfLinksInNetwork < 1)
+  return CalculateModularity( statistics );
+}
+
+void mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::CalculateModuleStatistics(
+  const AdjacencyListType& adjacency, const std::vector< int >& modules, ModuleStatistics* statistics ) const
+{
+  int numberOfModules( 0 );
+  for( int index( 0 ); index < modules.size(); index++ )
   {
-    return 0;
+    if( modules[ index ] + 1 > numberOfModules )
+    {
+      numberOfModules = modules[ index ] + 1;
+    }
   }
 
-  for( int index( 0 ); index < numberOfModules ; index++)
+  statistics->sumOfDegrees = 0;
+  statistics->numberOfVerticesInModule.assign( numberOfModules, 0 );
+  statistics->sumOfDegreesInModule.assign( numberOfModules, 0 );
+  statistics->numberOfLinkEndsInModule.assign( numberOfModules, 0 );
+
+  for( int nodeNumber( 0 ); nodeNumber < adjacency.size() ; nodeNumber++)
   {
-    numberOfLinksInModule[ index ] = numberOfLinksInModule[ index ] / 2;
+    int correspondingModule = modules[ nodeNumber ];
+    statistics->sumOfDegrees += adjacency[ nodeNumber ].size();
+    statistics->numberOfVerticesInModule[ correspondingModule ]++;
+    statistics->sumOfDegreesInModule[ correspondingModule ] += adjacency[ nodeNumber ].size();
+
+    for( int adjacentNodeNumber( 0 ); adjacentNodeNumber < adjacency[ nodeNumber ].size() ; adjacentNodeNumber++)
+    {
+      if( correspondingModule == modules[ adjacency[ nodeNumber ][ adjacentNodeNumber ] ] )
+      {
+        statistics->numberOfLinkEndsInModule[ correspondingModule ]++;
+      }
+    }
   }
+}
+
+double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::CalculateModularity( const ModuleStatistics& statistics ) const
+{
+  double modularity( 0.0 );
 
   //Calculate modularity M:
   //M = sum_{s=1}^{N_{M}} [ (l_{s} / L) - (d_{s} / ( 2L ))^2 ]
@@ -93,18 +122,84 @@ double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::CalculateModu
   // Cartography of complex networks: modules and universal roles
   // Journal of Statistical Mechanics: Theory and Experiment, 2005, 2005, P02001 )
 
-  for( int moduleID( 0 ); moduleID < numberOfModules; moduleID++ )
+  for( int moduleID( 0 ); moduleID < statistics.sumOfDegreesInModule.size(); moduleID++ )
   {
-    modularity += (((double) numberOfLinksInModule[ moduleID ]) / ((double) numberOfLinksInNetwork)) -
-      (
-      (((double) sumOfDegreesInModule[ moduleID ]) / ((double) 2 * numberOfLinksInNetwork) ) *
-      (((double) sumOfDegreesInModule[ moduleID ]) / ((double) 2 * numberOfLinksInNetwork) )
-      );
+    modularity += CalculateModuleModularity( statistics, moduleID );
   }
 
   return modularity;
 }
 
+double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::CalculateModuleModularity( const ModuleStatistics& statistics, int module ) const
+{
+  // the numbers for links have to be halved, as each edge was counted twice
+  int numberOfLinksInNetwork = statistics.sumOfDegrees / 2;
+
+  // if the network contains no links return 0
+  if( numberOfLinksInNetwork < 1)
+  {
+    return 0;
+  }
+
+  int numberOfLinksInModule = statistics.numberOfLinkEndsInModule[ module ] / 2;
+
+  return (((double) numberOfLinksInModule) / ((double) numberOfLinksInNetwork)) -
+    (
+    (((double) statistics.sumOfDegreesInModule[ module ]) / ((double) 2 * numberOfLinksInNetwork) ) *
+    (((double) statistics.sumOfDegreesInModule[ module ]) / ((double) 2 * numberOfLinksInNetwork) )
+    );
+}
+
+double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::Evaluate( const ModuleStatistics& statistics ) const
+{
+  return 100.0 * ( 1.0 - CalculateModularity( statistics ) );
+}
+
+double mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::MoveVertex(
+  const AdjacencyListType& adjacency, std::vector< int >* modules, ModuleStatistics* statistics, int vertex, int targetModule ) const
+{
+  const int sourceModule = (*modules)[ vertex ];
+  if( sourceModule == targetModule )
+  {
+    return 0.0;
+  }
+
+  double modularityBefore = CalculateModuleModularity( *statistics, sourceModule ) + CalculateModuleModularity( *statistics, targetModule );
+
+  // links to other vertices are counted from both ends, self loops only from this vertex
+  int linkEndsToSource( 0 ), linkEndsToTarget( 0 ), selfLoopEnds( 0 );
+  for( int adjacentNodeNumber( 0 ); adjacentNodeNumber < adjacency[ vertex ].size() ; adjacentNodeNumber++)
+  {
+    const int adjacentVertex = adjacency[ vertex ][ adjacentNodeNumber ];
+    if( adjacentVertex == vertex )
+    {
+      selfLoopEnds++;
+    }
+    else if( (*modules)[ adjacentVertex ] == sourceModule )
+    {
+      linkEndsToSource++;
+    }
+    else if( (*modules)[ adjacentVertex ] == targetModule )
+    {
+      linkEndsToTarget++;
+    }
+  }
+
+  const int degree = adjacency[ vertex ].size();
+  statistics->numberOfVerticesInModule[ sourceModule ]--;
+  statistics->numberOfVerticesInModule[ targetModule ]++;
+  statistics->sumOfDegreesInModule[ sourceModule ] -= degree;
+  statistics->sumOfDegreesInModule[ targetModule ] += degree;
+  statistics->numberOfLinkEndsInModule[ sourceModule ] -= 2 * linkEndsToSource + selfLoopEnds;
+  statistics->numberOfLinkEndsInModule[ targetModule ] += 2 * linkEndsToTarget + selfLoopEnds;
+  (*modules)[ vertex ] = targetModule;
+
+  double modularityAfter = CalculateModuleModularity( *statistics, sourceModule ) + CalculateModuleModularity( *statistics, targetModule );
+
+  // the cost is 100 * ( 1 - modularity )
+  return -100.0 * ( modularityAfter - modularityBefore );
+}
+
 int mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::getNumberOfModules(
   ToModuleMapType *vertexToModuleMap ) const
 {
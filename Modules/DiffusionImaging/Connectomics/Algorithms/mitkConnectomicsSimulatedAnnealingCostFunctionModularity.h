@@ -33,6 +33,22 @@ namespace mitk
     typedef std::map< VertexDescriptorType, int > ToModuleMapType;
     typedef std::map< VertexDescriptorType, VertexDescriptorType > VertexToVertexMapType;
 
+    // Adjacent vertices of each vertex, vertices are given by their index in GetVectorOfAllVertexDescriptors()
+    typedef std::vector< std::vector< int > > AdjacencyListType;
+
+    // The sums the modularity is calculated from, these can be updated cheaply when a single vertex changes module
+    struct ModuleStatistics
+    {
+      // sum of all degrees, i.e. twice the number of links in the network
+      int sumOfDegrees;
+      // number of vertices in each module
+      std::vector< int > numberOfVerticesInModule;
+      // sum of the degrees of the vertices in each module
+      std::vector< int > sumOfDegreesInModule;
+      // twice the number of links within each module
+      std::vector< int > numberOfLinkEndsInModule;
+    };
+
     /** Standard class typedefs. */
     /** Method for creation through the object factory. */
 
@@ -45,12 +61,29 @@ namespace mitk
     // Will calculate and return the modularity of the network
     double CalculateModularity( mitk::ConnectomicsNetwork::Pointer network, ToModuleMapType *vertexToModuleMap  ) const;
 
+    // Calculate the module statistics of a module assignment given as vector[ vertex index ] = module
+    void CalculateModuleStatistics( const AdjacencyListType& adjacency, const std::vector< int >& modules, ModuleStatistics* statistics ) const;
+
+    // Calculate the modularity from module statistics
+    double CalculateModularity( const ModuleStatistics& statistics ) const;
+
+    // Evaluate the cost of module statistics
+    double Evaluate( const ModuleStatistics& statistics ) const;
+
+    // Move a single vertex to another existing module, updates modules and statistics and returns the change of the cost
+    //
+    // Only the two modules involved change, so this costs O( degree ) instead of a complete evaluation
+    double MoveVertex( const AdjacencyListType& adjacency, std::vector< int >* modules, ModuleStatistics* statistics, int vertex, int targetModule ) const;
+
 
   protected:
 
     // returns the number of modules
     int getNumberOfModules( ToModuleMapType *vertexToModuleMap ) const;
 
+    // returns the contribution of a single module to the modularity
+    double CalculateModuleModularity( const ModuleStatistics& statistics, int module ) const;
+
     //////////////////// Functions ///////////////////////
     ConnectomicsSimulatedAnnealingCostFunctionModularity();
     ~ConnectomicsSimulatedAnnealingCostFunctionModularity();
@@ -20,8 +20,38 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vnl/vnl_random.h"
 #include "vnl/vnl_math.h"
 
+#include <itkMultiThreader.h>
+#include <itkTimeProbe.h>
+
+namespace
+{
+  /** The replicas and their temperatures for one temperature step of parallel tempering */
+  struct ReplicaThreadData
+  {
+    std::vector< mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer >* replicas;
+    std::vector< double > temperatures;
+  };
+
+  ITK_THREAD_RETURN_TYPE ReplicaThreaderCallback( void* arg )
+  {
+    itk::MultiThreader::ThreadInfoStruct* info = static_cast< itk::MultiThreader::ThreadInfoStruct* >( arg );
+    ReplicaThreadData* data = static_cast< ReplicaThreadData* >( info->UserData );
+
+    for( unsigned int replica( info->ThreadID ); replica < data->replicas->size(); replica += info->NumberOfThreads )
+    {
+      (*data->replicas)[ replica ]->Permutate( data->temperatures[ replica ] );
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+}
+
 mitk::ConnectomicsSimulatedAnnealingManager::ConnectomicsSimulatedAnnealingManager()
 : m_Permutation( 0 )
+, m_NumberOfReplicas( 1 )
+, m_ReplicaTemperatureRatio( 1.5 )
+, m_LastRunTime( 0.0 )
+, m_LastRunCost( 0.0 )
 {
 }
 
@@ -76,20 +106,113 @@ void mitk::ConnectomicsSimulatedAnnealingManager::RunSimulatedAnnealing(
     return;
   }
 
+  itk::TimeProbe clock;
+  clock.Start();
+
   // Initialize the associated permutation
   m_Permutation->Initialize();
 
+  // Create and initialize the additional replicas for parallel tempering
+  std::vector< mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer > replicas;
+  replicas.push_back( m_Permutation );
+  for( unsigned int index( 1 ); index < m_NumberOfReplicas; index++ )
+  {
+    mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer replica = m_Permutation->CreateReplica();
+    if( replica.IsNull() )
+    {
+      MBI_WARN << "Permutation does not support replicas, running a single chain.";
+      break;
+    }
+    replica->Initialize();
+    replicas.push_back( replica );
+  }
+
+  if( replicas.size() > 1 )
+  {
+    RunParallelTempering( replicas, temperature, stepSize );
+  }
+  else
+  {
+    for( double currentTemperature( temperature );
+      currentTemperature > 0.00001;
+      currentTemperature = currentTemperature / stepSize )
+    {
+      // Run Permutations at the current temperature
+      m_Permutation->Permutate( currentTemperature );
+
+    }
+  }
+
+  // Clean up result
+  m_Permutation->CleanUp();
+
+  clock.Stop();
+  m_LastRunTime = clock.GetTotal();
+  m_LastRunCost = m_Permutation->GetCost();
+}
+
+void mitk::ConnectomicsSimulatedAnnealingManager::RunParallelTempering(
+  std::vector< mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer >& replicas,
+  double temperature,
+  double stepSize )
+{
+  //the random number generator for the exchanges
+  vnl_random rng( (unsigned int) rand() );
+
+  ReplicaThreadData data;
+  data.replicas = &replicas;
+  data.temperatures.resize( replicas.size() );
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  if( threader->GetNumberOfThreads() > replicas.size() )
+  {
+    threader->SetNumberOfThreads( replicas.size() );
+  }
+  threader->SetSingleMethod( ReplicaThreaderCallback, &data );
 
   for( double currentTemperature( temperature );
     currentTemperature > 0.00001;
     currentTemperature = currentTemperature / stepSize )
   {
-    // Run Permutations at the current temperature
-    m_Permutation->Permutate( currentTemperature );
-
+    // replica k runs at currentTemperature * ratio^k
+    data.temperatures[ 0 ] = currentTemperature;
+    for( unsigned int index( 1 ); index < replicas.size(); index++ )
+    {
+      data.temperatures[ index ] = data.temperatures[ index - 1 ] * m_ReplicaTemperatureRatio;
+    }
+
+    // Run Permutations of all replicas at their temperatures
+    threader->SingleMethodExecute();
+
+    // exchange the solutions of neighbouring replicas with probability
+    // min( 1, exp( ( c_k - c_k+1 ) * ( 1 / t_k - 1 / t_k+1 ) ) )
+    for( unsigned int index( 0 ); index + 1 < replicas.size(); index++ )
+    {
+      const double exponent = ( replicas[ index ]->GetCost() - replicas[ index + 1 ]->GetCost() )
+        * ( 1.0 / data.temperatures[ index ] - 1.0 / data.temperatures[ index + 1 ] );
+
+      if( exponent >= 0 || rng.drand64( 0.0 , 1.0) < std::exp( exponent ) )
+      {
+        replicas[ index ]->SwapSolution( replicas[ index + 1 ] );
+      }
+    }
   }
 
-  // Clean up result
-  m_Permutation->CleanUp();
+  // make sure the assigned permutation holds the best solution
+  unsigned int bestReplica( 0 );
+  double bestCost( replicas[ 0 ]->GetCost() );
+  for( unsigned int index( 1 ); index < replicas.size(); index++ )
+  {
+    const double cost = replicas[ index ]->GetCost();
+    if( cost < bestCost )
+    {
+      bestCost = cost;
+      bestReplica = index;
+    }
+  }
 
+  if( bestReplica != 0 )
+  {
+    replicas[ 0 ]->SwapSolution( replicas[ bestReplica ] );
+  }
 }
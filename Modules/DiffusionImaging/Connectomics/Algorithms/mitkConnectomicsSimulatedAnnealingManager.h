@@ -27,6 +27,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkConnectomicsSimulatedAnnealingPermutationBase.h"
 
+#include <vector>
+
 namespace mitk
 {
   /**
@@ -45,8 +47,26 @@ namespace mitk
     bool AcceptChange( double costBefore, double costAfter, double temperature );
 
     // Run the permutations at different temperatures, where t_n = t_n-1 / stepSize
+    //
+    // If more than one replica is requested and the permutation supports it, parallel tempering is used:
+    // replica k runs at t_n * ratio^k, all replicas run in parallel and neighbouring replicas exchange
+    // their solutions after each temperature step. The best solution ends up in the assigned permutation.
     void RunSimulatedAnnealing( double temperature, double stepSize );
 
+    // Set the number of replicas used for parallel tempering, 1 runs a single chain (default)
+    itkSetMacro( NumberOfReplicas, unsigned int );
+    itkGetConstMacro( NumberOfReplicas, unsigned int );
+
+    // Set the ratio between the temperatures of neighbouring replicas
+    itkSetMacro( ReplicaTemperatureRatio, double );
+    itkGetConstMacro( ReplicaTemperatureRatio, double );
+
+    // Get the wall time of the last run in seconds
+    itkGetConstMacro( LastRunTime, double );
+
+    // Get the cost of the solution found by the last run
+    itkGetConstMacro( LastRunCost, double );
+
     // Set the permutation to be used
     void SetPermutation( mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer permutation );
 
@@ -56,10 +76,28 @@ namespace mitk
     ConnectomicsSimulatedAnnealingManager();
     ~ConnectomicsSimulatedAnnealingManager();
 
+    // Run parallel tempering on the given replicas, the first replica is the assigned permutation
+    void RunParallelTempering(
+      std::vector< mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer >& replicas,
+      double temperature,
+      double stepSize );
+
     /////////////////////// Variables ////////////////////////
     // The permutation assigned to the simulated annealing manager
     mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer m_Permutation;
 
+    // Number of replicas for parallel tempering
+    unsigned int m_NumberOfReplicas;
+
+    // Temperature ratio between neighbouring replicas
+    double m_ReplicaTemperatureRatio;
+
+    // Wall time of the last run in seconds
+    double m_LastRunTime;
+
+    // Cost of the solution found by the last run
+    double m_LastRunCost;
+
   };
 
 }// end namespace mitk
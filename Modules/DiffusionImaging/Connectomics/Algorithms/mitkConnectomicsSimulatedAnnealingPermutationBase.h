@@ -57,6 +57,19 @@ namespace mitk
     // Do clean up necessary after a permutation
     virtual void CleanUp(){};
 
+    // Create a new permutation with the same configuration, used as replica for parallel tempering
+    // Returns NULL if the permutation does not support replicas
+    virtual ConnectomicsSimulatedAnnealingPermutationBase::Pointer CreateReplica(){ return NULL; };
+
+    // Return the cost of the current solution
+    virtual double GetCost(){ return 0; };
+
+    // Exchange the current solution with the one of a replica
+    virtual void SwapSolution( ConnectomicsSimulatedAnnealingPermutationBase* replica ){};
+
+    // Seed the random number generator, otherwise it is seeded from rand() on initialization
+    virtual void SetRandomSeed( unsigned int seed ){};
+
   protected:
 
     //////////////////// Functions ///////////////////////
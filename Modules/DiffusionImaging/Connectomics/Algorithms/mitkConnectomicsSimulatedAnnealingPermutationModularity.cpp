@@ -23,6 +23,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vnl/vnl_math.h"
 
 mitk::ConnectomicsSimulatedAnnealingPermutationModularity::ConnectomicsSimulatedAnnealingPermutationModularity()
+: m_Depth( 0 )
+, m_StepSize( 0 )
+, m_HasRandomSeed( false )
 {
 }
 
@@ -38,6 +41,11 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::SetNetwork(
 
 void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::Initialize()
 {
+  if( !m_HasRandomSeed )
+  {
+    m_RandomGenerator.reseed( (unsigned int) rand() );
+  }
+
   // create entry for every vertex
   std::vector< VertexDescriptorType > vertexVector = m_Network->GetVectorOfAllVertexDescriptors();
   const int vectorSize = vertexVector.size();
@@ -55,40 +63,80 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::Initialize()
 
 void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::Permutate( double temperature )
 {
+  mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity* costMapping =
+    dynamic_cast<mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity*>( m_CostFunction.GetPointer() );
+  if( !costMapping )
+  {
+    MBI_ERROR << "Modularity permutation requires a modularity cost function.";
+    return;
+  }
+
+  // the single node shifts work on vertex indices, so that the cost can be updated incrementally
+  const std::vector< VertexDescriptorType > allNodesVector = m_Network->GetVectorOfAllVertexDescriptors();
+  const int numberOfVertices = allNodesVector.size();
 
-  ToModuleMapType currentSolution = m_BestSolution;
-  ToModuleMapType currentBestSolution = m_BestSolution;
+  std::map< VertexDescriptorType, int > vertexToIndexMap;
+  for( int index( 0 ); index < numberOfVertices; index++ )
+  {
+    vertexToIndexMap.insert( std::pair< VertexDescriptorType, int >( allNodesVector[ index ], index ) );
+  }
+
+  AdjacencyListType adjacency( numberOfVertices );
+  std::vector< int > currentSolution( numberOfVertices );
+  for( int index( 0 ); index < numberOfVertices; index++ )
+  {
+    const std::vector< VertexDescriptorType > adjacentNodexVector = m_Network->GetVectorOfAdjacentNodes( allNodesVector[ index ] );
+    for( int adjacentNodeNumber( 0 ); adjacentNodeNumber < adjacentNodexVector.size() ; adjacentNodeNumber++)
+    {
+      adjacency[ index ].push_back( vertexToIndexMap.find( adjacentNodexVector[ adjacentNodeNumber ] )->second );
+    }
+    currentSolution[ index ] = m_BestSolution.find( allNodesVector[ index ] )->second;
+  }
+  std::vector< int > currentBestSolution = currentSolution;
+
+  ModuleStatisticsType statistics;
+  costMapping->CalculateModuleStatistics( adjacency, currentSolution, &statistics );
 
   int factor = 1;
-  int numberOfVertices = m_BestSolution.size();
   int singleNodeMaxNumber = factor * numberOfVertices * numberOfVertices;
   int moduleMaxNumber = factor  * numberOfVertices;
-  double currentBestCost = Evaluate( &currentBestSolution );
+  double currentCost = costMapping->Evaluate( statistics );
+  double currentBestCost = currentCost;
 
   // do singleNodeMaxNumber node permutations and evaluate
   for(int loop( 0 ); loop < singleNodeMaxNumber; loop++)
   {
-    permutateMappingSingleNodeShift( &currentSolution, m_Network );
-    if( AcceptChange( currentBestCost, Evaluate( &currentSolution ), temperature ) )
+    currentCost += permutateMappingSingleNodeShift( &currentSolution, adjacency, &statistics );
+    if( AcceptChange( currentBestCost, currentCost, temperature ) )
     {
       currentBestSolution = currentSolution;
-      currentBestCost = Evaluate( &currentBestSolution );
+      currentBestCost = currentCost;
     }
   }
 
+  // the module permutations change many vertices at once and work on the maps
+  ToModuleMapType currentSolutionMap = m_BestSolution;
+  ToModuleMapType currentBestSolutionMap = m_BestSolution;
+  for( int index( 0 ); index < numberOfVertices; index++ )
+  {
+    currentSolutionMap.find( allNodesVector[ index ] )->second = currentSolution[ index ];
+    currentBestSolutionMap.find( allNodesVector[ index ] )->second = currentBestSolution[ index ];
+  }
+  currentBestCost = Evaluate( &currentBestSolutionMap );
+
   // do moduleMaxNumber module permutations
   for(int loop( 0 ); loop < moduleMaxNumber; loop++)
   {
-    permutateMappingModuleChange( &currentSolution, temperature, m_Network );
-    if( AcceptChange( currentBestCost, Evaluate( &currentSolution ), temperature ) )
+    permutateMappingModuleChange( &currentSolutionMap, temperature, m_Network );
+    if( AcceptChange( currentBestCost, Evaluate( &currentSolutionMap ), temperature ) )
     {
-      currentBestSolution = currentSolution;
-      currentBestCost = Evaluate( &currentBestSolution );
+      currentBestSolutionMap = currentSolutionMap;
+      currentBestCost = Evaluate( &currentBestSolutionMap );
     }
   }
 
   // store the best solution after the run
-  m_BestSolution = currentBestSolution;
+  m_BestSolution = currentBestSolutionMap;
 }
 
 void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::CleanUp()
@@ -103,56 +151,66 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::CleanUp()
   }
 }
 
-void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::permutateMappingSingleNodeShift(
-  ToModuleMapType *vertexToModuleMap, mitk::ConnectomicsNetwork::Pointer network )
+double mitk::ConnectomicsSimulatedAnnealingPermutationModularity::permutateMappingSingleNodeShift(
+  std::vector< int > *vertexToModuleVector, const AdjacencyListType& adjacency, ModuleStatisticsType* statistics )
 {
+  const int nodeCount = vertexToModuleVector->size();
+  const int moduleCount = statistics->numberOfVerticesInModule.size();
 
-  const int nodeCount = vertexToModuleMap->size();
-  const int moduleCount = getNumberOfModules( vertexToModuleMap );
-
-  // the random number generators
-  vnl_random rng( (unsigned int) rand() );
-  unsigned long randomNode = rng.lrand32( nodeCount - 1 );
-  // move the node either to any existing module, or to its own
-  //unsigned long randomModule = rng.lrand32( moduleCount );
-  unsigned long randomModule = rng.lrand32( moduleCount - 1 );
+  unsigned long randomNode = m_RandomGenerator.lrand32( nodeCount - 1 );
+  // move the node to any existing module
+  unsigned long randomModule = m_RandomGenerator.lrand32( moduleCount - 1 );
 
   // do some sanity checks
 
   if ( nodeCount < 2 )
   {
     // no sense in doing anything
-    return;
+    return 0.0;
   }
 
-  const std::vector< VertexDescriptorType > allNodesVector
-    = network->GetVectorOfAllVertexDescriptors();
-
-  ToModuleMapType::iterator iter = vertexToModuleMap->find( allNodesVector[ randomNode ] );
-  const int previousModuleNumber = iter->second;
+  const int previousModuleNumber = (*vertexToModuleVector)[ randomNode ];
 
   // if we move the node to its own module, do nothing
   if( previousModuleNumber == randomModule )
   {
-    return;
+    return 0.0;
   }
 
-  iter->second = randomModule;
+  mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity* costMapping =
+    static_cast<mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity*>( m_CostFunction.GetPointer() );
+  double costChange = costMapping->MoveVertex( adjacency, vertexToModuleVector, statistics, randomNode, randomModule );
 
-  if( getNumberOfVerticesInModule( vertexToModuleMap, previousModuleNumber ) < 1 )
+  // remove the module if it is empty now, by moving the last module to its place
+  if( statistics->numberOfVerticesInModule[ previousModuleNumber ] < 1 )
   {
-    removeModule( vertexToModuleMap, previousModuleNumber );
+    const int lastModuleNumber = moduleCount - 1;
+    if( previousModuleNumber != lastModuleNumber )
+    {
+      for( int index( 0 ); index < nodeCount; index++ )
+      {
+        if( (*vertexToModuleVector)[ index ] == lastModuleNumber )
+        {
+          (*vertexToModuleVector)[ index ] = previousModuleNumber;
+        }
+      }
+      statistics->numberOfVerticesInModule[ previousModuleNumber ] = statistics->numberOfVerticesInModule[ lastModuleNumber ];
+      statistics->sumOfDegreesInModule[ previousModuleNumber ] = statistics->sumOfDegreesInModule[ lastModuleNumber ];
+      statistics->numberOfLinkEndsInModule[ previousModuleNumber ] = statistics->numberOfLinkEndsInModule[ lastModuleNumber ];
+    }
+    statistics->numberOfVerticesInModule.pop_back();
+    statistics->sumOfDegreesInModule.pop_back();
+    statistics->numberOfLinkEndsInModule.pop_back();
   }
+
+  return costChange;
 }
 
 void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::permutateMappingModuleChange(
   ToModuleMapType *vertexToModuleMap, double currentTemperature, mitk::ConnectomicsNetwork::Pointer network )
 {
-  //the random number generators
-  vnl_random rng( (unsigned int) rand() );
-
   //randomly generate threshold
-  const double threshold = rng.drand64( 0.0 , 1.0);
+  const double threshold = m_RandomGenerator.drand64( 0.0 , 1.0);
 
   //for deciding whether to join two modules or split one
   double splitThreshold = 0.5;
@@ -162,10 +220,10 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::permutateMapping
 
   //select random module
   int numberOfModules = getNumberOfModules( vertexToModuleMap );
-  unsigned long randomModuleA = rng.lrand32( numberOfModules - 1 );
+  unsigned long randomModuleA = m_RandomGenerator.lrand32( numberOfModules - 1 );
 
   //select the second module to join, if joining
-  unsigned long randomModuleB = rng.lrand32( numberOfModules - 1 );
+  unsigned long randomModuleB = m_RandomGenerator.lrand32( numberOfModules - 1 );
 
   if( ( threshold < splitThreshold ) && ( randomModuleA != randomModuleB )  )
   {
@@ -253,6 +311,7 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::splitModule(
     permutation->SetNetwork( subNetwork );
     permutation->SetDepth( m_Depth - 1 );
     permutation->SetStepSize( m_StepSize * 2 );
+    permutation->SetRandomSeed( m_RandomGenerator.lrand32() );
 
     manager->SetPermutation( permutation.GetPointer() );
 
@@ -437,9 +496,6 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::randomlyAssignNo
     numberOfIntendedModules = vertexToModuleMap->size();
   }
 
-  //the random number generators
-  vnl_random rng( (unsigned int) rand() );
-
   std::vector< int > histogram;
   std::vector< int > nodeList;
 
@@ -452,7 +508,7 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::randomlyAssignNo
   for( int nodeIndex( 0 ); nodeIndex < nodeList.size(); nodeIndex++ )
   {
     //select random module
-    nodeList[ nodeIndex ] = rng.lrand32( numberOfIntendedModules - 1 );
+    nodeList[ nodeIndex ] = m_RandomGenerator.lrand32( numberOfIntendedModules - 1 );
 
     histogram[ nodeList[ nodeIndex ] ]++;
 
@@ -464,7 +520,7 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::randomlyAssignNo
   {
     while( histogram[ moduleIndex ] == 0 )
     {
-      int randomNodeIndex = rng.lrand32( numberOfVertices - 1 );
+      int randomNodeIndex = m_RandomGenerator.lrand32( numberOfVertices - 1 );
       if( histogram[ nodeList[ randomNodeIndex ] ] > 1 )
       {
         histogram[ moduleIndex ]++;
@@ -515,11 +571,8 @@ bool mitk::ConnectomicsSimulatedAnnealingPermutationModularity::AcceptChange( do
     return true;
   }
 
-  //the random number generators
-  vnl_random rng( (unsigned int) rand() );
-
   //randomly generate threshold
-  const double threshold = rng.drand64( 0.0 , 1.0);
+  const double threshold = m_RandomGenerator.drand64( 0.0 , 1.0);
 
   //the likelihood of acceptance
   double likelihood = std::exp( - ( costAfter - costBefore ) / temperature );
@@ -542,3 +595,38 @@ void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::SetStepSize( dou
 {
   m_StepSize = size;
 }
+
+void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::SetRandomSeed( unsigned int seed )
+{
+  m_RandomGenerator.reseed( seed );
+  m_HasRandomSeed = true;
+}
+
+mitk::ConnectomicsSimulatedAnnealingPermutationBase::Pointer
+mitk::ConnectomicsSimulatedAnnealingPermutationModularity::CreateReplica()
+{
+  Self::Pointer replica = Self::New();
+  replica->SetCostFunction( m_CostFunction );
+  replica->SetNetwork( m_Network );
+  replica->SetDepth( m_Depth );
+  replica->SetStepSize( m_StepSize );
+
+  return replica.GetPointer();
+}
+
+double mitk::ConnectomicsSimulatedAnnealingPermutationModularity::GetCost()
+{
+  return Evaluate( &m_BestSolution );
+}
+
+void mitk::ConnectomicsSimulatedAnnealingPermutationModularity::SwapSolution( ConnectomicsSimulatedAnnealingPermutationBase* replica )
+{
+  Self* modularityReplica = dynamic_cast< Self* >( replica );
+  if( !modularityReplica )
+  {
+    MBI_ERROR << "Trying to swap solution with a permutation of different type.";
+    return;
+  }
+
+  m_BestSolution.swap( modularityReplica->m_BestSolution );
+}
@@ -20,6 +20,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkConnectomicsSimulatedAnnealingPermutationBase.h"
 
 #include "mitkConnectomicsNetwork.h"
+#include "mitkConnectomicsSimulatedAnnealingCostFunctionModularity.h"
+
+#include "vnl/vnl_random.h"
 
 namespace mitk
 {
@@ -48,6 +51,18 @@ namespace mitk
     // Do clean up necessary after a permutation
     virtual void CleanUp();
 
+    // Create a permutation on the same network with the same cost function, depth and step size
+    virtual ConnectomicsSimulatedAnnealingPermutationBase::Pointer CreateReplica();
+
+    // Return the cost of the current best solution
+    virtual double GetCost();
+
+    // Exchange the current best solution with the one of another modularity permutation
+    virtual void SwapSolution( ConnectomicsSimulatedAnnealingPermutationBase* replica );
+
+    // Seed the random number generator
+    virtual void SetRandomSeed( unsigned int seed );
+
     // set the network permutation is to be run upon
     void SetNetwork( mitk::ConnectomicsNetwork::Pointer theNetwork );
 
@@ -75,10 +90,15 @@ namespace mitk
     ConnectomicsSimulatedAnnealingPermutationModularity();
     ~ConnectomicsSimulatedAnnealingPermutationModularity();
 
-    // This function moves one single node from a module to another
-        void permutateMappingSingleNodeShift(
-      ToModuleMapType *vertexToModuleMap,
-      mitk::ConnectomicsNetwork::Pointer network );
+    typedef mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::AdjacencyListType AdjacencyListType;
+    typedef mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::ModuleStatistics ModuleStatisticsType;
+
+    // This function moves one single node from a module to another, using vertex indices and updating
+    // the module statistics, returns the change of the cost
+    double permutateMappingSingleNodeShift(
+      std::vector< int > *vertexToModuleVector,
+      const AdjacencyListType& adjacency,
+      ModuleStatisticsType* statistics );
 
         // This function splits and joins modules
     void permutateMappingModuleChange(
@@ -132,6 +152,12 @@ namespace mitk
 
     // The step size for recursive configuring of simulated annealing manager
     double m_StepSize;
+
+    // The random number generator of this permutation
+    mutable vnl_random m_RandomGenerator;
+
+    // Whether the random number generator has been seeded explicitly
+    bool m_HasRandomSeed;
   };
 
 }// end namespace mitk
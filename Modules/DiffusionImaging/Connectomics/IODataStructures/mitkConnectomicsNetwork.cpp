@@ -18,10 +18,184 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkConnectomicsNetwork.h"
 #include <boost/graph/clustering_coefficient.hpp>
 #include <boost/graph/betweenness_centrality.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+
+#include <itkMultiThreader.h>
+
+namespace
+{
+  typedef mitk::ConnectomicsNetwork::NetworkType NetworkType;
+
+  /** Data shared by the threads computing one of the graph measures */
+  struct GraphMeasuresThreadData
+  {
+    enum MeasureType
+    {
+      BetweennessMeasure,
+      ClusteringMeasure,
+      ShortestDistanceMeasure
+    };
+
+    MeasureType measure;
+    const NetworkType* network;
+    int numberOfVertices;
+    int numberOfEdges;
+
+    // compressed adjacency, every edge is stored for both of its vertices
+    std::vector< int > adjacencyOffsets;
+    std::vector< int > adjacentVertices;
+    std::vector< int > adjacentEdges;
+
+    // partial betweenness sums, one vector per thread
+    std::vector< std::vector< double > > nodeBetweenness;
+    std::vector< std::vector< double > > edgeBetweenness;
+
+    // results indexed by vertex descriptor
+    std::vector< double > clustering;
+    std::vector< std::vector< double > >* distances;
+  };
+
+  /** Adds the dependencies of all source vertices assigned to this thread to its partial betweenness sums
+    *
+    * Unweighted variant of Brandes' algorithm: a breadth first search counts the shortest paths from the
+    * source, afterwards the dependencies are accumulated in order of decreasing distance.
+    */
+  void AccumulateBetweenness( GraphMeasuresThreadData* data, int threadId, int numberOfThreads )
+  {
+    const int numberOfVertices( data->numberOfVertices );
+    const std::vector< int >& offsets = data->adjacencyOffsets;
+    const std::vector< int >& adjacentVertices = data->adjacentVertices;
+    const std::vector< int >& adjacentEdges = data->adjacentEdges;
+    std::vector< double >& nodeBetweenness = data->nodeBetweenness[ threadId ];
+    std::vector< double >& edgeBetweenness = data->edgeBetweenness[ threadId ];
+
+    // vertices in order of discovery, used as queue during the search
+    std::vector< int > order;
+    order.reserve( numberOfVertices );
+    std::vector< int > distance( numberOfVertices );
+    std::vector< double > numberOfPaths( numberOfVertices );
+    std::vector< double > dependency( numberOfVertices );
+
+    for( int source( threadId ); source < numberOfVertices; source += numberOfThreads )
+    {
+      std::fill( distance.begin(), distance.end(), -1 );
+      std::fill( numberOfPaths.begin(), numberOfPaths.end(), 0.0 );
+      std::fill( dependency.begin(), dependency.end(), 0.0 );
+
+      distance[ source ] = 0;
+      numberOfPaths[ source ] = 1.0;
+      order.clear();
+      order.push_back( source );
+
+      for( std::size_t head( 0 ); head < order.size(); ++head )
+      {
+        const int vertex( order[ head ] );
+        for( int index( offsets[ vertex ] ); index < offsets[ vertex + 1 ]; ++index )
+        {
+          const int neighbour( adjacentVertices[ index ] );
+          if( distance[ neighbour ] < 0 )
+          {
+            distance[ neighbour ] = distance[ vertex ] + 1;
+            order.push_back( neighbour );
+          }
+          if( distance[ neighbour ] == distance[ vertex ] + 1 )
+          {
+            numberOfPaths[ neighbour ] += numberOfPaths[ vertex ];
+          }
+        }
+      }
+
+      // the source itself is at position 0 and does not receive any dependency
+      for( int position( order.size() - 1 ); position > 0; --position )
+      {
+        const int vertex( order[ position ] );
+        for( int index( offsets[ vertex ] ); index < offsets[ vertex + 1 ]; ++index )
+        {
+          const int predecessor( adjacentVertices[ index ] );
+          if( distance[ predecessor ] == distance[ vertex ] - 1 )
+          {
+            const double contribution( numberOfPaths[ predecessor ] / numberOfPaths[ vertex ] * ( 1.0 + dependency[ vertex ] ) );
+            dependency[ predecessor ] += contribution;
+            edgeBetweenness[ adjacentEdges[ index ] ] += contribution;
+          }
+        }
+        nodeBetweenness[ vertex ] += dependency[ vertex ];
+      }
+    }
+  }
+
+  ITK_THREAD_RETURN_TYPE GraphMeasuresThreaderCallback( void* arg )
+  {
+    itk::MultiThreader::ThreadInfoStruct* info = static_cast< itk::MultiThreader::ThreadInfoStruct* >( arg );
+    GraphMeasuresThreadData* data = static_cast< GraphMeasuresThreadData* >( info->UserData );
+    const int threadId( info->ThreadID );
+    const int numberOfThreads( info->NumberOfThreads );
+    const NetworkType& network = *data->network;
+
+    switch( data->measure )
+    {
+    case GraphMeasuresThreadData::BetweennessMeasure:
+      {
+        AccumulateBetweenness( data, threadId, numberOfThreads );
+        break;
+      }
+    case GraphMeasuresThreadData::ClusteringMeasure:
+      {
+        for( int vertex( threadId ); vertex < data->numberOfVertices; vertex += numberOfThreads )
+        {
+          data->clustering[ vertex ] = boost::clustering_coefficient( network, vertex );
+        }
+        break;
+      }
+    case GraphMeasuresThreadData::ShortestDistanceMeasure:
+      {
+        std::vector< mitk::ConnectomicsNetwork::VertexDescriptorType > predecessorMap( data->numberOfVertices );
+        for( int source( threadId ); source < data->numberOfVertices; source += numberOfThreads )
+        {
+          boost::dijkstra_shortest_paths( network, source,
+            boost::predecessor_map( &predecessorMap[ 0 ] ).distance_map( &( *data->distances )[ source ][ 0 ] ).weight_map( boost::get( &mitk::ConnectomicsNetwork::NetworkEdge::edge_weight, network ) ) );
+        }
+        break;
+      }
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  /** Runs the graph measure thread callback, returns the number of threads actually used */
+  int ExecuteGraphMeasuresThreads( GraphMeasuresThreadData* data, unsigned int numberOfThreads )
+  {
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    if( numberOfThreads > 0 )
+    {
+      threader->SetNumberOfThreads( numberOfThreads );
+    }
+    if( data->numberOfVertices > 0 && (int) threader->GetNumberOfThreads() > data->numberOfVertices )
+    {
+      threader->SetNumberOfThreads( data->numberOfVertices );
+    }
+
+    // the partial betweenness sums have to exist before the threads start
+    if( data->measure == GraphMeasuresThreadData::BetweennessMeasure )
+    {
+      data->nodeBetweenness.assign( threader->GetNumberOfThreads(), std::vector< double >( data->numberOfVertices, 0.0 ) );
+      data->edgeBetweenness.assign( threader->GetNumberOfThreads(), std::vector< double >( data->numberOfEdges, 0.0 ) );
+    }
+
+    threader->SetSingleMethod( GraphMeasuresThreaderCallback, data );
+    threader->SingleMethodExecute();
+
+    return threader->GetNumberOfThreads();
+  }
+}
 
 /* Constructor and Destructor */
 mitk::ConnectomicsNetwork::ConnectomicsNetwork()
 : m_IsModified( false )
+, m_NumberOfThreads( 0 )
+, m_BetweennessIsValid( false )
+, m_LocalClusteringCoefficientsAreValid( false )
+, m_ShortestDistanceMatrixIsValid( false )
 {
 }
 
@@ -342,31 +516,51 @@ int mitk::ConnectomicsNetwork::GetMaximumDegree() const
 
 std::vector< double > mitk::ConnectomicsNetwork::GetLocalClusteringCoefficients( ) const
 {
-  std::vector< double > vectorOfClusteringCoefficients;
+  m_GraphMeasuresMutex.Lock();
+  if( !m_LocalClusteringCoefficientsAreValid )
+  {
+    ComputeLocalClusteringCoefficients();
+  }
+  std::vector< double > vectorOfClusteringCoefficients = m_LocalClusteringCoefficients;
+  m_GraphMeasuresMutex.Unlock();
 
-  typedef boost::graph_traits<NetworkType>::vertex_iterator vertexIter;
+  return vectorOfClusteringCoefficients;
+}
 
-  vectorOfClusteringCoefficients.resize( this->GetNumberOfVertices() );
+void mitk::ConnectomicsNetwork::ComputeLocalClusteringCoefficients() const
+{
+  GraphMeasuresThreadData data;
+  data.measure = GraphMeasuresThreadData::ClusteringMeasure;
+  data.network = &m_Network;
+  data.numberOfVertices = this->GetNumberOfVertices();
+  data.numberOfEdges = this->GetNumberOfEdges();
+  data.distances = NULL;
+  data.clustering.resize( data.numberOfVertices );
+
+  ExecuteGraphMeasuresThreads( &data, m_NumberOfThreads );
 
+  m_LocalClusteringCoefficients.clear();
+  m_LocalClusteringCoefficients.resize( data.numberOfVertices );
+
+  typedef boost::graph_traits<NetworkType>::vertex_iterator vertexIter;
   std::pair<vertexIter, vertexIter> vertexPair;
 
-  //for every vertex calculate the clustering coefficient
-  int size = vectorOfClusteringCoefficients.size();
+  // the results are stored by vertex id
+  int size = m_LocalClusteringCoefficients.size();
   for (vertexPair = vertices(m_Network); vertexPair.first != vertexPair.second; ++vertexPair.first)
   {
     int index = m_Network[ *vertexPair.first ].id;
 
-    if( index > size )
+    if( index < 0 || index >= size )
     {
       MITK_ERROR << "Trying to access out of bounds clustering coefficient";
       continue;
     }
 
-    vectorOfClusteringCoefficients[ index ] =
-      boost::clustering_coefficient(m_Network,*vertexPair.first) ;
+    m_LocalClusteringCoefficients[ index ] = data.clustering[ *vertexPair.first ];
   }
 
-  return vectorOfClusteringCoefficients;
+  m_LocalClusteringCoefficientsAreValid = true;
 }
 
 std::vector< double > mitk::ConnectomicsNetwork::GetClusteringCoefficientsByDegree( )
@@ -432,7 +626,7 @@ double mitk::ConnectomicsNetwork::GetGlobalClusteringCoefficient( )
   return globalClusteringCoefficient;
 }
 
-mitk::ConnectomicsNetwork::NetworkType* mitk::ConnectomicsNetwork::GetBoostGraph()
+const mitk::ConnectomicsNetwork::NetworkType* mitk::ConnectomicsNetwork::GetBoostGraph() const
 {
   return &m_Network;
 }
@@ -447,6 +641,34 @@ bool mitk::ConnectomicsNetwork::GetIsModified() const
 void mitk::ConnectomicsNetwork::SetIsModified( bool value)
 {
   m_IsModified = value;
+
+  if( value )
+  {
+    InvalidateGraphMeasures();
+  }
+}
+
+void mitk::ConnectomicsNetwork::InvalidateGraphMeasures()
+{
+  m_GraphMeasuresMutex.Lock();
+  m_BetweennessIsValid = false;
+  m_LocalClusteringCoefficientsAreValid = false;
+  m_ShortestDistanceMatrixIsValid = false;
+  m_NodeBetweenness.clear();
+  m_EdgeBetweenness.clear();
+  m_LocalClusteringCoefficients.clear();
+  m_ShortestDistanceMatrix.clear();
+  m_GraphMeasuresMutex.Unlock();
+}
+
+void mitk::ConnectomicsNetwork::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  m_NumberOfThreads = numberOfThreads;
+}
+
+unsigned int mitk::ConnectomicsNetwork::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
 }
 
 
@@ -598,58 +820,121 @@ void mitk::ConnectomicsNetwork::PruneEdgesBelowWeight( int targetWeight )
 
 std::vector< double > mitk::ConnectomicsNetwork::GetNodeBetweennessVector() const
 {
-  std::vector< double > betweennessVector;
-
-  betweennessVector.clear();
-  betweennessVector.resize( this->GetNumberOfVertices() );
-
-  boost::brandes_betweenness_centrality(
-    m_Network,
-    boost::centrality_map(
-    boost::make_iterator_property_map( betweennessVector.begin(), boost::get( &NetworkNode::id, m_Network ), double() )
-    ).vertex_index_map( boost::get( &NetworkNode::id, m_Network ) )
-    );
+  m_GraphMeasuresMutex.Lock();
+  if( !m_BetweennessIsValid )
+  {
+    ComputeBetweennessCentrality();
+  }
+  std::vector< double > betweennessVector = m_NodeBetweenness;
+  m_GraphMeasuresMutex.Unlock();
 
   return betweennessVector;
 }
 
 std::vector< double > mitk::ConnectomicsNetwork::GetEdgeBetweennessVector() const
 {
-  // std::map used for convenient initialization
-  typedef std::map<EdgeDescriptorType, int> EdgeIndexStdMap;
-  EdgeIndexStdMap stdEdgeIndex;
-  // associative property map needed for iterator property map-wrapper
-  typedef boost::associative_property_map< EdgeIndexStdMap > EdgeIndexMap;
-  EdgeIndexMap edgeIndex(stdEdgeIndex);
+  m_GraphMeasuresMutex.Lock();
+  if( !m_BetweennessIsValid )
+  {
+    ComputeBetweennessCentrality();
+  }
+  std::vector< double > edgeBetweennessVector = m_EdgeBetweenness;
+  m_GraphMeasuresMutex.Unlock();
+
+  return edgeBetweennessVector;
+}
+
+void mitk::ConnectomicsNetwork::ComputeBetweennessCentrality() const
+{
+  GraphMeasuresThreadData data;
+  data.measure = GraphMeasuresThreadData::BetweennessMeasure;
+  data.network = &m_Network;
+  data.numberOfVertices = this->GetNumberOfVertices();
+  data.distances = NULL;
+
+  // build the compressed adjacency, edges are numbered in the order of boost::edges
+  // self loops are never part of a shortest path and are left out
+  std::vector< int > degree( data.numberOfVertices, 0 );
 
   boost::graph_traits<NetworkType>::edge_iterator iterator, end;
+  for ( boost::tie(iterator, end) = boost::edges( m_Network ); iterator != end; ++iterator)
+  {
+    VertexDescriptorType source = boost::source( *iterator, m_Network );
+    VertexDescriptorType target = boost::target( *iterator, m_Network );
+    if( source != target )
+    {
+      degree[ source ]++;
+      degree[ target ]++;
+    }
+  }
 
-  // sets iterator to start end end to end
-  boost::tie(iterator, end) = boost::edges( m_Network );
+  data.adjacencyOffsets.resize( data.numberOfVertices + 1, 0 );
+  for( int index( 0 ); index < data.numberOfVertices; index++ )
+  {
+    data.adjacencyOffsets[ index + 1 ] = data.adjacencyOffsets[ index ] + degree[ index ];
+  }
+
+  int numberOfEdges = this->GetNumberOfEdges();
+  data.numberOfEdges = numberOfEdges;
+  data.adjacentVertices.resize( data.adjacencyOffsets[ data.numberOfVertices ] );
+  data.adjacentEdges.resize( data.adjacencyOffsets[ data.numberOfVertices ] );
+
+  std::vector< int > position( data.adjacencyOffsets.begin(), data.adjacencyOffsets.end() - 1 );
+  int edgeIndex( 0 );
+  for ( boost::tie(iterator, end) = boost::edges( m_Network ); iterator != end; ++iterator, ++edgeIndex)
+  {
+    VertexDescriptorType source = boost::source( *iterator, m_Network );
+    VertexDescriptorType target = boost::target( *iterator, m_Network );
+    if( source != target )
+    {
+      data.adjacentVertices[ position[ source ] ] = target;
+      data.adjacentEdges[ position[ source ]++ ] = edgeIndex;
+      data.adjacentVertices[ position[ target ] ] = source;
+      data.adjacentEdges[ position[ target ]++ ] = edgeIndex;
+    }
+  }
+
+  int numberOfThreads = ExecuteGraphMeasuresThreads( &data, m_NumberOfThreads );
+
+  // sum the partial results, every path of the undirected graph has been counted from both ends
+  std::vector< double > nodeBetweenness( data.numberOfVertices, 0.0 );
+  m_EdgeBetweenness.assign( numberOfEdges, 0.0 );
+  for( int thread( 0 ); thread < numberOfThreads; thread++ )
+  {
+    for( int index( 0 ); index < data.numberOfVertices; index++ )
+    {
+      nodeBetweenness[ index ] += data.nodeBetweenness[ thread ][ index ];
+    }
+    for( int index( 0 ); index < numberOfEdges; index++ )
+    {
+      m_EdgeBetweenness[ index ] += data.edgeBetweenness[ thread ][ index ];
+    }
+  }
 
-  int i(0);
-  for ( ; iterator != end; ++iterator, ++i)
+  for( int index( 0 ); index < numberOfEdges; index++ )
   {
-    stdEdgeIndex.insert(std::pair< EdgeDescriptorType, int >( *iterator, i));
+    m_EdgeBetweenness[ index ] /= 2.0;
   }
 
-  // Define EdgeCentralityMap
-  std::vector< double > edgeBetweennessVector(boost::num_edges( m_Network ), 0.0);
-  // Create the external property map
-  boost::iterator_property_map< std::vector< double >::iterator, EdgeIndexMap >
-    e_centrality_map(edgeBetweennessVector.begin(), edgeIndex);
+  // the node betweenness is stored by vertex id
+  m_NodeBetweenness.clear();
+  m_NodeBetweenness.resize( data.numberOfVertices, 0.0 );
+
+  boost::graph_traits<NetworkType>::vertex_iterator vertexIterator, vertexEnd;
+  for ( boost::tie(vertexIterator, vertexEnd) = boost::vertices( m_Network ); vertexIterator != vertexEnd; ++vertexIterator)
+  {
+    int index = m_Network[ *vertexIterator ].id;
 
-  // Define VertexCentralityMap
-  typedef boost::property_map< NetworkType, boost::vertex_index_t>::type VertexIndexMap;
-  VertexIndexMap vertexIndex = get(boost::vertex_index, m_Network );
-  std::vector< double > betweennessVector(boost::num_vertices( m_Network ), 0.0);
-  // Create the external property map
-  boost::iterator_property_map< std::vector< double >::iterator, VertexIndexMap >
-    v_centrality_map(betweennessVector.begin(), vertexIndex);
+    if( index < 0 || index >= data.numberOfVertices )
+    {
+      MITK_ERROR << "Trying to access out of bounds betweenness centrality";
+      continue;
+    }
 
-  boost::brandes_betweenness_centrality( m_Network, v_centrality_map, e_centrality_map );
+    m_NodeBetweenness[ index ] = nodeBetweenness[ *vertexIterator ] / 2.0;
+  }
 
-  return edgeBetweennessVector;
+  m_BetweennessIsValid = true;
 }
 
 std::vector< double > mitk::ConnectomicsNetwork::GetShortestDistanceVectorFromLabel( std::string targetLabel ) const
@@ -674,11 +959,53 @@ std::vector< double > mitk::ConnectomicsNetwork::GetShortestDistanceVectorFromLa
     return distanceMatrix;
   }
 
+  // reuse the all pairs distances if they have been computed already
+  m_GraphMeasuresMutex.Lock();
+  if( m_ShortestDistanceMatrixIsValid )
+  {
+    distanceMatrix = m_ShortestDistanceMatrix[ *iterator ];
+    m_GraphMeasuresMutex.Unlock();
+    return distanceMatrix;
+  }
+  m_GraphMeasuresMutex.Unlock();
+
   boost::dijkstra_shortest_paths(m_Network, *iterator, boost::predecessor_map(&predecessorMap[ 0 ]).distance_map(&distanceMatrix[ 0 ]).weight_map( boost::get( &NetworkEdge::edge_weight ,m_Network ) ) ) ;
 
   return distanceMatrix;
 }
 
+std::vector< std::vector< double > > mitk::ConnectomicsNetwork::GetShortestDistanceMatrix() const
+{
+  m_GraphMeasuresMutex.Lock();
+  if( !m_ShortestDistanceMatrixIsValid )
+  {
+    ComputeShortestDistanceMatrix();
+  }
+  std::vector< std::vector< double > > distanceMatrix = m_ShortestDistanceMatrix;
+  m_GraphMeasuresMutex.Unlock();
+
+  return distanceMatrix;
+}
+
+void mitk::ConnectomicsNetwork::ComputeShortestDistanceMatrix() const
+{
+  int numberOfNodes( boost::num_vertices( m_Network ) );
+
+  m_ShortestDistanceMatrix.clear();
+  m_ShortestDistanceMatrix.resize( numberOfNodes, std::vector< double >( numberOfNodes ) );
+
+  GraphMeasuresThreadData data;
+  data.measure = GraphMeasuresThreadData::ShortestDistanceMeasure;
+  data.network = &m_Network;
+  data.numberOfVertices = numberOfNodes;
+  data.numberOfEdges = this->GetNumberOfEdges();
+  data.distances = &m_ShortestDistanceMatrix;
+
+  ExecuteGraphMeasuresThreads( &data, m_NumberOfThreads );
+
+  m_ShortestDistanceMatrixIsValid = true;
+}
+
 bool mitk::ConnectomicsNetwork::CheckForLabel( std::string targetLabel ) const
 {
   boost::graph_traits<NetworkType>::vertex_iterator iterator, end;
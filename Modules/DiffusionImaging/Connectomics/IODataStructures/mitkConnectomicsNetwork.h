@@ -25,6 +25,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <boost/graph/adjacency_list.hpp>
 
+#include <itkSimpleFastMutexLock.h>
+
 namespace mitk {
 
   /**
@@ -47,6 +49,9 @@ namespace mitk {
   *  <li> int weight - Weight of the edge as int (used for counting fibers)
   *  <li> double edge_weight - Used for boost and algorithms, should be between 0 and 1
   * </ul>
+  *
+  * The betweenness centralities, local clustering coefficients and shortest distances are computed using
+  * multiple threads and cached until the network is marked as modified via SetIsModified( true ).
   */
   class Connectomics_EXPORT ConnectomicsNetwork : public BaseData
   {
@@ -176,13 +181,22 @@ namespace mitk {
     /** Get the shortest distance from a specified vertex to all other vertices in form of a vector of length (number vertices)*/
     std::vector< double > GetShortestDistanceVectorFromLabel( std::string targetLabel ) const;
 
-    /** Access boost graph directly */
-    NetworkType* GetBoostGraph();
+    /** Get the shortest distances between all vertices in the format matrix[ source vertex ][ target vertex ] */
+    std::vector< std::vector< double > > GetShortestDistanceMatrix() const;
+
+    /** Set the number of threads used to compute betweenness, clustering and distances (0 uses the ITK default) */
+    void SetNumberOfThreads( unsigned int numberOfThreads );
+
+    /** Get the number of threads used to compute betweenness, clustering and distances */
+    unsigned int GetNumberOfThreads() const;
+
+    /** Access boost graph directly, read only since changes would bypass the cached graph measures */
+    const NetworkType* GetBoostGraph() const;
 
     /** Get the modified flag */
     bool GetIsModified() const;
 
-    /** Set the modified flag */
+    /** Set the modified flag, setting it to true discards the cached graph measures */
     void SetIsModified( bool );
 
     /** Update the bounds of the geometry to fit the network */
@@ -210,6 +224,18 @@ namespace mitk {
       */
     void UpdateIDs();
 
+    /** Compute node and edge betweenness centrality in parallel, one breadth first search per source vertex (Brandes) */
+    void ComputeBetweennessCentrality() const;
+
+    /** Compute the local clustering coefficients in parallel */
+    void ComputeLocalClusteringCoefficients() const;
+
+    /** Compute the shortest distances between all vertices in parallel */
+    void ComputeShortestDistanceMatrix() const;
+
+    /** Discard all cached graph measures */
+    void InvalidateGraphMeasures();
+
     NetworkType m_Network;
 
     /// Flag which indicates whether the network has been modified since the last check
@@ -218,6 +244,19 @@ namespace mitk {
 
     bool m_IsModified;
 
+    /// Number of threads used for the graph measures, 0 means ITK default
+    unsigned int m_NumberOfThreads;
+
+    /// Cached graph measures, valid until the network is modified
+    mutable std::vector< double > m_NodeBetweenness;
+    mutable std::vector< double > m_EdgeBetweenness;
+    mutable bool m_BetweennessIsValid;
+    mutable std::vector< double > m_LocalClusteringCoefficients;
+    mutable bool m_LocalClusteringCoefficientsAreValid;
+    mutable std::vector< std::vector< double > > m_ShortestDistanceMatrix;
+    mutable bool m_ShortestDistanceMatrixIsValid;
+    mutable itk::SimpleFastMutexLock m_GraphMeasuresMutex;
+
   private:
 
   };
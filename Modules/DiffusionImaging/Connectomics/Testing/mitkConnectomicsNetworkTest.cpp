@@ -22,9 +22,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkConnectomicsSimulatedAnnealingManager.h"
 #include "mitkConnectomicsSimulatedAnnealingPermutationModularity.h"
 #include "mitkConnectomicsSimulatedAnnealingCostFunctionModularity.h"
+#include <itkTimeProbe.h>
+#include <boost/graph/betweenness_centrality.hpp>
 #include <vector>
+#include <map>
 #include <string>
 #include <utility>
+#include <algorithm>
 
 /**Documentation
 *  Test for synthetic connectomics generation and connectomics network functionality
@@ -388,6 +392,88 @@ int mitkConnectomicsNetworkTest(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  try
+  {
+    // Testing parallel betweenness, clustering and shortest distance calculation
+
+    mitk::ConnectomicsSyntheticNetworkGenerator::Pointer generator = mitk::ConnectomicsSyntheticNetworkGenerator::New();
+    mitk::ConnectomicsNetwork::Pointer network = generator->CreateSyntheticNetwork( 2, 500, 0.02 );
+    MITK_TEST_CONDITION_REQUIRED( generator->WasGenerationSuccessfull() && network.IsNotNull(), "Random network for graph measures has been instantiated")
+
+    // serial reference using the boost implementation, edges are numbered in the order of boost::edges
+    const mitk::ConnectomicsNetwork::NetworkType* boostGraph = network->GetBoostGraph();
+    std::map< EdgeType, int > stdEdgeIndex;
+    boost::associative_property_map< std::map< EdgeType, int > > edgeIndex( stdEdgeIndex );
+    boost::graph_traits< mitk::ConnectomicsNetwork::NetworkType >::edge_iterator edgeIterator, edgeEnd;
+    int edgeCounter( 0 );
+    for( boost::tie( edgeIterator, edgeEnd ) = boost::edges( *boostGraph ); edgeIterator != edgeEnd; ++edgeIterator, ++edgeCounter )
+    {
+      stdEdgeIndex.insert( std::pair< EdgeType, int >( *edgeIterator, edgeCounter ) );
+    }
+
+    std::vector< double > referenceBetweenness( network->GetNumberOfVertices(), 0.0 );
+    std::vector< double > referenceEdgeBetweenness( network->GetNumberOfEdges(), 0.0 );
+    boost::brandes_betweenness_centrality(
+      *boostGraph,
+      boost::centrality_map(
+      boost::make_iterator_property_map( referenceBetweenness.begin(), boost::get( &NodeType::id, *boostGraph ), double() )
+      ).edge_centrality_map(
+      boost::make_iterator_property_map( referenceEdgeBetweenness.begin(), edgeIndex, double() )
+      ).vertex_index_map( boost::get( &NodeType::id, *boostGraph ) )
+      );
+
+    network->SetNumberOfThreads( 1 );
+    std::vector< double > singleThreadBetweenness = network->GetNodeBetweennessVector();
+    std::vector< double > singleThreadEdgeBetweenness = network->GetEdgeBetweennessVector();
+    std::vector< double > singleThreadClustering = network->GetLocalClusteringCoefficients();
+
+    // force a recomputation with several threads
+    network->SetIsModified( true );
+    network->SetNumberOfThreads( 4 );
+    itk::TimeProbe clock;
+    clock.Start();
+    std::vector< double > multiThreadBetweenness = network->GetNodeBetweennessVector();
+    clock.Stop();
+    MITK_INFO << "Betweenness of " << network->GetNumberOfVertices() << " nodes computed in " << clock.GetTotal() << "s";
+    std::vector< double > multiThreadEdgeBetweenness = network->GetEdgeBetweennessVector();
+    std::vector< double > multiThreadClustering = network->GetLocalClusteringCoefficients();
+
+    bool betweennessMatches( referenceBetweenness.size() == multiThreadBetweenness.size() );
+    for( int index(0); betweennessMatches && index < referenceBetweenness.size(); index++ )
+    {
+      betweennessMatches = std::abs( referenceBetweenness[ index ] - multiThreadBetweenness[ index ] ) < eps
+        && std::abs( singleThreadBetweenness[ index ] - multiThreadBetweenness[ index ] ) < eps;
+    }
+    MITK_TEST_CONDITION_REQUIRED( betweennessMatches, "Parallel node betweenness matches boost reference")
+
+    bool edgeBetweennessMatches( referenceEdgeBetweenness.size() == singleThreadEdgeBetweenness.size()
+      && singleThreadEdgeBetweenness.size() == multiThreadEdgeBetweenness.size() );
+    for( int index(0); edgeBetweennessMatches && index < referenceEdgeBetweenness.size(); index++ )
+    {
+      edgeBetweennessMatches = std::abs( referenceEdgeBetweenness[ index ] - multiThreadEdgeBetweenness[ index ] ) < eps
+        && std::abs( singleThreadEdgeBetweenness[ index ] - multiThreadEdgeBetweenness[ index ] ) < eps;
+    }
+    MITK_TEST_CONDITION_REQUIRED( edgeBetweennessMatches, "Parallel edge betweenness matches boost reference")
+
+    MITK_TEST_CONDITION_REQUIRED( singleThreadClustering == multiThreadClustering, "Clustering coefficients independent of number of threads")
+
+    std::vector< std::vector< double > > distanceMatrix = network->GetShortestDistanceMatrix();
+    std::string firstLabel = network->GetNode( network->GetVectorOfAllVertexDescriptors()[ 0 ] ).label;
+    MITK_TEST_CONDITION_REQUIRED( distanceMatrix.size() == network->GetNumberOfVertices()
+      && network->GetShortestDistanceVectorFromLabel( firstLabel ) == distanceMatrix[ 0 ], "Shortest distance matrix matches single source distances")
+
+    // modifying the network has to discard the cached values
+    std::vector< VertexType > vertices = network->GetVectorOfAllVertexDescriptors();
+    VertexType newVertex = network->AddVertex( vertices.size() );
+    network->AddEdge( vertices[ 0 ], newVertex );
+    MITK_TEST_CONDITION_REQUIRED( network->GetNodeBetweennessVector().size() == vertices.size() + 1, "Cached betweenness is updated after modification")
+  }
+  catch (...)
+  {
+    MITK_ERROR << "Unhandled exception caught while testing graph measures [FAILED]" ;
+    return EXIT_FAILURE;
+  }
+
   try
   {
     // Testing modularity calculation
@@ -515,6 +601,49 @@ int mitkConnectomicsNetworkTest(int argc, char* argv[])
 
     bool noInternalThreeModuleModularity( std::abs(-0.3395 - costFunction->CalculateModularity( network, &noInternalLinksThreeModuleSolution )) < eps);
     MITK_TEST_CONDITION_REQUIRED( noInternalThreeModuleModularity, "Expected three module modularity containing no internal links")
+
+    // Test incremental cost update for single vertex moves
+    typedef mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::AdjacencyListType AdjacencyListType;
+    AdjacencyListType adjacency( vertexInVector.size() );
+    std::vector< int > modules( vertexInVector.size() );
+    for( int index( 0 ); index < vertexInVector.size(); index++ )
+    {
+      std::vector< VertexType > adjacentVertices = network->GetVectorOfAdjacentNodes( vertexInVector[ index ] );
+      for( int adjacentIndex( 0 ); adjacentIndex < adjacentVertices.size(); adjacentIndex++ )
+      {
+        adjacency[ index ].push_back( std::find( vertexInVector.begin(), vertexInVector.end(), adjacentVertices[ adjacentIndex ] ) - vertexInVector.begin() );
+      }
+      modules[ index ] = threeModuleSolution[ vertexInVector[ index ] ];
+    }
+
+    mitk::ConnectomicsSimulatedAnnealingCostFunctionModularity::ModuleStatistics statistics;
+    costFunction->CalculateModuleStatistics( adjacency, modules, &statistics );
+    double cost = costFunction->Evaluate( statistics );
+    cost += costFunction->MoveVertex( adjacency, &modules, &statistics, 4, 1 );
+    cost += costFunction->MoveVertex( adjacency, &modules, &statistics, 9, 0 );
+
+    ToModuleMapType movedSolution = threeModuleSolution;
+    movedSolution[ vertexInVector[ 4 ] ] = 1;
+    movedSolution[ vertexInVector[ 9 ] ] = 0;
+    bool incrementalCostMatches( std::abs( costFunction->Evaluate( network, &movedSolution ) - cost ) < eps );
+    MITK_TEST_CONDITION_REQUIRED( incrementalCostMatches, "Incremental cost matches full evaluation after moving vertices")
+
+    // Test parallel tempering
+    srand( 0 );
+    permutation->SetCostFunction( costFunction.GetPointer() );
+    permutation->SetNetwork( network );
+    permutation->SetDepth( 1 );
+    permutation->SetStepSize( 4.0 );
+    manager->SetPermutation( permutation.GetPointer() );
+    manager->SetNumberOfReplicas( 4 );
+    manager->RunSimulatedAnnealing( 2.0, 4.0 );
+
+    ToModuleMapType temperingSolution = permutation->GetMapping();
+    double temperingModularity = costFunction->CalculateModularity( network, &temperingSolution );
+    MITK_INFO << "Parallel tempering with 4 replicas reached modularity " << temperingModularity << " in " << manager->GetLastRunTime() << "s";
+    MITK_TEST_CONDITION_REQUIRED( temperingSolution.size() == vertexInVector.size(), "Parallel tempering returns a module for each vertex")
+    MITK_TEST_CONDITION_REQUIRED( std::abs( costFunction->Evaluate( network, &temperingSolution ) - manager->GetLastRunCost() ) < eps, "Reported cost matches the returned solution")
+    MITK_TEST_CONDITION_REQUIRED( temperingModularity > 0.0, "Parallel tempering finds a modular solution")
   }
   catch (...)
   {
@@ -51,7 +51,8 @@ AnalyticalDiffusionQballReconstructionImageFilter<T,TG,TO,L,NODF>
     m_Lambda(0.0),
     m_DirectionsDuplicated(false),
     m_Delta1(0.001),
-    m_Delta2(0.001)
+    m_Delta2(0.001),
+    m_BatchSize(64)
 {
     // At least 1 inputs is necessary for a vector image.
     // For images added one at a time we need at least six
@@ -257,6 +258,11 @@ void AnalyticalDiffusionQballReconstructionImageFilter<T,TG,TO,L,NODF>
     }
 
     this->ComputeReconstructionMatrix();
+    m_TransposedReconstructionMatrix = m_ReconstructionMatrix->transpose();
+    m_TransposedCoeffReconstructionMatrix = m_CoeffReconstructionMatrix->transpose();
+    m_TransposedSphericalHarmonicBasisMatrix = m_SphericalHarmonicBasisMatrix->transpose();
+    if (m_BatchSize<1)
+        m_BatchSize = 1;
 
     typename GradientImagesType::Pointer img = static_cast< GradientImagesType * >(
                 this->ProcessObject::GetInput(0) );
@@ -343,79 +349,128 @@ void AnalyticalDiffusionQballReconstructionImageFilter<T,TG,TO,L,NODF>
             gradientind.push_back(gradientind[i]);
     }
 
-    while( !git.IsAtEnd() )
+    if(m_NormalizationMethod == QBAR_NONNEG_SOLID_ANGLE)
     {
-        GradientVectorType b = git.Get();
+        /** this would be the place to implement a non-negative
+      * solver for quadratic programming problem:
+      * min .5*|| Bc-s ||^2 subject to -CLPc <= 4*pi*ones
+      * (refer to MICCAI 2009 Goh et al. "Estimating ODFs with PDF constraints")
+      * .5*|| Bc-s ||^2 == .5*c'B'Bc - x'B's + .5*s's
+      */
+
+        itkExceptionMacro( << "Nonnegative Solid Angle not yet implemented");
+    }
 
-        typename NumericTraits<ReferencePixelType>::AccumulateType b0 = NumericTraits<ReferencePixelType>::Zero;
+    // the voxels are reconstructed in blocks of m_BatchSize: the (pre-normalized) signals of all voxels above the
+    // threshold are gathered in the rows of a matrix and multiplied with the reconstruction matrices at once
+    typedef typename NumericTraits<ReferencePixelType>::AccumulateType B0Type;
+    std::vector< B0Type > b0Values(m_BatchSize);
+    std::vector< int > signalRows(m_BatchSize);
+    vnl_matrix<TO> signals(m_BatchSize, m_NumberOfGradientDirections);
+    vnl_matrix<TO> coeffs(m_BatchSize, m_NumberCoefficients);
+    vnl_matrix<TO> odfs(m_BatchSize, NODF);
+    vnl_vector<TO> B(m_NumberOfGradientDirections);
 
-        // Average the baseline image pixels
-        for(unsigned int i = 0; i < baselineind.size(); ++i)
+    while( !git.IsAtEnd() )
+    {
+        unsigned int numVoxels = 0;
+        unsigned int numSignals = 0;
+        while( numVoxels<m_BatchSize && !git.IsAtEnd() )
         {
-            b0 += b[baselineind[i]];
-        }
-        b0 /= this->m_NumberOfBaselineImages;
+            GradientVectorType b = git.Get();
 
-        OdfPixelType odf(0.0);
-        typename CoefficientImageType::PixelType coeffPixel(0.0);
-        vnl_vector<TO> B(m_NumberOfGradientDirections);
+            B0Type b0 = NumericTraits<ReferencePixelType>::Zero;
 
-        if( (b0 != 0) && (b0 >= m_Threshold) )
-        {
-            for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+            // Average the baseline image pixels
+            for(unsigned int i = 0; i < baselineind.size(); ++i)
             {
-                B[i] = static_cast<TO>(b[gradientind[i]]);
+                b0 += b[baselineind[i]];
             }
+            b0 /= this->m_NumberOfBaselineImages;
+            b0Values[numVoxels] = b0;
+            signalRows[numVoxels] = -1;
 
-            B = PreNormalize(B, b0);
-            if(m_NormalizationMethod == QBAR_SOLID_ANGLE)
-            {
-                vnl_vector<TO> coeffs(m_NumberCoefficients);
-                coeffs = ( (*m_CoeffReconstructionMatrix) * B );
-                coeffs[0] += 1.0/(2.0*sqrt(QBALL_ANAL_RECON_PI));
-                odf = ( (*m_SphericalHarmonicBasisMatrix) * coeffs ).data_block();
-                coeffPixel = coeffs.data_block();
-            }
-            else if(m_NormalizationMethod == QBAR_NONNEG_SOLID_ANGLE)
+            if( (b0 != 0) && (b0 >= m_Threshold) )
             {
-                /** this would be the place to implement a non-negative
-              * solver for quadratic programming problem:
-              * min .5*|| Bc-s ||^2 subject to -CLPc <= 4*pi*ones
-              * (refer to MICCAI 2009 Goh et al. "Estimating ODFs with PDF constraints")
-              * .5*|| Bc-s ||^2 == .5*c'B'Bc - x'B's + .5*s's
-              */
-
-                itkExceptionMacro( << "Nonnegative Solid Angle not yet implemented");
+                for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+                {
+                    B[i] = static_cast<TO>(b[gradientind[i]]);
+                }
+
+                B = PreNormalize(B, b0);
+                signals.set_row(numSignals, B);
+                signalRows[numVoxels] = numSignals++;
             }
-            else
+
+            ++numVoxels;
+            ++git;  // Gradient  image iterator
+        }
+
+        // actual reconstruction
+        this->ReconstructBatch(signals, numSignals, coeffs, odfs);
+
+        for (unsigned int v=0; v<numVoxels; v++)
+        {
+            OdfPixelType odf(0.0);
+            typename CoefficientImageType::PixelType coeffPixel(0.0);
+
+            if (signalRows[v]>=0)
             {
-                vnl_vector<TO> coeffs(m_NumberCoefficients);
-                coeffs = ( (*m_CoeffReconstructionMatrix) * B );
-                coeffs[0] += 1.0/(2.0*sqrt(QBALL_ANAL_RECON_PI));
-                coeffPixel = coeffs.data_block();
-                odf = ( (*m_ReconstructionMatrix) * B ).data_block();
+                odf = odfs[signalRows[v]];
+                coeffPixel = coeffs[signalRows[v]];
+                odf = Normalize(odf, b0Values[v]);
             }
-            odf = Normalize(odf, b0);
 
+            oit.Set( odf );
+            oit2.Set( b0Values[v] );
+            float sum = 0;
+            for (int k=0; k<odf.Size(); k++)
+                sum += (float) odf[k];
+            oit3.Set( sum-1 );
+            oit4.Set(coeffPixel);
+            ++oit;  // odf image iterator
+            ++oit3; // odf sum image iterator
+            ++oit2; // b0 image iterator
+            ++oit4; // coefficient image iterator
         }
-
-        oit.Set( odf );
-        oit2.Set( b0 );
-        float sum = 0;
-        for (int k=0; k<odf.Size(); k++)
-            sum += (float) odf[k];
-        oit3.Set( sum-1 );
-        oit4.Set(coeffPixel);
-        ++oit;  // odf image iterator
-        ++oit3; // odf sum image iterator
-        ++oit2; // b0 image iterator
-        ++oit4; // coefficient image iterator
-        ++git;  // Gradient  image iterator
     }
 
     std::cout << "One Thread finished reconstruction" << std::endl;
 }
 
+template< class T, class TG, class TO, int L, int NODF>
+void AnalyticalDiffusionQballReconstructionImageFilter<T,TG,TO,L,NODF>
+::ReconstructBatch(const vnl_matrix<TO>& signals, unsigned int numSignals, vnl_matrix<TO>& coeffs, vnl_matrix<TO>& odfs) const
+{
+    if (m_BatchSize==1)
+    {
+        // voxel by voxel with the matrix-vector products of vnl
+        for (unsigned int r=0; r<numSignals; r++)
+        {
+            vnl_vector<TO> B = signals.get_row(r);
+            vnl_vector<TO> c = (*m_CoeffReconstructionMatrix) * B;
+            c[0] += 1.0/(2.0*sqrt(QBALL_ANAL_RECON_PI));
+            coeffs.set_row(r, c);
+            if(m_NormalizationMethod == QBAR_SOLID_ANGLE)
+                odfs.set_row(r, (*m_SphericalHarmonicBasisMatrix) * c);
+            else
+                odfs.set_row(r, (*m_ReconstructionMatrix) * B);
+        }
+        return;
+    }
+
+    if (numSignals==0)
+        return;
+
+    BatchedReconstructionProduct(signals, numSignals, m_TransposedCoeffReconstructionMatrix, coeffs);
+    for (unsigned int r=0; r<numSignals; r++)
+        coeffs[r][0] += 1.0/(2.0*sqrt(QBALL_ANAL_RECON_PI));
+    if(m_NormalizationMethod == QBAR_SOLID_ANGLE)
+        BatchedReconstructionProduct(coeffs, numSignals, m_TransposedSphericalHarmonicBasisMatrix, odfs);
+    else
+        BatchedReconstructionProduct(signals, numSignals, m_TransposedReconstructionMatrix, odfs);
+}
+
 template< class T, class TG, class TO, int L, int NODF>
 void AnalyticalDiffusionQballReconstructionImageFilter<T,TG,TO,L,NODF>
 ::tofile2(vnl_matrix<double> *pA, std::string fname)
@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vnl/vnl_vector_fixed.h"
 #include "vnl/vnl_matrix.h"
 #include "vnl/algo/vnl_svd.h"
+#include "itkBatchedReconstructionProduct.h"
 #include "itkVectorContainer.h"
 #include "itkVectorImage.h"
 
@@ -214,6 +215,11 @@ public:
     itkSetMacro( Lambda, double )
     itkGetMacro( Lambda, double )
 
+    /** Number of voxels that are reconstructed together with one matrix-matrix product
+      * (1 -> voxel by voxel with the matrix-vector products of vnl, as before batching) */
+    itkSetMacro( BatchSize, unsigned int )
+    itkGetMacro( BatchSize, unsigned int )
+
 #ifdef ITK_USE_CONCEPT_CHECKING
     /** Begin concept checking */
     itkConceptMacro(ReferenceEqualityComparableCheck,
@@ -240,6 +246,8 @@ protected:
     void PrintSelf(std::ostream& os, Indent indent) const;
 
     void ComputeReconstructionMatrix();
+    /** SH coefficients and ODFs of the first numSignals rows of signals */
+    void ReconstructBatch(const vnl_matrix<TOdfPixelType>& signals, unsigned int numSignals, vnl_matrix<TOdfPixelType>& coeffs, vnl_matrix<TOdfPixelType>& odfs) const;
     void BeforeThreadedGenerateData();
     void ThreadedGenerateData( const
                                OutputImageRegionType &outputRegionForThread, ThreadIdType);
@@ -270,6 +278,11 @@ private:
     typename CoefficientImageType::Pointer            m_CoefficientImage;
     TOdfPixelType                                     m_Delta1;
     TOdfPixelType                                     m_Delta2;
+    unsigned int                                      m_BatchSize;
+    /** transposed reconstruction matrices used by the batched reconstruction */
+    vnl_matrix<TOdfPixelType>                         m_TransposedReconstructionMatrix;
+    vnl_matrix<TOdfPixelType>                         m_TransposedCoeffReconstructionMatrix;
+    vnl_matrix<TOdfPixelType>                         m_TransposedSphericalHarmonicBasisMatrix;
 };
 
 }
@@ -0,0 +1,77 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+#ifndef __itkBatchedReconstructionProduct_h_
+#define __itkBatchedReconstructionProduct_h_
+
+#include <vnl/vnl_matrix.h>
+#include <algorithm>
+
+namespace itk{
+
+/**
+* \brief Applies a reconstruction matrix to a block of voxels at once.
+*
+* Each row of "signals" holds the measurement vector of one voxel. The reconstruction matrix is passed transposed
+* (measurements x outputs) so that the innermost loop runs over contiguous memory and can be vectorized. The outputs
+* are processed in tiles that fit into the cache, so the reconstruction matrix is loaded once per block of voxels
+* instead of once per voxel. Row r of "result" receives A*signals.get_row(r) for the first numRows rows.
+*/
+template< class T >
+void BatchedReconstructionProduct(const vnl_matrix<T>& signals, unsigned int numRows, const vnl_matrix<T>& transposedMatrix, vnl_matrix<T>& result)
+{
+    const unsigned int numInputs = transposedMatrix.rows();
+    const unsigned int numOutputs = transposedMatrix.cols();
+    const unsigned int tileSize = 64;
+
+    if (result.rows()<numRows || result.cols()!=numOutputs)
+        result.set_size(std::max(numRows, signals.rows()), numOutputs);
+
+    for (unsigned int r=0; r<numRows; r++)
+        std::fill(result[r], result[r]+numOutputs, T(0));
+
+    for (unsigned int j0=0; j0<numOutputs; j0+=tileSize)
+    {
+        const unsigned int j1 = std::min(j0+tileSize, numOutputs);
+        for (unsigned int r=0; r<numRows; r++)
+        {
+            const T* s = signals[r];
+            T* c = result[r];
+            for (unsigned int k=0; k<numInputs; k++)
+            {
+                const T sk = s[k];
+                const T* a = transposedMatrix[k];
+                for (unsigned int j=j0; j<j1; j++)
+                    c[j] += sk*a[j];
+            }
+        }
+    }
+}
+
+/**
+* \brief Copies a reconstruction matrix into a matrix of another precision, e.g. double to float for a faster product.
+*/
+template< class TOut, class TIn >
+void CastReconstructionMatrix(const vnl_matrix<TIn>& matrix, vnl_matrix<TOut>& result)
+{
+    result.set_size(matrix.rows(), matrix.cols());
+    for (unsigned int r=0; r<matrix.rows(); r++)
+        for (unsigned int c=0; c<matrix.cols(); c++)
+            result[r][c] = static_cast<TOut>(matrix[r][c]);
+}
+
+}
+
+#endif //__itkBatchedReconstructionProduct_h_
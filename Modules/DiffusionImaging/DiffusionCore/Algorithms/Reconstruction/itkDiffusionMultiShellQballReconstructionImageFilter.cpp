@@ -47,7 +47,9 @@ DiffusionMultiShellQballReconstructionImageFilter<T,TG,TO,L,NODF>
   m_BValue(1.0),
   m_Lambda(0.0),
   m_IsHemisphericalArrangementOfGradientDirections(false),
-  m_IsArithmeticProgession(false)
+  m_IsArithmeticProgession(false),
+  m_BatchSize(64),
+  m_UseFloatPrecision(false)
 {
   // At least 1 inputs is necessary for a vector image.
   // For images added one at a time we need at least six
@@ -394,6 +396,8 @@ void DiffusionMultiShellQballReconstructionImageFilter<T,TG,TO,L,NODF>
 ::BeforeThreadedGenerateData()
 {
   m_ReconstructionType = Mode_Standard1Shell;
+  if (m_BatchSize<1)
+    m_BatchSize = 1;
 
   if(m_BValueMap.size() == 4 ){
 
@@ -633,52 +637,74 @@ void DiffusionMultiShellQballReconstructionImageFilter<T,TG,TO,L,NODF>
 
   typedef typename GradientImagesType::PixelType         GradientVectorType;
 
+  // the voxels are reconstructed in blocks of m_BatchSize: the normalized signals of all voxels above the
+  // threshold are gathered in the rows of a matrix and multiplied with the reconstruction matrices at once
+  std::vector< int > signalRows(m_BatchSize);
+  vnl_matrix<double> signals(m_BatchSize, NumbersOfGradientIndicies);
+  vnl_matrix<double> coeffs(m_BatchSize, m_TransposedCoeffReconstructionMatrix.cols());
+  vnl_matrix<double> odfs(m_BatchSize, NODF);
+  vnl_vector<double> SignalVector(NumbersOfGradientIndicies);
+
   // iterate overall voxels of the gradient image region
   while( ! git.IsAtEnd() )
   {
-    GradientVectorType b = git.Get();
-    // ODF Vector
-    OdfPixelType odf(0.0);
-
-    double b0average = 0;
-    const unsigned int b0size = BZeroIndicies.size();
-    for(unsigned int i = 0; i < b0size ; ++i)
-    {
-      b0average += b[BZeroIndicies[i]];
-    }
-    b0average /= b0size;
-    bzeroIterator.Set(b0average);
-    ++bzeroIterator;
-
-    // Create the Signal Vector
-    vnl_vector<double> SignalVector(NumbersOfGradientIndicies);
-    if( (b0average != 0) && (b0average >= m_Threshold) )
+    unsigned int numVoxels = 0;
+    unsigned int numSignals = 0;
+    while( numVoxels<m_BatchSize && ! git.IsAtEnd() )
     {
+      GradientVectorType b = git.Get();
 
-      for( unsigned int i = 0; i< SignalIndicies.size(); i++ )
+      double b0average = 0;
+      const unsigned int b0size = BZeroIndicies.size();
+      for(unsigned int i = 0; i < b0size ; ++i)
       {
-        SignalVector[i] = static_cast<double>(b[SignalIndicies[i]]);
+        b0average += b[BZeroIndicies[i]];
       }
+      b0average /= b0size;
+      bzeroIterator.Set(b0average);
+      ++bzeroIterator;
+
+      // Create the Signal Vector
+      signalRows[numVoxels] = -1;
+      if( (b0average != 0) && (b0average >= m_Threshold) )
+      {
 
-      // apply threashold an generate ln(-ln(E)) signal
-      // Replace SignalVector with PreNormalized SignalVector
-      S_S0Normalization(SignalVector, b0average);
-      Projection1(SignalVector);
+        for( unsigned int i = 0; i< SignalIndicies.size(); i++ )
+        {
+          SignalVector[i] = static_cast<double>(b[SignalIndicies[i]]);
+        }
 
-      DoubleLogarithm(SignalVector);
+        // apply threashold an generate ln(-ln(E)) signal
+        // Replace SignalVector with PreNormalized SignalVector
+        S_S0Normalization(SignalVector, b0average);
+        Projection1(SignalVector);
 
-      // approximate ODF coeffs
-      vnl_vector<double>  coeffs = ( (*m_CoeffReconstructionMatrix) * SignalVector );
-      coeffs[0] = 1.0/(2.0*sqrt(M_PI));
+        DoubleLogarithm(SignalVector);
 
-      odf = element_cast<double, TO>(( (*m_ODFSphericalHarmonicBasisMatrix) * coeffs )).data_block();
-      odf *= (M_PI*4/NODF);
+        signals.set_row(numSignals, SignalVector);
+        signalRows[numVoxels] = numSignals++;
+      }
+      ++numVoxels;
+      ++git;
     }
-    // set ODF to ODF-Image
-    oit.Set( odf );
-    ++oit;
-    ++git;
 
+    // approximate ODF coeffs
+    this->ReconstructBatch(signals, numSignals, coeffs, odfs);
+
+    for (unsigned int v=0; v<numVoxels; v++)
+    {
+      // ODF Vector
+      OdfPixelType odf(0.0);
+      if (signalRows[v]>=0)
+      {
+        for (int i=0; i<NODF; i++)
+          odf[i] = static_cast<TO>(odfs[signalRows[v]][i]);
+        odf *= (M_PI*4/NODF);
+      }
+      // set ODF to ODF-Image
+      oit.Set( odf );
+      ++oit;
+    }
   }
 
   MITK_INFO << "One Thread finished reconstruction";
@@ -781,172 +807,191 @@ void DiffusionMultiShellQballReconstructionImageFilter<T,TG,TO,L,NODF>
 
 
 
+  // the final SH-fit is done in blocks of m_BatchSize voxels (see StandardOneShellReconstruction)
+  std::vector< int > signalRows(m_BatchSize);
+  vnl_matrix<double> signals(m_BatchSize, m_MaxDirections);
+  vnl_matrix<double> coeffs(m_BatchSize, m_TransposedCoeffReconstructionMatrix.cols());
+  vnl_matrix<double> odfs(m_BatchSize, NODF);
+
   // iterate overall voxels of the gradient image region
   while( ! gradientInputImageIterator.IsAtEnd() )
   {
+    unsigned int numVoxels = 0;
+    unsigned int numSignals = 0;
+    while( numVoxels<m_BatchSize && ! gradientInputImageIterator.IsAtEnd() )
+    {
+      GradientVectorType b = gradientInputImageIterator.Get();
 
-    odf = 0.0;
-    coeffPixel = 0.0;
-
-    GradientVectorType b = gradientInputImageIterator.Get();
-
-    // calculate for each shell the corresponding b0-averages
-    double shell1b0Norm =0;
-    double shell2b0Norm =0;
-    double shell3b0Norm =0;
-    double b0average = 0;
-    const unsigned int b0size = BZeroIndicies.size();
+      // calculate for each shell the corresponding b0-averages
+      double shell1b0Norm =0;
+      double shell2b0Norm =0;
+      double shell3b0Norm =0;
+      double b0average = 0;
+      const unsigned int b0size = BZeroIndicies.size();
 
-    if(b0size == 1)
-    {
-      shell1b0Norm = b[BZeroIndicies[0]];
-      shell2b0Norm = b[BZeroIndicies[0]];
-      shell3b0Norm = b[BZeroIndicies[0]];
-      b0average = b[BZeroIndicies[0]];
-    }else if(b0size % 3 ==0)
-    {
-      for(unsigned int i = 0; i < b0size ; ++i)
+      if(b0size == 1)
       {
-        if(i < b0size / 3)                          shell1b0Norm += b[BZeroIndicies[i]];
-        if(i >= b0size / 3 && i < (b0size / 3)*2)   shell2b0Norm += b[BZeroIndicies[i]];
-        if(i >= (b0size / 3) * 2)                   shell3b0Norm += b[BZeroIndicies[i]];
-      }
-      shell1b0Norm /= (b0size/3);
-      shell2b0Norm /= (b0size/3);
-      shell3b0Norm /= (b0size/3);
-      b0average = (shell1b0Norm + shell2b0Norm+ shell3b0Norm)/3;
-    }else
-    {
-      for(unsigned int i = 0; i <b0size ; ++i)
+        shell1b0Norm = b[BZeroIndicies[0]];
+        shell2b0Norm = b[BZeroIndicies[0]];
+        shell3b0Norm = b[BZeroIndicies[0]];
+        b0average = b[BZeroIndicies[0]];
+      }else if(b0size % 3 ==0)
+      {
+        for(unsigned int i = 0; i < b0size ; ++i)
+        {
+          if(i < b0size / 3)                          shell1b0Norm += b[BZeroIndicies[i]];
+          if(i >= b0size / 3 && i < (b0size / 3)*2)   shell2b0Norm += b[BZeroIndicies[i]];
+          if(i >= (b0size / 3) * 2)                   shell3b0Norm += b[BZeroIndicies[i]];
+        }
+        shell1b0Norm /= (b0size/3);
+        shell2b0Norm /= (b0size/3);
+        shell3b0Norm /= (b0size/3);
+        b0average = (shell1b0Norm + shell2b0Norm+ shell3b0Norm)/3;
+      }else
       {
-        shell1b0Norm += b[BZeroIndicies[i]];
+        for(unsigned int i = 0; i <b0size ; ++i)
+        {
+          shell1b0Norm += b[BZeroIndicies[i]];
+        }
+        shell1b0Norm /= b0size;
+        shell2b0Norm = shell1b0Norm;
+        shell3b0Norm = shell1b0Norm;
+        b0average = shell1b0Norm;
       }
-      shell1b0Norm /= b0size;
-      shell2b0Norm = shell1b0Norm;
-      shell3b0Norm = shell1b0Norm;
-      b0average = shell1b0Norm;
-    }
 
-    bzeroIterator.Set(b0average);
-    ++bzeroIterator;
+      bzeroIterator.Set(b0average);
+      ++bzeroIterator;
 
-    if( (b0average != 0) && ( b0average >= m_Threshold) )
-    {
-      // Get the Signal-Value for each Shell at each direction (specified in the ShellIndicies Vector .. this direction corresponse to this shell...)
+      signalRows[numVoxels] = -1;
+      if( (b0average != 0) && ( b0average >= m_Threshold) )
+      {
+        // Get the Signal-Value for each Shell at each direction (specified in the ShellIndicies Vector .. this direction corresponse to this shell...)
 
-      /*//fsl fix ---------------------------------------------------
-      for(int i = 0 ; i < Shell1Indiecies.size(); i++)
-        DataShell1[i] = static_cast<double>(b[Shell1Indiecies[i]]);
-      for(int i = 0 ; i < Shell2Indiecies.size(); i++)
-        DataShell2[i] = static_cast<double>(b[Shell2Indiecies[i]]);
-      for(int i = 0 ; i < Shell3Indiecies.size(); i++)
-        DataShell3[i] = static_cast<double>(b[Shell2Indiecies[i]]);
+        /*//fsl fix ---------------------------------------------------
+        for(int i = 0 ; i < Shell1Indiecies.size(); i++)
+          DataShell1[i] = static_cast<double>(b[Shell1Indiecies[i]]);
+        for(int i = 0 ; i < Shell2Indiecies.size(); i++)
+          DataShell2[i] = static_cast<double>(b[Shell2Indiecies[i]]);
+        for(int i = 0 ; i < Shell3Indiecies.size(); i++)
+          DataShell3[i] = static_cast<double>(b[Shell2Indiecies[i]]);
 
-      // Normalize the Signal: Si/S0
-      S_S0Normalization(DataShell1, shell1b0Norm);
-      S_S0Normalization(DataShell2, shell2b0Norm);
-      S_S0Normalization(DataShell3, shell2b0Norm);
-      *///fsl fix -------------------------------------------ende--
+        // Normalize the Signal: Si/S0
+        S_S0Normalization(DataShell1, shell1b0Norm);
+        S_S0Normalization(DataShell2, shell2b0Norm);
+        S_S0Normalization(DataShell3, shell2b0Norm);
+        *///fsl fix -------------------------------------------ende--
 
-      ///correct version
-      for(unsigned int i = 0 ; i < Shell1Indiecies.size(); i++)
-        DataShell1[i] = static_cast<double>(b[Shell1Indiecies[i]]);
-      for(unsigned int i = 0 ; i < Shell2Indiecies.size(); i++)
-        DataShell2[i] = static_cast<double>(b[Shell2Indiecies[i]]);
-      for(unsigned int i = 0 ; i < Shell3Indiecies.size(); i++)
-        DataShell3[i] = static_cast<double>(b[Shell3Indiecies[i]]);
+        ///correct version
+        for(unsigned int i = 0 ; i < Shell1Indiecies.size(); i++)
+          DataShell1[i] = static_cast<double>(b[Shell1Indiecies[i]]);
+        for(unsigned int i = 0 ; i < Shell2Indiecies.size(); i++)
+          DataShell2[i] = static_cast<double>(b[Shell2Indiecies[i]]);
+        for(unsigned int i = 0 ; i < Shell3Indiecies.size(); i++)
+          DataShell3[i] = static_cast<double>(b[Shell3Indiecies[i]]);
 
 
 
-      // Normalize the Signal: Si/S0
-      S_S0Normalization(DataShell1, shell1b0Norm);
-      S_S0Normalization(DataShell2, shell2b0Norm);
-      S_S0Normalization(DataShell3, shell3b0Norm);
+        // Normalize the Signal: Si/S0
+        S_S0Normalization(DataShell1, shell1b0Norm);
+        S_S0Normalization(DataShell2, shell2b0Norm);
+        S_S0Normalization(DataShell3, shell3b0Norm);
 
 
-      if(m_Interpolation_Flag)
-      {
-        E1 = tempInterpolationMatrixShell1 * DataShell1;
-        E2 = tempInterpolationMatrixShell2 * DataShell2;
-        E3 = tempInterpolationMatrixShell3 * DataShell3;
-      }else{
-        E1 = (DataShell1);
-        E2 = (DataShell2);
-        E3 = (DataShell3);
-      }
+        if(m_Interpolation_Flag)
+        {
+          E1 = tempInterpolationMatrixShell1 * DataShell1;
+          E2 = tempInterpolationMatrixShell2 * DataShell2;
+          E3 = tempInterpolationMatrixShell3 * DataShell3;
+        }else{
+          E1 = (DataShell1);
+          E2 = (DataShell2);
+          E3 = (DataShell3);
+        }
 
-      //Implements Eq. [19] and Fig. 4.
-      Projection1(E1);
-      Projection1(E2);
-      Projection1(E3);
-      //inqualities [31]. Taking the lograithm of th first tree inqualities
-      //convert the quadratic inqualities to linear ones.
-      Projection2(E1,E2,E3);
+        //Implements Eq. [19] and Fig. 4.
+        Projection1(E1);
+        Projection1(E2);
+        Projection1(E3);
+        //inqualities [31]. Taking the lograithm of th first tree inqualities
+        //convert the quadratic inqualities to linear ones.
+        Projection2(E1,E2,E3);
 
-      for( unsigned int i = 0; i< m_MaxDirections; i++ )
-      {
-        double e1 = E1.get(i);
-        double e2 = E2.get(i);
-        double e3 = E3.get(i);
+        for( unsigned int i = 0; i< m_MaxDirections; i++ )
+        {
+          double e1 = E1.get(i);
+          double e2 = E2.get(i);
+          double e3 = E3.get(i);
 
-        P2 = e2-e1*e1;
-        A = (e3 -e1*e2) / ( 2* P2);
-        B2 = A * A -(e1 * e3 - e2 * e2) /P2;
-        B = 0;
-        if(B2 > 0) B = sqrt(B2);
-        P = 0;
-        if(P2 > 0) P = sqrt(P2);
+          P2 = e2-e1*e1;
+          A = (e3 -e1*e2) / ( 2* P2);
+          B2 = A * A -(e1 * e3 - e2 * e2) /P2;
+          B = 0;
+          if(B2 > 0) B = sqrt(B2);
+          P = 0;
+          if(P2 > 0) P = sqrt(P2);
 
-        alpha = A + B;
-        beta = A - B;
+          alpha = A + B;
+          beta = A - B;
 
-        PValues.put(i, P);
-        AlphaValues.put(i, alpha);
-        BetaValues.put(i, beta);
+          PValues.put(i, P);
+          AlphaValues.put(i, alpha);
+          BetaValues.put(i, beta);
 
-      }
+        }
 
-      Projection3(PValues, AlphaValues, BetaValues);
+        Projection3(PValues, AlphaValues, BetaValues);
 
-      for(unsigned int i = 0 ; i < m_MaxDirections; i++)
-      {
-        const double fac = (PValues[i] * 2 ) / (AlphaValues[i] - BetaValues[i]);
-        lambda = 0.5 + 0.5 * std::sqrt(1 - fac * fac);;
-        ER1 = std::fabs(lambda * (AlphaValues[i] - BetaValues[i]) + (BetaValues[i] - E1.get(i) ))
-            + std::fabs(lambda * (AlphaValues[i] * AlphaValues[i] - BetaValues[i] * BetaValues[i]) + (BetaValues[i] * BetaValues[i] - E2.get(i) ))
-            + std::fabs(lambda * (AlphaValues[i] * AlphaValues[i] * AlphaValues[i] - BetaValues[i] * BetaValues[i] * BetaValues[i]) + (BetaValues[i] * BetaValues[i] * BetaValues[i] - E3.get(i) ));
-        ER2 = std::fabs((1-lambda) * (AlphaValues[i] - BetaValues[i]) + (BetaValues[i] - E1.get(i) ))
-            + std::fabs((1-lambda) * (AlphaValues[i] * AlphaValues[i] - BetaValues[i] * BetaValues[i]) + (BetaValues[i] * BetaValues[i] - E2.get(i) ))
-            + std::fabs((1-lambda) * (AlphaValues[i] * AlphaValues[i] * AlphaValues[i] - BetaValues[i] * BetaValues[i] * BetaValues[i]) + (BetaValues[i] * BetaValues[i] * BetaValues[i] - E3.get(i)));
-        if(ER1 < ER2)
-          LAValues.put(i, lambda);
-        else
-          LAValues.put(i, 1-lambda);
+        for(unsigned int i = 0 ; i < m_MaxDirections; i++)
+        {
+          const double fac = (PValues[i] * 2 ) / (AlphaValues[i] - BetaValues[i]);
+          lambda = 0.5 + 0.5 * std::sqrt(1 - fac * fac);;
+          ER1 = std::fabs(lambda * (AlphaValues[i] - BetaValues[i]) + (BetaValues[i] - E1.get(i) ))
+              + std::fabs(lambda * (AlphaValues[i] * AlphaValues[i] - BetaValues[i] * BetaValues[i]) + (BetaValues[i] * BetaValues[i] - E2.get(i) ))
+              + std::fabs(lambda * (AlphaValues[i] * AlphaValues[i] * AlphaValues[i] - BetaValues[i] * BetaValues[i] * BetaValues[i]) + (BetaValues[i] * BetaValues[i] * BetaValues[i] - E3.get(i) ));
+          ER2 = std::fabs((1-lambda) * (AlphaValues[i] - BetaValues[i]) + (BetaValues[i] - E1.get(i) ))
+              + std::fabs((1-lambda) * (AlphaValues[i] * AlphaValues[i] - BetaValues[i] * BetaValues[i]) + (BetaValues[i] * BetaValues[i] - E2.get(i) ))
+              + std::fabs((1-lambda) * (AlphaValues[i] * AlphaValues[i] * AlphaValues[i] - BetaValues[i] * BetaValues[i] * BetaValues[i]) + (BetaValues[i] * BetaValues[i] * BetaValues[i] - E3.get(i)));
+          if(ER1 < ER2)
+            LAValues.put(i, lambda);
+          else
+            LAValues.put(i, 1-lambda);
 
-      }
+        }
 
-      DoubleLogarithm(AlphaValues);
-      DoubleLogarithm(BetaValues);
+        DoubleLogarithm(AlphaValues);
+        DoubleLogarithm(BetaValues);
 
-      vnl_vector<double> SignalVector(element_product((LAValues) , (AlphaValues)-(BetaValues)) + (BetaValues));
+        vnl_vector<double> SignalVector(element_product((LAValues) , (AlphaValues)-(BetaValues)) + (BetaValues));
+        signals.set_row(numSignals, SignalVector);
+        signalRows[numVoxels] = numSignals++;
+      }
 
-      vnl_vector<double> coeffs((*m_CoeffReconstructionMatrix) *SignalVector );
+      ++numVoxels;
+      ++gradientInputImageIterator;
+    }
 
-      // the first coeff is a fix value
-      coeffs[0] = 1.0/(2.0*sqrt(M_PI));
-      coeffPixel = element_cast<double, TO>(coeffs).data_block();
+    this->ReconstructBatch(signals, numSignals, coeffs, odfs);
 
-      // Cast the Signal-Type from double to float for the ODF-Image
-      odf = element_cast<double, TO>( (*m_ODFSphericalHarmonicBasisMatrix) * coeffs ).data_block();
-      odf *= ((M_PI*4)/NODF);
-    }
+    for (unsigned int v=0; v<numVoxels; v++)
+    {
+      odf = 0.0;
+      coeffPixel = 0.0;
+      if (signalRows[v]>=0)
+      {
+        // Cast the Signal-Type from double to float for the ODF- and coefficient-image
+        for (unsigned int i=0; i<coeffs.cols(); i++)
+          coeffPixel[i] = static_cast<TO>(coeffs[signalRows[v]][i]);
+        for (int i=0; i<NODF; i++)
+          odf[i] = static_cast<TO>(odfs[signalRows[v]][i]);
+        odf *= ((M_PI*4)/NODF);
+      }
 
-    // set ODF to ODF-Image
-    coefficientImageIterator.Set(coeffPixel);
-    odfOutputImageIterator.Set( odf );
-    ++odfOutputImageIterator;
-    ++coefficientImageIterator;
-    ++gradientInputImageIterator;
+      // set ODF to ODF-Image
+      coefficientImageIterator.Set(coeffPixel);
+      odfOutputImageIterator.Set( odf );
+      ++odfOutputImageIterator;
+      ++coefficientImageIterator;
+    }
   }
 
 }
@@ -1065,6 +1110,63 @@ void DiffusionMultiShellQballReconstructionImageFilter<T,TG,TO,L,NOdfDirections>
   MatrixDoublePtr tempPtr (new vnl_matrix<double>( U->as_matrix() ));
   m_ODFSphericalHarmonicBasisMatrix  = new vnl_matrix<double>(NOdfDirections,NumberOfCoeffs);
   ComputeSphericalHarmonicsBasis(tempPtr.get(), m_ODFSphericalHarmonicBasisMatrix, LOrder);
+
+  m_TransposedCoeffReconstructionMatrix = m_CoeffReconstructionMatrix->transpose();
+  m_TransposedODFSphericalHarmonicBasisMatrix = m_ODFSphericalHarmonicBasisMatrix->transpose();
+  CastReconstructionMatrix(m_TransposedCoeffReconstructionMatrix, m_TransposedCoeffReconstructionMatrixFloat);
+  CastReconstructionMatrix(m_TransposedODFSphericalHarmonicBasisMatrix, m_TransposedODFSphericalHarmonicBasisMatrixFloat);
+}
+
+template< class T, class TG, class TO, int L, int NODF>
+void DiffusionMultiShellQballReconstructionImageFilter<T,TG,TO,L,NODF>
+::ReconstructBatch(const vnl_matrix<double>& signals, unsigned int numSignals, vnl_matrix<double>& coeffs, vnl_matrix<double>& odfs) const
+{
+  if (m_BatchSize==1)
+  {
+    // voxel by voxel with the matrix-vector products of vnl, in double precision
+    for (unsigned int r=0; r<numSignals; r++)
+    {
+      vnl_vector<double> c = (*m_CoeffReconstructionMatrix) * signals.get_row(r);
+      // the first coeff is a fix value
+      c[0] = 1.0/(2.0*sqrt(M_PI));
+      coeffs.set_row(r, c);
+      odfs.set_row(r, (*m_ODFSphericalHarmonicBasisMatrix) * c);
+    }
+    return;
+  }
+
+  if (numSignals==0)
+    return;
+
+  if (!m_UseFloatPrecision)
+  {
+    BatchedReconstructionProduct(signals, numSignals, m_TransposedCoeffReconstructionMatrix, coeffs);
+    // the first coeff is a fix value
+    for (unsigned int r=0; r<numSignals; r++)
+      coeffs[r][0] = 1.0/(2.0*sqrt(M_PI));
+    BatchedReconstructionProduct(coeffs, numSignals, m_TransposedODFSphericalHarmonicBasisMatrix, odfs);
+    return;
+  }
+
+  vnl_matrix<float> floatSignals(numSignals, signals.cols());
+  for (unsigned int r=0; r<numSignals; r++)
+    for (unsigned int c=0; c<signals.cols(); c++)
+      floatSignals[r][c] = static_cast<float>(signals[r][c]);
+
+  vnl_matrix<float> floatCoeffs(numSignals, m_TransposedCoeffReconstructionMatrixFloat.cols());
+  vnl_matrix<float> floatOdfs(numSignals, m_TransposedODFSphericalHarmonicBasisMatrixFloat.cols());
+  BatchedReconstructionProduct(floatSignals, numSignals, m_TransposedCoeffReconstructionMatrixFloat, floatCoeffs);
+  for (unsigned int r=0; r<numSignals; r++)
+    floatCoeffs[r][0] = static_cast<float>(1.0/(2.0*sqrt(M_PI)));
+  BatchedReconstructionProduct(floatCoeffs, numSignals, m_TransposedODFSphericalHarmonicBasisMatrixFloat, floatOdfs);
+
+  for (unsigned int r=0; r<numSignals; r++)
+  {
+    for (unsigned int c=0; c<floatCoeffs.cols(); c++)
+      coeffs[r][c] = floatCoeffs[r][c];
+    for (unsigned int c=0; c<floatOdfs.cols(); c++)
+      odfs[r][c] = floatOdfs[r][c];
+  }
 }
 
 template< class T, class TG, class TO, int L, int NOdfDirections>
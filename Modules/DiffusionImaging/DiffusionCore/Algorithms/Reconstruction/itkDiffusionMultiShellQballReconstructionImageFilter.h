@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define __itkDiffusionMultiShellQballReconstructionImageFilter_h_
 
 #include <itkImageToImageFilter.h>
+#include <itkBatchedReconstructionProduct.h>
 
 namespace itk{
 /** \class DiffusionMultiShellQballReconstructionImageFilter
@@ -106,6 +107,17 @@ public:
     itkSetMacro( Lambda, double )
     itkGetMacro( Lambda, double )
 
+    /** Number of voxels that are reconstructed together with one matrix-matrix product
+      * (1 -> voxel by voxel with the matrix-vector products of vnl in double precision, as before batching) */
+    itkSetMacro( BatchSize, unsigned int )
+    itkGetMacro( BatchSize, unsigned int )
+
+    /** Compute the batched products in float instead of double precision (default false).
+      * The signals and the non-linear projections stay double. */
+    itkSetMacro( UseFloatPrecision, bool )
+    itkGetMacro( UseFloatPrecision, bool )
+    itkBooleanMacro( UseFloatPrecision )
+
 protected:
     DiffusionMultiShellQballReconstructionImageFilter();
     ~DiffusionMultiShellQballReconstructionImageFilter() { }
@@ -138,6 +150,14 @@ private:
     vnl_matrix< double > * m_CoeffReconstructionMatrix;
     vnl_matrix< double > * m_ODFSphericalHarmonicBasisMatrix;
 
+    /** transposed reconstruction matrices used by the batched reconstruction */
+    vnl_matrix< double > m_TransposedCoeffReconstructionMatrix;
+    vnl_matrix< double > m_TransposedODFSphericalHarmonicBasisMatrix;
+    vnl_matrix< float > m_TransposedCoeffReconstructionMatrixFloat;
+    vnl_matrix< float > m_TransposedODFSphericalHarmonicBasisMatrixFloat;
+    unsigned int m_BatchSize;
+    bool m_UseFloatPrecision;
+
     /** container to hold gradient directions */
     GradientDirectionContainerType::Pointer m_GradientDirectionContainer;
 
@@ -181,6 +201,8 @@ private:
     void AnalyticalThreeShellReconstruction(const OutputImageRegionType& outputRegionForThread);
     void NumericalNShellReconstruction(const OutputImageRegionType& outputRegionForThread);
     void GenerateAveragedBZeroImage(const OutputImageRegionType& outputRegionForThread);
+    /** SH coefficients and ODFs of the first numSignals rows of signals, in double or float precision */
+    void ReconstructBatch(const vnl_matrix<double>& signals, unsigned int numSignals, vnl_matrix<double>& coeffs, vnl_matrix<double>& odfs) const;
     void ComputeSphericalFromCartesian(vnl_matrix<double> * Q, const IndiciesVector & refShell);
 
 
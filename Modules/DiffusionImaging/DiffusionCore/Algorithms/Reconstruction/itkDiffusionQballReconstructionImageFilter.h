@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vnl/vnl_vector_fixed.h"
 #include "vnl/vnl_matrix.h"
 #include "vnl/algo/vnl_svd.h"
+#include "itkBatchedReconstructionProduct.h"
 #include "itkVectorContainer.h"
 #include "itkVectorImage.h"
 
@@ -251,6 +252,11 @@ public:
 #endif
   itkGetConstReferenceMacro( BValue, TOdfPixelType);
 
+  /** Number of voxels that are reconstructed together with one matrix-matrix product
+   * (1 -> voxel by voxel with the matrix-vector product of vnl) */
+  itkSetMacro( BatchSize, unsigned int );
+  itkGetMacro( BatchSize, unsigned int );
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro(ReferenceEqualityComparableCheck,
@@ -279,6 +285,9 @@ protected:
   /** constructs reconstrion matrix according to Tuch's algorithm */
   void ComputeReconstructionMatrix();
 
+  /** ODFs of the first numSignals rows of signals */
+  void ReconstructBatch(const vnl_matrix<TOdfPixelType>& signals, unsigned int numSignals, vnl_matrix<TOdfPixelType>& odfs) const;
+
   void BeforeThreadedGenerateData();
   void ThreadedGenerateData( const
       OutputImageRegionType &outputRegionForThread, ThreadIdType);
@@ -328,6 +337,10 @@ private:
 
   /** Normalization method to be applied */
   Normalization                                     m_NormalizationMethod;
+
+  /** Number of voxels reconstructed at once and the transposed reconstruction matrix used for it */
+  unsigned int                                      m_BatchSize;
+  vnl_matrix<TOdfPixelType>                         m_TransposedReconstructionMatrix;
 };
 
 }
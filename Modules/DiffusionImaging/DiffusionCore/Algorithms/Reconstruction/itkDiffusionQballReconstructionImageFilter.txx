@@ -47,7 +47,8 @@ namespace itk {
     m_Threshold(NumericTraits< ReferencePixelType >::NonpositiveMin()),
     m_BValue(1.0),
     m_GradientImageTypeEnumeration(Else),
-    m_DirectionsDuplicated(false)
+    m_DirectionsDuplicated(false),
+    m_BatchSize(64)
   {
     // At least 1 inputs is necessary for a vector image.
     // For images added one at a time we need at least six
@@ -94,6 +95,9 @@ namespace itk {
     // Compute reconstruction matrix that is multiplied to the data-vector
     // each voxel in order to reconstruct the ODFs
     this->ComputeReconstructionMatrix();
+    m_TransposedReconstructionMatrix = m_ReconstructionMatrix->transpose();
+    if (m_BatchSize<1)
+      m_BatchSize = 1;
 
     // Allocate the b-zero image
     m_BZeroImage = BZeroImageType::New();
@@ -267,57 +271,82 @@ namespace itk {
         gradientItContainer.push_back(git);
       }
 
+      // the voxels are reconstructed in blocks of m_BatchSize: the pre-normalized signals of all voxels above the
+      // threshold are gathered in the rows of a matrix and multiplied with the reconstruction matrix at once
+      std::vector< ReferencePixelType > b0Values(m_BatchSize);
+      std::vector< int > signalRows(m_BatchSize);
+      vnl_matrix<TOdfPixelType> signals(m_BatchSize, m_NumberOfGradientDirections);
+      vnl_matrix<TOdfPixelType> odfs(m_BatchSize, NrOdfDirections);
+
       // Following loop does the actual reconstruction work in each voxel
       // (Tuch, Q-Ball Reconstruction [1])
       while( !it.IsAtEnd() )
       {
+        unsigned int numVoxels = 0;
+        unsigned int numSignals = 0;
+        while( numVoxels<m_BatchSize && !it.IsAtEnd() )
+        {
+          // b-zero reference value
+          ReferencePixelType b0 = it.Get();
+          b0Values[numVoxels] = b0;
+          signalRows[numVoxels] = -1;
 
-        // b-zero reference value
-        ReferencePixelType b0 = it.Get();
-
-        // init ODF
-        OdfPixelType odf(0.0);
+          // threshold on reference value to suppress noisy regions
+          if( (b0 != 0) && (b0 >= m_Threshold) )
+          {
 
-        // threshold on reference value to suppress noisy regions
-        if( (b0 != 0) && (b0 >= m_Threshold) )
-        {
+            // fill array of diffusion measurements
+            for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+            {
+              GradientPixelType b = gradientItContainer[i]->Get();
+              B[i] = static_cast<TOdfPixelType>(b);
+              ++(*gradientItContainer[i]);
+            }
 
-          // fill array of diffusion measurements
-          for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+            // pre-normalization according to m_NormalizationMethod
+            B = PreNormalize(B);
+            signals.set_row(numSignals, B);
+            signalRows[numVoxels] = numSignals++;
+          }
+          else
           {
-            GradientPixelType b = gradientItContainer[i]->Get();
-            B[i] = static_cast<TOdfPixelType>(b);
-            ++(*gradientItContainer[i]);
+            // in case we fall below threshold, we just increment to next voxel
+            for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+            {
+              ++(*gradientItContainer[i]);
+            }
           }
 
-          // pre-normalization according to m_NormalizationMethod
-          B = PreNormalize(B);
+          ++numVoxels;
+          ++it;
+        }
 
-          // actual reconstruction
-          odf = ( (*m_ReconstructionMatrix) * B ).data_block();
+        // actual reconstruction
+        this->ReconstructBatch(signals, numSignals, odfs);
 
-          // post-normalization according to m_NormalizationMethod
-          odf.Normalize();
-        }
-        else
+        for (unsigned int v=0; v<numVoxels; v++)
         {
-          // in case we fall below threshold, we just increment to next voxel
-          for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+          // init ODF
+          OdfPixelType odf(0.0);
+
+          if (signalRows[v]>=0)
           {
-            ++(*gradientItContainer[i]);
+            odf = odfs[signalRows[v]];
+
+            // post-normalization according to m_NormalizationMethod
+            odf.Normalize();
           }
-        }
 
-        for (int i=0; i<odf.Size(); i++)
-            if (odf.GetElement(i)!=odf.GetElement(i))
-                odf.Fill(0.0);
+          for (int i=0; i<odf.Size(); i++)
+              if (odf.GetElement(i)!=odf.GetElement(i))
+                  odf.Fill(0.0);
 
-        // set and increment output iterators
-        oit.Set( odf );
-        ++oit;
-        oit2.Set( b0 );
-        ++oit2;
-        ++it;
+          // set and increment output iterators
+          oit.Set( odf );
+          ++oit;
+          oit2.Set( b0Values[v] );
+          ++oit2;
+        }
       }
 
       // clean up
@@ -364,59 +393,106 @@ namespace itk {
           gradientind.push_back(gradientind[i]);
       }
 
+      // the voxels are reconstructed in blocks of m_BatchSize (see above)
+      typedef typename NumericTraits<ReferencePixelType>::AccumulateType B0Type;
+      std::vector< B0Type > b0Values(m_BatchSize);
+      std::vector< int > signalRows(m_BatchSize);
+      vnl_matrix<TOdfPixelType> signals(m_BatchSize, m_NumberOfGradientDirections);
+      vnl_matrix<TOdfPixelType> odfs(m_BatchSize, NrOdfDirections);
+
       // Following loop does the actual reconstruction work in each voxel
       // (Tuch, Q-Ball Reconstruction [1])
       while( !git.IsAtEnd() )
       {
-        // current vector of diffusion measurements
-        GradientVectorType b = git.Get();
-
-        // average of current b-zero reference values
-        typename NumericTraits<ReferencePixelType>::AccumulateType b0 = NumericTraits<ReferencePixelType>::Zero;
-        for(unsigned int i = 0; i < baselineind.size(); ++i)
+        unsigned int numVoxels = 0;
+        unsigned int numSignals = 0;
+        while( numVoxels<m_BatchSize && !git.IsAtEnd() )
         {
-          b0 += b[baselineind[i]];
-        }
-        b0 /= this->m_NumberOfBaselineImages;
+          // current vector of diffusion measurements
+          GradientVectorType b = git.Get();
 
-        // init resulting ODF
-        OdfPixelType odf(0.0);
+          // average of current b-zero reference values
+          B0Type b0 = NumericTraits<ReferencePixelType>::Zero;
+          for(unsigned int i = 0; i < baselineind.size(); ++i)
+          {
+            b0 += b[baselineind[i]];
+          }
+          b0 /= this->m_NumberOfBaselineImages;
+          b0Values[numVoxels] = b0;
+          signalRows[numVoxels] = -1;
 
-        // threshold on reference value to suppress noisy regions
-        if( (b0 != 0) && (b0 >= m_Threshold) )
-        {
-          for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+          // threshold on reference value to suppress noisy regions
+          if( (b0 != 0) && (b0 >= m_Threshold) )
           {
-            B[i] = static_cast<TOdfPixelType>(b[gradientind[i]]);
+            for( unsigned int i = 0; i< m_NumberOfGradientDirections; i++ )
+            {
+              B[i] = static_cast<TOdfPixelType>(b[gradientind[i]]);
+            }
+
+            // pre-normalization according to m_NormalizationMethod
+            B = PreNormalize(B);
+            signals.set_row(numSignals, B);
+            signalRows[numVoxels] = numSignals++;
           }
 
-          // pre-normalization according to m_NormalizationMethod
-          B = PreNormalize(B);
+          ++numVoxels;
+          ++git; // Gradient  image iterator
+        }
 
-          // actual reconstruction
-          odf = ( (*m_ReconstructionMatrix) * B ).data_block();
+        // actual reconstruction
+        this->ReconstructBatch(signals, numSignals, odfs);
 
-          // post-normalization according to m_NormalizationMethod
-          odf = Normalize(odf, b0);
+        for (unsigned int v=0; v<numVoxels; v++)
+        {
+          // init resulting ODF
+          OdfPixelType odf(0.0);
 
-        }
+          if (signalRows[v]>=0)
+          {
+            odf = odfs[signalRows[v]];
 
-        for (int i=0; i<odf.Size(); i++)
-            if (odf.GetElement(i)!=odf.GetElement(i))
-                odf.Fill(0.0);
+            // post-normalization according to m_NormalizationMethod
+            odf = Normalize(odf, b0Values[v]);
+          }
+
+          for (int i=0; i<odf.Size(); i++)
+              if (odf.GetElement(i)!=odf.GetElement(i))
+                  odf.Fill(0.0);
 
-        // set and increment output iterators
-        oit.Set( odf );
-        ++oit;
-        oit2.Set( b0 );
-        ++oit2;
-        ++git; // Gradient  image iterator
+          // set and increment output iterators
+          oit.Set( odf );
+          ++oit;
+          oit2.Set( b0Values[v] );
+          ++oit2;
+        }
       }
     }
 
     std::cout << "One Thread finished reconstruction" << std::endl;
   }
 
+  template< class TReferenceImagePixelType,
+  class TGradientImagePixelType,
+  class TOdfPixelType,
+    int NrOdfDirections,
+    int NrBasisFunctionCenters>
+    void DiffusionQballReconstructionImageFilter< TReferenceImagePixelType,
+    TGradientImagePixelType, TOdfPixelType, NrOdfDirections,
+    NrBasisFunctionCenters>
+    ::ReconstructBatch(const vnl_matrix<TOdfPixelType>& signals, unsigned int numSignals, vnl_matrix<TOdfPixelType>& odfs) const
+  {
+    if (m_BatchSize==1)
+    {
+      // voxel by voxel with the matrix-vector product of vnl
+      for (unsigned int r=0; r<numSignals; r++)
+        odfs.set_row(r, (*m_ReconstructionMatrix) * signals.get_row(r));
+    }
+    else if (numSignals>0)
+    {
+      BatchedReconstructionProduct(signals, numSignals, m_TransposedReconstructionMatrix, odfs);
+    }
+  }
+
   template< class TReferenceImagePixelType,
   class TGradientImagePixelType,
   class TOdfPixelType,
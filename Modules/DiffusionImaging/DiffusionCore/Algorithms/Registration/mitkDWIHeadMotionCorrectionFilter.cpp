@@ -32,16 +32,183 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 
 
+#include <algorithm>
 #include <vector>
 
+#include <itkMutexLockHolder.h>
+
 #include "mitkIOUtil.h"
 #include <itkImage.h>
 
 template< typename DiffusionPixelType>
 mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>
 ::DWIHeadMotionCorrectionFilter()
+  : m_NumberOfThreads( itk::MultiThreader::GetGlobalDefaultNumberOfThreads() ),
+    m_MaximumMemoryUsage( 0 ),
+    m_NumberOfThreadsPerRegistration( 0 )
+{
+
+}
+
+template< typename DiffusionPixelType>
+ITK_THREAD_RETURN_TYPE mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>
+::RegisterVolumesThreaderCallback( void* arg )
 {
+  itk::MultiThreader::ThreadInfoStruct* info = static_cast< itk::MultiThreader::ThreadInfoStruct* >( arg );
+  VolumeRegistrationData* data = static_cast< VolumeRegistrationData* >( info->UserData );
+
+  mitk::PyramidImageRegistrationMethod::Pointer registrationMethod = mitk::PyramidImageRegistrationMethod::New();
+  registrationMethod->SetFixedImage( data->fixedImages[ info->ThreadID ] );
+  registrationMethod->SetCrossModality( data->crossModality );
+  if( data->affine )
+    registrationMethod->SetTransformToAffine();
+  else
+    registrationMethod->SetTransformToRigid();
+
+  // use the advanced (windowed sinc) interpolation
+  registrationMethod->SetUseAdvancedInterpolation(true);
+
+  registrationMethod->SetNumberOfThreads( data->threadsPerRegistration );
+
+  const unsigned int numberOfVolumes = data->endVolume - data->firstVolume;
+
+  while( true )
+  {
+    unsigned int i = 0;
+    {
+      itk::MutexLockHolder< itk::SimpleFastMutexLock > lock( data->mutex );
+      if( data->nextVolume >= data->endVolume )
+        break;
+
+      i = data->nextVolume++;
+    }
+
+    try
+    {
+      mitk::Image::Pointer movingImage;
+      {
+        // the volumes image is shared by all workers, so the time step is extracted under the lock and
+        // disconnected from the selector such that the registration does not update the shared pipeline.
+        // The lock holder releases the lock if the selector throws.
+        itk::MutexLockHolder< itk::SimpleFastMutexLock > lock( data->mutex );
+        mitk::ImageTimeSelector::Pointer t_selector = mitk::ImageTimeSelector::New();
+        t_selector->SetInput( data->volumes );
+        t_selector->SetTimeNr(i);
+        t_selector->Update();
+
+        movingImage = t_selector->GetOutput();
+        movingImage->DisconnectPipeline();
+      }
+
+      registrationMethod->SetMovingImage( movingImage );
+
+      // the ITK seed of the metric sampling comes from a global counter, which depends on the order the workers
+      // pick up the volumes, so each volume gets a fixed seed
+      registrationMethod->SetRandomSeed( i );
+
+      MITK_INFO << " === (" << i - data->firstVolume + 1 <<"/"<< numberOfVolumes << ") :: Starting registration";
+      registrationMethod->Update();
+
+      mitk::Image::Pointer resampledImage = registrationMethod->GetResampledMovingImage();
 
+      itk::MutexLockHolder< itk::SimpleFastMutexLock > lock( data->mutex );
+      data->output->SetImportVolume( resampledImage->GetData(),
+                                     i + data->outputOffset, 0, mitk::Image::CopyMemory );
+
+      if( data->transforms != NULL )
+        ( *data->transforms )[ i - data->firstVolume ] = registrationMethod->GetLastRotationMatrix();
+    }
+    catch( const std::exception& e )
+    {
+      // stop the other workers, the error is reported by RegisterVolumes
+      itk::MutexLockHolder< itk::SimpleFastMutexLock > lock( data->mutex );
+      if( data->errorMessage.empty() )
+        data->errorMessage = e.what();
+      data->nextVolume = data->endVolume;
+    }
+    catch( ... )
+    {
+      itk::MutexLockHolder< itk::SimpleFastMutexLock > lock( data->mutex );
+      if( data->errorMessage.empty() )
+        data->errorMessage = "Unknown exception";
+      data->nextVolume = data->endVolume;
+    }
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename DiffusionPixelType>
+void mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>
+::RegisterVolumes( mitk::Image* volumes, unsigned int firstVolume, mitk::Image* fixedImage,
+                   bool affine, bool crossModality,
+                   mitk::Image* output, unsigned int outputOffset,
+                   std::vector< MatrixType >* transforms )
+{
+  const unsigned int endVolume = volumes->GetTimeSteps();
+  if( endVolume <= firstVolume )
+    return;
+
+  const unsigned int numberOfVolumes = endVolume - firstVolume;
+  unsigned int numberOfWorkers = std::max( 1u, std::min( m_NumberOfThreads, numberOfVolumes ) );
+
+  if( m_MaximumMemoryUsage > 0 )
+  {
+    // estimated working memory of one registration: the moving and the resampled volume, the cached copy
+    // of the fixed image, the fixed and moving pyramids ( ~1.15 volumes each ) and the gradient image of
+    // the moving image ( 3 doubles per voxel )
+    double numberOfVoxels = 1.0;
+    for( unsigned int d=0; d<3; d++)
+      numberOfVoxels *= fixedImage->GetDimension(d);
+
+    const double bytesPerWorker = numberOfVoxels * ( 5.3 * volumes->GetPixelType().GetSize() + 3 * sizeof(double) );
+    const double maximumBytes = m_MaximumMemoryUsage * 1024.0 * 1024.0;
+
+    unsigned int memoryLimitedWorkers = static_cast<unsigned int>( maximumBytes / bytesPerWorker );
+    numberOfWorkers = std::max( 1u, std::min( numberOfWorkers, memoryLimitedWorkers ) );
+  }
+
+  VolumeRegistrationData data;
+  data.volumes = volumes;
+  data.output = output;
+  data.transforms = transforms;
+  data.firstVolume = firstVolume;
+  data.endVolume = endVolume;
+  data.nextVolume = firstVolume;
+  data.outputOffset = outputOffset;
+  data.threadsPerRegistration = m_NumberOfThreadsPerRegistration;
+  if( data.threadsPerRegistration == 0 )
+  {
+    data.threadsPerRegistration = std::max( 1u, itk::MultiThreader::GetGlobalDefaultNumberOfThreads() / numberOfWorkers );
+  }
+  data.affine = affine;
+  data.crossModality = crossModality;
+
+  if( transforms != NULL )
+    transforms->resize( numberOfVolumes );
+
+  // every worker gets its own image object on the memory of the fixed image, the workers share
+  // the voxel data but not the pipeline state of the image
+  for( unsigned int w=0; w<numberOfWorkers; w++)
+  {
+    mitk::Image::Pointer fixedView = mitk::Image::New();
+    fixedView->Initialize( fixedImage );
+    fixedView->SetImportVolume( fixedImage->GetData(), 0, 0, mitk::Image::ReferenceMemory );
+    data.fixedImages.push_back( fixedView );
+  }
+
+  MITK_INFO << " Registering " << numberOfVolumes << " volumes with " << numberOfWorkers << " thread(s), "
+            << data.threadsPerRegistration << " thread(s) per registration";
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( numberOfWorkers );
+  threader->SetSingleMethod( RegisterVolumesThreaderCallback, &data );
+  threader->SingleMethodExecute();
+
+  if( !data.errorMessage.empty() )
+  {
+    mitkThrow() << "Failed to register the volumes, the PyramidRegistration threw an exception: \n" << data.errorMessage;
+  }
 }
 
 template< typename DiffusionPixelType>
@@ -79,48 +246,11 @@ void mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>
   // first unweighted image as reference space for the registration
   mitk::Image::Pointer b0referenceImage = t_selector->GetOutput();
 
-  mitk::PyramidImageRegistrationMethod::Pointer registrationMethod = mitk::PyramidImageRegistrationMethod::New();
-  registrationMethod->SetFixedImage( b0referenceImage );
-  registrationMethod->SetTransformToRigid();
-
-  // the unweighted images are of same modality
-  registrationMethod->SetCrossModalityOff();
-
-  // use the advanced (windowed sinc) interpolation
-  registrationMethod->SetUseAdvancedInterpolation(true);
-
   // Initialize the temporary output image
   mitk::Image::Pointer registeredB0Image = b0Image->Clone();
-  const unsigned int numberOfb0Images = b0Image->GetTimeSteps();
 
-  mitk::ImageTimeSelector::Pointer t_selector2 =
-      mitk::ImageTimeSelector::New();
-
-  t_selector2->SetInput( b0Image );
-
-  for( unsigned int i=1; i<numberOfb0Images; i++)
-  {
-
-    t_selector2->SetTimeNr(i);
-    t_selector2->Update();
-
-    registrationMethod->SetMovingImage( t_selector2->GetOutput() );
-
-    try
-    {
-      MITK_INFO << " === (" << i <<"/"<< numberOfb0Images-1 << ") :: Starting registration";
-      registrationMethod->Update();
-    }
-    catch( const itk::ExceptionObject& e)
-    {
-      mitkThrow() << "Failed to register the b0 images, the PyramidRegistration threw an exception: \n" << e.what();
-    }
-
-    // import volume to the inter-results
-    registeredB0Image->SetImportVolume( registrationMethod->GetResampledMovingImage()->GetData(),
-                                       i, 0, mitk::Image::ReferenceMemory );
-
-  }
+  // the unweighted images are of same modality, register them rigidly
+  this->RegisterVolumes( b0Image, 1, b0referenceImage, false, false, registeredB0Image, 0, NULL );
 
 
   //
@@ -150,12 +280,6 @@ void mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>
   //     to perform the registration of  Image -> unweighted reference
   //
 
-  mitk::PyramidImageRegistrationMethod::Pointer weightedRegistrationMethod
-      = mitk::PyramidImageRegistrationMethod::New();
-
-  weightedRegistrationMethod->SetTransformToAffine();
-  weightedRegistrationMethod->SetCrossModalityOn();
-
   //
   //   - (3.1) Create a reference image by averaging the aligned b0 images
   //
@@ -163,10 +287,6 @@ void mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>
   // use the accumulateImageFilter as provided by the ItkAccumulateFilter method in the header file
   AccessFixedDimensionByItk_1(registeredB0Image, ItkAccumulateFilter, (4), b0referenceImage );
 
-  weightedRegistrationMethod->SetFixedImage( b0referenceImage );
-  // use the advanced (windowed sinc) interpolation
-  weightedRegistrationMethod->SetUseAdvancedInterpolation(true);
-
   //
   //   - (3.2) Register all timesteps in the splitted image onto the first reference
   //
@@ -182,41 +302,13 @@ void mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>
                                       0,0, mitk::Image::CopyMemory );
 
 
-  // mitk::Image::Pointer registeredWeighted = splittedImage->Clone();
   // this time start at 0, we have only gradient images in the 3d+t file
-  // the reference image comes form an other image
-  mitk::ImageTimeSelector::Pointer t_selector_w =
-      mitk::ImageTimeSelector::New();
-
-  t_selector_w->SetInput( splittedImage );
+  // the reference image comes form an other image, it is stored as first volume
 
   // store the rotation parts of the transformations in a vector
-  typedef mitk::PyramidImageRegistrationMethod::TransformMatrixType MatrixType;
   std::vector< MatrixType > estimated_transforms;
 
-  for( unsigned int i=0; i<maxImageIdx; i++)
-  {
-    t_selector_w->SetTimeNr(i);
-    t_selector_w->Update();
-
-    weightedRegistrationMethod->SetMovingImage( t_selector_w->GetOutput() );
-
-    try
-    {
-      MITK_INFO << " === (" << i+1 <<"/"<< maxImageIdx << ") :: Starting registration";
-      weightedRegistrationMethod->Update();
-    }
-    catch( const itk::ExceptionObject& e)
-    {
-      mitkThrow() << "Failed to register the b0 images, the PyramidRegistration threw an exception: \n" << e.what();
-    }
-
-    // allow expansion
-    registeredWeighted->SetImportVolume( weightedRegistrationMethod->GetResampledMovingImage()->GetData(),
-                                         i+1, 0, mitk::Image::CopyMemory);
-
-    estimated_transforms.push_back( weightedRegistrationMethod->GetLastRotationMatrix() );
-  }
+  this->RegisterVolumes( splittedImage, 0, b0referenceImage, true, true, registeredWeighted, 1, &estimated_transforms );
 
 
   //
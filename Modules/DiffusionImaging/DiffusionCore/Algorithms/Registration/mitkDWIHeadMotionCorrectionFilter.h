@@ -20,7 +20,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDiffusionImageToDiffusionImageFilter.h"
 
 #include <itkAccumulateImageFilter.h>
+#include <itkMultiThreader.h>
+#include <itkSimpleFastMutexLock.h>
 #include "mitkITKImageImport.h"
+#include "mitkPyramidImageRegistrationMethod.h"
+
+#include <vector>
 
 namespace mitk
 {
@@ -36,6 +41,10 @@ namespace mitk
  * as error metric. Second, the weighted gradient images are registered to the unweighted reference ( computed as average from the aligned images from first step )
  * by an affine transformation using the MattesMutualInformation metric as optimizer guidance.
  *
+ * The registrations of the single volumes are independent of each other and are executed concurrently, see
+ * SetNumberOfThreads() and SetMaximumMemoryUsage(). The random sampling of the MattesMutualInformation metric is
+ * seeded by the index of the volume, so the result is reproducible. It does not depend on the number of concurrent
+ * registrations as long as each registration uses the same number of threads, see SetNumberOfThreadsPerRegistration().
  */
 template< typename DiffusionPixelType>
 class DWIHeadMotionCorrectionFilter
@@ -56,12 +65,81 @@ public:
   typedef typename Superclass::OutputImageType        OutputImageType;
   typedef typename Superclass::OutputImagePointerType OutputImagePointerType;
 
+  /**
+   * @brief Set the number of volumes registered concurrently
+   *
+   * Defaults to the number of threads of the itk::MultiThreader, 1 registers one volume after another.
+   */
+  itkSetMacro( NumberOfThreads, unsigned int )
+  itkGetConstMacro( NumberOfThreads, unsigned int )
+
+  /**
+   * @brief Set an upper bound (in MB) for the working memory of the concurrent registrations
+   *
+   * The number of concurrent registrations is reduced such that their estimated working memory stays
+   * below this value, but at least one registration runs. 0 ( default ) means no limit.
+   */
+  itkSetMacro( MaximumMemoryUsage, unsigned int )
+  itkGetConstMacro( MaximumMemoryUsage, unsigned int )
+
+  /**
+   * @brief Set the number of threads of a single registration ( metric, pyramids and resampling )
+   *
+   * 0 ( default ) divides the threads of the itk::MultiThreader among the concurrent registrations, such that
+   * they do not oversubscribe the CPU.
+   */
+  itkSetMacro( NumberOfThreadsPerRegistration, unsigned int )
+  itkGetConstMacro( NumberOfThreadsPerRegistration, unsigned int )
+
 protected:
   DWIHeadMotionCorrectionFilter();
   virtual ~DWIHeadMotionCorrectionFilter() {}
 
   virtual void GenerateData();
 
+  typedef mitk::PyramidImageRegistrationMethod::TransformMatrixType MatrixType;
+
+  /** Shared state of the workers of RegisterVolumes() */
+  struct VolumeRegistrationData
+  {
+    mitk::Image* volumes;
+    std::vector< mitk::Image::Pointer > fixedImages;
+    mitk::Image* output;
+    std::vector< MatrixType >* transforms;
+    unsigned int firstVolume;
+    unsigned int endVolume;
+    unsigned int nextVolume;
+    unsigned int outputOffset;
+    unsigned int threadsPerRegistration;
+    bool affine;
+    bool crossModality;
+    std::string errorMessage;
+
+    // guards nextVolume, errorMessage, the access to the volumes and the output image
+    itk::SimpleFastMutexLock mutex;
+  };
+
+  /**
+   * @brief Registers the time steps [firstVolume, volumes->GetTimeSteps()) of the given image to the fixed image
+   *
+   * The resampled time step i is stored as time step i+outputOffset of the output image, the rotation parts of
+   * the transforms in the (optional) transforms vector. The volumes are distributed dynamically over
+   * the worker threads, each of them reusing its registration method for all volumes it processes.
+   */
+  void RegisterVolumes( mitk::Image* volumes, unsigned int firstVolume, mitk::Image* fixedImage,
+                        bool affine, bool crossModality,
+                        mitk::Image* output, unsigned int outputOffset,
+                        std::vector< MatrixType >* transforms );
+
+  /** @brief itk::MultiThreader callback for RegisterVolumes() */
+  static ITK_THREAD_RETURN_TYPE RegisterVolumesThreaderCallback( void* arg );
+
+  unsigned int m_NumberOfThreads;
+
+  unsigned int m_MaximumMemoryUsage;
+
+  unsigned int m_NumberOfThreadsPerRegistration;
+
   /**
    * @brief Averages an 3d+t image along the time axis.
    *
@@ -26,7 +26,13 @@ mitk::PyramidImageRegistrationMethod::PyramidImageRegistrationMethod()
     m_UseAffineTransform(true),
     m_UseWindowedSincInterpolator(false),
     m_EstimatedParameters(NULL),
-    m_Verbose(false)
+    m_Verbose(false),
+    m_UseFixedImageCache(true),
+    m_CachedFixedImageSource(NULL),
+    m_CachedFixedImageMTime(0),
+    m_NumberOfFixedImageCacheHits(0),
+    m_RandomSeed(-1),
+    m_NumberOfThreads(0)
 {
 
 }
@@ -43,10 +49,22 @@ void mitk::PyramidImageRegistrationMethod::SetFixedImage(mitk::Image::Pointer fi
 {
   if( fixed.IsNotNull() )
   {
+    if( fixed != m_FixedImage )
+    {
+      this->ClearFixedImageCache();
+    }
     m_FixedImage = fixed;
   }
 }
 
+void mitk::PyramidImageRegistrationMethod::ClearFixedImageCache()
+{
+  m_CachedFixedImage = NULL;
+  m_CachedFixedPyramid = NULL;
+  m_CachedFixedImageSource = NULL;
+  m_CachedFixedImageMTime = 0;
+}
+
 void mitk::PyramidImageRegistrationMethod::SetMovingImage(mitk::Image::Pointer moving)
 {
   if( moving.IsNotNull() )
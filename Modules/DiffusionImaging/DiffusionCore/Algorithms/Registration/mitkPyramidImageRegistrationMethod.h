@@ -27,6 +27,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkPyramidRegistrationMethodHelper.h"
 #include <itkWindowedSincInterpolateImageFunction.h>
+#include <itkMultiResolutionPyramidImageFilter.h>
+#include <itkImageDuplicator.h>
+#include <itkArray2D.h>
 
 #include "mitkImageToItk.h"
 #include "mitkITKImageImport.h"
@@ -47,6 +50,11 @@ namespace mitk
  * It uses
  *   - MattesMutualInformation for CrossModality=on ( default ) and
  *   - NormalizedCorrelation for CrossModality=off.
+ *
+ * The fixed image side of the registration ( a copy of the fixed image and its multi-resolution pyramid ) is cached
+ * and reused by subsequent calls to Update() as long as neither the fixed image ( pointer and modification time )
+ * nor the pyramid schedule change, which is the common case of registering several moving images to one reference.
+ * @sa SetUseFixedImageCache
  */
 class DiffusionCore_EXPORT PyramidImageRegistrationMethod :
     public itk::Object
@@ -122,6 +130,48 @@ public:
   /** Input image, the reference one */
   void SetFixedImage( mitk::Image::Pointer );
 
+  /**
+   * @brief Control the reuse of the fixed image pyramid across calls to Update() ( default on )
+   *
+   * The cache holds a copy of the fixed image and its pyramid, switching it off releases that memory.
+   */
+  void SetUseFixedImageCache( bool flag )
+  {
+    m_UseFixedImageCache = flag;
+    if( !flag )
+      this->ClearFixedImageCache();
+  }
+
+  /** Release the cached fixed image and pyramid */
+  void ClearFixedImageCache();
+
+  /**
+   * @brief Seed for the random sampling of the MattesMutualInformation metric
+   *
+   * A negative value ( default ) keeps the ITK seed, which is taken from a global counter and hence differs
+   * between calls. Set a seed to get reproducible results.
+   */
+  void SetRandomSeed( int seed )
+  {
+    m_RandomSeed = seed;
+  }
+
+  /**
+   * @brief Number of threads of the metric, the pyramid filters and the resampling
+   *
+   * 0 ( default ) uses the global default of the itk::MultiThreader.
+   */
+  void SetNumberOfThreads( unsigned int threads )
+  {
+    m_NumberOfThreads = threads;
+  }
+
+  /** Number of registrations which reused the cached fixed image pyramid */
+  unsigned int GetNumberOfFixedImageCacheHits() const
+  {
+    return m_NumberOfFixedImageCacheHits;
+  }
+
   /** Input image, the one to be transformed */
   void SetMovingImage( mitk::Image::Pointer );
 
@@ -213,6 +263,25 @@ protected:
   /** Control the verbosity of the regsitistration output */
   bool m_Verbose;
 
+  bool m_UseFixedImageCache;
+
+  /** Copy of the fixed image, the ITK view on the mitk image holds an accessor and can not be kept */
+  itk::DataObject::Pointer m_CachedFixedImage;
+
+  /** Pyramid filter on m_CachedFixedImage, its levels are only recomputed if its input or schedule changes */
+  itk::ProcessObject::Pointer m_CachedFixedPyramid;
+
+  /** Key of the cache: the fixed image, its modification time and the pyramid schedule */
+  const mitk::Image* m_CachedFixedImageSource;
+  unsigned long m_CachedFixedImageMTime;
+  itk::Array2D< unsigned int > m_CachedFixedImageSchedule;
+
+  unsigned int m_NumberOfFixedImageCacheHits;
+
+  int m_RandomSeed;
+
+  unsigned int m_NumberOfThreads;
+
   template <typename TPixel1, unsigned int VImageDimension1, typename TPixel2, unsigned int VImageDimension2>
   void RegisterTwoImages(itk::Image<TPixel1, VImageDimension1>* itkImage1, itk::Image<TPixel2, VImageDimension2>* itkImage2)
   {
@@ -228,6 +297,7 @@ protected:
     typedef typename itk::MattesMutualInformationImageToImageMetric< FixedImageType, MovingImageType > MMIMetricType;
     typedef typename itk::NormalizedCorrelationImageToImageMetric< FixedImageType, MovingImageType > NCMetricType;
     typedef typename itk::ImageToImageMetric< FixedImageType, MovingImageType> BaseMetricType;
+    typedef typename itk::MultiResolutionPyramidImageFilter< FixedImageType, FixedImageType > FixedPyramidType;
 
     typename itk::LinearInterpolateImageFunction<MovingImageType, double>::Pointer interpolator =
         itk::LinearInterpolateImageFunction<MovingImageType, double>::New();
@@ -237,7 +307,10 @@ protected:
 
     if( m_CrossModalityRegistration )
     {
-      metric = MMIMetricType::New();
+      typename MMIMetricType::Pointer mmiMetric = MMIMetricType::New();
+      if( m_RandomSeed >= 0 )
+        mmiMetric->ReinitializeSeed( m_RandomSeed );
+      metric = mmiMetric;
     }
     else
     {
@@ -303,6 +376,41 @@ protected:
       fixedSchedule[i][2] = std::max( fixedSchedule[i-1][2]/2, 1u);
     }
 
+    // reuse the fixed image and its pyramid from the last call if neither the image nor the schedule changed
+    typename FixedPyramidType::Pointer fixedPyramid;
+    if( m_UseFixedImageCache )
+    {
+      FixedImageType* cachedImage = dynamic_cast< FixedImageType* >( m_CachedFixedImage.GetPointer() );
+      FixedPyramidType* cachedPyramid = dynamic_cast< FixedPyramidType* >( m_CachedFixedPyramid.GetPointer() );
+
+      if( cachedImage != NULL && cachedPyramid != NULL
+          && m_CachedFixedImageSource == m_FixedImage.GetPointer()
+          && m_CachedFixedImageMTime == m_FixedImage->GetMTime()
+          && m_CachedFixedImageSchedule == fixedSchedule )
+      {
+        referenceImage = cachedImage;
+        fixedPyramid = cachedPyramid;
+      }
+      else
+      {
+        typedef itk::ImageDuplicator< FixedImageType > DuplicatorType;
+        typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
+        duplicator->SetInputImage( itkImage1 );
+        duplicator->Update();
+
+        referenceImage = duplicator->GetOutput();
+        fixedPyramid = FixedPyramidType::New();
+
+        m_CachedFixedImage = referenceImage.GetPointer();
+        m_CachedFixedPyramid = fixedPyramid.GetPointer();
+        m_CachedFixedImageSource = m_FixedImage.GetPointer();
+        m_CachedFixedImageMTime = m_FixedImage->GetMTime();
+        m_CachedFixedImageSchedule = fixedSchedule;
+      }
+
+      registration->SetFixedImagePyramid( fixedPyramid );
+    }
+
     typename OptimizerType::Pointer optimizer = OptimizerType::New();
     typename OptimizerType::ScalesType optScales( paramDim );
     optScales.Fill(10.0);
@@ -350,16 +458,37 @@ protected:
 
     registration->AddObserver( itk::IterationEvent(), pyramid_observer );
 
+    if( m_NumberOfThreads > 0 )
+    {
+      metric->SetNumberOfThreads( m_NumberOfThreads );
+      registration->SetNumberOfThreads( m_NumberOfThreads );
+      registration->GetFixedImagePyramid()->SetNumberOfThreads( m_NumberOfThreads );
+      registration->GetMovingImagePyramid()->SetNumberOfThreads( m_NumberOfThreads );
+    }
+
+    // a pyramid level which was computed before the registration started was taken from the cache
+    unsigned long fixedPyramidUpdateTime = 0;
+    if( fixedPyramid.IsNotNull() )
+    {
+      fixedPyramidUpdateTime = fixedPyramid->GetOutput(0)->GetUpdateMTime();
+    }
+
     try
     {
       registration->Update();
     }
     catch (itk::ExceptionObject &e)
     {
+      this->ClearFixedImageCache();
       MITK_ERROR << "[Registration Update] Caught ITK exception: ";
       mitkThrow() << "Registration failed with exception: " << e.what();
     }
 
+    if( fixedPyramidUpdateTime != 0 && fixedPyramid->GetOutput(0)->GetUpdateMTime() == fixedPyramidUpdateTime )
+    {
+      m_NumberOfFixedImageCacheHits++;
+    }
+
     if( m_EstimatedParameters != NULL)
     {
       delete [] m_EstimatedParameters;
@@ -397,6 +526,7 @@ protected:
 
     typename mitk::ImageToItk< ImageType >::Pointer reference_image = mitk::ImageToItk< ImageType >::New();
     reference_image->SetInput( this->m_FixedImage );
+    reference_image->ConstInputOn();
     reference_image->Update();
 
     typedef itk::MatrixOffsetTransformBase< double, 3, 3> BaseTransformType;
@@ -437,6 +567,8 @@ protected:
     resampler->SetTransform( base_transform );
     resampler->SetReferenceImage( reference_image->GetOutput() );
     resampler->UseReferenceImageOn();
+    if( m_NumberOfThreads > 0 )
+      resampler->SetNumberOfThreads( m_NumberOfThreads );
 
     resampler->Update();
 
@@ -294,12 +294,14 @@ namespace mitk
     typedef mitk::ImageToItk<ProbImageType> CastFilterType;
     typename CastFilterType::Pointer castFilter = CastFilterType::New();
     castFilter->SetInput( rgbin->r );
+    castFilter->ConstInputOn();
     castFilter->Update();
 
     typename ProbImageType::Pointer r = castFilter->GetOutput();
 
     castFilter = CastFilterType::New();
     castFilter->SetInput( rgbin->g );
+    castFilter->ConstInputOn();
     castFilter->Update();
     typename ProbImageType::Pointer g = castFilter->GetOutput();
 
@@ -626,6 +628,7 @@ namespace mitk
     typedef mitk::ImageToItk<ProbImageType> CastFilterType;
     typename CastFilterType::Pointer castFilter = CastFilterType::New();
     castFilter->SetInput( clusteredImage );
+    castFilter->ConstInputOn();
     castFilter->Update();
     typename ProbImageType::Pointer clusterImage = castFilter->GetOutput();
 
@@ -635,6 +638,7 @@ namespace mitk
       typedef mitk::ImageToItk<MaskImageType> CastFilterType2;
       typename CastFilterType2::Pointer castFilter2 = CastFilterType2::New();
       castFilter2->SetInput( mask );
+      castFilter2->ConstInputOn();
       castFilter2->Update();
       itkmask = castFilter2->GetOutput();
     }
@@ -700,16 +704,19 @@ namespace mitk
     typedef mitk::ImageToItk<ImageType> CastType;
     CastType::Pointer caster = CastType::New();
     caster->SetInput(comp1);
+    caster->ConstInputOn();
     caster->Update();
     ImageType::Pointer comp1Image = caster->GetOutput();
 
     caster = CastType::New();
     caster->SetInput(comp2);
+    caster->ConstInputOn();
     caster->Update();
     ImageType::Pointer comp2Image = caster->GetOutput();
 
     caster = CastType::New();
     caster->SetInput(probImg);
+    caster->ConstInputOn();
     caster->Update();
     ImageType::Pointer probImage = caster->GetOutput();
 
@@ -734,9 +741,9 @@ namespace mitk
     ListSampleType::Pointer listSample = ListSampleType::New();
     listSample->SetMeasurementVectorSize( MeasurementVectorLength );
 
-    itk::ImageRegionIterator<ImageType>
+    itk::ImageRegionConstIterator<ImageType>
         it1(comp1Image, comp1Image->GetLargestPossibleRegion());
-    itk::ImageRegionIterator<ImageType>
+    itk::ImageRegionConstIterator<ImageType>
         it2(comp2Image, comp2Image->GetLargestPossibleRegion());
 
     it1 = it1.Begin();
@@ -559,6 +559,7 @@ namespace mitk
     typedef mitk::ImageToItk<ImageType> CastType;
     CastType::Pointer caster = CastType::New();
     caster->SetInput(image);
+    caster->ConstInputOn();
     caster->Update();
 
     ImageMaskSpatialObject::Pointer maskSO = ImageMaskSpatialObject::New();
@@ -376,7 +376,8 @@ namespace mitk
 
         try
         {
-          setlocale(LC_ALL, currLocale.c_str());
+          if ( locale.compare(currLocale)!=0 )
+            setlocale(LC_ALL, currLocale.c_str());
         }
         catch(...)
         {
@@ -286,7 +286,8 @@ void mitk::NrrdDiffusionImageWriter<TPixelType>::GenerateData()
   }
   try
   {
-    setlocale(LC_ALL, currLocale.c_str());
+    if ( locale.compare(currLocale)!=0 )
+      setlocale(LC_ALL, currLocale.c_str());
   }
   catch(...)
   {
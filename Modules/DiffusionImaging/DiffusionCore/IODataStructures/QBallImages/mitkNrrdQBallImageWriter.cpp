@@ -117,7 +117,8 @@ void mitk::NrrdQBallImageWriter::GenerateData()
 
     try
     {
-      setlocale(LC_ALL, currLocale.c_str());
+      if ( locale.compare(currLocale)!=0 )
+        setlocale(LC_ALL, currLocale.c_str());
     }
     catch(...)
     {
@@ -352,7 +352,8 @@ void NrrdTensorImageReader
 
             try
             {
-                setlocale(LC_ALL, currLocale.c_str());
+                if ( locale.compare(currLocale)!=0 )
+                  setlocale(LC_ALL, currLocale.c_str());
             }
             catch(...)
             {
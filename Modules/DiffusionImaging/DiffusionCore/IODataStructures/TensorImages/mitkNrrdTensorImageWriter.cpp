@@ -89,7 +89,8 @@ void mitk::NrrdTensorImageWriter::GenerateData()
 
     try
     {
-      setlocale(LC_ALL, currLocale.c_str());
+      if ( locale.compare(currLocale)!=0 )
+        setlocale(LC_ALL, currLocale.c_str());
     }
     catch(...)
     {
@@ -1,5 +1,6 @@
 set(MODULE_TESTS
   mitkFactoryRegistrationTest.cpp
+  mitkQballReconstructionBatchTest.cpp
 )
 
 set(MODULE_CUSTOM_TESTS
@@ -22,6 +22,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDWIHeadMotionCorrectionFilter.h"
 #include "mitkNrrdDiffusionImageWriter.h"
 
+#include <itkImageRegionConstIterator.h>
+#include <itkTimeProbe.h>
+
 typedef short                                       DiffusionPixelType;
 typedef mitk::DiffusionImage< DiffusionPixelType >  DiffusionImageType;
 
@@ -29,6 +32,9 @@ typedef mitk::DiffusionImage< DiffusionPixelType >  DiffusionImageType;
  * @brief Custom test to provide CMD-line access to the mitk::DWIHeadMotionCorrectionFilter
  *
  * @param argv : Input and Output image full path
+ *
+ * The correction runs once with concurrent registrations and once with a single thread. The test reports both
+ * wall times and checks that the outputs are identical.
  */
 int mitkDWHeadMotionCorrectionTest( int argc, char* argv[] )
 {
@@ -46,7 +52,48 @@ int mitkDWHeadMotionCorrectionTest( int argc, char* argv[] )
       mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>::New();
 
   corrfilter->SetInput( dwimage );
+  // the metric result depends on the threads of a registration, the comparison needs the same number in both runs
+  corrfilter->SetNumberOfThreadsPerRegistration( 1 );
+
+  itk::TimeProbe parallelProbe;
+  parallelProbe.Start();
   corrfilter->Update();
+  parallelProbe.Stop();
+
+  MITK_INFO << "Head motion correction with " << corrfilter->GetNumberOfThreads() << " thread(s): "
+            << parallelProbe.GetTotal() << "s";
+
+  mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>::Pointer serialfilter =
+      mitk::DWIHeadMotionCorrectionFilter<DiffusionPixelType>::New();
+
+  serialfilter->SetInput( dwimage );
+  serialfilter->SetNumberOfThreads( 1 );
+  serialfilter->SetNumberOfThreadsPerRegistration( 1 );
+
+  itk::TimeProbe serialProbe;
+  serialProbe.Start();
+  serialfilter->Update();
+  serialProbe.Stop();
+
+  MITK_INFO << "Head motion correction with 1 thread: " << serialProbe.GetTotal() << "s";
+
+  typedef DiffusionImageType::ImageType VectorImageType;
+  VectorImageType* parallelImage = corrfilter->GetOutput()->GetVectorImage();
+  VectorImageType* serialImage = serialfilter->GetOutput()->GetVectorImage();
+
+  MITK_TEST_CONDITION_REQUIRED( parallelImage->GetLargestPossibleRegion() == serialImage->GetLargestPossibleRegion(),
+                                "Serial and parallel output have the same size" );
+
+  itk::ImageRegionConstIterator< VectorImageType > pIter( parallelImage, parallelImage->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator< VectorImageType > sIter( serialImage, serialImage->GetLargestPossibleRegion() );
+
+  bool identical = true;
+  for( ; !pIter.IsAtEnd() && identical; ++pIter, ++sIter )
+  {
+    identical = ( pIter.Get() == sIter.Get() );
+  }
+
+  MITK_TEST_CONDITION( identical, "Serial and parallel output are identical" );
 
   mitk::NrrdDiffusionImageWriter< DiffusionPixelType >::Pointer dwiwriter =
       mitk::NrrdDiffusionImageWriter< DiffusionPixelType >::New();
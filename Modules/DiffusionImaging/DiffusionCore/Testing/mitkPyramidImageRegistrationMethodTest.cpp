@@ -21,6 +21,33 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "Registration/mitkPyramidImageRegistrationMethod.h"
 
 #include <itkTransformFileWriter.h>
+#include <itkTimeProbe.h>
+
+/**
+ * @brief Registers the moving image several times to the same fixed image and returns the mean time per registration
+ */
+static double BenchmarkRepeatedRegistration( mitk::Image::Pointer fixedImage, mitk::Image::Pointer movingImage,
+                                             bool rigid, bool useCache, unsigned int runs, unsigned int& cacheHits )
+{
+  mitk::PyramidImageRegistrationMethod::Pointer method = mitk::PyramidImageRegistrationMethod::New();
+  method->SetFixedImage( fixedImage );
+  method->SetUseFixedImageCache( useCache );
+  if( rigid )
+    method->SetTransformToRigid();
+
+  itk::TimeProbe probe;
+  for( unsigned int i=0; i<runs; i++)
+  {
+    // a new moving image object each time, as for the volumes of a time series
+    method->SetMovingImage( movingImage->Clone() );
+    probe.Start();
+    method->Update();
+    probe.Stop();
+  }
+
+  cacheHits = method->GetNumberOfFixedImageCacheHits();
+  return probe.GetMean();
+}
 
 
 int mitkPyramidImageRegistrationMethodTest( int argc, char* argv[] )
@@ -151,6 +178,21 @@ int mitkPyramidImageRegistrationMethodTest( int argc, char* argv[] )
     MITK_ERROR << "Caught exception: " << e.what();
   }
 
+  // 1 fixed vs. N moving images: time per registration with and without reusing the fixed image pyramid
+  const unsigned int runs = 4;
+  unsigned int cachedHits = 0;
+  unsigned int uncachedHits = 0;
+  const bool rigid = ( type_flag == "Rigid" );
+  double cachedTime = BenchmarkRepeatedRegistration( fixedImage, movingImage, rigid, true, runs, cachedHits );
+  double uncachedTime = BenchmarkRepeatedRegistration( fixedImage, movingImage, rigid, false, runs, uncachedHits );
+
+  MITK_INFO << runs << " registrations to one fixed image: " << uncachedTime << "s per registration without cache, "
+            << cachedTime << "s with cache ( " << cachedHits << " cache hits, saving "
+            << uncachedTime - cachedTime << "s per registration )";
+
+  MITK_TEST_CONDITION( cachedHits == runs - 1, "Fixed image pyramid is reused for all but the first registration" );
+  MITK_TEST_CONDITION( uncachedHits == 0, "No reuse with disabled cache" );
+
 
   MITK_TEST_END();
 }
@@ -0,0 +1,225 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkQBallImage.h"
+
+#include <itkDiffusionQballReconstructionImageFilter.h>
+#include <itkAnalyticalDiffusionQballReconstructionImageFilter.h>
+#include <itkDiffusionMultiShellQballReconstructionImageFilter.h>
+#include <itkImageRegionIterator.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkTimeProbe.h>
+
+#include <cmath>
+
+namespace {
+
+typedef short                                                   DiffusionPixelType;
+typedef itk::VectorImage< DiffusionPixelType, 3 >               GradientImagesType;
+typedef itk::VectorContainer< unsigned int, vnl_vector_fixed< double, 3 > > GradientDirectionContainerType;
+
+typedef itk::DiffusionQballReconstructionImageFilter<DiffusionPixelType, DiffusionPixelType, float, QBALL_ODFSIZE> TuchFilterType;
+typedef itk::AnalyticalDiffusionQballReconstructionImageFilter<DiffusionPixelType, DiffusionPixelType, float, 4, QBALL_ODFSIZE> AnalyticalFilterType;
+typedef itk::DiffusionMultiShellQballReconstructionImageFilter<DiffusionPixelType, DiffusionPixelType, float, 4, QBALL_ODFSIZE> MultiShellFilterType;
+typedef TuchFilterType::OutputImageType OdfImageType;
+
+const double BMAX = 3000.0;
+
+/** Directions on a half sphere (golden section spiral), one b0 and one shell per b-value scaled as MITK stores them */
+GradientDirectionContainerType::Pointer CreateGradients(unsigned int numberOfDirections, unsigned int numberOfShells)
+{
+  GradientDirectionContainerType::Pointer gradients = GradientDirectionContainerType::New();
+  vnl_vector_fixed< double, 3 > b0(0.0);
+  gradients->push_back(b0);
+
+  for (unsigned int s=1; s<=numberOfShells; s++)
+  {
+    // b = BMAX * |g|^2
+    const double scale = std::sqrt(s*1000.0 / BMAX);
+    for (unsigned int i=0; i<numberOfDirections; i++)
+    {
+      double z = 1.0 - (i + 0.5) / numberOfDirections;
+      double r = std::sqrt(1.0 - z*z);
+      double phi = i * 2.399963229728653;
+      vnl_vector_fixed< double, 3 > g;
+      g[0] = scale * r * std::cos(phi);
+      g[1] = scale * r * std::sin(phi);
+      g[2] = scale * z;
+      gradients->push_back(g);
+    }
+  }
+  return gradients;
+}
+
+/** Two crossing tensors whose angle varies over the image, the border is below the threshold */
+GradientImagesType::Pointer CreateSignal(unsigned int size, const GradientDirectionContainerType* gradients)
+{
+  GradientImagesType::Pointer image = GradientImagesType::New();
+  GradientImagesType::RegionType region;
+  GradientImagesType::SizeType imageSize = { { size, size, size/2 } };
+  region.SetSize(imageSize);
+  image->SetRegions(region);
+  image->SetVectorLength(gradients->Size());
+  image->Allocate();
+
+  itk::ImageRegionIterator< GradientImagesType > it(image, region);
+  GradientImagesType::PixelType pixel(gradients->Size());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    GradientImagesType::IndexType index = it.GetIndex();
+    bool border = index[0]==0 || index[1]==0;
+    double angle = 3.14159265 * index[0] / size;
+    double fiber2[3] = { std::cos(angle), std::sin(angle), 0.0 };
+
+    for (unsigned int i=0; i<gradients->Size(); i++)
+    {
+      vnl_vector_fixed< double, 3 > g = gradients->ElementAt(i);
+      double b = BMAX * g.squared_magnitude();
+      double dot1 = b>0 ? g[0] / g.magnitude() : 0.0;
+      double dot2 = b>0 ? (g[0]*fiber2[0] + g[1]*fiber2[1]) / g.magnitude() : 0.0;
+      // D = 0.3e-3 + 1.4e-3 along the fiber
+      double signal = 0.5*std::exp(-b*(0.0003 + 0.0014*dot1*dot1)) + 0.5*std::exp(-b*(0.0003 + 0.0014*dot2*dot2));
+      pixel[i] = border ? 0 : static_cast<DiffusionPixelType>(1000.0 * signal + 0.5*(index[2]%3));
+    }
+    it.Set(pixel);
+  }
+  return image;
+}
+
+/** Largest difference between the ODFs of two images relative to the largest ODF value */
+double MaxRelativeDifference(OdfImageType* a, OdfImageType* b)
+{
+  itk::ImageRegionConstIterator< OdfImageType > ait(a, a->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator< OdfImageType > bit(b, b->GetLargestPossibleRegion());
+  double maxDifference = 0;
+  double maxValue = 0;
+  for (; !ait.IsAtEnd(); ++ait, ++bit)
+  {
+    for (unsigned int i=0; i<QBALL_ODFSIZE; i++)
+    {
+      maxDifference = std::max(maxDifference, (double)std::fabs(ait.Get()[i] - bit.Get()[i]));
+      maxValue = std::max(maxValue, (double)std::fabs(ait.Get()[i]));
+    }
+  }
+  return maxValue>0 ? maxDifference/maxValue : maxDifference;
+}
+
+OdfImageType::Pointer RunTuch(const GradientDirectionContainerType* gradients, const GradientImagesType* signal, unsigned int batchSize, double& seconds)
+{
+  TuchFilterType::Pointer filter = TuchFilterType::New();
+  filter->SetGradientImage(gradients, signal);
+  filter->SetBValue(BMAX);
+  filter->SetThreshold(1);
+  filter->SetNormalizationMethod(TuchFilterType::QBR_STANDARD);
+  filter->SetBatchSize(batchSize);
+  itk::TimeProbe probe;
+  probe.Start();
+  filter->Update();
+  probe.Stop();
+  seconds = probe.GetTotal();
+  return filter->GetOutput();
+}
+
+OdfImageType::Pointer RunAnalytical(const GradientDirectionContainerType* gradients, const GradientImagesType* signal, unsigned int batchSize, double& seconds)
+{
+  AnalyticalFilterType::Pointer filter = AnalyticalFilterType::New();
+  filter->SetGradientImage(gradients, signal);
+  filter->SetBValue(BMAX);
+  filter->SetThreshold(1);
+  filter->SetLambda(0.006);
+  filter->SetNormalizationMethod(AnalyticalFilterType::QBAR_SOLID_ANGLE);
+  filter->SetBatchSize(batchSize);
+  itk::TimeProbe probe;
+  probe.Start();
+  filter->Update();
+  probe.Stop();
+  seconds = probe.GetTotal();
+  return filter->GetOutput();
+}
+
+OdfImageType::Pointer RunMultiShell(const GradientDirectionContainerType* gradients, const GradientImagesType* signal, unsigned int batchSize, bool useFloat, double& seconds)
+{
+  MultiShellFilterType::Pointer filter = MultiShellFilterType::New();
+  filter->SetGradientImage(gradients, signal, BMAX);
+  filter->SetThreshold(1);
+  filter->SetLambda(0.006);
+  filter->SetBatchSize(batchSize);
+  filter->SetUseFloatPrecision(useFloat);
+  itk::TimeProbe probe;
+  probe.Start();
+  filter->Update();
+  probe.Stop();
+  seconds = probe.GetTotal();
+  return filter->GetOutput();
+}
+
+}
+
+/**
+ * Compares the batched reconstruction of the Q-ball filters to the voxel by voxel reconstruction (BatchSize 1),
+ * which uses the matrix-vector products of vnl as the filters did before batching, and reports the
+ * reconstruction times of a larger three shell image.
+ */
+int mitkQballReconstructionBatchTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("mitkQballReconstructionBatchTest");
+
+  double perVoxelTime, batchedTime, floatTime;
+
+  // single shell, an odd size leaves an incomplete last batch in every thread
+  GradientDirectionContainerType::Pointer singleShell = CreateGradients(60, 1);
+  GradientImagesType::Pointer singleShellSignal = CreateSignal(13, singleShell);
+
+  OdfImageType::Pointer perVoxel = RunTuch(singleShell, singleShellSignal, 1, perVoxelTime);
+  OdfImageType::Pointer batched = RunTuch(singleShell, singleShellSignal, 64, batchedTime);
+  MITK_TEST_CONDITION(MaxRelativeDifference(perVoxel, batched) < 1e-4, "Batched Tuch reconstruction equals the voxel by voxel reconstruction")
+
+  perVoxel = RunAnalytical(singleShell, singleShellSignal, 1, perVoxelTime);
+  batched = RunAnalytical(singleShell, singleShellSignal, 64, batchedTime);
+  MITK_TEST_CONDITION(MaxRelativeDifference(perVoxel, batched) < 1e-4, "Batched analytical reconstruction equals the voxel by voxel reconstruction")
+
+  perVoxel = RunMultiShell(singleShell, singleShellSignal, 1, false, perVoxelTime);
+  batched = RunMultiShell(singleShell, singleShellSignal, 64, false, batchedTime);
+  MITK_TEST_CONDITION(MaxRelativeDifference(perVoxel, batched) < 1e-6, "Batched single shell reconstruction equals the voxel by voxel reconstruction")
+
+  // three shells in arithmetic progression use the analytical three shell reconstruction
+  GradientDirectionContainerType::Pointer threeShells = CreateGradients(60, 3);
+  GradientImagesType::Pointer threeShellSignal = CreateSignal(13, threeShells);
+
+  perVoxel = RunMultiShell(threeShells, threeShellSignal, 1, false, perVoxelTime);
+  batched = RunMultiShell(threeShells, threeShellSignal, 64, false, batchedTime);
+  OdfImageType::Pointer batchedFloat = RunMultiShell(threeShells, threeShellSignal, 64, true, floatTime);
+  MITK_TEST_CONDITION(MaxRelativeDifference(perVoxel, batched) < 1e-6, "Batched three shell reconstruction equals the voxel by voxel reconstruction")
+  MITK_TEST_CONDITION(MaxRelativeDifference(perVoxel, batchedFloat) < 1e-3, "Float three shell reconstruction is close to the double reconstruction")
+
+  // timing run on a three shell image of 64x64x32 voxels (a 2mm whole brain has about four times as many)
+  GradientImagesType::Pointer largeSignal = CreateSignal(64, threeShells);
+  RunMultiShell(threeShells, largeSignal, 1, false, perVoxelTime);
+  RunMultiShell(threeShells, largeSignal, 64, false, batchedTime);
+  RunMultiShell(threeShells, largeSignal, 64, true, floatTime);
+  MITK_INFO << "Three shell reconstruction of 64x64x32 voxels: " << perVoxelTime << "s voxel by voxel, "
+            << batchedTime << "s batched (" << perVoxelTime/batchedTime << "x), "
+            << floatTime << "s batched in float (" << perVoxelTime/floatTime << "x)";
+
+  GradientImagesType::Pointer largeSingleShellSignal = CreateSignal(64, singleShell);
+  RunTuch(singleShell, largeSingleShellSignal, 1, perVoxelTime);
+  RunTuch(singleShell, largeSingleShellSignal, 64, batchedTime);
+  MITK_INFO << "Tuch reconstruction of 64x64x32 voxels: " << perVoxelTime << "s voxel by voxel, "
+            << batchedTime << "s batched (" << perVoxelTime/batchedTime << "x)";
+
+  MITK_TEST_END();
+}
@@ -87,6 +87,7 @@ set(H_FILES
   Algorithms/Reconstruction/itkDiffusionIntravoxelIncoherentMotionReconstructionImageFilter.h
   Algorithms/Reconstruction/itkMultiShellAdcAverageReconstructionImageFilter.h
   Algorithms/Reconstruction/itkMultiShellRadialAdcKurtosisImageFilter.h
+  Algorithms/Reconstruction/itkBatchedReconstructionProduct.h
 
   # IO Datastructures
   IODataStructures/DiffusionWeightedImages/mitkDiffusionImage.h
@@ -146,24 +146,12 @@ float EnergyComputer::SpatProb(vnl_vector_fixed<float, 3> pos)
         return 0;
 }
 
-float EnergyComputer::mbesseli0(float x)
+float EnergyComputer::ComputeTotalInternalEnergy()
 {
-    //    BESSEL_APPROXCOEFF[0] = -0.1714;
-    //    BESSEL_APPROXCOEFF[1] = 0.5332;
-    //    BESSEL_APPROXCOEFF[2] = -1.4889;
-    //    BESSEL_APPROXCOEFF[3] = 2.0389;
-    float y = x*x;
-    float erg = -0.1714;
-    erg += y*0.5332;
-    erg += y*y*-1.4889;
-    erg += y*y*y*2.0389;
-    return erg;
-}
-
-float EnergyComputer::mexp(float x)
-{
-    return((x>=7.0) ? 0 : ((x>=5.0) ? (-0.0029*x+0.0213) : ((x>=3.0) ? (-0.0215*x+0.1144) : ((x>=2.0) ? (-0.0855*x+0.3064) : ((x>=1.0) ? (-0.2325*x+0.6004) : ((x>=0.5) ? (-0.4773*x+0.8452) : ((x>=0.0) ? (-0.7869*x+1.0000) : 1 )))))));
-    //  return exp(-x);
+    float energy = 0;
+    for (int i=0; i<m_ParticleGrid->m_NumParticles; i++)
+        energy += ComputeInternalEnergy(m_ParticleGrid->GetParticle(i));
+    return energy/2;
 }
 
 int EnergyComputer::GetNumActiveVoxels()
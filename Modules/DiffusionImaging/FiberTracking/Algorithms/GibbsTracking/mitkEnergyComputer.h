@@ -52,6 +52,9 @@ public:
     virtual float ComputeInternalEnergyConnection(Particle *p1,int ep1, Particle *p2, int ep2) = 0;
     virtual float ComputeInternalEnergy(Particle *dp) = 0;
 
+    // internal energy of the complete particle configuration (each connection counted once)
+    float ComputeTotalInternalEnergy();
+
     int GetNumActiveVoxels();
 
 protected:
@@ -82,8 +85,27 @@ protected:
 
     float SpatProb(vnl_vector_fixed<float, 3> pos);
     float EvaluateOdf(vnl_vector_fixed<float, 3> &pos, vnl_vector_fixed<float, 3> dir);
-    float mbesseli0(float x);
-    float mexp(float x);
+    std::vector< float >            m_NeighborContributions;    // per neighbour model contribution, summed in neighbour order
+
+    inline float mbesseli0(float x)
+    {
+        //    BESSEL_APPROXCOEFF[0] = -0.1714;
+        //    BESSEL_APPROXCOEFF[1] = 0.5332;
+        //    BESSEL_APPROXCOEFF[2] = -1.4889;
+        //    BESSEL_APPROXCOEFF[3] = 2.0389;
+        float y = x*x;
+        float erg = -0.1714;
+        erg += y*0.5332;
+        erg += y*y*-1.4889;
+        erg += y*y*y*2.0389;
+        return erg;
+    }
+
+    inline float mexp(float x)
+    {
+        return((x>=7.0) ? 0 : ((x>=5.0) ? (-0.0029*x+0.0213) : ((x>=3.0) ? (-0.0215*x+0.1144) : ((x>=2.0) ? (-0.0855*x+0.3064) : ((x>=1.0) ? (-0.2325*x+0.6004) : ((x>=0.5) ? (-0.4773*x+0.8452) : ((x>=0.0) ? (-0.7869*x+1.0000) : 1 )))))));
+        //  return exp(-x);
+    }
 };
 
 #endif
@@ -126,24 +126,31 @@ float GibbsEnergyComputer::ComputeExternalEnergy(vnl_vector_fixed<float, 3> &R,
 
     float odfVal = EvaluateOdf(R, N);   // evaluate ODF in given direction
 
-    float modelVal = 0;
-    m_ParticleGrid->ComputeNeighbors(R);    // retrieve neighbouring particles from particle grid
-    Particle* neighbour =  m_ParticleGrid->GetNextNeighbor();
-    while (neighbour!=NULL)                         // iterate over nieghbouring particles
+    // see Reisert et al. "Global Reconstruction of Neuronal Fibers", MICCAI 2009
+    // the neighbours are gathered into contiguous arrays first so that the model evaluation can be vectorized
+    int numNeighbors = m_ParticleGrid->GatherNeighbors(R, dp);    // retrieve neighbouring particles from particle grid
+    const ParticleGrid::NeighborBuffer& nb = m_ParticleGrid->GetNeighborBuffer();
+    if ((int)m_NeighborContributions.size() < numNeighbors)
+        m_NeighborContributions.resize(numNeighbors);
+    float* contrib = numNeighbors>0 ? &m_NeighborContributions[0] : NULL;
+
+    for (int i=0; i<numNeighbors; i++)
     {
-        if (dp != neighbour)                        // don't evaluate against itself
-        {
-            // see Reisert et al. "Global Reconstruction of Neuronal Fibers", MICCAI 2009
-            float dot = fabs(dot_product(N,neighbour->dir));
-            float bw = mbesseli0(dot);
-            float dpos = (neighbour->pos-R).squared_magnitude();
-            float w = mexp(dpos*gamma_s);
-            modelVal += w*(bw+m_ParticleChemicalPotential);
-            w = mexp(dpos*gamma_reg_s);
-        }
-        neighbour =  m_ParticleGrid->GetNextNeighbor();
+        float dot = fabs(N[0]*nb.dirX[i] + N[1]*nb.dirY[i] + N[2]*nb.dirZ[i]);
+        float bw = mbesseli0(dot);
+        float dx = nb.posX[i]-R[0];
+        float dy = nb.posY[i]-R[1];
+        float dz = nb.posZ[i]-R[2];
+        float dpos = dx*dx + dy*dy + dz*dz;
+        float w = mexp(dpos*gamma_s);
+        contrib[i] = w*(bw+m_ParticleChemicalPotential);
     }
 
+    // accumulate in neighbour order to keep the results independent of the vectorization
+    float modelVal = 0;
+    for (int i=0; i<numNeighbors; i++)
+        modelVal += contrib[i];
+
     float energy = 2*(odfVal/m_ParticleWeight-modelVal) - (mbesseli0(1.0)+m_ParticleChemicalPotential);
     return energy*m_ExtStrength;
 }
@@ -51,6 +51,14 @@ ParticleGrid::ParticleGrid(ItkFloatImageType* image, float particleLength, int c
     m_NeighbourTracker.cellidx.resize(8, 0);        // allocate and initialize neighbour tracker
     m_NeighbourTracker.cellidx_c.resize(8, 0);
 
+    m_NeighborBuffer.posX.resize(8*m_CellCapacity); // allocate neighbour buffer for the maximum number of particles in 8 cells
+    m_NeighborBuffer.posY.resize(8*m_CellCapacity);
+    m_NeighborBuffer.posZ.resize(8*m_CellCapacity);
+    m_NeighborBuffer.dirX.resize(8*m_CellCapacity);
+    m_NeighborBuffer.dirY.resize(8*m_CellCapacity);
+    m_NeighborBuffer.dirZ.resize(8*m_CellCapacity);
+    m_NeighborBuffer.size = 0;
+
     for (int i = 0;i < m_ContainerCapacity;i++)     // initialize particle IDs
         m_Particles[i].ID = i;
 
@@ -334,6 +342,67 @@ Particle* ParticleGrid::GetNextNeighbor()
     }
 }
 
+int ParticleGrid::GatherNeighbors(vnl_vector_fixed<float, 3> &R, Particle* exclude)
+{
+    ComputeNeighbors(R);
+
+    int n = 0;
+    for (int c=0; c<8; c++)
+    {
+        int count = m_OccupationCount[m_NeighbourTracker.cellidx[c]];
+        Particle** cell = &m_Grid[m_NeighbourTracker.cellidx_c[c]];
+        for (int j=0; j<count; j++)
+        {
+            Particle* p = cell[j];
+            if (p == exclude)
+                continue;
+            m_NeighborBuffer.posX[n] = p->pos[0];
+            m_NeighborBuffer.posY[n] = p->pos[1];
+            m_NeighborBuffer.posZ[n] = p->pos[2];
+            m_NeighborBuffer.dirX[n] = p->dir[0];
+            m_NeighborBuffer.dirY[n] = p->dir[1];
+            m_NeighborBuffer.dirZ[n] = p->dir[2];
+            n++;
+        }
+    }
+    m_NeighborBuffer.size = n;
+    return n;
+}
+
+void ParticleGrid::SortParticles()
+{
+    // new particle IDs in grid cell order
+    std::vector< int > newIDs(m_NumParticles, -1);
+    int c = 0;
+    for (unsigned int cell=0; cell<m_OccupationCount.size(); cell++)
+        for (int j=0; j<m_OccupationCount[cell]; j++)
+            newIDs[m_Grid[cell*m_CellCapacity+j]->ID] = c++;
+
+    if (c != m_NumParticles)
+    {
+        std::cout << "ParticleGrid: grid inconsistent, particles not sorted!" << std::endl;
+        return;
+    }
+
+    std::vector< Particle > sorted(m_NumParticles);
+    for (int i=0; i<m_NumParticles; i++)
+    {
+        Particle p = m_Particles[i];
+        p.ID = newIDs[i];
+        if (p.pID != -1)
+            p.pID = newIDs[p.pID];
+        if (p.mID != -1)
+            p.mID = newIDs[p.mID];
+        sorted[p.ID] = p;
+    }
+
+    for (int i=0; i<m_NumParticles; i++)
+    {
+        m_Particles[i] = sorted[i];
+        m_Grid[m_Particles[i].gridindex] = &m_Particles[i];
+    }
+}
+
 void ParticleGrid::CreateConnection(Particle *P1,int ep1, Particle *P2, int ep2)
 {
     if (ep1 == -1)
@@ -37,6 +37,18 @@ public:
 
     typedef itk::Image< float, 3 >  ItkFloatImageType;
 
+    // positions and directions of the neighbouring particles in structure-of-arrays layout
+    struct NeighborBuffer
+    {
+        std::vector< float > posX;
+        std::vector< float > posY;
+        std::vector< float > posZ;
+        std::vector< float > dirX;
+        std::vector< float > dirY;
+        std::vector< float > dirZ;
+        int size;
+    };
+
     int m_NumParticles;         // number of particles
     int m_NumConnections;       // number of connections
     int m_NumCellOverflows;     // number of cell overflows
@@ -54,6 +66,13 @@ public:
     void ComputeNeighbors(vnl_vector_fixed<float, 3> &R);
     Particle* GetNextNeighbor();
 
+    // copy position and direction of all neighbours of R (except "exclude") into the neighbour buffer
+    int GatherNeighbors(vnl_vector_fixed<float, 3> &R, Particle* exclude);
+    const NeighborBuffer& GetNeighborBuffer() const { return m_NeighborBuffer; }
+
+    // reorder the particle container by grid cell so that neighbouring particles are close in memory (changes the particle IDs)
+    void SortParticles();
+
     void CreateConnection(Particle *P1,int ep1, Particle *P2, int ep2);
     void DestroyConnection(Particle *P1,int ep1, Particle *P2, int ep2);
     void DestroyConnection(Particle *P1,int ep1);
@@ -84,6 +103,8 @@ protected:
         int pcnt;
     } m_NeighbourTracker;
 
+    NeighborBuffer m_NeighborBuffer;
+
 };
 
 class FiberTracking_EXPORT Track
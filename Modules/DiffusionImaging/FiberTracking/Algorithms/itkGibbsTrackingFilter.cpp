@@ -66,7 +66,16 @@ GibbsTrackingFilter< ItkQBallImageType >::GibbsTrackingFilter():
     m_RandomSeed(-1),
     m_LoadParameterFile(""),
     m_LutPath(""),
-    m_IsInValidState(true)
+    m_IsInValidState(true),
+    m_SamplingMode(SINGLE_CHAIN),
+    m_NumReplicas(0),
+    m_ReplicaTemperatureRatio(1.5),
+    m_ExchangeInterval(5000),
+    m_ReplicaExchangeAcceptance(0),
+    m_TrackingTime(0),
+    m_ProposalsPerSecond(0),
+    m_SortParticles(false),
+    m_ProposalsPerRun(0)
 {
 
 }
@@ -252,6 +261,42 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
       m_BuildFibers = false;
       mitkThrow() << "Unable to load lookup tables.";
     }
+
+    MITK_INFO << "----------------------------------------";
+    MITK_INFO << "Iterations: " << m_Iterations;
+    MITK_INFO << "Steps: " << m_Steps;
+    MITK_INFO << "Particle length: " << m_ParticleLength;
+    MITK_INFO << "Particle width: " << m_ParticleWidth;
+    MITK_INFO << "Particle weight: " << m_ParticleWeight;
+    MITK_INFO << "Start temperature: " << m_StartTemperature;
+    MITK_INFO << "End temperature: " << m_EndTemperature;
+    MITK_INFO << "In/Ex balance: " << m_InexBalance;
+    MITK_INFO << "Min. fiber length: " << m_MinFiberLength;
+    MITK_INFO << "Curvature threshold: " << m_CurvatureThreshold;
+    MITK_INFO << "Random seed: " << m_RandomSeed;
+    MITK_INFO << "----------------------------------------";
+
+    if (m_SamplingMode==REPLICA_EXCHANGE)
+    {
+        preClock.Stop();
+        TimeProbe clock; clock.Start();
+        unsigned long proposals = RunReplicaExchange(interpolator, randGen, alpha, singleIts);
+        clock.Stop();
+        if (clock.GetTotal()>0)
+            m_ProposalsPerSecond = proposals/clock.GetTotal();
+        delete interpolator;
+        m_AbortTracking = true;
+        m_BuildFibers = false;
+
+        m_TrackingTime = clock.GetTotal();
+        MITK_INFO << "GibbsTrackingFilter: finished replica exchange tracking in " << m_TrackingTime << "s";
+        MITK_INFO << "GibbsTrackingFilter: preparation of the data took " << preClock.GetTotal() << "s";
+        MITK_INFO << "GibbsTrackingFilter: " << m_NumAcceptedFibers << " fibers accepted";
+        MITK_INFO << "GibbsTrackingFilter: " << m_ProposalsPerSecond << " proposals per second";
+        SaveParameters();
+        return;
+    }
+
     // initialize the actual tracking components (ParticleGrid, Metropolis Hastings Sampler and Energy Computer)
     ParticleGrid* particleGrid;
     GibbsEnergyComputer* encomp;
@@ -271,20 +316,6 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
         return;
     }
 
-    MITK_INFO << "----------------------------------------";
-    MITK_INFO << "Iterations: " << m_Iterations;
-    MITK_INFO << "Steps: " << m_Steps;
-    MITK_INFO << "Particle length: " << m_ParticleLength;
-    MITK_INFO << "Particle width: " << m_ParticleWidth;
-    MITK_INFO << "Particle weight: " << m_ParticleWeight;
-    MITK_INFO << "Start temperature: " << m_StartTemperature;
-    MITK_INFO << "End temperature: " << m_EndTemperature;
-    MITK_INFO << "In/Ex balance: " << m_InexBalance;
-    MITK_INFO << "Min. fiber length: " << m_MinFiberLength;
-    MITK_INFO << "Curvature threshold: " << m_CurvatureThreshold;
-    MITK_INFO << "Random seed: " << m_RandomSeed;
-    MITK_INFO << "----------------------------------------";
-
     // main loop
     preClock.Stop();
     TimeProbe clock; clock.Start();
@@ -299,6 +330,9 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
         float temperature = m_StartTemperature * exp(alpha*(((1.0)*m_CurrentStep)/((1.0)*m_Steps)));
         sampler->SetTemperature(temperature);
 
+        if (m_SortParticles)
+            particleGrid->SortParticles();
+
         for (unsigned long i=0; i<singleIts; i++)
         {
             ++disp;
@@ -335,6 +369,9 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
         m_NumAcceptedFibers = m_FiberPolyData->GetNumberOfLines();
     }
     clock.Stop();
+    m_TrackingTime = clock.GetTotal();
+    if (m_TrackingTime>0)
+        m_ProposalsPerSecond = counter/m_TrackingTime;
 
     delete sampler;
     delete encomp;
@@ -351,10 +388,181 @@ void GibbsTrackingFilter< ItkQBallImageType >::GenerateData()
     s = (int)preClock.GetTotal()%60;
     MITK_INFO << "GibbsTrackingFilter: preparation of the data took " << m << "m and " << s << "s";
     MITK_INFO << "GibbsTrackingFilter: " << m_NumAcceptedFibers << " fibers accepted";
+    MITK_INFO << "GibbsTrackingFilter: " << m_ProposalsPerSecond << " proposals per second";
 
     SaveParameters();
 }
 
+// run several annealing chains at different temperatures in parallel and swap their configurations (parallel tempering)
+template< class ItkQBallImageType >
+unsigned long GibbsTrackingFilter< ItkQBallImageType >::RunReplicaExchange(SphereInterpolator* interpolator, Statistics::MersenneTwisterRandomVariateGenerator* randGen, float alpha, unsigned long singleIts)
+{
+    unsigned int numReplicas = m_NumReplicas;
+    if (numReplicas==0)
+        numReplicas = this->GetNumberOfThreads();
+    if (numReplicas<2)
+        numReplicas = 2;
+    if (m_ReplicaTemperatureRatio<1)
+        m_ReplicaTemperatureRatio = 1;
+    if (m_ExchangeInterval<1)
+        m_ExchangeInterval = 1;
+
+    MITK_INFO << "GibbsTrackingFilter: replica exchange sampling with " << numReplicas << " replicas";
+    MITK_INFO << "GibbsTrackingFilter: replica temperature ratio " << m_ReplicaTemperatureRatio;
+    MITK_INFO << "GibbsTrackingFilter: exchange interval " << m_ExchangeInterval;
+
+    // every replica gets its own grid, energy computer, sampler and interpolator (the interpolator caches the last lookup)
+    m_Replicas.clear();
+    try{
+        for (unsigned int k=0; k<numReplicas; k++)
+        {
+            Replica replica;
+            replica.m_RandGen = Statistics::MersenneTwisterRandomVariateGenerator::New();
+            replica.m_RandGen->SetSeed(randGen->GetIntegerVariate());
+            replica.m_Interpolator = new SphereInterpolator(*interpolator);
+            replica.m_ParticleGrid = new ParticleGrid(m_MaskImage, m_ParticleLength, m_ParticleGridCellCapacity);
+            replica.m_EnergyComputer = new GibbsEnergyComputer(m_QBallImage, m_MaskImage, replica.m_ParticleGrid, replica.m_Interpolator, replica.m_RandGen);
+            replica.m_EnergyComputer->SetParameters(m_ParticleWeight,m_ParticleWidth,m_ConnectionPotential*m_ParticleLength*m_ParticleLength,m_CurvatureThreshold,m_InexBalance,m_ParticlePotential);
+            replica.m_Sampler = new MetropolisHastingsSampler(replica.m_ParticleGrid, replica.m_EnergyComputer, replica.m_RandGen, m_CurvatureThreshold);
+            m_Replicas.push_back(replica);
+        }
+    }
+    catch(...)
+    {
+        MITK_ERROR  << "Particle grid allocation failed. Not enough memory? Try to increase the particle length or to decrease the number of replicas.";
+        for (unsigned int k=0; k<m_Replicas.size(); k++)
+        {
+            delete m_Replicas[k].m_Sampler;
+            delete m_Replicas[k].m_EnergyComputer;
+            delete m_Replicas[k].m_ParticleGrid;
+            delete m_Replicas[k].m_Interpolator;
+        }
+        m_Replicas.clear();
+        m_IsInValidState = false;
+        m_AbortTracking = true;
+        m_BuildFibers = false;
+        return 0;
+    }
+
+    unsigned long proposals = 0;
+    unsigned long attemptedExchanges = 0;
+    unsigned long acceptedExchanges = 0;
+    m_NumAcceptedFibers = 0;
+
+    this->GetMultiThreader()->SetNumberOfThreads(std::min(numReplicas, (unsigned int)this->GetNumberOfThreads()));
+    this->GetMultiThreader()->SetSingleMethod(ReplicaThreaderCallback, this);
+
+    boost::progress_display disp(m_Steps);
+    if (!m_AbortTracking)
+    for( m_CurrentStep = 1; m_CurrentStep <= m_Steps; m_CurrentStep++ )
+    {
+        ++disp;
+        // update temperatur for simulated annealing process
+        float temperature = m_StartTemperature * exp(alpha*(((1.0)*m_CurrentStep)/((1.0)*m_Steps)));
+        for (unsigned int k=0; k<numReplicas; k++)
+        {
+            m_Replicas[k].m_Sampler->SetTemperature(temperature*pow(m_ReplicaTemperatureRatio, (float)k));
+            if (m_SortParticles)
+                m_Replicas[k].m_ParticleGrid->SortParticles();
+        }
+
+        unsigned long its = 0;
+        while (its<singleIts && !m_AbortTracking)
+        {
+            m_ProposalsPerRun = std::min(m_ExchangeInterval, singleIts-its);
+            this->GetMultiThreader()->SingleMethodExecute();
+            its += m_ProposalsPerRun;
+            proposals += numReplicas*m_ProposalsPerRun;
+
+            attemptedExchanges += numReplicas-1;
+            acceptedExchanges += ExchangeReplicas(temperature, randGen);
+
+            if (m_BuildFibers)
+            {
+                FiberBuilder fiberBuilder(m_Replicas[0].m_ParticleGrid, m_MaskImage);
+                m_FiberPolyData = fiberBuilder.iterate(m_MinFiberLength);
+                m_NumAcceptedFibers = m_FiberPolyData->GetNumberOfLines();
+                m_BuildFibers = false;
+            }
+        }
+
+        unsigned long acceptedProposals = 0;
+        for (unsigned int k=0; k<numReplicas; k++)
+            acceptedProposals += m_Replicas[k].m_Sampler->GetNumAcceptedProposals();
+        m_ProposalAcceptance = (float)acceptedProposals/(numReplicas*m_CurrentStep*singleIts);
+        m_NumParticles = m_Replicas[0].m_ParticleGrid->m_NumParticles;
+        m_NumConnections = m_Replicas[0].m_ParticleGrid->m_NumConnections;
+        m_ReplicaExchangeAcceptance = (float)acceptedExchanges/attemptedExchanges;
+
+        if (m_AbortTracking)
+            break;
+    }
+    if (m_CurrentStep > m_Steps)
+        m_CurrentStep = m_Steps;
+
+    MITK_INFO << "GibbsTrackingFilter: replica exchange acceptance " << m_ReplicaExchangeAcceptance*100 << "%";
+
+    FiberBuilder fiberBuilder(m_Replicas[0].m_ParticleGrid, m_MaskImage);
+    m_FiberPolyData = fiberBuilder.iterate(m_MinFiberLength);
+    m_NumAcceptedFibers = m_FiberPolyData->GetNumberOfLines();
+
+    for (unsigned int k=0; k<m_Replicas.size(); k++)
+    {
+        delete m_Replicas[k].m_Sampler;
+        delete m_Replicas[k].m_EnergyComputer;
+        delete m_Replicas[k].m_ParticleGrid;
+        delete m_Replicas[k].m_Interpolator;
+    }
+    m_Replicas.clear();
+    return proposals;
+}
+
+// attempt to swap the configurations of neighbouring replicas, returns the number of accepted swaps
+template< class ItkQBallImageType >
+int GibbsTrackingFilter< ItkQBallImageType >::ExchangeReplicas(float temperature, Statistics::MersenneTwisterRandomVariateGenerator* randGen)
+{
+    // the external energy is weighted with the same fixed temperature in every replica and cancels out,
+    // so only the internal energy enters the exchange probability
+    std::vector< float > energies(m_Replicas.size());
+    for (unsigned int k=0; k<m_Replicas.size(); k++)
+        energies[k] = m_Replicas[k].m_EnergyComputer->ComputeTotalInternalEnergy();
+
+    int accepted = 0;
+    for (unsigned int k=0; k+1<m_Replicas.size(); k++)
+    {
+        float t1 = temperature*pow(m_ReplicaTemperatureRatio, (float)k);
+        float t2 = t1*m_ReplicaTemperatureRatio;
+        float prob = exp((energies[k+1]-energies[k])*(1/t1-1/t2));
+
+        if (prob > 1 || randGen->GetVariate() < prob)
+        {
+            std::swap(m_Replicas[k], m_Replicas[k+1]);
+            std::swap(energies[k], energies[k+1]);
+            m_Replicas[k].m_Sampler->SetTemperature(t1);
+            m_Replicas[k+1].m_Sampler->SetTemperature(t2);
+            accepted++;
+        }
+    }
+    return accepted;
+}
+
+template< class ItkQBallImageType >
+ITK_THREAD_RETURN_TYPE GibbsTrackingFilter< ItkQBallImageType >::ReplicaThreaderCallback( void *arg )
+{
+    MultiThreader::ThreadInfoStruct* info = (MultiThreader::ThreadInfoStruct *)(arg);
+    Self* filter = (Self*)(info->UserData);
+
+    for (unsigned int k=info->ThreadID; k<filter->m_Replicas.size(); k+=info->NumberOfThreads)
+        for (unsigned long i=0; i<filter->m_ProposalsPerRun; i++)
+        {
+            if (filter->m_AbortTracking)
+                break;
+            filter->m_Replicas[k].m_Sampler->MakeProposal();
+        }
+
+    return ITK_THREAD_RETURN_VALUE;
+}
+
 template< class ItkQBallImageType >
 void GibbsTrackingFilter< ItkQBallImageType >::PrepareMaskImage()
 {
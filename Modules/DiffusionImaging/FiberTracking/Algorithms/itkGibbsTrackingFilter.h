@@ -24,6 +24,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkImage.h>
 #include <itkDiffusionTensor3D.h>
 #include <itkMersenneTwisterRandomVariateGenerator.h>
+#include <itkMultiThreader.h>
 
 // VTK
 #include <vtkSmartPointer.h>
@@ -32,10 +33,23 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkPoints.h>
 #include <vtkPolyLine.h>
 
+namespace mitk{
+class ParticleGrid;
+class MetropolisHastingsSampler;
+}
+class GibbsEnergyComputer;
+
 namespace itk{
 
 /**
-* \brief Performes global fiber tractography on the input Q-Ball or tensor image (Gibbs tracking, Reisert 2010).   */
+* \brief Performes global fiber tractography on the input Q-Ball or tensor image (Gibbs tracking, Reisert 2010).
+*
+* In the default SINGLE_CHAIN mode one Metropolis-Hastings chain is annealed on a single particle grid. The
+* REPLICA_EXCHANGE mode runs several chains in parallel (one per thread by default), each on its own particle grid and
+* at a temperature scaled by ReplicaTemperatureRatio^k. After every ExchangeInterval proposals neighbouring replicas
+* attempt to swap their configurations (parallel tempering). The output is taken from the replica at the nominal
+* annealing temperature. All replica random generators are seeded from the filter's generator, so results are
+* reproducible for a fixed RandomSeed independent of the thread scheduling.   */
 
 template< class ItkQBallImageType >
 class GibbsTrackingFilter : public ProcessObject
@@ -54,6 +68,11 @@ public:
     typedef Image< float, 3 >                       ItkFloatImageType;
     typedef vtkSmartPointer< vtkPolyData >          FiberPolyDataType;
 
+    enum SamplingMode {
+      SINGLE_CHAIN,
+      REPLICA_EXCHANGE
+    };
+
     // parameter setter
     itkSetMacro( StartTemperature, float )
     itkSetMacro( EndTemperature, float )
@@ -72,6 +91,11 @@ public:
     itkSetMacro( LoadParameterFile, std::string )
     itkSetMacro( SaveParameterFile, std::string )
     itkSetMacro( LutPath, std::string )
+    itkSetMacro( SamplingMode, SamplingMode )
+    itkSetMacro( NumReplicas, unsigned int )
+    itkSetMacro( ReplicaTemperatureRatio, float )
+    itkSetMacro( ExchangeInterval, unsigned long )
+    itkSetMacro( SortParticles, bool )
 
     // getter
     itkGetMacro( ParticleWeight, float )
@@ -84,6 +108,14 @@ public:
     itkGetMacro( ProposalAcceptance, float )
     itkGetMacro( Steps, unsigned int)
     itkGetMacro( IsInValidState, bool)
+    itkGetMacro( SamplingMode, SamplingMode )
+    itkGetMacro( NumReplicas, unsigned int )
+    itkGetMacro( ReplicaTemperatureRatio, float )
+    itkGetMacro( ExchangeInterval, unsigned long )
+    itkGetMacro( ReplicaExchangeAcceptance, float )
+    itkGetMacro( TrackingTime, double )
+    itkGetMacro( SortParticles, bool )
+    itkGetMacro( ProposalsPerSecond, double )
 
     // input data
     itkSetMacro(QBallImage, typename ItkQBallImageType::Pointer)
@@ -107,6 +139,20 @@ protected:
     bool LoadParameters();
     bool SaveParameters();
 
+    /** components of one Markov chain used in the REPLICA_EXCHANGE mode */
+    struct Replica
+    {
+        mitk::ParticleGrid*                                                 m_ParticleGrid;
+        GibbsEnergyComputer*                                                m_EnergyComputer;
+        mitk::MetropolisHastingsSampler*                                    m_Sampler;
+        SphereInterpolator*                                                 m_Interpolator;
+        Statistics::MersenneTwisterRandomVariateGenerator::Pointer          m_RandGen;
+    };
+
+    unsigned long RunReplicaExchange(SphereInterpolator* interpolator, Statistics::MersenneTwisterRandomVariateGenerator* randGen, float alpha, unsigned long singleIts);
+    int ExchangeReplicas(float temperature, Statistics::MersenneTwisterRandomVariateGenerator* randGen);
+    static ITK_THREAD_RETURN_TYPE ReplicaThreaderCallback( void *arg );
+
     // Input Images
     typename ItkQBallImageType::Pointer m_QBallImage;
     typename ItkFloatImageType::Pointer m_MaskImage;
@@ -138,6 +184,16 @@ protected:
     std::string     m_SaveParameterFile;    ///< filename of parameter file (writer)
     std::string     m_LutPath;              ///< path to lookuptables used by the sphere interpolator
     bool            m_IsInValidState;       ///< Whether the filter is in a valid state, false if error occured
+    SamplingMode    m_SamplingMode;         ///< single chain or parallel replica exchange sampling
+    unsigned int    m_NumReplicas;          ///< number of parallel chains in replica exchange mode (0 -> one per thread)
+    float           m_ReplicaTemperatureRatio;  ///< temperature ratio between neighbouring replicas (>1)
+    unsigned long   m_ExchangeInterval;     ///< number of proposals per replica between two exchange attempts
+    float           m_ReplicaExchangeAcceptance;    ///< accepted/attempted replica exchanges (0-1)
+    double          m_TrackingTime;         ///< wall time of the last sampling run in seconds
+    double          m_ProposalsPerSecond;   ///< sampling throughput of the last run (summed over all replicas)
+    bool            m_SortParticles;        ///< reorder the particle container by grid cell after each temperature step (changes the proposal sequence for a given seed)
+    std::vector< Replica >  m_Replicas;     ///< chains ordered by temperature, m_Replicas[0] runs at the nominal temperature
+    unsigned long   m_ProposalsPerRun;      ///< number of proposals each replica performs in one threaded run
 
     FiberPolyDataType m_FiberPolyData;      ///< container for reconstructed fibers
 
@@ -203,7 +203,8 @@ namespace mitk
           throw "could not open xml file";
         }
       }
-      setlocale(LC_ALL, currLocale.c_str());
+      if ( locale.compare(currLocale)!=0 )
+        setlocale(LC_ALL, currLocale.c_str());
       MITK_INFO << "Fiber bundle read";
     }
     catch(...)
@@ -35,7 +35,8 @@ void mitk::FiberBundleXWriter::GenerateData()
   {
     const std::string& locale = "C";
     const std::string& currLocale = setlocale( LC_ALL, NULL );
-    setlocale(LC_ALL, locale.c_str());
+    if ( locale.compare(currLocale)!=0 )
+      setlocale(LC_ALL, locale.c_str());
 
     MITK_INFO << "Writing fiber bundle";
     m_Success = false;
@@ -56,7 +57,8 @@ void mitk::FiberBundleXWriter::GenerateData()
     writer->SetFileTypeToASCII();
     writer->Write();
 
-    setlocale(LC_ALL, currLocale.c_str());
+    if ( locale.compare(currLocale)!=0 )
+      setlocale(LC_ALL, currLocale.c_str());
     m_Success = true;
     MITK_INFO << "Fiber bundle written";
   }
@@ -66,6 +66,7 @@ int GibbsTracking(int argc, char* argv[])
     parser.addArgument("mask", "m", ctkCommandLineParser::String, "binary mask image");
     parser.addArgument("shConvention", "s", ctkCommandLineParser::String, "sh coefficient convention (FSL, MRtrix)", string("FSL"), true);
     parser.addArgument("outFile", "o", ctkCommandLineParser::String, "output fiber bundle (.fib)", us::Any(), false);
+    parser.addArgument("replicas", "r", ctkCommandLineParser::Int, "number of parallel replica exchange chains (0: single chain)", 0, true);
 
     map<string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
     if (parsedArgs.size()==0)
@@ -181,6 +182,11 @@ int GibbsTracking(int argc, char* argv[])
 
         gibbsTracker->SetDuplicateImage(false);
         gibbsTracker->SetLoadParameterFile( paramFileName );
+        if (parsedArgs.count("replicas") && us::any_cast<int>(parsedArgs["replicas"])>0)
+        {
+            gibbsTracker->SetSamplingMode(GibbsTrackingFilterType::REPLICA_EXCHANGE);
+            gibbsTracker->SetNumReplicas(us::any_cast<int>(parsedArgs["replicas"]));
+        }
 //        gibbsTracker->SetLutPath( "" );
         gibbsTracker->Update();
 
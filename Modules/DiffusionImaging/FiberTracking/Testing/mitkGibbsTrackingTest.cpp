@@ -87,6 +87,30 @@ int mitkGibbsTrackingTest(int argc, char* argv[])
     gibbsTracker->Update();
     fib2 = mitk::FiberBundleX::New(gibbsTracker->GetFiberBundle());
     MITK_TEST_CONDITION_REQUIRED(!fib1->Equals(fib2), "check if gibbs tracking has changed after wrong seed");
+
+    // sorting the particle container changes the proposal sequence but has to keep the grid consistent
+    gibbsTracker->SetSortParticles(true);
+    gibbsTracker->SetRandomSeed(1);
+    gibbsTracker->Update();
+    fib2 = mitk::FiberBundleX::New(gibbsTracker->GetFiberBundle());
+    MITK_TEST_CONDITION_REQUIRED(fib2->GetNumFibers()>0, "check if gibbs tracking with sorted particles produced fibers");
+    MITK_TEST_CONDITION(gibbsTracker->GetProposalsPerSecond()>0, "check proposal throughput measurement");
+    gibbsTracker->SetSortParticles(false);
+
+    // replica exchange sampling has to be reproducible for a fixed seed, independent of the thread scheduling
+    gibbsTracker->SetSamplingMode(GibbsTrackingFilterType::REPLICA_EXCHANGE);
+    gibbsTracker->SetNumReplicas(4);
+    gibbsTracker->SetNumberOfThreads(4);
+    gibbsTracker->SetRandomSeed(1);
+    gibbsTracker->Update();
+    mitk::FiberBundleX::Pointer fib3 = mitk::FiberBundleX::New(gibbsTracker->GetFiberBundle());
+    MITK_TEST_CONDITION_REQUIRED(fib3->GetNumFibers()>0, "check if replica exchange tracking produced fibers");
+    MITK_TEST_CONDITION(gibbsTracker->GetReplicaExchangeAcceptance()>=0 && gibbsTracker->GetReplicaExchangeAcceptance()<=1, "check replica exchange acceptance rate");
+
+    gibbsTracker->SetNumberOfThreads(2);
+    gibbsTracker->Update();
+    mitk::FiberBundleX::Pointer fib4 = mitk::FiberBundleX::New(gibbsTracker->GetFiberBundle());
+    MITK_TEST_CONDITION_REQUIRED(fib3->Equals(fib4), "check if replica exchange tracking is reproducible");
   }
   catch(...)
   {
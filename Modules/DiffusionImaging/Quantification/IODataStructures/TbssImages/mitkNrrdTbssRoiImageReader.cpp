@@ -199,7 +199,8 @@ namespace mitk
       try
       {
         MITK_INFO << " ** Changing locale back from " << setlocale(LC_ALL, NULL) << " to '" << currLocale << "'";
-        setlocale(LC_ALL, currLocale.c_str());
+        if ( locale.compare(currLocale)!=0 )
+          setlocale(LC_ALL, currLocale.c_str());
       }
       catch(...)
       {
@@ -17,26 +17,40 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkLabeledImageToSurfaceFilter.h>
 
 #include <vtkImageChangeInformation.h>
-#include <vtkImageThreshold.h>
 #include <vtkImageGaussianSmooth.h>
-#include <vtkImageMarchingCubes.h>
+#include <vtkMarchingCubes.h>
+#include <vtkDiscreteMarchingCubes.h>
 #include <vtkPolyData.h>
 #include <vtkSmoothPolyDataFilter.h>
 #include <vtkDecimatePro.h>
 #include <vtkLinearTransform.h>
 #include <vtkMatrix4x4.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkPointData.h>
 
 #include <mitkImageAccessByItk.h>
 #include <mitkInstantiateAccessFunctions.h>
 #include <itkImageRegionIterator.h>
 #include <itkNumericTraits.h>
+#include <itkMultiThreader.h>
+#include <itkSimpleFastMutexLock.h>
+#include <itkMutexLockHolder.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
 
 
 mitk::LabeledImageToSurfaceFilter::LabeledImageToSurfaceFilter() :
 m_GaussianStandardDeviation(1.5),
 m_GenerateAllLabels(true),
 m_Label(1),
-m_BackgroundLabel(0)
+m_BackgroundLabel(0),
+m_DiscreteMarchingCubes(false),
+m_NumberOfThreads(0)
 {
 }
 
@@ -119,6 +133,325 @@ void mitk::LabeledImageToSurfaceFilter::GenerateOutputInformation()
 }
 
 
+namespace
+{
+  typedef mitk::LabeledImageToSurfaceFilter::LabelType LabelType;
+
+  // surface of one label, processed by one of the threads
+  struct LabelSurfaceJob
+  {
+    LabelType label;
+    // index extent of the label volume which is thresholded and smoothed
+    int extent[6];
+    // the extracted surface, already set by the discrete marching cubes
+    vtkPolyData* polydata;
+  };
+
+  struct LabelSurfaceThreadData
+  {
+    std::vector<LabelSurfaceJob>* jobs;
+    unsigned int nextJob;
+    itk::SimpleFastMutexLock jobMutex;
+    // Every thread owns the VTK pipelines of its labels, and the filters below keep their
+    // state in these instances (vtkImageGaussianSmooth runs single-threaded then), so their
+    // Update() runs in parallel. Connecting and deleting the pipelines registers and collects
+    // the reference loops between algorithms, executives and data objects, which goes
+    // through VTK's global garbage collector, so it is serialized. vtkDecimatePro is not
+    // known to be thread safe, so the whole decimation is serialized.
+    itk::SimpleFastMutexLock vtkMutex;
+
+    // the labeled input, accessed read-only by all threads
+    const void* scalars;
+    int scalarType;
+    vtkIdType increments[3];
+    int wholeExtent[6];
+    double spacing[3];
+
+    // parameters of the filter
+    double gaussianStandardDeviation;
+    bool smooth;
+    int smoothIteration;
+    float smoothRelaxation;
+    bool decimate;
+    float targetReduction;
+    bool singleThreadedGaussian;
+
+    // index to world transformation of the output points
+    double matrix[4][4];
+  };
+
+  template <typename T>
+  void FillLabelMask( const T* scalars, const LabelSurfaceThreadData* data, const int extent[6], double label, unsigned char* out )
+  {
+    for ( int z = extent[4]; z <= extent[5]; ++z )
+    {
+      for ( int y = extent[2]; y <= extent[3]; ++y )
+      {
+        const T* in = scalars + ( z - data->wholeExtent[4] ) * data->increments[2]
+                              + ( y - data->wholeExtent[2] ) * data->increments[1]
+                              + ( extent[0] - data->wholeExtent[0] ) * data->increments[0];
+        for ( int x = extent[0]; x <= extent[1]; ++x, in += data->increments[0] )
+        {
+          *out++ = ( static_cast<double>( *in ) == label ) ? 100 : 0;
+        }
+      }
+    }
+  }
+
+  // thresholds and smoothes the label within the extent of the job and runs the marching cubes
+  vtkPolyData* ExtractLabelSurface( LabelSurfaceThreadData* data, const LabelSurfaceJob& job )
+  {
+    vtkImageData* mask;
+    vtkImageGaussianSmooth *gaussian;
+    vtkMarchingCubes *skinExtractor;
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock( data->vtkMutex );
+
+      mask = vtkImageData::New();
+      mask->SetExtent( const_cast<int*>( job.extent ) );
+      mask->SetSpacing( data->spacing );
+      mask->SetOrigin( 0.0, 0.0, 0.0 );
+      mask->SetScalarTypeToUnsignedChar();
+      mask->SetNumberOfScalarComponents( 1 );
+      mask->AllocateScalars();
+
+      gaussian = vtkImageGaussianSmooth::New();
+      gaussian->SetInput( mask );
+      gaussian->SetDimensionality( 3  );
+      gaussian->SetRadiusFactor( 0.49 );
+      gaussian->SetStandardDeviation( data->gaussianStandardDeviation );
+      if ( data->singleThreadedGaussian )
+      {
+        gaussian->SetNumberOfThreads( 1 );
+      }
+
+      skinExtractor = vtkMarchingCubes::New();
+      skinExtractor->SetInput( gaussian->GetOutput() );
+      skinExtractor->SetValue( 0, 50 );
+    }
+
+    unsigned char* out = static_cast<unsigned char*>( mask->GetScalarPointer() );
+    switch ( data->scalarType )
+    {
+      vtkTemplateMacro( FillLabelMask( static_cast<const VTK_TT*>( data->scalars ), data, job.extent, job.label, out ) );
+    }
+
+    skinExtractor->Update();
+
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock( data->vtkMutex );
+    vtkPolyData *polydata = skinExtractor->GetOutput();
+    polydata->Register( NULL );
+    polydata->SetSource( NULL );
+
+    skinExtractor->Delete();
+    gaussian->Delete();
+    mask->Delete();
+    return polydata;
+  }
+
+  // smoothes, decimates and transforms the surface of a job to world coordinates
+  vtkPolyData* PostProcessLabelSurface( LabelSurfaceThreadData* data, vtkPolyData* polydata )
+  {
+    if ( data->smooth )
+    {
+      vtkSmoothPolyDataFilter *smoother;
+      {
+        itk::MutexLockHolder<itk::SimpleFastMutexLock> lock( data->vtkMutex );
+        smoother = vtkSmoothPolyDataFilter::New();
+        smoother->SetInput( polydata );
+        smoother->SetNumberOfIterations( data->smoothIteration );
+        smoother->SetRelaxationFactor( data->smoothRelaxation );
+        smoother->SetFeatureAngle( 60 );
+        smoother->FeatureEdgeSmoothingOff();
+        smoother->BoundarySmoothingOff();
+        smoother->SetConvergence( 0 );
+      }
+      smoother->Update();
+
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock( data->vtkMutex );
+      polydata->UnRegister( NULL );
+      polydata = smoother->GetOutput();
+      polydata->Register( NULL );
+      polydata->SetSource( NULL );
+      smoother->Delete();
+    }
+
+    if ( data->decimate )
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock( data->vtkMutex );
+
+      vtkDecimatePro *decimate = vtkDecimatePro::New();
+      decimate->SplittingOff();
+      decimate->SetErrorIsAbsolute(5);
+      decimate->SetFeatureAngle(30);
+      decimate->PreserveTopologyOn();
+      decimate->BoundaryVertexDeletionOff();
+      decimate->SetDegree(10); //std-value is 25!
+      decimate->SetInput( polydata );
+      decimate->SetTargetReduction( data->targetReduction );
+      decimate->SetMaximumError(0.002);
+      decimate->Update();
+
+      polydata->UnRegister( NULL );
+      polydata = decimate->GetOutput();
+      polydata->Register( NULL );
+      polydata->SetSource( NULL );
+      decimate->Delete();
+    }
+
+    if ( polydata->GetNumberOfPoints() > 0 )
+    {
+      vtkPoints * points = polydata->GetPoints();
+      vtkIdType n = points->GetNumberOfPoints();
+      double point[3];
+      double transformed[3];
+      for ( vtkIdType i = 0; i < n; ++i )
+      {
+        points->GetPoint( i, point );
+        for ( unsigned int r = 0; r < 3; ++r )
+        {
+          transformed[r] = data->matrix[r][0] * point[0] + data->matrix[r][1] * point[1]
+                         + data->matrix[r][2] * point[2] + data->matrix[r][3];
+        }
+        points->SetPoint( i, transformed );
+      }
+    }
+    return polydata;
+  }
+
+  ITK_THREAD_RETURN_TYPE LabelSurfaceThreaderCallback( void* arg )
+  {
+    itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>( arg );
+    LabelSurfaceThreadData* data = static_cast<LabelSurfaceThreadData*>( info->UserData );
+
+    while ( true )
+    {
+      unsigned int jobIndex;
+      {
+        itk::MutexLockHolder<itk::SimpleFastMutexLock> lock( data->jobMutex );
+        jobIndex = data->nextJob++;
+      }
+      if ( jobIndex >= data->jobs->size() )
+      {
+        break;
+      }
+
+      LabelSurfaceJob& job = ( *data->jobs )[ jobIndex ];
+      if ( job.polydata == NULL )
+      {
+        job.polydata = ExtractLabelSurface( data, job );
+      }
+      job.polydata = PostProcessLabelSurface( data, job.polydata );
+    }
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  template <typename T>
+  void ComputeLabelBoundsInternal( const T* scalars, const int extent[6], const vtkIdType increments[3], mitk::LabeledImageToSurfaceFilter::LabelBoundsMapType& labelBounds )
+  {
+    typedef mitk::LabeledImageToSurfaceFilter::LabelBoundsType LabelBoundsType;
+    itk::Index<3> index;
+    for ( int z = extent[4]; z <= extent[5]; ++z )
+    {
+      for ( int y = extent[2]; y <= extent[3]; ++y )
+      {
+        const T* in = scalars + ( z - extent[4] ) * increments[2] + ( y - extent[2] ) * increments[1];
+        // runs of voxels with the same label are merged into the bounds at once
+        int x = extent[0];
+        while ( x <= extent[1] )
+        {
+          LabelType label = static_cast<LabelType>( *in );
+          int runStart = x;
+          for ( ++x, in += increments[0]; x <= extent[1] && static_cast<LabelType>( *in ) == label; ++x, in += increments[0] )
+          {
+          }
+
+          index[0] = runStart;
+          index[1] = y;
+          index[2] = z;
+          std::pair<mitk::LabeledImageToSurfaceFilter::LabelBoundsMapType::iterator, bool> inserted =
+            labelBounds.insert( std::make_pair( label, LabelBoundsType( index, index ) ) );
+          LabelBoundsType& bounds = inserted.first->second;
+          for ( unsigned int d = 0; d < 3; ++d )
+            bounds.first[d] = std::min( bounds.first[d], index[d] );
+          index[0] = x - 1;
+          for ( unsigned int d = 0; d < 3; ++d )
+            bounds.second[d] = std::max( bounds.second[d], index[d] );
+        }
+      }
+    }
+  }
+
+  // splits the output of the discrete marching cubes into one surface per label in one pass over the cells
+  void SplitDiscreteSurface( vtkPolyData* input, std::vector<LabelSurfaceJob>& jobs )
+  {
+    std::map<LabelType, std::size_t> jobOfLabel;
+    for ( std::size_t i = 0; i < jobs.size(); ++i )
+    {
+      jobOfLabel[ jobs[i].label ] = i;
+    }
+
+    vtkDataArray* cellLabels = input->GetCellData()->GetScalars();
+    vtkDataArray* pointLabels = input->GetPointData()->GetScalars();
+
+    // bucket the cells by label
+    std::vector< std::vector<vtkIdType> > cellsOfJob( jobs.size() );
+    vtkCellArray* polys = input->GetPolys();
+    vtkIdType npts;
+    vtkIdType* pts;
+    vtkIdType cellId = 0;
+    for ( polys->InitTraversal(); polys->GetNextCell( npts, pts ); ++cellId )
+    {
+      double label = 0.0;
+      if ( cellLabels != NULL )
+        label = cellLabels->GetTuple1( cellId );
+      else if ( pointLabels != NULL && npts > 0 )
+        label = pointLabels->GetTuple1( pts[0] );
+      std::map<LabelType, std::size_t>::iterator it = jobOfLabel.find( static_cast<LabelType>( label ) );
+      if ( it != jobOfLabel.end() )
+        cellsOfJob[ it->second ].push_back( polys->GetTraversalLocation( npts ) );
+    }
+
+    // copy the cells of every label, the point map is reset after each label
+    vtkPoints* inputPoints = input->GetPoints();
+    std::vector<vtkIdType> pointMap( input->GetNumberOfPoints(), -1 );
+    vtkIdType* connectivity = polys->GetPointer();
+    for ( std::size_t i = 0; i < jobs.size(); ++i )
+    {
+      vtkPoints* points = vtkPoints::New();
+      vtkCellArray* cells = vtkCellArray::New();
+      std::vector<vtkIdType> usedPoints;
+
+      for ( std::vector<vtkIdType>::const_iterator it = cellsOfJob[i].begin(); it != cellsOfJob[i].end(); ++it )
+      {
+        vtkIdType cellSize = connectivity[ *it ];
+        const vtkIdType* cellPoints = connectivity + *it + 1;
+        cells->InsertNextCell( cellSize );
+        for ( vtkIdType p = 0; p < cellSize; ++p )
+        {
+          vtkIdType& mapped = pointMap[ cellPoints[p] ];
+          if ( mapped < 0 )
+          {
+            mapped = points->InsertNextPoint( inputPoints->GetPoint( cellPoints[p] ) );
+            usedPoints.push_back( cellPoints[p] );
+          }
+          cells->InsertCellPoint( mapped );
+        }
+      }
+      for ( std::vector<vtkIdType>::const_iterator it = usedPoints.begin(); it != usedPoints.end(); ++it )
+      {
+        pointMap[ *it ] = -1;
+      }
+
+      jobs[i].polydata = vtkPolyData::New();
+      jobs[i].polydata->SetPoints( points );
+      jobs[i].polydata->SetPolys( cells );
+      points->Delete();
+      cells->Delete();
+    }
+  }
+}
+
 void mitk::LabeledImageToSurfaceFilter::GenerateData()
 {
   mitk::Image* image =  ( mitk::Image* )GetInput();
@@ -136,9 +469,9 @@ void mitk::LabeledImageToSurfaceFilter::GenerateData()
     return;
 
   //
-  // traverse the known labels and create surfaces for them.
+  // collect the known labels in the order of the outputs
   //
-  unsigned int currentOutputIndex = 0;
+  std::vector<LabelType> labels;
   for ( LabelMapType::iterator it = m_AvailableLabels.begin() ; it != m_AvailableLabels.end() ; ++it )
   {
     if ( it->first == m_BackgroundLabel )
@@ -146,134 +479,153 @@ void mitk::LabeledImageToSurfaceFilter::GenerateData()
     if ( ( it->second == 0 ) && m_GenerateAllLabels )
       continue;
 
-    assert ( currentOutputIndex < this->GetNumberOfOutputs() );
-    mitk::Surface::Pointer surface = this->GetOutput( currentOutputIndex );
-    assert( surface.IsNotNull() );
-
-    int tstart=outputRegion.GetIndex(3);
-    int tmax=tstart+outputRegion.GetSize(3); //GetSize()==1 - will aber 0 haben, wenn nicht zeitaufgeloet
-    int t;
-    for( t=tstart; t < tmax; ++t)
-    {
-      vtkImageData *vtkimagedata =  image->GetVtkImageData( t );
-      CreateSurface( t,vtkimagedata,surface.GetPointer(), it->first );
-    }
-    m_IdxToLabels[ currentOutputIndex ] = it->first;
-    currentOutputIndex++;
+    assert ( labels.size() < this->GetNumberOfOutputs() );
+    m_IdxToLabels[ labels.size() ] = it->first;
+    labels.push_back( it->first );
   }
-}
 
-void mitk::LabeledImageToSurfaceFilter::CreateSurface( int time, vtkImageData *vtkimage, mitk::Surface * surface, mitk::LabeledImageToSurfaceFilter::LabelType label )
-{
-  vtkImageChangeInformation *indexCoordinatesImageFilter = vtkImageChangeInformation::New();
-  indexCoordinatesImageFilter->SetInput(vtkimage);
-  indexCoordinatesImageFilter->SetOutputOrigin(0.0,0.0,0.0);
-
-    vtkImageThreshold* threshold = vtkImageThreshold::New();
-    threshold->SetInput( indexCoordinatesImageFilter->GetOutput() );
-    //indexCoordinatesImageFilter->Delete();
-    threshold->SetInValue( 100 );
-    threshold->SetOutValue( 0 );
-    threshold->ThresholdBetween( label, label );
-    threshold->SetOutputScalarTypeToUnsignedChar();
-    threshold->ReleaseDataFlagOn();
-
-    vtkImageGaussianSmooth *gaussian = vtkImageGaussianSmooth::New();
-    gaussian->SetInput( threshold->GetOutput() );
-    //threshold->Delete();
-    gaussian->SetDimensionality( 3  );
-    gaussian->SetRadiusFactor( 0.49 );
-    gaussian->SetStandardDeviation( GetGaussianStandardDeviation() );
-    gaussian->ReleaseDataFlagOn();
-    gaussian->UpdateInformation();
-    gaussian->Update();
-
-  //MarchingCube -->create Surface
-  vtkMarchingCubes *skinExtractor = vtkMarchingCubes::New();
-  skinExtractor->ReleaseDataFlagOn();
-  skinExtractor->SetInput(gaussian->GetOutput());//RC++
-  indexCoordinatesImageFilter->Delete();
-  skinExtractor->SetValue(0, 50);
-
-  vtkPolyData *polydata;
-  polydata = skinExtractor->GetOutput();
-  polydata->Register(NULL);//RC++
-  skinExtractor->Delete();
-
-  if (m_Smooth)
+  std::vector<mitk::Surface*> surfaces;
+  for ( unsigned int i = 0; i < labels.size(); ++i )
   {
-    vtkSmoothPolyDataFilter *smoother = vtkSmoothPolyDataFilter::New();
-    //read poly1 (poly1 can be the original polygon, or the decimated polygon)
-    smoother->SetInput(polydata);//RC++
-    smoother->SetNumberOfIterations( m_SmoothIteration );
-    smoother->SetRelaxationFactor( m_SmoothRelaxation );
-    smoother->SetFeatureAngle( 60 );
-    smoother->FeatureEdgeSmoothingOff();
-    smoother->BoundarySmoothingOff();
-    smoother->SetConvergence( 0 );
-
-    polydata->Delete();//RC--
-    polydata = smoother->GetOutput();
-    polydata->Register(NULL);//RC++
-    smoother->Delete();
+    surfaces.push_back( this->GetOutput( i ) );
+    assert( surfaces.back() != NULL );
   }
 
-  //decimate = to reduce number of polygons
-  if(m_Decimate==DecimatePro)
+  int tstart=outputRegion.GetIndex(3);
+  int tmax=tstart+outputRegion.GetSize(3); //GetSize()==1 - will aber 0 haben, wenn nicht zeitaufgeloet
+  for( int t=tstart; t < tmax; ++t)
   {
-    vtkDecimatePro *decimate = vtkDecimatePro::New();
-    decimate->SplittingOff();
-    decimate->SetErrorIsAbsolute(5);
-    decimate->SetFeatureAngle(30);
-    decimate->PreserveTopologyOn();
-    decimate->BoundaryVertexDeletionOff();
-    decimate->SetDegree(10); //std-value is 25!
-
-    decimate->SetInput(polydata);//RC++
-    decimate->SetTargetReduction(m_TargetReduction);
-    decimate->SetMaximumError(0.002);
-
-    polydata->Delete();//RC--
-    polydata = decimate->GetOutput();
-    polydata->Register(NULL);//RC++
-    decimate->Delete();
+    vtkImageData *vtkimagedata =  image->GetVtkImageData( t );
+    LabelBoundsMapType labelBounds;
+    this->ComputeLabelBounds( vtkimagedata, labelBounds );
+    this->CreateSurfaces( t, vtkimagedata, labels, surfaces, labelBounds );
   }
+}
 
-  polydata->Update();
-
-  polydata->SetSource(NULL);
+void mitk::LabeledImageToSurfaceFilter::ComputeLabelBounds( vtkImageData *vtkimage, LabelBoundsMapType& labelBounds )
+{
+  labelBounds.clear();
 
-  if(polydata->GetNumberOfPoints() > 0)
+  int extent[6];
+  vtkIdType increments[3];
+  vtkimage->GetExtent( extent );
+  vtkimage->GetIncrements( increments );
+  switch ( vtkimage->GetScalarType() )
   {
-    mitk::Vector3D spacing = GetInput()->GetGeometry(time)->GetSpacing();
-
-    vtkPoints * points = polydata->GetPoints();
-    vtkMatrix4x4 *vtkmatrix = vtkMatrix4x4::New();
-    GetInput()->GetGeometry(time)->GetVtkTransform()->GetMatrix(vtkmatrix);
-    double (*matrix)[4] = vtkmatrix->Element;
-
-    unsigned int i,j;
-    for(i=0;i<3;++i)
-      for(j=0;j<3;++j)
-        matrix[i][j]/=spacing[j];
+    vtkTemplateMacro( ComputeLabelBoundsInternal( static_cast<const VTK_TT*>( vtkimage->GetScalarPointer() ), extent, increments, labelBounds ) );
+  }
+}
 
-    unsigned int n = points->GetNumberOfPoints();
-    vtkFloatingPointType point[3];
+void mitk::LabeledImageToSurfaceFilter::CreateSurfaces( int time, vtkImageData *vtkimage, const std::vector<LabelType>& labels, const std::vector<mitk::Surface*>& surfaces, const LabelBoundsMapType& labelBounds )
+{
+  LabelSurfaceThreadData data;
+  std::vector<LabelSurfaceJob> jobs( labels.size() );
+  data.jobs = &jobs;
+  data.nextJob = 0;
+
+  data.scalars = vtkimage->GetScalarPointer();
+  data.scalarType = vtkimage->GetScalarType();
+  vtkimage->GetIncrements( data.increments );
+  vtkimage->GetExtent( data.wholeExtent );
+  vtkimage->GetSpacing( data.spacing );
+
+  unsigned int numberOfThreads = m_NumberOfThreads > 0 ? m_NumberOfThreads : itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  if ( numberOfThreads > labels.size() )
+    numberOfThreads = labels.size();
+  if ( numberOfThreads == 0 )
+    numberOfThreads = 1;
+
+  data.gaussianStandardDeviation = m_GaussianStandardDeviation;
+  data.smooth = m_Smooth;
+  data.smoothIteration = m_SmoothIteration;
+  data.smoothRelaxation = m_SmoothRelaxation;
+  data.decimate = ( m_Decimate == DecimatePro );
+  data.targetReduction = m_TargetReduction;
+  // the labels are already processed in parallel
+  data.singleThreadedGaussian = numberOfThreads > 1;
+
+  // the points are in index coordinates scaled by the spacing, the spacing is
+  // divided out of the index to world transformation of the geometry
+  mitk::Vector3D spacing = GetInput()->GetGeometry(time)->GetSpacing();
+  vtkMatrix4x4 *vtkmatrix = vtkMatrix4x4::New();
+  GetInput()->GetGeometry(time)->GetVtkTransform()->GetMatrix(vtkmatrix);
+  for ( unsigned int i = 0; i < 4; ++i )
+    for ( unsigned int j = 0; j < 4; ++j )
+      data.matrix[i][j] = vtkmatrix->GetElement( i, j ) / ( ( i < 3 && j < 3 ) ? spacing[j] : 1.0 );
+  vtkmatrix->Delete();
+
+  int padding = static_cast<int>( std::ceil( 0.49 * m_GaussianStandardDeviation ) ) + 1;
+
+  for ( std::size_t i = 0; i < labels.size(); ++i )
+  {
+    jobs[i].label = labels[i];
+    jobs[i].polydata = NULL;
+    std::copy( data.wholeExtent, data.wholeExtent + 6, jobs[i].extent );
 
-    for (i = 0; i < n; i++)
+    LabelBoundsMapType::const_iterator bounds = labelBounds.find( labels[i] );
+    if ( bounds != labelBounds.end() )
     {
-      points->GetPoint(i, point);
-      mitkVtkLinearTransformPoint(matrix,point,point);
-      points->SetPoint(i, point);
+      // restrict the label volume to the bounding box of the label, padded by the
+      // radius of the Gaussian kernel and one voxel to close the surface
+      for ( unsigned int d = 0; d < 3; ++d )
+      {
+        jobs[i].extent[2*d] = std::max<int>( data.wholeExtent[2*d], bounds->second.first[d] - padding );
+        jobs[i].extent[2*d+1] = std::min<int>( data.wholeExtent[2*d+1], bounds->second.second[d] + padding );
+      }
     }
-    vtkmatrix->Delete();
   }
 
-  surface->SetVtkPolyData(polydata, time);
-  polydata->UnRegister(NULL);
+  if ( m_DiscreteMarchingCubes && !jobs.empty() )
+  {
+    // one pass for all labels, on the calling thread before the labels are distributed
+    vtkImageChangeInformation *indexCoordinatesImageFilter = vtkImageChangeInformation::New();
+    indexCoordinatesImageFilter->SetInput( vtkimage );
+    indexCoordinatesImageFilter->SetOutputOrigin( 0.0, 0.0, 0.0 );
+
+    vtkDiscreteMarchingCubes *discreteExtractor = vtkDiscreteMarchingCubes::New();
+    discreteExtractor->SetInput( indexCoordinatesImageFilter->GetOutput() );
+    discreteExtractor->ComputeScalarsOn();
+    discreteExtractor->SetNumberOfContours( labels.size() );
+    for ( std::size_t i = 0; i < labels.size(); ++i )
+      discreteExtractor->SetValue( i, labels[i] );
+    discreteExtractor->Update();
+
+    SplitDiscreteSurface( discreteExtractor->GetOutput(), jobs );
+
+    discreteExtractor->Delete();
+    indexCoordinatesImageFilter->Delete();
+  }
 
-  gaussian->Delete();
-  threshold->Delete();
+  if ( numberOfThreads > 1 )
+  {
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads( numberOfThreads );
+    threader->SetSingleMethod( LabelSurfaceThreaderCallback, &data );
+    threader->SingleMethodExecute();
+  }
+  else
+  {
+    itk::MultiThreader::ThreadInfoStruct info;
+    info.ThreadID = 0;
+    info.NumberOfThreads = 1;
+    info.UserData = &data;
+    LabelSurfaceThreaderCallback( &info );
+  }
+
+  for ( std::size_t i = 0; i < jobs.size(); ++i )
+  {
+    surfaces[i]->SetVtkPolyData( jobs[i].polydata, time );
+    jobs[i].polydata->UnRegister( NULL );
+  }
+}
+
+void mitk::LabeledImageToSurfaceFilter::CreateSurface( int time, vtkImageData *vtkimage, mitk::Surface * surface, mitk::LabeledImageToSurfaceFilter::LabelType label )
+{
+  std::vector<LabelType> labels( 1, label );
+  std::vector<mitk::Surface*> surfaces( 1, surface );
+  LabelBoundsMapType labelBounds;
+  this->ComputeLabelBounds( vtkimage, labelBounds );
+  this->CreateSurfaces( time, vtkimage, labels, surfaces, labelBounds );
 }
 
 template < typename TPixel, unsigned int VImageDimension >
@@ -20,7 +20,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImageToSurfaceFilter.h>
 #include "MitkExtExports.h"
 #include <vtkImageData.h>
+#include <itkIndex.h>
 #include <map>
+#include <vector>
 
 namespace mitk
 {
@@ -35,6 +37,11 @@ namespace mitk
  * If you want to calculate a surface representation only for one
  * specific label, you may call GenerateAllLabelsOff() and set the
  * desired label by SetLabel(label).
+ *
+ * The labels are processed in parallel. Each label is thresholded and
+ * smoothed only within its bounding box. With DiscreteMarchingCubesOn(),
+ * the surfaces of all labels are extracted in a single pass over the
+ * image by vtkDiscreteMarchingCubes instead.
  */
 class MitkExt_EXPORT LabeledImageToSurfaceFilter : public ImageToSurfaceFilter
 {
@@ -50,6 +57,10 @@ public:
 
   typedef std::map<unsigned int, LabelType> IdxToLabelMapType;
 
+  typedef std::pair< itk::Index<3>, itk::Index<3> > LabelBoundsType;
+
+  typedef std::map<LabelType, LabelBoundsType> LabelBoundsMapType;
+
   /**
    * Set whether you want to extract all (true) or only
    * a specific label (false)
@@ -103,6 +114,33 @@ public:
    */
   itkGetMacro( GaussianStandardDeviation, double );
 
+  /**
+   * Set whether the surfaces of all labels are extracted in one pass by
+   * vtkDiscreteMarchingCubes. The label volumes are not smoothed by a
+   * Gaussian filter in this mode, so the surfaces follow the voxel borders
+   * (use SetSmooth() to smooth the meshes).
+   * @param _arg false by default
+   */
+  itkSetMacro( DiscreteMarchingCubes, bool );
+
+  /**
+   * @returns if all labels are extracted in one pass.
+   */
+  itkGetMacro( DiscreteMarchingCubes, bool );
+
+  itkBooleanMacro( DiscreteMarchingCubes );
+
+  /**
+   * Set the number of threads which process the labels in parallel.
+   * @param _arg 0 (default) uses the ITK default number of threads
+   */
+  itkSetMacro( NumberOfThreads, unsigned int );
+
+  /**
+   * @returns the number of threads which process the labels.
+   */
+  itkGetMacro( NumberOfThreads, unsigned int );
+
   /**
    * Lets you retrieve the label which was used for generating the Nth output of this filter.
    * If GenerateAllLabels() is set to false, this filter only knows about the label provided
@@ -145,12 +183,28 @@ protected:
 
   IdxToLabelMapType m_IdxToLabels;
 
+  bool m_DiscreteMarchingCubes;
+
+  unsigned int m_NumberOfThreads;
+
   virtual void GenerateData();
 
   virtual void GenerateOutputInformation();
 
   virtual void CreateSurface( int time, vtkImageData *vtkimage, mitk::Surface * surface, LabelType label );
 
+  /**
+   * Creates the surfaces of the given labels and assigns them to the given surfaces.
+   * Labels with an entry in labelBounds are only processed within their bounding box,
+   * all other labels within the whole image.
+   */
+  void CreateSurfaces( int time, vtkImageData *vtkimage, const std::vector<LabelType>& labels, const std::vector<mitk::Surface*>& surfaces, const LabelBoundsMapType& labelBounds );
+
+  /**
+   * Computes the index bounding boxes of all labels of the given time step.
+   */
+  virtual void ComputeLabelBounds( vtkImageData *vtkimage, LabelBoundsMapType& labelBounds );
+
   virtual LabelMapType GetAvailableLabels();
 
   LabeledImageToSurfaceFilter();
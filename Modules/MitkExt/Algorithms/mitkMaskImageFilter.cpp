@@ -103,6 +103,7 @@ void mitk::MaskImageFilter::InternalComputeMask(itk::Image<TPixel, VImageDimensi
 
   typename mitk::ImageToItk<ItkMaskImageType>::Pointer maskimagetoitk = mitk::ImageToItk<ItkMaskImageType>::New();
   maskimagetoitk->SetInput(m_MaskTimeSelector->GetOutput());
+  maskimagetoitk->ConstInputOn();
   maskimagetoitk->Update();
   typename ItkMaskImageType::Pointer maskItkImage = maskimagetoitk->GetOutput();
 
@@ -19,6 +19,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDataNodeFactory.h"
 #include "mitkReferenceCountWatcher.h"
 
+#include <itkTimeProbe.h>
+
+#include <vtkPolyData.h>
+
+#include <algorithm>
 #include <cmath>
 
 bool equals(const mitk::ScalarType& val1, const mitk::ScalarType& val2, mitk::ScalarType epsilon = mitk::eps )
@@ -26,6 +31,154 @@ bool equals(const mitk::ScalarType& val1, const mitk::ScalarType& val2, mitk::Sc
   return ( std::fabs(val1 - val2) <= epsilon );
 }
 
+/**
+ * Creates a 64x64x64 image with numberOfLabels cubic blocks of 6x6x6 voxels, labeled 1..numberOfLabels.
+ */
+mitk::Image::Pointer CreateLabelImage( unsigned int numberOfLabels )
+{
+  const unsigned int size = 64;
+  unsigned int dim[3] = { size, size, size };
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize( mitk::MakeScalarPixelType<unsigned char>(), 3, dim );
+
+  unsigned char* data = static_cast<unsigned char*>( image->GetData() );
+  std::fill( data, data + size * size * size, 0 );
+
+  // blocks on a grid with a spacing of 8 voxels, leaving a background gap of 2 voxels between them
+  const unsigned int blocksPerRow = size / 8;
+  for ( unsigned int label = 1; label <= numberOfLabels; ++label )
+  {
+    unsigned int block = label - 1;
+    unsigned int x0 = 1 + 8 * ( block % blocksPerRow );
+    unsigned int y0 = 1 + 8 * ( ( block / blocksPerRow ) % blocksPerRow );
+    unsigned int z0 = 1 + 8 * ( block / ( blocksPerRow * blocksPerRow ) );
+    for ( unsigned int z = z0; z < z0 + 6; ++z )
+      for ( unsigned int y = y0; y < y0 + 6; ++y )
+        for ( unsigned int x = x0; x < x0 + 6; ++x )
+          data[ ( z * size + y ) * size + x ] = static_cast<unsigned char>( label );
+  }
+  return image;
+}
+
+/**
+ * Extracts the surfaces of synthetic label images with 1, 10 and 50 labels and compares the
+ * run time of the Gaussian and the discrete marching cubes mode with one and the default number of threads.
+ */
+bool TestMultipleLabels()
+{
+  const unsigned int numbersOfLabels[] = { 1, 10, 50 };
+  for ( unsigned int n = 0; n < 3; ++n )
+  {
+    mitk::Image::Pointer image = CreateLabelImage( numbersOfLabels[n] );
+    for ( int discrete = 0; discrete < 2; ++discrete )
+    {
+      for ( unsigned int threads = 1; threads <= 2; ++threads )
+      {
+        mitk::LabeledImageToSurfaceFilter::Pointer filter = mitk::LabeledImageToSurfaceFilter::New();
+        filter->SetInput( image );
+        filter->SetDiscreteMarchingCubes( discrete == 1 );
+        filter->SetNumberOfThreads( threads == 1 ? 1 : 0 );
+
+        itk::TimeProbe probe;
+        probe.Start();
+        filter->Update();
+        probe.Stop();
+
+        std::cout << "Surfaces of " << numbersOfLabels[n] << " label(s), "
+                  << ( discrete ? "discrete marching cubes" : "Gaussian smoothing" ) << ", "
+                  << ( threads == 1 ? "1 thread" : "default threads" ) << ": "
+                  << probe.GetTotal() << "s ";
+
+        if ( filter->GetNumberOfOutputs() != numbersOfLabels[n] )
+        {
+          std::cout << "wrong number of outputs " << filter->GetNumberOfOutputs() << " [FAILED]" << std::endl;
+          return false;
+        }
+        for ( unsigned int i = 0; i < filter->GetNumberOfOutputs(); ++i )
+        {
+          vtkPolyData* polydata = filter->GetOutput( i )->GetVtkPolyData();
+          if ( polydata == NULL || polydata->GetNumberOfPoints() == 0 || polydata->GetNumberOfPolys() == 0 )
+          {
+            std::cout << "empty surface for output " << i << " [FAILED]" << std::endl;
+            return false;
+          }
+        }
+        std::cout << "[PASSED]" << std::endl;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Extracts every label from the whole image instead of its bounding box.
+ */
+class FullVolumeLabeledImageToSurfaceFilter : public mitk::LabeledImageToSurfaceFilter
+{
+public:
+  mitkClassMacro( FullVolumeLabeledImageToSurfaceFilter, mitk::LabeledImageToSurfaceFilter );
+  itkNewMacro( Self );
+
+protected:
+  virtual void ComputeLabelBounds( vtkImageData*, LabelBoundsMapType& labelBounds )
+  {
+    labelBounds.clear();
+  }
+};
+
+/**
+ * Checks that the surfaces extracted within the bounding boxes of the labels equal the
+ * surfaces extracted from the whole image.
+ */
+bool TestBoundingBoxExtraction()
+{
+  mitk::Image::Pointer image = CreateLabelImage( 10 );
+
+  mitk::LabeledImageToSurfaceFilter::Pointer filter = mitk::LabeledImageToSurfaceFilter::New();
+  filter->SetInput( image );
+  filter->Update();
+
+  FullVolumeLabeledImageToSurfaceFilter::Pointer fullVolumeFilter = FullVolumeLabeledImageToSurfaceFilter::New();
+  fullVolumeFilter->SetInput( image );
+  fullVolumeFilter->Update();
+
+  std::cout << "Testing if the surfaces extracted within the label bounding boxes equal the surfaces of the whole image: ";
+  if ( filter->GetNumberOfOutputs() != fullVolumeFilter->GetNumberOfOutputs() )
+  {
+    std::cout << "different number of outputs [FAILED]" << std::endl;
+    return false;
+  }
+  for ( unsigned int i = 0; i < filter->GetNumberOfOutputs(); ++i )
+  {
+    vtkPolyData* cropped = filter->GetOutput( i )->GetVtkPolyData();
+    vtkPolyData* full = fullVolumeFilter->GetOutput( i )->GetVtkPolyData();
+    if ( filter->GetLabelForNthOutput( i ) != fullVolumeFilter->GetLabelForNthOutput( i ) )
+    {
+      std::cout << "different label for output " << i << " [FAILED]" << std::endl;
+      return false;
+    }
+    if ( cropped->GetNumberOfPoints() != full->GetNumberOfPoints() || cropped->GetNumberOfCells() != full->GetNumberOfCells() )
+    {
+      std::cout << "different number of points or cells for label " << filter->GetLabelForNthOutput( i ) << " [FAILED]" << std::endl;
+      return false;
+    }
+    double croppedBounds[6];
+    double fullBounds[6];
+    cropped->GetBounds( croppedBounds );
+    full->GetBounds( fullBounds );
+    for ( unsigned int j = 0; j < 6; ++j )
+    {
+      if ( !equals( croppedBounds[j], fullBounds[j] ) )
+      {
+        std::cout << "different bounds for label " << filter->GetLabelForNthOutput( i ) << " [FAILED]" << std::endl;
+        return false;
+      }
+    }
+  }
+  std::cout << "[PASSED]" << std::endl;
+  return true;
+}
+
 int mitkLabeledImageToSurfaceFilterTest(int argc, char* argv[])
 {
   if(argc<2)
@@ -34,6 +187,16 @@ int mitkLabeledImageToSurfaceFilterTest(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  if ( !TestMultipleLabels() )
+  {
+    return EXIT_FAILURE;
+  }
+
+  if ( !TestBoundingBoxExtraction() )
+  {
+    return EXIT_FAILURE;
+  }
+
   std::string fileIn = argv[1];
   std::cout<<"Eingabe Datei: "<<fileIn<<std::endl;
   mitk::Image::Pointer image = NULL;
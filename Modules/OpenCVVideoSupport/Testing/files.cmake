@@ -1,3 +1,4 @@
 set(MODULE_TESTS
   mitkOpenCVMitkConversionTest.cpp
+  mitkUndistortCameraImageTest.cpp
 )
@@ -23,6 +23,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkRGBPixel.h>
 #include <mitkImageAccessByItk.h>
 #include <mitkIOUtil.h>
+#include <mitkImageReadAccessor.h>
 
 // define test pixel indexes and intensities and other values
 typedef itk::RGBPixel< unsigned char > TestUCRGBPixelType;
@@ -81,6 +82,39 @@ void ComparePixels( itk::Image<itk::RGBPixel<TPixel>,VImageDimension>* image )
 
 }
 
+void TestImagePool( const cv::Mat& testRGBImage )
+{
+  mitk::OpenCVToMitkImageFilter::Pointer openCvToMitkFilter = mitk::OpenCVToMitkImageFilter::New();
+  openCvToMitkFilter->SetUseImagePool(true);
+
+  for (unsigned int i = 0; i < 10; ++i)
+  {
+    openCvToMitkFilter->SetOpenCVMat( testRGBImage );
+    openCvToMitkFilter->Modified();
+    openCvToMitkFilter->Update();
+  }
+  MITK_TEST_CONDITION( openCvToMitkFilter->GetNumberOfAllocatedImages() == 1, "Testing if an unused output image is recycled" )
+
+  mitk::Image::Pointer heldImage = openCvToMitkFilter->GetOutput();
+  openCvToMitkFilter->Modified();
+  openCvToMitkFilter->Update();
+  MITK_TEST_CONDITION( openCvToMitkFilter->GetOutput() != heldImage.GetPointer(), "Testing if an output image which is still referenced is not recycled" )
+
+  AccessFixedTypeByItk(openCvToMitkFilter->GetOutput(), ComparePixels,
+                       (itk::RGBPixel<unsigned char>), // rgb image
+                       (2) );
+
+  MITK_INFO << "referencing a grey OpenCV image without copy";
+  cv::Mat testGreyImage;
+  cv::cvtColor( testRGBImage, testGreyImage, CV_BGR2GRAY );
+  openCvToMitkFilter->SetCopyBuffer(false);
+  openCvToMitkFilter->SetOpenCVMat( testGreyImage );
+  openCvToMitkFilter->Modified();
+  openCvToMitkFilter->Update();
+  mitk::ImageReadAccessor accessor( openCvToMitkFilter->GetOutput() );
+  MITK_TEST_CONDITION( accessor.GetData() == testGreyImage.data, "Testing if a grey image is referenced, not copied" )
+}
+
 int mitkOpenCVMitkConversionTest(int argc, char* argv[])
 {
   MITK_TEST_BEGIN("ImageToOpenCVImageFilter")
@@ -138,6 +172,9 @@ int mitkOpenCVMitkConversionTest(int argc, char* argv[])
 
   MITK_TEST_CONDITION( color3 == convertedColor3, "Testing if initially created color values " << static_cast<int>( color3[0] ) << ", " << static_cast<int>( color3[1] ) << ", " << static_cast<int>( color3[2] ) << " matches the color values " << static_cast<int>( convertedColor3[0] ) << ", " << static_cast<int>( convertedColor3[1] ) << ", " << static_cast<int>( convertedColor3[2] ) << " at the same position " << pos3.x << ", " << pos3.y << " in the back converted OpenCV image" )
 
+  MITK_INFO << "converting OpenCV test image repeatedly with image pool";
+  TestImagePool( testRGBImage );
+
   MITK_TEST_END();
 
 }
@@ -0,0 +1,142 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkUndistortCameraImage.h"
+#include <mitkTestingMacros.h>
+#include <itkTimeProbe.h>
+
+// full HD camera with moderate barrel distortion
+const int width = 1920;
+const int height = 1080;
+const float fc[2] = { 1400.0f, 1400.0f };
+const float cc[2] = { 960.0f, 540.0f };
+float kc[4] = { -0.25f, 0.08f, 0.001f, -0.0005f };
+
+static IplImage* CreateTestImage()
+{
+  IplImage* image = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 3);
+  // checkerboard with smooth color gradients
+  for (int y = 0; y < height; ++y)
+  {
+    unsigned char* row = reinterpret_cast<unsigned char*>(image->imageData + y * image->widthStep);
+    for (int x = 0; x < width; ++x)
+    {
+      bool white = ((x / 40) + (y / 40)) % 2 == 0;
+      row[3 * x] = white ? 255 : 0;
+      row[3 * x + 1] = static_cast<unsigned char>(x * 255 / width);
+      row[3 * x + 2] = static_cast<unsigned char>(y * 255 / height);
+    }
+  }
+  return image;
+}
+
+static void TestAgainstOpenCV(IplImage* src)
+{
+  IplImage* reference = cvCreateImage(cvGetSize(src), src->depth, src->nChannels);
+  IplImage* result = cvCreateImage(cvGetSize(src), src->depth, src->nChannels);
+
+  float intrinsic[9] = { fc[0], 0.0f, cc[0], 0.0f, fc[1], cc[1], 0.0f, 0.0f, 1.0f };
+  CvMat intrinsicMatrix = cvMat(3, 3, CV_32FC1, intrinsic);
+  CvMat distortionMatrix = cvMat(1, 4, CV_32FC1, kc);
+  cvUndistort2(src, reference, &intrinsicMatrix, &distortionMatrix);
+
+  mitk::UndistortCameraImage::Pointer undistort = mitk::UndistortCameraImage::New();
+  undistort->SetFocalLength(fc[0], fc[1]);
+  undistort->SetPrincipalPoint(cc[0], cc[1]);
+  undistort->SetCameraDistortion(kc[0], kc[1], kc[2], kc[3]);
+  undistort->UndistortImage(src, result);
+
+  // the fixed-point remap tables may differ from OpenCV by one grey value
+  cv::Mat difference;
+  cv::absdiff(cv::Mat(reference), cv::Mat(result), difference);
+  double maxDifference = 0.0;
+  cv::minMaxLoc(difference.reshape(1), NULL, &maxDifference);
+  MITK_TEST_CONDITION(maxDifference <= 2.0, "Undistorted image matches cvUndistort2 (maximum difference " << maxDifference << ")")
+
+  cvReleaseImage(&reference);
+  cvReleaseImage(&result);
+}
+
+static void TestFastUndistortionInPlace(IplImage* src)
+{
+  mitk::UndistortCameraImage::Pointer undistort = mitk::UndistortCameraImage::New();
+  undistort->SetUndistortImageFastInfo(fc[0], fc[1], cc[0], cc[1], kc, width, height);
+
+  IplImage* inPlace = cvCloneImage(src);
+  IplImage* result = cvCreateImage(cvGetSize(src), src->depth, src->nChannels);
+  undistort->UndistortImageFast(src, result);
+  undistort->UndistortImageFast(inPlace);
+
+  cv::Mat difference;
+  cv::absdiff(cv::Mat(inPlace), cv::Mat(result), difference);
+  MITK_TEST_CONDITION(cv::countNonZero(difference.reshape(1)) == 0, "In-place fast undistortion equals undistortion into a second image")
+
+  cvReleaseImage(&inPlace);
+  cvReleaseImage(&result);
+}
+
+static void BenchmarkUndistortion(IplImage* src)
+{
+  const int numberOfFrames = 20;
+  IplImage* dst = cvCreateImage(cvGetSize(src), src->depth, src->nChannels);
+
+  float intrinsic[9] = { fc[0], 0.0f, cc[0], 0.0f, fc[1], cc[1], 0.0f, 0.0f, 1.0f };
+  CvMat intrinsicMatrix = cvMat(3, 3, CV_32FC1, intrinsic);
+  CvMat distortionMatrix = cvMat(1, 4, CV_32FC1, kc);
+  itk::TimeProbe referenceProbe;
+  referenceProbe.Start();
+  for (int i = 0; i < numberOfFrames; ++i)
+    cvUndistort2(src, dst, &intrinsicMatrix, &distortionMatrix);
+  referenceProbe.Stop();
+  MITK_INFO << "cvUndistort2: " << numberOfFrames / referenceProbe.GetTotal() << " frames per second";
+
+  for (unsigned int threads = 1; threads <= 8; threads *= 2)
+  {
+    mitk::UndistortCameraImage::Pointer undistort = mitk::UndistortCameraImage::New();
+    undistort->SetFocalLength(fc[0], fc[1]);
+    undistort->SetPrincipalPoint(cc[0], cc[1]);
+    undistort->SetCameraDistortion(kc[0], kc[1], kc[2], kc[3]);
+    undistort->SetNumberOfThreads(threads);
+
+    itk::TimeProbe probe;
+    probe.Start();
+    for (int i = 0; i < numberOfFrames; ++i)
+      undistort->UndistortImage(src, dst);
+    probe.Stop();
+    MITK_INFO << "UndistortImage with " << threads << " thread(s): " << numberOfFrames / probe.GetTotal() << " frames per second";
+  }
+
+  cvReleaseImage(&dst);
+}
+
+/**
+ * Compares the cached, threaded undistortion against OpenCV and reports
+ * the frames per second for full HD images.
+ */
+int mitkUndistortCameraImageTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("UndistortCameraImage")
+
+  IplImage* src = CreateTestImage();
+
+  TestAgainstOpenCV(src);
+  TestFastUndistortionInPlace(src);
+  BenchmarkUndistortion(src);
+
+  cvReleaseImage(&src);
+
+  MITK_TEST_END();
+}
@@ -21,9 +21,47 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkITKImageImport.txx>
 #include <itkOpenCVImageBridge.h>
 #include <itkImageFileWriter.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <cstring>
+
+namespace
+{
+  // copies the rows of an OpenCV image into a contiguous buffer, three channel
+  // images are converted from BGR to RGB as done by itk::OpenCVImageBridge
+  template <typename TComponent>
+  void CopyIplImageData( const IplImage* input, void* target )
+  {
+    const unsigned int channels = input->nChannels;
+    const std::size_t rowLength = input->width * channels;
+    TComponent* out = static_cast<TComponent*>(target);
+
+    for (int y = 0; y < input->height; ++y, out += rowLength)
+    {
+      const TComponent* in = reinterpret_cast<const TComponent*>(input->imageData + y * input->widthStep);
+      if (channels == 3)
+      {
+        for (std::size_t x = 0; x < rowLength; x += 3)
+        {
+          out[x] = in[x + 2];
+          out[x + 1] = in[x + 1];
+          out[x + 2] = in[x];
+        }
+      }
+      else
+      {
+        std::memcpy(out, in, rowLength * sizeof(TComponent));
+      }
+    }
+  }
+}
 
 mitk::OpenCVToMitkImageFilter::OpenCVToMitkImageFilter()
-: m_OpenCVImage(0)
+: m_OpenCVImage(0),
+  m_CopyBuffer(true),
+  m_UseImagePool(false),
+  m_MaximumImagePoolSize(4),
+  m_NumberOfAllocatedImages(0)
 {
 }
 
@@ -39,6 +77,9 @@ void mitk::OpenCVToMitkImageFilter::SetOpenCVImage(const IplImage* image)
 
 void mitk::OpenCVToMitkImageFilter::GenerateData()
 {
+  // release the previous output, so it can be recycled if nobody else holds it
+  m_Image = NULL;
+
   IplImage cvMatIplImage;
   const IplImage* targetImage = 0;
   if(m_OpenCVImage == 0)
@@ -59,31 +100,31 @@ void mitk::OpenCVToMitkImageFilter::GenerateData()
 
   // now convert rgb image
   if( (targetImage->depth>=0) && ((unsigned int)targetImage->depth == IPL_DEPTH_8S) && (targetImage->nChannels == 1) )
-    m_Image = ConvertIplToMitkImage< char, 2>( targetImage );
+    m_Image = this->ConvertIplImage< char, char >( targetImage );
 
   else if( targetImage->depth == IPL_DEPTH_8U && targetImage->nChannels == 1 )
-    m_Image = ConvertIplToMitkImage< unsigned char, 2>( targetImage );
+    m_Image = this->ConvertIplImage< unsigned char, unsigned char >( targetImage );
 
   else if( targetImage->depth == IPL_DEPTH_8U && targetImage->nChannels == 3 )
-    m_Image = ConvertIplToMitkImage< UCRGBPixelType, 2>( targetImage );
+    m_Image = this->ConvertIplImage< UCRGBPixelType, unsigned char >( targetImage );
 
   else if( targetImage->depth == IPL_DEPTH_16U && targetImage->nChannels == 1 )
-    m_Image = ConvertIplToMitkImage< unsigned short, 2>( targetImage );
+    m_Image = this->ConvertIplImage< unsigned short, unsigned short >( targetImage );
 
   else if( targetImage->depth == IPL_DEPTH_16U && targetImage->nChannels == 3 )
-    m_Image = ConvertIplToMitkImage< USRGBPixelType, 2>( targetImage );
+    m_Image = this->ConvertIplImage< USRGBPixelType, unsigned short >( targetImage );
 
   else if( targetImage->depth == IPL_DEPTH_32F && targetImage->nChannels == 1 )
-    m_Image = ConvertIplToMitkImage< float, 2>( targetImage );
+    m_Image = this->ConvertIplImage< float, float >( targetImage );
 
   else if( targetImage->depth == IPL_DEPTH_32F && targetImage->nChannels == 3 )
-    m_Image = ConvertIplToMitkImage< FloatRGBPixelType , 2>( targetImage );
+    m_Image = this->ConvertIplImage< FloatRGBPixelType, float >( targetImage );
 
   else if( targetImage->depth == IPL_DEPTH_64F && targetImage->nChannels == 1 )
-    m_Image = ConvertIplToMitkImage< double, 2>( targetImage );
+    m_Image = this->ConvertIplImage< double, double >( targetImage );
 
   else if( targetImage->depth == IPL_DEPTH_64F && targetImage->nChannels == 3 )
-    m_Image = ConvertIplToMitkImage< DoubleRGBPixelType , 2>( targetImage );
+    m_Image = this->ConvertIplImage< DoubleRGBPixelType, double >( targetImage );
 
   else
   {
@@ -117,17 +158,82 @@ mitk::Image::Pointer mitk::OpenCVToMitkImageFilter::ConvertIplToMitkImage( const
 }
 
 
-void mitk::OpenCVToMitkImageFilter::SetOpenCVMat(const cv::Mat &image)
+template <typename TPixel, typename TComponent>
+mitk::Image::Pointer mitk::OpenCVToMitkImageFilter::ConvertIplImage( const IplImage* input )
 {
-    m_OpenCVMat = image;
+  const mitk::PixelType pixelType = mitk::MakePixelType< itk::Image<TPixel, 2> >();
+  const bool topLeftOrigin = input->origin == IPL_ORIGIN_TL;
+
+  // reference the OpenCV memory if the layout is identical
+  if ( !m_CopyBuffer && topLeftOrigin && input->nChannels == 1
+       && input->widthStep == static_cast<int>(input->width * sizeof(TComponent)) )
+  {
+    unsigned int dimensions[2] = { static_cast<unsigned int>(input->width), static_cast<unsigned int>(input->height) };
+    mitk::Image::Pointer mitkImage = mitk::Image::New();
+    mitkImage->Initialize( pixelType, 2, dimensions );
+    mitkImage->SetImportVolume( input->imageData, 0, 0, mitk::Image::ReferenceMemory );
+    return mitkImage;
+  }
+
+  if ( m_UseImagePool && topLeftOrigin )
+  {
+    mitk::Image::Pointer mitkImage = this->GetPooledImage( pixelType, input->width, input->height );
+    {
+      mitk::ImageWriteAccessor accessor( mitkImage );
+      CopyIplImageData<TComponent>( input, accessor.GetData() );
+    }
+    mitkImage->Modified();
+    return mitkImage;
+  }
+
+  ++m_NumberOfAllocatedImages;
+  return ConvertIplToMitkImage< TPixel, 2 >( input );
 }
 
+mitk::Image::Pointer mitk::OpenCVToMitkImageFilter::GetPooledImage( const mitk::PixelType& pixelType, unsigned int width, unsigned int height )
+{
+  std::vector<mitk::Image::Pointer>::iterator iter = m_ImagePool.begin();
+  while ( iter != m_ImagePool.end() )
+  {
+    mitk::Image* image = *iter;
+    if ( image->GetPixelType() == pixelType && image->GetDimension(0) == width && image->GetDimension(1) == height )
+    {
+      // the pool holds the only reference
+      if ( image->GetReferenceCount() == 1 )
+      {
+        return image;
+      }
+      ++iter;
+    }
+    else
+    {
+      // the frame format changed, images of the old format are not needed anymore
+      iter = m_ImagePool.erase(iter);
+    }
+  }
+
+  unsigned int dimensions[2] = { width, height };
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize( pixelType, 2, dimensions );
+  ++m_NumberOfAllocatedImages;
 
-void mitk::OpenCVToMitkImageFilter::SetCopyBuffer(bool)
+  if ( m_ImagePool.size() < m_MaximumImagePoolSize )
+  {
+    m_ImagePool.push_back( image );
+  }
+  return image;
+}
+
+void mitk::OpenCVToMitkImageFilter::SetUseImagePool(bool usePool)
 {
+  m_UseImagePool = usePool;
+  if ( !usePool )
+  {
+    m_ImagePool.clear();
+  }
 }
 
-bool mitk::OpenCVToMitkImageFilter::GetCopyBuffer()
+void mitk::OpenCVToMitkImageFilter::SetOpenCVMat(const cv::Mat &image)
 {
-    return true;
+    m_OpenCVMat = image;
 }
@@ -25,12 +25,22 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkOpenCVVideoSupportExports.h"
 
+#include <vector>
+
 namespace mitk
 {
 
 ///
 /// \brief Filter for creating MITK RGB Images from an OpenCV image
 ///
+/// For video streams the filter can recycle its output images: with SetUseImagePool(true) the
+/// pixel data of a frame is copied into a pooled image which is no longer referenced by anybody
+/// else, so no image buffer is allocated per frame once the pool is filled.
+///
+/// With SetCopyBuffer(false), single channel frames whose rows are not padded are not copied at
+/// all; the output image references the memory of the OpenCV image, which must then outlive the
+/// output (or the output must be copied before the OpenCV image is released). Other frames are copied.
+///
 class MITK_OPENCVVIDEOSUPPORT_EXPORT OpenCVToMitkImageFilter : public ImageSource
 {
   public:
@@ -41,7 +51,7 @@ class MITK_OPENCVVIDEOSUPPORT_EXPORT OpenCVToMitkImageFilter : public ImageSourc
 
     ///
     /// the static function for the conversion
-    /// WARNING: copyBuffer is deprecated, data will always be copied
+    /// WARNING: copyBuffer is ignored, data will always be copied
     ///
     template <typename TPixel, unsigned int VImageDimension>
     static mitk::Image::Pointer ConvertIplToMitkImage( const IplImage * input, bool copyBuffer=true );
@@ -61,8 +71,29 @@ class MITK_OPENCVVIDEOSUPPORT_EXPORT OpenCVToMitkImageFilter : public ImageSourc
     void SetOpenCVMat(const cv::Mat& image);
     itkGetMacro(OpenCVMat, cv::Mat);
 
-    DEPRECATED( void SetCopyBuffer( bool ); );
-    DEPRECATED( bool GetCopyBuffer(); );
+    ///
+    /// if false, compatible frames are referenced instead of copied (default true)
+    ///
+    itkSetMacro(CopyBuffer, bool);
+    itkGetMacro(CopyBuffer, bool);
+
+    ///
+    /// recycle output images which are no longer referenced outside of the filter (default false)
+    ///
+    void SetUseImagePool(bool usePool);
+    itkGetMacro(UseImagePool, bool);
+
+    ///
+    /// maximum number of images kept in the pool (default 4); if all of them are
+    /// still in use, additional frames get a new, unpooled image
+    ///
+    itkSetMacro(MaximumImagePoolSize, unsigned int);
+    itkGetMacro(MaximumImagePoolSize, unsigned int);
+
+    ///
+    /// number of image buffers allocated by this filter so far
+    ///
+    itkGetMacro(NumberOfAllocatedImages, unsigned long);
 
     OutputImageType* GetOutput(void);
 
@@ -73,10 +104,27 @@ class MITK_OPENCVVIDEOSUPPORT_EXPORT OpenCVToMitkImageFilter : public ImageSourc
 
     virtual void GenerateData();
 
+    ///
+    /// converts the image by referencing, pooling or copying its data
+    ///
+    template <typename TPixel, typename TComponent>
+    mitk::Image::Pointer ConvertIplImage( const IplImage* input );
+
+    ///
+    /// returns an unused pooled image of the given type and size, creates one if there is none
+    ///
+    mitk::Image::Pointer GetPooledImage( const mitk::PixelType& pixelType, unsigned int width, unsigned int height );
+
 protected:
     mitk::Image::Pointer m_Image;
     const IplImage* m_OpenCVImage;
     cv::Mat m_OpenCVMat;
+
+    bool m_CopyBuffer;
+    bool m_UseImagePool;
+    unsigned int m_MaximumImagePoolSize;
+    unsigned long m_NumberOfAllocatedImages;
+    std::vector<mitk::Image::Pointer> m_ImagePool;
 };
 
 } // namespace
@@ -24,13 +24,54 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkUndistortCameraImage.h"
 #include "itkTimeProbe.h"
+#include "itkMultiThreader.h"
 
 #include "highgui.h"
 
+#include <algorithm>
+
+namespace
+{
+  struct RemapThreadData
+  {
+    cv::Mat src;
+    cv::Mat dst;
+    cv::Mat map1;
+    cv::Mat map2;
+    int interpolation;
+  };
+
+  // remaps one band of rows, the maps contain absolute source coordinates,
+  // so every band can be remapped independently from the full source image
+  ITK_THREAD_RETURN_TYPE RemapThreaderCallback(void* arg)
+  {
+    itk::MultiThreader::ThreadInfoStruct* info = static_cast<itk::MultiThreader::ThreadInfoStruct*>(arg);
+    RemapThreadData* data = static_cast<RemapThreadData*>(info->UserData);
+
+    int rows = data->dst.rows;
+    int begin = rows * info->ThreadID / info->NumberOfThreads;
+    int end = rows * (info->ThreadID + 1) / info->NumberOfThreads;
+    if (end > begin)
+    {
+      cv::Mat dstRows = data->dst.rowRange(begin, end);
+      cv::remap(data->src, dstRows, data->map1.rowRange(begin, end), data->map2.rowRange(begin, end),
+                data->interpolation, cv::BORDER_CONSTANT, cv::Scalar());
+    }
+    return ITK_THREAD_RETURN_VALUE;
+  }
+}
+
 mitk::UndistortCameraImage::UndistortCameraImage()
+: m_ccX(0.0f), m_ccY(0.0f), m_fcX(1.0f), m_fcY(1.0f),
+  m_FastParametersSet(false),
+  m_MaximumNumberOfRemapTables(4),
+  m_NumberOfThreads(0)
 {
   m_tempImage = NULL;
-
+  for (int i = 0; i < 4; ++i)
+    m_distortionMatrixData[i] = 0.0f;
+  for (int i = 0; i < 8; ++i)
+    m_FastParameters[i] = 0.0f;
 }
 mitk::UndistortCameraImage::~UndistortCameraImage()
 {
@@ -115,23 +156,15 @@ mitk::Point2D mitk::UndistortCameraImage::UndistortPixel(mitk::Point2D src)
 
 void mitk::UndistortCameraImage::UndistortImage(IplImage *src, IplImage *dst)
 {
-   // init intrinsic camera matrix [fx 0 cx; 0 fy cy; 0 0 1].
-  m_intrinsicMatrixData[0] = (double)m_fcX;
-  m_intrinsicMatrixData[1] = 0.0;
-  m_intrinsicMatrixData[2] = (double)m_ccX;
-  m_intrinsicMatrixData[3] = 0.0;
-  m_intrinsicMatrixData[4] = (double)m_fcY;
-  m_intrinsicMatrixData[5] = (double)m_ccY;
-  m_intrinsicMatrixData[6] = 0.0;
-  m_intrinsicMatrixData[7] = 0.0;
-  m_intrinsicMatrixData[8] = 1.0;
-  m_intrinsicMatrix        = cvMat(3, 3, CV_32FC1, m_intrinsicMatrixData);
-
-  // init distortion matrix
-  m_distortionMatrix       = cvMat(1, 4, CV_32F, m_distortionMatrixData);
-
-  // undistort
-  cvUndistort2(src,dst, &m_intrinsicMatrix, &m_distortionMatrix);
+  if(!src || !dst)
+    return;
+
+  // same result as cvUndistort2 with bilinear interpolation, but the remap table is only computed once
+  float parameters[8] = { m_fcX, m_fcY, m_ccX, m_ccY,
+                          m_distortionMatrixData[0], m_distortionMatrixData[1],
+                          m_distortionMatrixData[2], m_distortionMatrixData[3] };
+  const RemapTable& table = this->GetRemapTable(src->width, src->height, parameters);
+  this->Remap(src, dst, table, CV_INTER_LINEAR);
 }
 
 
@@ -139,100 +172,123 @@ void mitk::UndistortCameraImage::UndistortImage(IplImage *src, IplImage *dst)
 
 void mitk::UndistortCameraImage::UndistortImageFast(IplImage * src, IplImage* dst)
 {
-  if(!src)
+  if(!src || !m_FastParametersSet)
     return;
 
-  /*if(dst == NULL)
-    dst = src;
-
-  if(src->nChannels == 3)
-  {
-    IplImage *r = cvCreateImage(cvGetSize(src),src->depth,1);//subpixel
-    IplImage *g = cvCreateImage(cvGetSize(src),src->depth,1);//subpixel
-    IplImage *b = cvCreateImage(cvGetSize(src),src->depth,1);//subpixel
-
-    cvSplit(src, r,g,b, NULL);
-
-    cvRemap( r, r, m_mapX, m_mapY ); // Undistort image
-    cvRemap( g, g, m_mapX, m_mapY ); // Undistort image
-    cvRemap( b, b, m_mapX, m_mapY ); // Undistort image
-
-    cvMerge(r,g,b, NULL, dst);
-  }
-  else
-  {
-    cvRemap(src, dst, m_mapX, m_mapY);
-  }*/
-
-
-  /*if(m_tempImage == NULL)
-    m_tempImage = cvCreateImage(cvSize(src->width,src->height),src->depth,src->nChannels);*/
-
-  /*if(dst == NULL)
-    dst = cvCreateImage(cvSize(src->width,src->height),src->depth,src->nChannels);*/
+  const RemapTable& table = this->GetRemapTable(src->width, src->height, m_FastParameters);
 
-  if(!dst)
+  if(!dst || dst == src)
   {
-    m_tempImage = cvCloneImage( src );
-    cvRemap(m_tempImage, src, m_mapX, m_mapY, CV_INTER_CUBIC);
-    cvReleaseImage( &m_tempImage );
-    m_tempImage = 0;
-    /*memcpy( src->imageData, m_tempImage->imageData, m_tempImage->imageSize );
-    cvReleaseImage( &m_tempImage );*/
+    // remapping cannot be done in place, keep a copy of the source for the next frames
+    if(m_tempImage == NULL || m_tempImage->width != src->width || m_tempImage->height != src->height
+       || m_tempImage->depth != src->depth || m_tempImage->nChannels != src->nChannels)
+    {
+      if(m_tempImage != NULL)
+        cvReleaseImage(&m_tempImage);
+      m_tempImage = cvCreateImage(cvGetSize(src), src->depth, src->nChannels);
+    }
+    cvCopy(src, m_tempImage);
+    m_tempImage->origin = src->origin;
+    this->Remap(m_tempImage, src, table, CV_INTER_CUBIC);
   }
   else
   {
-   cvRemap(src, dst, m_mapX, m_mapY, CV_INTER_CUBIC);
+    this->Remap(src, dst, table, CV_INTER_CUBIC);
   }
-
-  /*m_tempImage->origin = src->origin;
-
-  if(dst == NULL)
-    memcpy( src->imageData, m_tempImage->imageData, m_tempImage->imageSize );
-  else
-    memcpy( dst->imageData, m_tempImage->imageData, m_tempImage->imageSize );
-
-  //cvUnDistort(m_srcImg, m_dstImg, m_undistMap,m_interpolationMode);
-  //cvUndistort2(m_srcImg, m_dstImg, &m_intrinsicMatrix,&m_distortionMatrixDataCoefficients);*/
 }
 
-
-
 void mitk::UndistortCameraImage::SetUndistortImageFastInfo(float in_dF1, float in_dF2,
                                                  float in_dPrincipalX, float in_dPrincipalY,
                                                  float in_Dist[4], float ImageSizeX, float ImageSizeY)
 {
-  //create new matrix
-  m_DistortionCoeffs  = cvCreateMat(4, 1, CV_64FC1);
-  m_CameraMatrix      = cvCreateMat(3, 3, CV_64FC1);
-
-
-  //set the camera matrix [fx 0 cx; 0 fy cy; 0 0 1].
-  cvSetReal2D(m_CameraMatrix, 0, 0, in_dF1);
-  cvSetReal2D(m_CameraMatrix, 0, 1, 0.0);
-  cvSetReal2D(m_CameraMatrix, 0, 2, in_dPrincipalX);
-
-  cvSetReal2D(m_CameraMatrix, 1, 0, 0.0);
-  cvSetReal2D(m_CameraMatrix, 1, 1, in_dF2);
-  cvSetReal2D(m_CameraMatrix, 1, 2, in_dPrincipalY);
-
-  cvSetReal2D(m_CameraMatrix, 2, 0, 0.0);
-  cvSetReal2D(m_CameraMatrix, 2, 1, 0.0);
-  cvSetReal2D(m_CameraMatrix, 2, 2, 1.0);
-
-  //set distortions coefficients
-  cvSetReal1D(m_DistortionCoeffs, 0, in_Dist[0]);
-  cvSetReal1D(m_DistortionCoeffs, 1, in_Dist[1]);
-  cvSetReal1D(m_DistortionCoeffs, 2, in_Dist[2]);
-  cvSetReal1D(m_DistortionCoeffs, 3, in_Dist[3]);
-
-  m_mapX = cvCreateMat(ImageSizeY, ImageSizeX, CV_32FC1);
-  m_mapY = cvCreateMat(ImageSizeY, ImageSizeX, CV_32FC1);
+  m_FastParameters[0] = in_dF1;
+  m_FastParameters[1] = in_dF2;
+  m_FastParameters[2] = in_dPrincipalX;
+  m_FastParameters[3] = in_dPrincipalY;
+  for (int i = 0; i < 4; ++i)
+    m_FastParameters[4 + i] = in_Dist[i];
+  m_FastParametersSet = true;
+
+  // precompute the remap table for the expected frame size
+  this->GetRemapTable(static_cast<int>(ImageSizeX), static_cast<int>(ImageSizeY), m_FastParameters);
+}
 
-  //cv::initUndistortRectifyMap(m_CameraMatrix, m_DistortionCoeffs, m_mapX, m_mapY);
-  cvInitUndistortMap(m_CameraMatrix, m_DistortionCoeffs, m_mapX, m_mapY);
+void mitk::UndistortCameraImage::InitRemapUndistortion(int sizeX, int sizeY)
+{
+  this->SetUndistortImageFastInfo(m_fcX, m_fcY, m_ccX, m_ccY, m_distortionMatrixData,
+                                  static_cast<float>(sizeX), static_cast<float>(sizeY));
 }
 
+const mitk::UndistortCameraImage::RemapTable& mitk::UndistortCameraImage::GetRemapTable(int width, int height, const float parameters[8])
+{
+  for (std::vector<RemapTable>::iterator iter = m_RemapTables.begin(); iter != m_RemapTables.end(); ++iter)
+  {
+    if (iter->width == width && iter->height == height
+        && std::equal(parameters, parameters + 8, iter->parameters))
+    {
+      // move the table to the front, so the least recently used one is dropped first
+      if (iter != m_RemapTables.begin())
+      {
+        std::rotate(m_RemapTables.begin(), iter, iter + 1);
+      }
+      return m_RemapTables.front();
+    }
+  }
 
+  RemapTable table;
+  table.width = width;
+  table.height = height;
+  std::copy(parameters, parameters + 8, table.parameters);
+
+  // camera matrix [fx 0 cx; 0 fy cy; 0 0 1]
+  cv::Mat cameraMatrix = cv::Mat::zeros(3, 3, CV_64FC1);
+  cameraMatrix.at<double>(0, 0) = parameters[0];
+  cameraMatrix.at<double>(1, 1) = parameters[1];
+  cameraMatrix.at<double>(0, 2) = parameters[2];
+  cameraMatrix.at<double>(1, 2) = parameters[3];
+  cameraMatrix.at<double>(2, 2) = 1.0;
+
+  cv::Mat distortionCoefficients(4, 1, CV_64FC1);
+  for (int i = 0; i < 4; ++i)
+    distortionCoefficients.at<double>(i) = parameters[4 + i];
+
+  // evaluate the distortion model once per pixel and convert the maps to fixed point,
+  // which is both smaller and faster to interpolate from than the floating point maps
+  cv::Mat mapX, mapY;
+  cv::initUndistortRectifyMap(cameraMatrix, distortionCoefficients, cv::Mat(), cameraMatrix,
+                              cv::Size(width, height), CV_32FC1, mapX, mapY);
+  cv::convertMaps(mapX, mapY, table.map1, table.map2, CV_16SC2);
+
+  if (m_MaximumNumberOfRemapTables > 0 && m_RemapTables.size() >= m_MaximumNumberOfRemapTables)
+  {
+    m_RemapTables.resize(m_MaximumNumberOfRemapTables - 1);
+  }
+  m_RemapTables.insert(m_RemapTables.begin(), table);
+  return m_RemapTables.front();
+}
 
+void mitk::UndistortCameraImage::Remap(IplImage* src, IplImage* dst, const RemapTable& table, int interpolation)
+{
+  RemapThreadData data;
+  data.src = cv::Mat(src);
+  data.dst = cv::Mat(dst);
+  data.map1 = table.map1;
+  data.map2 = table.map2;
+  data.interpolation = interpolation;
+
+  if (data.dst.rows != table.height || data.dst.cols != table.width || data.dst.type() != data.src.type())
+  {
+    MITK_WARN << "Destination image size or type does not match the source image. Cannot undistort.";
+    return;
+  }
 
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  unsigned int numberOfThreads = m_NumberOfThreads > 0 ? m_NumberOfThreads : itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  if (numberOfThreads > static_cast<unsigned int>(table.height))
+  {
+    numberOfThreads = table.height;
+  }
+  threader->SetNumberOfThreads(numberOfThreads);
+  threader->SetSingleMethod(RemapThreaderCallback, &data);
+  threader->SingleMethodExecute();
+}
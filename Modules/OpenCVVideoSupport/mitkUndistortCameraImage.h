@@ -26,6 +26,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkVector.h"
 #include "cv.h"
 
+#include <vector>
+
 /*!
 \brief UndistortCameraImage
 
@@ -37,6 +39,10 @@ OpenCV image.
 A faster version of UndistortImage() is UndistortImageFast(), however, it has to be initialized once with SetUndistortImageFastInfo()
 instead of the Set... methods before use.
 
+Both methods remap the image with fixed-point remap tables which are computed once per image size and set of
+intrinsic parameters and then cached, so only the first frame of a video pays for the evaluation of the
+distortion model. The remapping is split into bands of rows which are processed by SetNumberOfThreads() threads.
+
 \sa QmitkFunctionality
 \ingroup Functionalities
 */
@@ -75,9 +81,19 @@ class MITK_OPENCVVIDEOSUPPORT_EXPORT UndistortCameraImage : public itk::Object
       m_distortionMatrixData[2] = kc3; m_distortionMatrixData[3] = kc4;
     }
     /*
-    * Pre-Calculates matrices for the later use of UndistortImageFast()
+    * Pre-Calculates matrices for the later use of UndistortImageFast() from the parameters given by the Set... methods
     */
     void InitRemapUndistortion(int sizeX, int sizeY);
+    /*
+    * Set the number of threads which remap an image, 0 (default) uses the ITK default
+    */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetMacro(NumberOfThreads, unsigned int);
+    /*
+    * Set the maximum number of cached remap tables (default 4), one table is needed per image size and parameter set
+    */
+    itkSetMacro(MaximumNumberOfRemapTables, unsigned int);
+    itkGetMacro(MaximumNumberOfRemapTables, unsigned int);
 
     /// USAGE ///
     /*
@@ -105,23 +121,35 @@ class MITK_OPENCVVIDEOSUPPORT_EXPORT UndistortCameraImage : public itk::Object
 
   protected:
 
+    // remap table for one image size and parameter set
+    struct RemapTable
+    {
+      int width;
+      int height;
+      // fcX, fcY, ccX, ccY, kc1, kc2, kc3, kc4
+      float parameters[8];
+      // integer source coordinates (CV_16SC2) and interpolation table indices (CV_16UC1)
+      cv::Mat map1, map2;
+    };
+
+    // returns the cached remap table for the given size and parameters, computes it if necessary
+    const RemapTable& GetRemapTable(int width, int height, const float parameters[8]);
+    // remaps src into dst with the given table, split over the threads
+    void Remap(IplImage* src, IplImage* dst, const RemapTable& table, int interpolation);
+
     // principal point and focal length parameters
     float m_ccX, m_ccY, m_fcX, m_fcY;
     // undistortion parameters
     float m_distortionMatrixData[4];
-    // intrinsic camera parameters
-    float m_intrinsicMatrixData[9];
-    // precalculated matrices for fast image undistortion with UndistortImageFast()
-    CvMat * m_mapX, * m_mapY;
-    // intrinsic and undistortion camera matrices
-    CvMat m_intrinsicMatrix, m_distortionMatrix;
-    // temp image
+    // parameters for UndistortImageFast(), set by SetUndistortImageFastInfo() or InitRemapUndistortion()
+    float m_FastParameters[8];
+    bool m_FastParametersSet;
+    // cached remap tables, the most recently used one first
+    std::vector<RemapTable> m_RemapTables;
+    unsigned int m_MaximumNumberOfRemapTables;
+    unsigned int m_NumberOfThreads;
+    // temp image for in-place undistortion
     IplImage * m_tempImage;
-
-
-
-    CvMat *m_DistortionCoeffs;
-    CvMat *m_CameraMatrix;
 };
 
 }
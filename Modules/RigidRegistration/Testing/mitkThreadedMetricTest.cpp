@@ -0,0 +1,193 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestingMacros.h"
+#include "mitkMetricFactory.h"
+#include "mitkMetricParameters.h"
+#include "itkThreadedNormalizedCorrelationImageToImageMetric.h"
+
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkNormalizedCorrelationImageToImageMetric.h>
+#include <itkTranslationTransform.h>
+#include <itkLinearInterpolateImageFunction.h>
+#include <itkTimeProbe.h>
+
+#include <cmath>
+
+typedef itk::Image<float, 3> ImageType;
+typedef itk::TranslationTransform<double, 3> TransformType;
+typedef itk::LinearInterpolateImageFunction<ImageType, double> InterpolatorType;
+typedef itk::ImageToImageMetric<ImageType, ImageType> MetricType;
+
+/**
+ * Creates a smooth blob image. The moving image is shifted and has a different,
+ * linear intensity mapping ( as between two modalities ).
+ */
+static ImageType::Pointer CreateImage(unsigned int size, double shift, double scale, double offset)
+{
+  ImageType::Pointer image = ImageType::New();
+  ImageType::SizeType imageSize;
+  imageSize.Fill(size);
+  image->SetRegions(imageSize);
+  image->Allocate();
+
+  const double center = 0.5 * size;
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    ImageType::IndexType index = it.GetIndex();
+    double dx = index[0] - center - shift;
+    double dy = index[1] - center;
+    double dz = index[2] - center;
+    double value = std::exp(-(dx * dx + dy * dy + dz * dz) / (0.08 * size * size));
+    it.Set(static_cast<float>(scale * value + offset));
+  }
+  return image;
+}
+
+static void InitializeMetric(MetricType* metric, ImageType* fixedImage, ImageType* movingImage)
+{
+  metric->SetFixedImage(fixedImage);
+  metric->SetMovingImage(movingImage);
+  metric->SetFixedImageRegion(fixedImage->GetLargestPossibleRegion());
+  metric->SetTransform(TransformType::New());
+  metric->SetInterpolator(InterpolatorType::New());
+  metric->Initialize();
+}
+
+static void TestThreadedNormalizedCorrelation(ImageType* fixedImage, ImageType* movingImage)
+{
+  typedef itk::NormalizedCorrelationImageToImageMetric<ImageType, ImageType> ReferenceMetricType;
+  typedef itk::ThreadedNormalizedCorrelationImageToImageMetric<ImageType, ImageType> ThreadedMetricType;
+
+  TransformType::ParametersType parameters(3);
+  parameters.Fill(0.0);
+  parameters[0] = 1.5;
+
+  for (int subtractMean = 0; subtractMean < 2; ++subtractMean)
+  {
+    ReferenceMetricType::Pointer reference = ReferenceMetricType::New();
+    reference->SetSubtractMean(subtractMean == 1);
+    InitializeMetric(reference, fixedImage, movingImage);
+
+    MetricType::MeasureType referenceValue;
+    MetricType::DerivativeType referenceDerivative;
+    reference->GetValueAndDerivative(parameters, referenceValue, referenceDerivative);
+
+    for (unsigned int threads = 1; threads <= 4; threads *= 2)
+    {
+      ThreadedMetricType::Pointer threaded = ThreadedMetricType::New();
+      threaded->SetSubtractMean(subtractMean == 1);
+      threaded->SetNumberOfThreads(threads);
+      InitializeMetric(threaded, fixedImage, movingImage);
+
+      MetricType::MeasureType value;
+      MetricType::DerivativeType derivative;
+      threaded->GetValueAndDerivative(parameters, value, derivative);
+
+      MITK_TEST_CONDITION(std::fabs(value - referenceValue) < 1e-6,
+                          "Threaded NC value matches ITK with " << threads << " thread(s), SubtractMean " << subtractMean
+                          << " (" << value << " vs. " << referenceValue << ")")
+      MITK_TEST_CONDITION(std::fabs(threaded->GetValue(parameters) - value) < 1e-9, "GetValue() matches GetValueAndDerivative()")
+
+      bool derivativeMatches = derivative.GetSize() == referenceDerivative.GetSize();
+      for (unsigned int i = 0; derivativeMatches && i < derivative.GetSize(); ++i)
+      {
+        derivativeMatches = std::fabs(derivative[i] - referenceDerivative[i]) < 1e-6 * (1.0 + std::fabs(referenceDerivative[i]));
+      }
+      MITK_TEST_CONDITION(derivativeMatches, "Threaded NC derivative matches ITK with " << threads << " thread(s)")
+    }
+  }
+}
+
+static void TestMetricFactory(ImageType* fixedImage, ImageType* movingImage)
+{
+  mitk::MetricParameters::Pointer metricParameters = mitk::MetricParameters::New();
+  metricParameters->SetMetric(mitk::MetricParameters::NORMALIZEDCORRELATIONIMAGETOIMAGEMETRIC);
+  metricParameters->SetUseMultiThreadedMetric(true);
+  metricParameters->SetNumberOfMetricThreads(2);
+
+  mitk::MetricFactory<float, 3>::Pointer factory = mitk::MetricFactory<float, 3>::New();
+  factory->SetMetricParameters(metricParameters);
+  MetricType::Pointer metric = factory->GetMetric();
+
+  MITK_TEST_CONDITION(dynamic_cast<itk::ThreadedNormalizedCorrelationImageToImageMetric<ImageType, ImageType>*>(metric.GetPointer()) != NULL,
+                      "MetricFactory creates the threaded NC metric")
+  MITK_TEST_CONDITION(metric->GetNumberOfThreads() == 2, "MetricFactory sets the number of metric threads")
+
+  InitializeMetric(metric, fixedImage, movingImage);
+  TransformType::ParametersType parameters(3);
+  parameters.Fill(0.0);
+  MITK_TEST_CONDITION(metric->GetValue(parameters) < 0.0, "Threaded NC of correlated images is negative")
+}
+
+static void BenchmarkMetrics(ImageType* fixedImage, ImageType* movingImage)
+{
+  const int metrics[] = { mitk::MetricParameters::MEANSQUARESIMAGETOIMAGEMETRIC,
+                          mitk::MetricParameters::NORMALIZEDCORRELATIONIMAGETOIMAGEMETRIC,
+                          mitk::MetricParameters::MATTESMUTUALINFORMATIONIMAGETOIMAGEMETRIC };
+  const char* names[] = { "MeanSquares", "NormalizedCorrelation", "MattesMutualInformation" };
+
+  TransformType::ParametersType parameters(3);
+  parameters.Fill(0.0);
+  parameters[0] = 1.0;
+
+  for (unsigned int m = 0; m < 3; ++m)
+  {
+    for (unsigned int threads = 1; threads <= 8; threads *= 2)
+    {
+      mitk::MetricParameters::Pointer metricParameters = mitk::MetricParameters::New();
+      metricParameters->SetMetric(metrics[m]);
+      metricParameters->SetUseMultiThreadedMetric(true);
+      metricParameters->SetNumberOfMetricThreads(threads);
+
+      mitk::MetricFactory<float, 3>::Pointer factory = mitk::MetricFactory<float, 3>::New();
+      factory->SetMetricParameters(metricParameters);
+      MetricType::Pointer metric = factory->GetMetric();
+      InitializeMetric(metric, fixedImage, movingImage);
+
+      MetricType::MeasureType value;
+      MetricType::DerivativeType derivative;
+      itk::TimeProbe probe;
+      for (unsigned int i = 0; i < 10; ++i)
+      {
+        probe.Start();
+        metric->GetValueAndDerivative(parameters, value, derivative);
+        probe.Stop();
+      }
+      MITK_INFO << names[m] << " with " << threads << " thread(s): " << probe.GetMean() << "s per evaluation";
+    }
+  }
+}
+
+/**
+ * Compares the multi-threaded normalized correlation metric against the ITK
+ * implementation and times the metrics of the MetricFactory for different numbers of threads.
+ */
+int mitkThreadedMetricTest(int /*argc*/, char* /*argv*/[])
+{
+  MITK_TEST_BEGIN("ThreadedMetric")
+
+  ImageType::Pointer fixedImage = CreateImage(48, 0.0, 1000.0, -100.0);
+  ImageType::Pointer movingImage = CreateImage(48, 2.0, -300.0, 400.0);
+
+  TestThreadedNormalizedCorrelation(fixedImage, movingImage);
+  TestMetricFactory(fixedImage, fixedImage);
+  BenchmarkMetrics(fixedImage, movingImage);
+
+  MITK_TEST_END()
+}
@@ -0,0 +1,140 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __itkThreadedNormalizedCorrelationImageToImageMetric_h
+#define __itkThreadedNormalizedCorrelationImageToImageMetric_h
+
+#include "itkImageToImageMetric.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class ThreadedNormalizedCorrelationImageToImageMetric
+ * \brief Normalized correlation metric evaluated by the multi-threaded sample loop of ImageToImageMetric
+ *
+ * Computes the same measure as NormalizedCorrelationImageToImageMetric, the negative normalized cross
+ * correlation of the fixed image samples and the mapped moving image values ( optionally with the means
+ * subtracted ). In contrast to the ITK class, every thread accumulates partial sums ( and partial derivatives )
+ * over its share of the fixed image samples, the sums are merged once per evaluation.
+ *
+ * All pixels of the fixed image are used by default, a random subset after
+ * SetNumberOfFixedImageSamples() and UseAllPixelsOff(). The number of threads is set by SetNumberOfThreads().
+ *
+ * \ingroup RegistrationMetrics
+ */
+template < class TFixedImage, class TMovingImage >
+class ITK_EXPORT ThreadedNormalizedCorrelationImageToImageMetric :
+    public ImageToImageMetric< TFixedImage, TMovingImage >
+{
+public:
+
+  /** Standard class typedefs. */
+  typedef ThreadedNormalizedCorrelationImageToImageMetric  Self;
+  typedef ImageToImageMetric<TFixedImage, TMovingImage>    Superclass;
+  typedef SmartPointer<Self>                               Pointer;
+  typedef SmartPointer<const Self>                         ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ThreadedNormalizedCorrelationImageToImageMetric, ImageToImageMetric);
+
+  /** Types inherited from Superclass. */
+  typedef typename Superclass::TransformType            TransformType;
+  typedef typename Superclass::TransformJacobianType    TransformJacobianType;
+  typedef typename Superclass::MeasureType              MeasureType;
+  typedef typename Superclass::DerivativeType           DerivativeType;
+  typedef typename Superclass::ParametersType           ParametersType;
+  typedef typename Superclass::FixedImagePointType      FixedImagePointType;
+  typedef typename Superclass::MovingImagePointType     MovingImagePointType;
+  typedef typename Superclass::ImageDerivativesType     ImageDerivativesType;
+
+  itkStaticConstMacro(MovingImageDimension, unsigned int, TMovingImage::ImageDimension);
+
+  /** Allocates the per thread sums, called by the registration method. */
+  virtual void Initialize(void) throw ( ExceptionObject );
+
+  /** Get the value for single valued optimizers. */
+  MeasureType GetValue(const ParametersType & parameters) const;
+
+  /** Get the derivatives of the match measure. */
+  void GetDerivative(const ParametersType & parameters, DerivativeType & derivative) const;
+
+  /** Get value and derivatives for multiple valued optimizers. */
+  void GetValueAndDerivative(const ParametersType & parameters, MeasureType & value, DerivativeType & derivative) const;
+
+  /** Subtract the means of fixed and moving samples before computing the correlation ( default off ) */
+  itkSetMacro(SubtractMean, bool);
+  itkGetConstReferenceMacro(SubtractMean, bool);
+  itkBooleanMacro(SubtractMean);
+
+protected:
+  ThreadedNormalizedCorrelationImageToImageMetric();
+  virtual ~ThreadedNormalizedCorrelationImageToImageMetric() {}
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+  /** Partial sums of one thread */
+  struct ThreadSums
+  {
+    double sff;
+    double smm;
+    double sfm;
+    double sf;
+    double sm;
+  };
+
+  inline bool GetValueThreadProcessSample(ThreadIdType threadID,
+                                          SizeValueType fixedImageSample,
+                                          const MovingImagePointType & mappedPoint,
+                                          double movingImageValue) const;
+
+  inline bool GetValueAndDerivativeThreadProcessSample(ThreadIdType threadID,
+                                                       SizeValueType fixedImageSample,
+                                                       const MovingImagePointType & mappedPoint,
+                                                       double movingImageValue,
+                                                       const ImageDerivativesType & movingImageGradientValue) const;
+
+private:
+  ThreadedNormalizedCorrelationImageToImageMetric(const Self &); //purposely not implemented
+  void operator=(const Self &);                                  //purposely not implemented
+
+  /** Merges the partial sums of all threads, optionally with the means subtracted */
+  ThreadSums MergeSums() const;
+
+  /** Throws if too few samples mapped into the moving image */
+  void CheckNumberOfPixelsCounted() const;
+
+  bool m_SubtractMean;
+
+  mutable std::vector< ThreadSums > m_ThreaderSums;
+
+  /** Per thread sums of f * dm/dp, m * dm/dp and dm/dp */
+  mutable std::vector< DerivativeType > m_ThreaderDerivativeF;
+  mutable std::vector< DerivativeType > m_ThreaderDerivativeM;
+  mutable std::vector< DerivativeType > m_ThreaderDerivativeM1;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkThreadedNormalizedCorrelationImageToImageMetric.txx"
+#endif
+
+#endif // __itkThreadedNormalizedCorrelationImageToImageMetric_h
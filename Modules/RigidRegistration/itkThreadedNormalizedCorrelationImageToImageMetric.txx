@@ -0,0 +1,286 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __itkThreadedNormalizedCorrelationImageToImageMetric_txx
+#define __itkThreadedNormalizedCorrelationImageToImageMetric_txx
+
+#include "itkThreadedNormalizedCorrelationImageToImageMetric.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+template < class TFixedImage, class TMovingImage >
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::ThreadedNormalizedCorrelationImageToImageMetric()
+  : m_SubtractMean(false)
+{
+  this->m_WithinThreadPreProcess = false;
+  this->m_WithinThreadPostProcess = false;
+
+  // as NormalizedCorrelationImageToImageMetric, use all pixels of the fixed image by default
+  this->UseAllPixelsOn();
+}
+
+template < class TFixedImage, class TMovingImage >
+void
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::Initialize(void) throw ( ExceptionObject )
+{
+  Superclass::Initialize();
+  Superclass::MultiThreadingInitialize();
+
+  m_ThreaderSums.resize( this->m_NumberOfThreads );
+  m_ThreaderDerivativeF.resize( this->m_NumberOfThreads );
+  m_ThreaderDerivativeM.resize( this->m_NumberOfThreads );
+  m_ThreaderDerivativeM1.resize( this->m_NumberOfThreads );
+  for( ThreadIdType threadID = 0; threadID < this->m_NumberOfThreads; threadID++ )
+  {
+    m_ThreaderDerivativeF[threadID].SetSize( this->m_NumberOfParameters );
+    m_ThreaderDerivativeM[threadID].SetSize( this->m_NumberOfParameters );
+    m_ThreaderDerivativeM1[threadID].SetSize( this->m_NumberOfParameters );
+  }
+}
+
+template < class TFixedImage, class TMovingImage >
+inline bool
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::GetValueThreadProcessSample(ThreadIdType threadID,
+                              SizeValueType fixedImageSample,
+                              const MovingImagePointType & itkNotUsed(mappedPoint),
+                              double movingImageValue) const
+{
+  const double fixedImageValue = this->m_FixedImageSamples[fixedImageSample].value;
+
+  ThreadSums& sums = m_ThreaderSums[threadID];
+  sums.sff += fixedImageValue * fixedImageValue;
+  sums.smm += movingImageValue * movingImageValue;
+  sums.sfm += fixedImageValue * movingImageValue;
+  sums.sf += fixedImageValue;
+  sums.sm += movingImageValue;
+
+  return true;
+}
+
+template < class TFixedImage, class TMovingImage >
+inline bool
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::GetValueAndDerivativeThreadProcessSample(ThreadIdType threadID,
+                                           SizeValueType fixedImageSample,
+                                           const MovingImagePointType & mappedPoint,
+                                           double movingImageValue,
+                                           const ImageDerivativesType & movingImageGradientValue) const
+{
+  this->GetValueThreadProcessSample( threadID, fixedImageSample, mappedPoint, movingImageValue );
+
+  const double fixedImageValue = this->m_FixedImageSamples[fixedImageSample].value;
+  const FixedImagePointType& fixedImagePoint = this->m_FixedImageSamples[fixedImageSample].point;
+
+  // the transforms of the other threads are copies of m_Transform, raw pointers avoid the
+  // locking of the smart pointer reference counts
+  TransformType* transform;
+  if( threadID > 0 )
+  {
+    transform = this->m_ThreaderTransform[threadID - 1];
+  }
+  else
+  {
+    transform = this->m_Transform;
+  }
+
+  // the Jacobian is evaluated at the unmapped ( fixed image ) point
+  TransformJacobianType jacobian;
+  transform->ComputeJacobianWithRespectToParameters( fixedImagePoint, jacobian );
+
+  DerivativeType& derivativeF = m_ThreaderDerivativeF[threadID];
+  DerivativeType& derivativeM = m_ThreaderDerivativeM[threadID];
+  DerivativeType& derivativeM1 = m_ThreaderDerivativeM1[threadID];
+
+  for( unsigned int par = 0; par < this->m_NumberOfParameters; par++ )
+  {
+    double differential = 0.0;
+    for( unsigned int dim = 0; dim < MovingImageDimension; dim++ )
+    {
+      differential += jacobian(dim, par) * movingImageGradientValue[dim];
+    }
+    derivativeF[par] += fixedImageValue * differential;
+    derivativeM[par] += movingImageValue * differential;
+    derivativeM1[par] += differential;
+  }
+
+  return true;
+}
+
+template < class TFixedImage, class TMovingImage >
+typename ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::ThreadSums
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::MergeSums() const
+{
+  ThreadSums merged = m_ThreaderSums[0];
+  for( ThreadIdType threadID = 1; threadID < this->m_NumberOfThreads; threadID++ )
+  {
+    merged.sff += m_ThreaderSums[threadID].sff;
+    merged.smm += m_ThreaderSums[threadID].smm;
+    merged.sfm += m_ThreaderSums[threadID].sfm;
+    merged.sf += m_ThreaderSums[threadID].sf;
+    merged.sm += m_ThreaderSums[threadID].sm;
+  }
+
+  if( m_SubtractMean && this->m_NumberOfPixelsCounted > 0 )
+  {
+    const double n = static_cast<double>( this->m_NumberOfPixelsCounted );
+    merged.sff -= merged.sf * merged.sf / n;
+    merged.smm -= merged.sm * merged.sm / n;
+    merged.sfm -= merged.sf * merged.sm / n;
+  }
+
+  return merged;
+}
+
+template < class TFixedImage, class TMovingImage >
+void
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::CheckNumberOfPixelsCounted() const
+{
+  if( this->m_NumberOfPixelsCounted < this->m_NumberOfFixedImageSamples / 4 )
+  {
+    itkExceptionMacro( "Too many samples map outside moving image buffer: "
+                       << this->m_NumberOfPixelsCounted << " / "
+                       << this->m_NumberOfFixedImageSamples << std::endl );
+  }
+}
+
+template < class TFixedImage, class TMovingImage >
+typename ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::MeasureType
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::GetValue(const ParametersType & parameters) const
+{
+  if( !this->m_FixedImage )
+  {
+    itkExceptionMacro( << "Fixed image has not been assigned" );
+  }
+
+  std::fill( m_ThreaderSums.begin(), m_ThreaderSums.end(), ThreadSums() );
+
+  this->m_Transform->SetParameters( parameters );
+  this->m_Parameters = parameters;
+
+  this->GetValueMultiThreadedInitiate();
+  this->CheckNumberOfPixelsCounted();
+
+  const ThreadSums sums = this->MergeSums();
+  const double denom = std::sqrt( sums.sff * sums.smm );
+
+  if( this->m_NumberOfPixelsCounted == 0 || denom == 0.0 )
+  {
+    return NumericTraits< MeasureType >::Zero;
+  }
+
+  return -sums.sfm / denom;
+}
+
+template < class TFixedImage, class TMovingImage >
+void
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::GetDerivative(const ParametersType & parameters, DerivativeType & derivative) const
+{
+  MeasureType value;
+  this->GetValueAndDerivative( parameters, value, derivative );
+}
+
+template < class TFixedImage, class TMovingImage >
+void
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::GetValueAndDerivative(const ParametersType & parameters, MeasureType & value, DerivativeType & derivative) const
+{
+  if( !this->m_FixedImage )
+  {
+    itkExceptionMacro( << "Fixed image has not been assigned" );
+  }
+
+  std::fill( m_ThreaderSums.begin(), m_ThreaderSums.end(), ThreadSums() );
+  for( ThreadIdType threadID = 0; threadID < this->m_NumberOfThreads; threadID++ )
+  {
+    m_ThreaderDerivativeF[threadID].Fill( 0.0 );
+    m_ThreaderDerivativeM[threadID].Fill( 0.0 );
+    m_ThreaderDerivativeM1[threadID].Fill( 0.0 );
+  }
+
+  this->m_Transform->SetParameters( parameters );
+  this->m_Parameters = parameters;
+
+  this->GetValueAndDerivativeMultiThreadedInitiate();
+  this->CheckNumberOfPixelsCounted();
+
+  if( derivative.GetSize() != this->m_NumberOfParameters )
+  {
+    derivative = DerivativeType( this->m_NumberOfParameters );
+  }
+  derivative.Fill( 0.0 );
+
+  const ThreadSums sums = this->MergeSums();
+  const double denom = std::sqrt( sums.sff * sums.smm );
+
+  if( this->m_NumberOfPixelsCounted == 0 || denom == 0.0 )
+  {
+    value = NumericTraits< MeasureType >::Zero;
+    return;
+  }
+
+  // means of the samples, zero if the means are not subtracted
+  double meanF = 0.0;
+  double meanM = 0.0;
+  if( m_SubtractMean )
+  {
+    meanF = sums.sf / this->m_NumberOfPixelsCounted;
+    meanM = sums.sm / this->m_NumberOfPixelsCounted;
+  }
+
+  for( unsigned int par = 0; par < this->m_NumberOfParameters; par++ )
+  {
+    double derivativeF = 0.0;
+    double derivativeM = 0.0;
+    double derivativeM1 = 0.0;
+    for( ThreadIdType threadID = 0; threadID < this->m_NumberOfThreads; threadID++ )
+    {
+      derivativeF += m_ThreaderDerivativeF[threadID][par];
+      derivativeM += m_ThreaderDerivativeM[threadID][par];
+      derivativeM1 += m_ThreaderDerivativeM1[threadID][par];
+    }
+
+    // d/dp of -sfm / sqrt( sff * smm ), sff does not depend on the parameters
+    const double dsfm = derivativeF - meanF * derivativeM1;
+    const double halfDsmm = derivativeM - meanM * derivativeM1;
+    derivative[par] = -( dsfm - ( sums.sfm / sums.smm ) * halfDsmm ) / denom;
+  }
+
+  value = -sums.sfm / denom;
+}
+
+template < class TFixedImage, class TMovingImage >
+void
+ThreadedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "SubtractMean: " << m_SubtractMean << std::endl;
+}
+
+} // end namespace itk
+
+#endif // __itkThreadedNormalizedCorrelationImageToImageMetric_txx
@@ -87,6 +87,11 @@ namespace mitk {
     MetricFactory();
     ~MetricFactory() {};
 
+    /**
+    \brief Sets the number of threads and fixed image samples of a multi-threaded metric.
+    */
+    void SetMultiThreadingParameters(MetricType* metric, bool useSampling);
+
     MetricParameters::Pointer m_MetricParameters;
   };
 
@@ -30,6 +30,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkNormalizedMutualInformationHistogramImageToImageMetric.h>
 #include <itkMatchCardinalityImageToImageMetric.h>
 #include <itkKappaStatisticImageToImageMetric.h>
+#include <itkMultiThreader.h>
+#include "itkThreadedNormalizedCorrelationImageToImageMetric.h"
 
 namespace mitk {
 
@@ -38,6 +40,23 @@ namespace mitk {
   {
   }
 
+  template < class TPixelType, unsigned int VImageDimension >
+  void MetricFactory<TPixelType, VImageDimension>::SetMultiThreadingParameters(MetricType* metric, bool useSampling)
+  {
+    unsigned int numberOfThreads = m_MetricParameters->GetNumberOfMetricThreads();
+    if (numberOfThreads == 0)
+    {
+      numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+    metric->SetNumberOfThreads(numberOfThreads);
+
+    if (useSampling && m_MetricParameters->GetNumberOfFixedImageSamples() > 0)
+    {
+      metric->SetNumberOfFixedImageSamples(m_MetricParameters->GetNumberOfFixedImageSamples());
+      metric->UseAllPixelsOff();
+    }
+  }
+
   template < class TPixelType, unsigned int VImageDimension >
     typename MetricFactory< TPixelType, VImageDimension>::MetricPointer
     MetricFactory<TPixelType, VImageDimension>
@@ -48,10 +67,21 @@ namespace mitk {
     {
       typename itk::MeanSquaresImageToImageMetric<FixedImageType, MovingImageType>::Pointer MetricPointer = itk::MeanSquaresImageToImageMetric<FixedImageType, MovingImageType>::New();
       MetricPointer->SetComputeGradient(m_MetricParameters->GetComputeGradient());
+      if (m_MetricParameters->GetUseMultiThreadedMetric())
+      {
+        this->SetMultiThreadingParameters(MetricPointer, true);
+      }
       return MetricPointer.GetPointer();
     }
     else if (metric == MetricParameters::NORMALIZEDCORRELATIONIMAGETOIMAGEMETRIC)
     {
+      if (m_MetricParameters->GetUseMultiThreadedMetric())
+      {
+        typename itk::ThreadedNormalizedCorrelationImageToImageMetric<FixedImageType, MovingImageType>::Pointer MetricPointer = itk::ThreadedNormalizedCorrelationImageToImageMetric<FixedImageType, MovingImageType>::New();
+        MetricPointer->SetComputeGradient(m_MetricParameters->GetComputeGradient());
+        this->SetMultiThreadingParameters(MetricPointer, true);
+        return MetricPointer.GetPointer();
+      }
       typename itk::NormalizedCorrelationImageToImageMetric<FixedImageType, MovingImageType>::Pointer MetricPointer = itk::NormalizedCorrelationImageToImageMetric<FixedImageType, MovingImageType>::New();
       MetricPointer->SetComputeGradient(m_MetricParameters->GetComputeGradient());
       return MetricPointer.GetPointer();
@@ -133,6 +163,11 @@ namespace mitk {
       MetricPointer->SetNumberOfHistogramBins(m_MetricParameters->GetNumberOfHistogramBinsMattesMutualInformation());
       MetricPointer->ReinitializeSeed( 76926294 );
       MetricPointer->SetComputeGradient(m_MetricParameters->GetComputeGradient());
+      if (m_MetricParameters->GetUseMultiThreadedMetric())
+      {
+        // Mattes MI has its own sampling parameters
+        this->SetMultiThreadingParameters(MetricPointer, false);
+      }
       return MetricPointer.GetPointer();
     }
     else if (metric == MetricParameters::MEANRECIPROCALSQUAREDIFFERENCEIMAGETOIMAGEMETRIC)
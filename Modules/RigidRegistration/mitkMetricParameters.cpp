@@ -23,6 +23,10 @@ namespace mitk {
   MetricParameters::MetricParameters() :
     m_Metric(MEANSQUARESIMAGETOIMAGEMETRIC),
     m_ComputeGradient(true),
+    // for the multi-threaded metrics
+    m_UseMultiThreadedMetric(false),
+    m_NumberOfMetricThreads(0),
+    m_NumberOfFixedImageSamples(0),
     // for itk::KullbackLeiblerCompareHistogramImageToImageMetric
     m_NumberOfHistogramBinsKullbackLeiblerCompareHistogram(256),
     // for itk::CorrelationCoefficientHistogramImageToImageMetric
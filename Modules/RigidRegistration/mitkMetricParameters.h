@@ -81,6 +81,38 @@ namespace mitk {
     */
     itkGetMacro( ComputeGradient, bool );
 
+    /**
+    \brief Sets whether the metric is evaluated by multiple threads with per-thread partial sums.
+
+    Applies to itk::MeanSquaresImageToImageMetric and itk::MattesMutualInformationImageToImageMetric, which
+    are evaluated by the threaded sample loop of ITK, and to normalized correlation, which is replaced by
+    itk::ThreadedNormalizedCorrelationImageToImageMetric. Other metrics are not affected.
+    */
+    itkSetMacro( UseMultiThreadedMetric, bool );
+    /**
+    \brief Returns whether the metric is evaluated by multiple threads.
+    */
+    itkGetMacro( UseMultiThreadedMetric, bool );
+
+    /**
+    \brief Sets the number of threads of a multi-threaded metric, 0 uses the ITK default.
+    */
+    itkSetMacro( NumberOfMetricThreads, unsigned int );
+    /**
+    \brief Returns the number of threads of a multi-threaded metric.
+    */
+    itkGetMacro( NumberOfMetricThreads, unsigned int );
+
+    /**
+    \brief Sets the number of randomly drawn fixed image samples of the multi-threaded mean squares and
+    normalized correlation metrics, 0 uses all pixels.
+    */
+    itkSetMacro( NumberOfFixedImageSamples, unsigned int );
+    /**
+    \brief Returns the number of fixed image samples of the multi-threaded metrics.
+    */
+    itkGetMacro( NumberOfFixedImageSamples, unsigned int );
+
     /**
     \brief for itk::KullbackLeiblerCompareHistogramImageToImageMetric
     */
@@ -237,6 +269,10 @@ namespace mitk {
 
     int m_Metric;
     bool m_ComputeGradient;
+    // for the multi-threaded metrics
+    bool m_UseMultiThreadedMetric;
+    unsigned int m_NumberOfMetricThreads;
+    unsigned int m_NumberOfFixedImageSamples;
     // for itk::KullbackLeiblerCompareHistogramImageToImageMetric
     unsigned int m_NumberOfHistogramBinsKullbackLeiblerCompareHistogram;
     // for itk::CorrelationCoefficientHistogramImageToImageMetric
@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 MITK_REGISTER_SERIALIZER(ImageSerializer)
 
 mitk::ImageSerializer::ImageSerializer()
+: m_NumberOfThreads(0)
 {
 }
 
@@ -54,6 +55,10 @@ std::cout << "creating file " << filename << " in " << m_WorkingDirectory << std
     writer->SetFileName( fullname );
     // was previously .pic, but due to IpPic-removal from core, the current standard file ending ist .nrrd
     writer->SetExtension(".nrrd");
+    // the scene archive is zipped anyway, favor save speed over file size
+    writer->SetCompressionLevel(1);
+    writer->SetNumberOfThreads( m_NumberOfThreads );
+    writer->SetImageIO( m_ImageIO );
     writer->SetInput( const_cast<Image*>(image) ); // bad writer design??
     writer->Write();
     fullname = writer->GetFileName();
@@ -21,6 +21,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkBaseDataSerializer.h"
 
+#include <itkImageIOBase.h>
+
 namespace mitk
 {
 
@@ -36,10 +38,23 @@ class SceneSerialization_EXPORT ImageSerializer : public BaseDataSerializer
 
     virtual std::string Serialize();
 
+    /**
+     * \brief Write the NRRD file with this ImageIO instead of one created by itk::ImageIOFactory in Serialize()
+     */
+    itkSetObjectMacro( ImageIO, itk::ImageIOBase );
+
+    /**
+     * \brief Number of threads that compress the image (0 uses the global default), see ImageWriter::SetNumberOfThreads()
+     */
+    itkSetMacro( NumberOfThreads, unsigned int );
+
   protected:
 
     ImageSerializer();
     virtual ~ImageSerializer();
+
+    itk::ImageIOBase::Pointer m_ImageIO;
+    unsigned int m_NumberOfThreads;
 };
 
 } // namespace
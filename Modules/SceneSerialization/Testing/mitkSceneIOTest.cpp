@@ -27,8 +27,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImage.h"
 #include "mitkSurface.h"
 #include "mitkPointSet.h"
+#include "mitkNodePredicateProperty.h"
+#include "mitkStringProperty.h"
 #include "Poco/File.h"
 #include "Poco/TemporaryFile.h"
+#include "Poco/Zip/Compress.h"
+
+#include <fstream>
+#include <sstream>
 
 #ifndef WIN32
   #include <ulimit.h>
@@ -207,6 +213,44 @@ static void VerifyStorage(mitk::DataStorage* storage)
   MITK_TEST_CONDITION_REQUIRED(p[0] == 2.0 && p[1] == -3.0 && p[2] == 22.0, "Test Pointset entry 2 after loading");
 
 }
+
+/**
+ * Writes a scene file whose entries try to leave the directory they are unzipped to
+ * and checks that LoadSceneLazily() does not create them.
+ */
+static void TestPathTraversal()
+{
+  const std::string outsideFileName = "mitkSceneIOTest_" + Poco::Path( Poco::TemporaryFile::tempName() ).getFileName() + ".txt";
+  const std::string sceneFileName = std::string( MITK_TEST_OUTPUT_DIR ) + Poco::Path::separator() + outsideFileName + ".zip";
+
+  {
+    std::ofstream file( sceneFileName.c_str(), std::ios::binary );
+    Poco::Zip::Compress zipper( file, true );
+
+    std::istringstream index( "<?xml version=\"1.0\" encoding=\"UTF-8\" ?><Version Writer=\"mitkSceneIOTest\" Revision=\"\" FileVersion=\"1\" />" );
+    zipper.addFile( index, Poco::DateTime(), Poco::Path( "index.xml", Poco::Path::PATH_UNIX ) );
+
+    // the lazily loaded scene is unzipped to a directory in Poco::Path::temp(), these entries point to Poco::Path::temp() itself
+    std::istringstream parentEntry( "outside" );
+    zipper.addFile( parentEntry, Poco::DateTime(), Poco::Path( "../" + outsideFileName, Poco::Path::PATH_UNIX ) );
+    std::istringstream nestedEntry( "outside" );
+    zipper.addFile( nestedEntry, Poco::DateTime(), Poco::Path( "data/../../nested_" + outsideFileName, Poco::Path::PATH_UNIX ) );
+    zipper.close();
+  }
+
+  mitk::SceneIO::Pointer sceneIO = mitk::SceneIO::New();
+  mitk::DataStorage::Pointer storage = sceneIO->LoadSceneLazily( sceneFileName );
+  MITK_TEST_CONDITION( storage.IsNotNull(), "Scene with malicious entries is loaded as far as possible" )
+
+  Poco::File parentFile( Poco::Path::temp() + outsideFileName );
+  Poco::File nestedFile( Poco::Path::temp() + "nested_" + outsideFileName );
+  MITK_TEST_CONDITION( !parentFile.exists(), "Entry starting with .. is not unzipped outside the working directory" )
+  MITK_TEST_CONDITION( !nestedFile.exists(), "Entry containing .. is not unzipped outside the working directory" )
+
+  if ( parentFile.exists() ) parentFile.remove();
+  if ( nestedFile.exists() ) nestedFile.remove();
+  Poco::File( sceneFileName ).remove();
+}
 }; // end test helper class
 
 int mitkSceneIOTest(int, char* argv[])
@@ -333,7 +377,45 @@ int mitkSceneIOTest(int, char* argv[])
     // check if data storage content has been restored correctly
     SceneIOTestClass::VerifyStorage(storage);
 
+    // load the scene again, but read only the image node "Pic3D" right away
+    sceneIO = mitk::SceneIO::New();
+    MITK_TEST_OUTPUT(<< "Loading scene lazily");
+    mitk::NodePredicateProperty::Pointer isPic3D = mitk::NodePredicateProperty::New("name", mitk::StringProperty::New("Pic3D"));
+    storage = sceneIO->LoadSceneLazily(sceneFileName, storage, true, isPic3D);
+    MITK_TEST_CONDITION_REQUIRED(storage.IsNotNull(), "Loading scene lazily");
+
+    mitk::DataNode::Pointer pic3DNode = storage->GetNamedNode("Pic3D");
+    mitk::DataNode::Pointer pointsNode = storage->GetNamedNode("points");
+    MITK_TEST_CONDITION_REQUIRED(pic3DNode.IsNotNull() && pointsNode.IsNotNull(), "Placeholder nodes are added with their properties");
+    MITK_TEST_CONDITION(pic3DNode->GetData() != NULL && !sceneIO->HasPendingData(pic3DNode), "Data of nodes matching the predicate is read immediately");
+    MITK_TEST_CONDITION(pointsNode->GetData() == NULL && sceneIO->HasPendingData(pointsNode), "Data of other nodes is deferred");
+
+    MITK_TEST_CONDITION(sceneIO->LoadNodeData(pointsNode) && pointsNode->GetData() != NULL, "Reading the data of a single pending node");
+    MITK_TEST_CONDITION(!sceneIO->LoadNodeData(pointsNode), "Data of a node is read only once");
+
+    sceneIO->LoadPendingData();
+    MITK_TEST_CONDITION(sceneIO->GetNumberOfPendingNodes() == 0, "Reading the data of all remaining nodes");
+    SceneIOTestClass::VerifyStorage(storage);
+
+    // placeholder nodes may be removed and deleted before their data is read
+    sceneIO = mitk::SceneIO::New();
+    storage = sceneIO->LoadSceneLazily(sceneFileName, storage, true);
+    const unsigned int numberOfNodes = storage->GetAll()->Size();
+    MITK_TEST_CONDITION_REQUIRED(sceneIO->GetNumberOfPendingNodes() == numberOfNodes, "Data of all nodes is deferred without a predicate");
+
+    pointsNode = storage->GetNamedNode("points");
+    const mitk::DataNode* deletedNode = pointsNode.GetPointer();
+    storage->Remove(pointsNode);
+    pointsNode = NULL;
+    MITK_TEST_CONDITION(!sceneIO->HasPendingData(deletedNode), "Deleted placeholder node has no pending data");
+    MITK_TEST_CONDITION(sceneIO->GetNumberOfPendingNodes() == numberOfNodes - 1, "Deleted placeholder node is not pending anymore");
+    MITK_TEST_CONDITION(sceneIO->LoadPendingData() == numberOfNodes - 1, "Reading the data of the remaining nodes skips the deleted node");
+    MITK_TEST_CONDITION(sceneIO->GetNumberOfPendingNodes() == 0, "No nodes are pending after reading all data");
+
   }
+
+  SceneIOTestClass::TestPathTraversal();
+
   // if no sub-test failed remove the scene file, otherwise it is kept for debugging purposes
   if ( mitk::TestManager::GetInstance()->NumberOfFailedTests() == 0 )
   {
@@ -16,14 +16,20 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <Poco/TemporaryFile.h>
 #include <Poco/Path.h>
+#include <Poco/DateTime.h>
 #include <Poco/Delegate.h>
 #include <Poco/Zip/Compress.h>
 #include <Poco/Zip/Decompress.h>
+#include <Poco/Zip/ZipStream.h>
+#include <Poco/StreamCopier.h>
 
 #include "mitkSceneIO.h"
 #include "mitkBaseDataSerializer.h"
+#include "mitkImageSerializer.h"
 #include "mitkPropertyListSerializer.h"
 #include "mitkSceneReader.h"
+#include "mitkPropertyListDeserializer.h"
+#include "mitkDataNodeFactory.h"
 
 #include "mitkProgressBar.h"
 #include "mitkBaseRenderer.h"
@@ -32,14 +38,93 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkStandardFileLocations.h>
 
 #include <itkObjectFactoryBase.h>
+#include <itkImageIOFactory.h>
+#include <itkMultiThreader.h>
+#include <itkTimeProbe.h>
 
 #include <tinyxml.h>
 
+#include <algorithm>
+#include <clocale>
 #include <fstream>
+#include <set>
 #include <sstream>
 
 #include "itksys/SystemTools.hxx"
 
+namespace
+{
+  // one BaseData object to be written by its serializer
+  struct BaseDataSerializationJob
+  {
+    mitk::BaseDataSerializer::Pointer serializer;
+    TiXmlElement* element;
+    mitk::DataNode* node;
+    std::string writtenFilename;
+    bool error;
+  };
+
+  typedef std::vector<BaseDataSerializationJob> BaseDataSerializationJobList;
+  typedef std::vector<BaseDataSerializationJob*> BaseDataSerializationJobPointerList;
+
+  mitk::BaseDataSerializer::Pointer CreateBaseDataSerializer( mitk::BaseData* data, const std::string& filenamehint, const std::string& workingDirectory )
+  {
+    // construct name of serializer class
+    std::string serializername(data->GetNameOfClass());
+    serializername += "Serializer";
+
+    std::list<itk::LightObject::Pointer> thingsThatCanSerializeThis = itk::ObjectFactoryBase::CreateAllInstance(serializername.c_str());
+    if (thingsThatCanSerializeThis.size() < 1)
+    {
+      MITK_ERROR << "No serializer found for " << data->GetNameOfClass() << ". Skipping object";
+    }
+
+    for ( std::list<itk::LightObject::Pointer>::iterator iter = thingsThatCanSerializeThis.begin();
+          iter != thingsThatCanSerializeThis.end();
+          ++iter )
+    {
+      if (mitk::BaseDataSerializer* serializer = dynamic_cast<mitk::BaseDataSerializer*>( iter->GetPointer() ) )
+      {
+        serializer->SetData(data);
+        serializer->SetFilenameHint(filenamehint);
+        serializer->SetWorkingDirectory( workingDirectory );
+        return serializer;
+      }
+    }
+
+    return NULL;
+  }
+
+  void RunBaseDataSerializationJob( BaseDataSerializationJob& job )
+  {
+    if ( job.serializer.IsNull() )
+      return; // no serializer found, job.error stays set
+
+    try
+    {
+      job.writtenFilename = job.serializer->Serialize();
+      job.error = false;
+    }
+    catch (std::exception& e)
+    {
+      MITK_ERROR << "Serializer " << job.serializer->GetNameOfClass() << " failed: " << e.what();
+    }
+  }
+
+  ITK_THREAD_RETURN_TYPE BaseDataSerializationThreaderCallback( void* arg )
+  {
+    itk::MultiThreader::ThreadInfoStruct* info = static_cast< itk::MultiThreader::ThreadInfoStruct* >( arg );
+    BaseDataSerializationJobPointerList* jobs = static_cast< BaseDataSerializationJobPointerList* >( info->UserData );
+
+    for ( unsigned int k = info->ThreadID; k < jobs->size(); k += info->NumberOfThreads )
+    {
+      RunBaseDataSerializationJob( *(*jobs)[k] );
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+}
+
 mitk::SceneIO::SceneIO()
 :m_WorkingDirectory(""),
  m_UnzipErrors(0)
@@ -48,6 +133,7 @@ mitk::SceneIO::SceneIO()
 
 mitk::SceneIO::~SceneIO()
 {
+  ClearPendingData();
 }
 
 std::string mitk::SceneIO::CreateEmptyTempDirectory()
@@ -176,6 +262,389 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadScene( const std::string& filename
 
 }
 
+mitk::DataStorage::Pointer mitk::SceneIO::LoadSceneLazily( const std::string& filename,
+                                                           DataStorage* pStorage,
+                                                           bool clearStorageFirst,
+                                                           const NodePredicateBase* loadDataPredicate )
+{
+  itk::TimeProbe probe;
+  probe.Start();
+
+  ClearPendingData();
+
+  // prepare data storage
+  DataStorage::Pointer storage = pStorage;
+  if ( storage.IsNull() )
+  {
+    storage = StandaloneDataStorage::New().GetPointer();
+  }
+
+  if ( clearStorageFirst )
+  {
+    try
+    {
+      storage->Remove( storage->GetAll() );
+    }
+    catch(...)
+    {
+      MITK_ERROR << "DataStorage cannot be cleared properly.";
+    }
+  }
+
+  // test input filename
+  if ( filename.empty() )
+  {
+    MITK_ERROR << "No filename given. Not possible to load scene.";
+    return NULL;
+  }
+
+  // test if filename can be read
+  std::ifstream file( filename.c_str(), std::ios::binary );
+  if (!file.good())
+  {
+    MITK_ERROR << "Cannot open '" << filename << "' for reading";
+    return NULL;
+  }
+
+  // read the central directory only, entries are extracted one by one below
+  try
+  {
+    Poco::Zip::ZipArchive archive( file );
+    m_LazyArchiveHeaders = Poco::Zip::ZipArchive::FileHeaders( archive.headerBegin(), archive.headerEnd() );
+  }
+  catch ( std::exception& e )
+  {
+    MITK_ERROR << "Could not read the contents of '" << filename << "'\nReason: " << e.what();
+    return NULL;
+  }
+
+  // get new temporary directory
+  m_LazyWorkingDirectory = CreateEmptyTempDirectory();
+  if (m_LazyWorkingDirectory.empty())
+  {
+    MITK_ERROR << "Could not create temporary directory. Cannot open scene files.";
+    return NULL;
+  }
+  m_LazySceneFilename = filename;
+
+  Poco::Zip::ZipArchive::FileHeaders::const_iterator indexHeader = m_LazyArchiveHeaders.find( "index.xml" );
+  if ( indexHeader == m_LazyArchiveHeaders.end() || !ExtractArchiveEntry( file, indexHeader->second ) )
+  {
+    MITK_ERROR << "Could not extract index.xml from '" << filename << "'";
+    ClearPendingData();
+    return NULL;
+  }
+
+  // parse index.xml with TinyXML
+  TiXmlDocument document( m_LazyWorkingDirectory + Poco::Path::separator() + "index.xml" );
+  if (!document.LoadFile())
+  {
+    MITK_ERROR << "Could not open/read/parse " << m_LazyWorkingDirectory << "/index.xml\nTinyXML reports: " << document.ErrorDesc() << std::endl;
+    ClearPendingData();
+    return NULL;
+  }
+
+  // extract everything except the data files (and their companion files, which share the name stem)
+  std::set<std::string> dataFileStems;
+  for( TiXmlElement* element = document.FirstChildElement("node"); element != NULL; element = element->NextSiblingElement("node") )
+  {
+    TiXmlElement* dataElement = element->FirstChildElement("data");
+    const char* dataFile = dataElement ? dataElement->Attribute("file") : NULL;
+    if ( dataFile )
+    {
+      dataFileStems.insert( Poco::Path( dataFile ).getBaseName() );
+    }
+  }
+
+  m_UnzipErrors = 0;
+  for ( Poco::Zip::ZipArchive::FileHeaders::const_iterator iter = m_LazyArchiveHeaders.begin();
+        iter != m_LazyArchiveHeaders.end();
+        ++iter )
+  {
+    if ( iter == indexHeader || !iter->second.isFile() ||
+         dataFileStems.find( Poco::Path( iter->first ).getBaseName() ) != dataFileStems.end() )
+    {
+      continue;
+    }
+
+    if ( !ExtractArchiveEntry( file, iter->second ) )
+    {
+      ++m_UnzipErrors;
+    }
+  }
+
+  if ( m_UnzipErrors )
+  {
+    MITK_ERROR << "There were " << m_UnzipErrors << " errors unzipping '" << filename << "'. Will attempt to read whatever could be unzipped.";
+  }
+
+  SceneReader::Pointer reader = SceneReader::New();
+  reader->SetLoadDataLazily( true );
+  if ( !reader->LoadScene( document, m_LazyWorkingDirectory, storage ) )
+  {
+    MITK_ERROR << "There were errors while loading scene file " << filename << ". Your data may be corrupted";
+  }
+
+  const SceneReader::PendingDataMapType& pendingData = reader->GetPendingData();
+  for ( SceneReader::PendingDataMapType::const_iterator iter = pendingData.begin();
+        iter != pendingData.end();
+        ++iter )
+  {
+    PendingNode& pending = m_PendingNodes[ iter->first ];
+    pending.node = iter->first;
+    pending.data = iter->second;
+  }
+
+  probe.Stop();
+  MITK_INFO << "Loaded " << storage->GetAll()->Size() << " nodes from scene file " << filename << " in " << probe.GetTotal()
+            << "s, reading the data of " << m_PendingNodes.size() << " nodes is deferred";
+
+  if ( loadDataPredicate )
+  {
+    LoadPendingData( loadDataPredicate );
+  }
+
+  if ( m_PendingNodes.empty() )
+  {
+    ClearPendingData();
+  }
+
+  // return new data storage, even if empty or uncomplete (return as much as possible but notify calling method)
+  return storage;
+}
+
+bool mitk::SceneIO::LoadNodeData( DataNode* node )
+{
+  PendingNodeMapType::iterator pendingIter = m_PendingNodes.find( node );
+  if ( node == NULL || pendingIter == m_PendingNodes.end() )
+  {
+    return false;
+  }
+
+  PendingNode pending = pendingIter->second;
+  m_PendingNodes.erase( pendingIter );
+  if ( pending.node.IsNull() )
+  {
+    // the placeholder was deleted and another node lives at its address
+    return false;
+  }
+
+  bool error(false);
+
+  std::ifstream file( m_LazySceneFilename.c_str(), std::ios::binary );
+  if (!file.good())
+  {
+    MITK_ERROR << "Cannot open '" << m_LazySceneFilename << "' for reading";
+    return false;
+  }
+
+  // extract the data file, its companion files (e.g. a raw file next to a header), and its properties
+  std::string dataFileStem = Poco::Path( pending.data.dataFile ).getBaseName();
+  std::vector<std::string> extractedFiles;
+  for ( Poco::Zip::ZipArchive::FileHeaders::const_iterator iter = m_LazyArchiveHeaders.begin();
+        iter != m_LazyArchiveHeaders.end();
+        ++iter )
+  {
+    if ( iter->second.isFile() &&
+         ( iter->first == pending.data.dataPropertiesFile || Poco::Path( iter->first ).getBaseName() == dataFileStem ) )
+    {
+      if ( ExtractArchiveEntry( file, iter->second ) )
+      {
+        extractedFiles.push_back( iter->first );
+      }
+      else
+      {
+        error = true;
+      }
+    }
+  }
+
+  DataNodeFactory::Pointer factory = DataNodeFactory::New();
+  factory->SetFileName( m_LazyWorkingDirectory + Poco::Path::separator() + pending.data.dataFile );
+
+  BaseData::Pointer data;
+  try
+  {
+    factory->Update();
+    DataNode::Pointer readNode = factory->GetOutput();
+    if ( readNode.IsNotNull() )
+    {
+      data = readNode->GetData();
+    }
+  }
+  catch (std::exception& e)
+  {
+    MITK_ERROR << "Error during attempt to read '" << pending.data.dataFile << "'. Exception says: " << e.what();
+  }
+
+  if ( data.IsNotNull() )
+  {
+    if ( !pending.data.dataPropertiesFile.empty() )
+    {
+      PropertyListDeserializer::Pointer deserializer = PropertyListDeserializer::New();
+      deserializer->SetFilename( m_LazyWorkingDirectory + Poco::Path::separator() + pending.data.dataPropertiesFile );
+      error |= !deserializer->Deserialize();
+      PropertyList::Pointer readProperties = deserializer->GetOutput();
+      if ( readProperties.IsNotNull() )
+      {
+        data->SetPropertyList( readProperties );
+      }
+      else
+      {
+        MITK_ERROR << "The property deserializer did not return a (valid) property list.";
+        error = true;
+      }
+    }
+
+    node->SetData( data );
+  }
+  else
+  {
+    MITK_ERROR << "Error during attempt to read '" << pending.data.dataFile << "'. Factory returned NULL object.";
+    error = true;
+  }
+
+  for ( std::vector<std::string>::const_iterator iter = extractedFiles.begin(); iter != extractedFiles.end(); ++iter )
+  {
+    try
+    {
+      Poco::File( m_LazyWorkingDirectory + Poco::Path::separator() + *iter ).remove();
+    }
+    catch(...)
+    {
+      MITK_ERROR << "Could not delete temporary file " << *iter;
+    }
+  }
+
+  if ( m_PendingNodes.empty() )
+  {
+    ClearPendingData();
+  }
+
+  return !error && data.IsNotNull();
+}
+
+unsigned int mitk::SceneIO::LoadPendingData( const NodePredicateBase* predicate )
+{
+  // LoadNodeData() modifies m_PendingNodes, so collect the nodes first and forget the deleted ones
+  std::vector<DataNode::Pointer> nodes;
+  for ( PendingNodeMapType::iterator iter = m_PendingNodes.begin(); iter != m_PendingNodes.end(); )
+  {
+    DataNode::Pointer node = iter->second.node.GetPointer();
+    if ( node.IsNull() )
+    {
+      m_PendingNodes.erase( iter++ );
+      continue;
+    }
+    if ( predicate == NULL || predicate->CheckNode( node ) )
+    {
+      nodes.push_back( node );
+    }
+    ++iter;
+  }
+
+  if ( m_PendingNodes.empty() )
+  {
+    ClearPendingData();
+    return 0;
+  }
+
+  ProgressBar::GetInstance()->AddStepsToDo( nodes.size() );
+
+  unsigned int loaded(0);
+  for ( std::vector<DataNode::Pointer>::const_iterator iter = nodes.begin(); iter != nodes.end(); ++iter )
+  {
+    if ( LoadNodeData( *iter ) )
+    {
+      ++loaded;
+    }
+    ProgressBar::GetInstance()->Progress();
+  }
+
+  return loaded;
+}
+
+bool mitk::SceneIO::HasPendingData( const DataNode* node ) const
+{
+  PendingNodeMapType::const_iterator iter = m_PendingNodes.find( node );
+  return iter != m_PendingNodes.end() && iter->second.node.IsNotNull();
+}
+
+unsigned int mitk::SceneIO::GetNumberOfPendingNodes() const
+{
+  // placeholders that were deleted in the meantime are not pending anymore
+  unsigned int numberOfPendingNodes(0);
+  for ( PendingNodeMapType::const_iterator iter = m_PendingNodes.begin(); iter != m_PendingNodes.end(); ++iter )
+  {
+    if ( iter->second.node.IsNotNull() )
+    {
+      ++numberOfPendingNodes;
+    }
+  }
+  return numberOfPendingNodes;
+}
+
+bool mitk::SceneIO::ExtractArchiveEntry( std::istream& archive, const Poco::Zip::ZipLocalFileHeader& header )
+{
+  try
+  {
+    // only extract entries below the working directory, the names in the archive are not trusted
+    Poco::Path entryPath( header.getFileName(), Poco::Path::PATH_UNIX );
+    bool outsideWorkingDirectory = entryPath.isAbsolute() || entryPath.getFileName() == "..";
+    for ( int i = 0; i < entryPath.depth(); ++i )
+    {
+      outsideWorkingDirectory |= entryPath[i] == "..";
+    }
+
+    Poco::Path workingDirectory( m_LazyWorkingDirectory );
+    workingDirectory.makeDirectory();
+    Poco::Path targetPath( workingDirectory.toString() + header.getFileName() );
+    targetPath.makeAbsolute();
+    const std::string prefix = workingDirectory.absolute().toString();
+    outsideWorkingDirectory |= targetPath.toString().compare( 0, prefix.size(), prefix ) != 0;
+
+    if ( outsideWorkingDirectory )
+    {
+      MITK_ERROR << "Refusing to unzip " << header.getFileName() << ", it would be written outside of " << m_LazyWorkingDirectory;
+      return false;
+    }
+
+    Poco::File( targetPath.parent() ).createDirectories();
+
+    archive.clear();
+    Poco::Zip::ZipInputStream zipStream( archive, header );
+    std::ofstream out( targetPath.toString().c_str(), std::ios::binary );
+    Poco::StreamCopier::copyStream( zipStream, out );
+    return out.good();
+  }
+  catch ( std::exception& e )
+  {
+    MITK_ERROR << "Error while unzipping " << header.getFileName() << ": " << e.what();
+    return false;
+  }
+}
+
+void mitk::SceneIO::ClearPendingData()
+{
+  m_PendingNodes.clear();
+  m_LazyArchiveHeaders.clear();
+  m_LazySceneFilename.clear();
+
+  if ( !m_LazyWorkingDirectory.empty() )
+  {
+    try
+    {
+      Poco::File deleteDir( m_LazyWorkingDirectory );
+      deleteDir.remove(true); // recursive
+    }
+    catch(...)
+    {
+      MITK_ERROR << "Could not delete temporary directory " << m_LazyWorkingDirectory;
+    }
+    m_LazyWorkingDirectory.clear();
+  }
+}
+
 bool mitk::SceneIO::SaveScene( DataStorage::SetOfObjects::ConstPointer sceneNodes, const DataStorage* storage,
                                            const std::string& filename)
 {
@@ -280,6 +749,7 @@ bool mitk::SceneIO::SaveScene( DataStorage::SetOfObjects::ConstPointer sceneNode
       }
 
       // write out objects, dependencies and properties
+      BaseDataSerializationJobList serializationJobs;
       for (DataStorage::SetOfObjects::const_iterator iter = sceneNodes->begin();
            iter != sceneNodes->end();
            ++iter)
@@ -314,16 +784,18 @@ bool mitk::SceneIO::SaveScene( DataStorage::SetOfObjects::ConstPointer sceneNode
             }
           }
 
-          // store basedata
+          // store basedata; the serializers are run in parallel once all nodes are prepared
           if ( BaseData* data = node->GetData() )
           {
-            //std::string filenameHint( node->GetName() );
-            bool error(false);
-            TiXmlElement* dataElement( SaveBaseData( data, filenameHint, error ) ); // returns a reference to a file
-            if (error)
-            {
-              m_FailedNodes->push_back( node );
-            }
+            TiXmlElement* dataElement = new TiXmlElement("data");
+            dataElement->SetAttribute( "type", data->GetNameOfClass() );
+
+            BaseDataSerializationJob job;
+            job.serializer = CreateBaseDataSerializer( data, filenameHint, m_WorkingDirectory );
+            job.element = dataElement;
+            job.node = node;
+            job.error = true;
+            serializationJobs.push_back( job );
 
             // store basedata properties
             PropertyList* propertyList = data->GetPropertyList();
@@ -373,11 +845,86 @@ bool mitk::SceneIO::SaveScene( DataStorage::SetOfObjects::ConstPointer sceneNode
         ProgressBar::GetInstance()->Progress();
       } // end for all nodes
 
+      // The serializers of different nodes write independent files. Images are written in parallel,
+      // their ImageIO is created here since itk::ImageIOFactory is not thread safe. The other
+      // serializers may use object factories while writing, so they run one after another.
+      BaseDataSerializationJobPointerList parallelJobs;
+      BaseDataSerializationJobPointerList sequentialJobs;
+      for ( BaseDataSerializationJobList::iterator job = serializationJobs.begin(); job != serializationJobs.end(); ++job )
+      {
+        ImageSerializer* imageSerializer = dynamic_cast<ImageSerializer*>( job->serializer.GetPointer() );
+        itk::ImageIOBase::Pointer imageIO;
+        if ( imageSerializer )
+        {
+          imageIO = itk::ImageIOFactory::CreateImageIO( "image.nrrd", itk::ImageIOFactory::WriteMode );
+        }
+        if ( imageIO.IsNotNull() )
+        {
+          imageSerializer->SetImageIO( imageIO );
+          parallelJobs.push_back( &*job );
+        }
+        else
+        {
+          sequentialJobs.push_back( &*job );
+        }
+      }
+
+      // The writers switch to the "C" locale unless it is set already. setlocale() changes the
+      // locale of the whole process, so it is set once here instead of in every thread.
+      const std::string currLocale = setlocale( LC_ALL, NULL );
+      setlocale( LC_ALL, "C" );
+      itk::TimeProbe clock;
+      clock.Start();
+      if ( parallelJobs.size() > 1 )
+      {
+        itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+        const unsigned int numberOfThreads = threader->GetNumberOfThreads();
+        if ( parallelJobs.size() < numberOfThreads )
+          threader->SetNumberOfThreads( parallelJobs.size() );
+
+        // each writer compresses its image with its share of the threads instead of all of them
+        const unsigned int threadsPerJob = std::max( 1u, numberOfThreads / threader->GetNumberOfThreads() );
+        for ( BaseDataSerializationJobPointerList::iterator job = parallelJobs.begin(); job != parallelJobs.end(); ++job )
+        {
+          static_cast<ImageSerializer*>( (*job)->serializer.GetPointer() )->SetNumberOfThreads( threadsPerJob );
+        }
+
+        threader->SetSingleMethod( BaseDataSerializationThreaderCallback, &parallelJobs );
+        threader->SingleMethodExecute();
+      }
+      else if ( parallelJobs.size() == 1 )
+      {
+        RunBaseDataSerializationJob( *parallelJobs.front() );
+      }
+      for ( BaseDataSerializationJobPointerList::iterator job = sequentialJobs.begin(); job != sequentialJobs.end(); ++job )
+      {
+        RunBaseDataSerializationJob( **job );
+      }
+      clock.Stop();
+      setlocale( LC_ALL, currLocale.c_str() );
+      MITK_INFO << "Serialized " << serializationJobs.size() << " data objects in " << clock.GetTotal() << " s";
+
+      for ( BaseDataSerializationJobList::iterator job = serializationJobs.begin(); job != serializationJobs.end(); ++job )
+      {
+        if ( job->error )
+        {
+          m_FailedNodes->push_back( job->node );
+        }
+        else
+        {
+          job->element->SetAttribute( "file", job->writtenFilename );
+        }
+      }
+
     } // end if sceneNodes
 
-    if ( !document.SaveFile( m_WorkingDirectory + Poco::Path::separator() + "index.xml" ) )
+    // index.xml is streamed into the archive directly, all other files are moved
+    // into it one by one, so the temporary directory never holds the complete
+    // scene next to the archive
+    TiXmlPrinter printer;
+    if ( !document.Accept( &printer ) )
     {
-      MITK_ERROR << "Could not write scene to " << m_WorkingDirectory << Poco::Path::separator() << "index.xml" << "\nTinyXML reports '" << document.ErrorDesc() << "'";
+      MITK_ERROR << "Could not write scene index for " << filename << "\nTinyXML reports '" << document.ErrorDesc() << "'";
       return false;
     }
     else
@@ -399,19 +946,43 @@ bool mitk::SceneIO::SaveScene( DataStorage::SetOfObjects::ConstPointer sceneNode
         else
         {
           Poco::Zip::Compress zipper( file, true );
-          Poco::Path tmpdir( m_WorkingDirectory );
-          zipper.addRecursive( tmpdir );
+
+          std::istringstream index( std::string( printer.CStr() ) );
+          zipper.addFile( index, Poco::DateTime(), Poco::Path("index.xml") );
+
+          if ( !m_WorkingDirectory.empty() )
+          {
+            std::vector<std::string> files;
+            Poco::File( m_WorkingDirectory ).list( files );
+            for ( std::vector<std::string>::const_iterator fileIter = files.begin(); fileIter != files.end(); ++fileIter )
+            {
+              Poco::Path realFile( m_WorkingDirectory + Poco::Path::separator() + *fileIter );
+              Poco::File aFile( realFile );
+              if ( aFile.isDirectory() )
+              {
+                zipper.addRecursive( realFile, Poco::Zip::ZipCommon::CL_MAXIMUM, false );
+              }
+              else
+              {
+                zipper.addFile( realFile, Poco::Path( *fileIter ) );
+              }
+              aFile.remove(true);
+            }
+          }
           zipper.close();
         }
-        try
-        {
-          Poco::File deleteDir( m_WorkingDirectory );
-          deleteDir.remove(true); // recursive
-        }
-        catch(...)
+        if ( !m_WorkingDirectory.empty() )
         {
-          MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
-          return false; // ok?
+          try
+          {
+            Poco::File deleteDir( m_WorkingDirectory );
+            deleteDir.remove(true); // recursive
+          }
+          catch(...)
+          {
+            MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
+            return false; // ok?
+          }
         }
       }
       catch(std::exception& e)
@@ -442,37 +1013,17 @@ TiXmlElement* mitk::SceneIO::SaveBaseData( BaseData* data, const std::string& fi
   TiXmlElement* element = new TiXmlElement("data");
   element->SetAttribute( "type", data->GetNameOfClass() );
 
-  // construct name of serializer class
-  std::string serializername(data->GetNameOfClass());
-  serializername += "Serializer";
+  BaseDataSerializationJob job;
+  job.serializer = CreateBaseDataSerializer( data, filenamehint, m_WorkingDirectory );
+  job.element = element;
+  job.node = NULL;
+  job.error = true;
+  RunBaseDataSerializationJob( job );
 
-  std::list<itk::LightObject::Pointer> thingsThatCanSerializeThis = itk::ObjectFactoryBase::CreateAllInstance(serializername.c_str());
-  if (thingsThatCanSerializeThis.size() < 1)
+  error = job.error;
+  if (!error)
   {
-    MITK_ERROR << "No serializer found for " << data->GetNameOfClass() << ". Skipping object";
-  }
-
-  for ( std::list<itk::LightObject::Pointer>::iterator iter = thingsThatCanSerializeThis.begin();
-        iter != thingsThatCanSerializeThis.end();
-        ++iter )
-  {
-    if (BaseDataSerializer* serializer = dynamic_cast<BaseDataSerializer*>( iter->GetPointer() ) )
-    {
-      serializer->SetData(data);
-      serializer->SetFilenameHint(filenamehint);
-      serializer->SetWorkingDirectory( m_WorkingDirectory );
-      try
-      {
-        std::string writtenfilename = serializer->Serialize();
-        element->SetAttribute("file", writtenfilename);
-        error = false;
-      }
-      catch (std::exception& e)
-      {
-        MITK_ERROR << "Serializer " << serializer->GetNameOfClass() << " failed: " << e.what();
-      }
-      break;
-    }
+    element->SetAttribute("file", job.writtenFilename);
   }
 
   return element;
@@ -21,8 +21,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDataStorage.h"
 #include "mitkNodePredicateBase.h"
+#include "mitkSceneReader.h"
+#include "mitkWeakPointer.h"
 
 #include <Poco/Zip/ZipLocalFileHeader.h>
+#include <Poco/Zip/ZipArchive.h>
 
 class TiXmlElement;
 
@@ -56,6 +59,48 @@ class SceneSerialization_EXPORT SceneIO : public itk::Object
                                             DataStorage* storage = NULL,
                                             bool clearStorageFirst = false );
 
+    /**
+     * \brief Load the structure of a scene, but defer reading the BaseData of its nodes
+     * \return DataStorage with one node per scene object. Nodes whose data was not read yet carry all their properties, but no data.
+     *
+     * Only index.xml and the property lists are extracted from the scene file. The BaseData of
+     * nodes matching loadDataPredicate is read right away, all other BaseData is read on request
+     * by LoadNodeData() or LoadPendingData(). The scene file must stay in place until then.
+     *
+     * \param filename full filename of the scene file
+     * \param storage If given, this DataStorage is used instead of a newly created one
+     * \param clearStorageFirst If set, the provided DataStorage will be cleared before populating it with the loaded objects
+     * \param loadDataPredicate If given, the data of all nodes matching this predicate is read immediately
+     */
+    virtual DataStorage::Pointer LoadSceneLazily( const std::string& filename,
+                                                  DataStorage* storage = NULL,
+                                                  bool clearStorageFirst = false,
+                                                  const NodePredicateBase* loadDataPredicate = NULL );
+
+    /**
+     * \brief Read the BaseData of a node created by the last call to LoadSceneLazily()
+     * \return True if the data was read and assigned to the node, false if reading failed or there was no pending data for this node
+     */
+    virtual bool LoadNodeData( DataNode* node );
+
+    /**
+     * \brief Read the BaseData of all pending nodes (of the last LoadSceneLazily() call) that match predicate
+     * \return The number of nodes whose data could be read
+     *
+     * \param predicate If NULL, the data of all pending nodes is read
+     */
+    virtual unsigned int LoadPendingData( const NodePredicateBase* predicate = NULL );
+
+    /**
+     * \brief Whether the BaseData of this node still has to be read by LoadNodeData()
+     */
+    bool HasPendingData( const DataNode* node ) const;
+
+    /**
+     * \brief Number of nodes whose BaseData still has to be read
+     */
+    unsigned int GetNumberOfPendingNodes() const;
+
     /**
      * \brief Save a scene of objects to file
      * \return True if complete success, false if any problem occurred. Note that a scene file might still be written if false is returned,
@@ -99,6 +144,16 @@ class SceneSerialization_EXPORT SceneIO : public itk::Object
 
     std::string CreateEmptyTempDirectory();
 
+    /**
+     * \brief Extract one entry of the lazily loaded scene file to m_LazyWorkingDirectory
+     */
+    bool ExtractArchiveEntry( std::istream& archive, const Poco::Zip::ZipLocalFileHeader& header );
+
+    /**
+     * \brief Forget all pending nodes and remove the files extracted by LoadSceneLazily()
+     */
+    void ClearPendingData();
+
     TiXmlElement* SaveBaseData( BaseData* data, const std::string& filenamehint, bool& error);
     TiXmlElement* SavePropertyList( PropertyList* propertyList, const std::string& filenamehint );
 
@@ -110,6 +165,20 @@ class SceneSerialization_EXPORT SceneIO : public itk::Object
 
     std::string  m_WorkingDirectory;
     unsigned int m_UnzipErrors;
+
+    struct PendingNode
+    {
+      // observes the deletion of placeholder nodes that are removed before their data is read
+      WeakPointer<DataNode> node;
+      SceneReader::PendingData data;
+    };
+    typedef std::map<const DataNode*, PendingNode> PendingNodeMapType;
+
+    // state of the last LoadSceneLazily() call
+    PendingNodeMapType                       m_PendingNodes;
+    std::string                              m_LazySceneFilename;
+    std::string                              m_LazyWorkingDirectory;
+    Poco::Zip::ZipArchive::FileHeaders       m_LazyArchiveHeaders;
 };
 
 }
@@ -16,6 +16,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkSceneReader.h"
 
+mitk::SceneReader::SceneReader()
+: m_LoadDataLazily(false)
+{
+}
+
 bool mitk::SceneReader::LoadScene( TiXmlDocument& document, const std::string& workingDirectory, DataStorage* storage )
 {
   // find version node --> note version in some variable
@@ -48,7 +53,10 @@ bool mitk::SceneReader::LoadScene( TiXmlDocument& document, const std::string& w
   {
     if (SceneReader* reader = dynamic_cast<SceneReader*>( iter->GetPointer() ) )
     {
-      if ( !reader->LoadScene( document, workingDirectory, storage ) )
+      reader->SetLoadDataLazily( m_LoadDataLazily );
+      bool success = reader->LoadScene( document, workingDirectory, storage );
+      m_PendingData = reader->GetPendingData();
+      if ( !success )
       {
         MITK_ERROR << "There were errors while loading scene file " << workingDirectory + "/index.xml. Your data may be corrupted";
         return false;
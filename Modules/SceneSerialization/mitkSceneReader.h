@@ -22,6 +22,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDataStorage.h"
 
+#include <map>
+#include <string>
+
 namespace mitk
 {
 
@@ -32,7 +35,37 @@ class SceneSerialization_EXPORT SceneReader : public itk::Object
     mitkClassMacro( SceneReader, itk::Object );
     itkNewMacro( Self );
 
+    /**
+     * \brief Archive entries holding the BaseData (and its properties) of a node that was not read yet.
+     */
+    struct PendingData
+    {
+      std::string dataFile;
+      std::string dataPropertiesFile;
+    };
+    typedef std::map<DataNode*, PendingData> PendingDataMapType;
+
     virtual bool LoadScene( TiXmlDocument& document, const std::string& workingDirectory, DataStorage* storage );
+
+    /**
+     * \brief If set, nodes are created with their properties only and the files of their BaseData are
+     * reported via GetPendingData() instead of being read.
+     */
+    itkSetMacro(LoadDataLazily, bool);
+    itkGetConstMacro(LoadDataLazily, bool);
+    itkBooleanMacro(LoadDataLazily);
+
+    /**
+     * \brief Nodes of the last LoadScene() call whose BaseData was not read (see SetLoadDataLazily()).
+     */
+    const PendingDataMapType& GetPendingData() const { return m_PendingData; }
+
+  protected:
+
+    SceneReader();
+
+    bool m_LoadDataLazily;
+    PendingDataMapType m_PendingData;
 };
 
 }
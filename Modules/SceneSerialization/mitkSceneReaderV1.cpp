@@ -20,11 +20,103 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkBaseRenderer.h"
 #include "mitkPropertyListDeserializer.h"
 #include "mitkProgressBar.h"
+#include "mitkIOAdapter.h"
+#include "mitkItkImageFileReader.h"
 #include "Poco/Path.h"
 #include <mitkRenderingModeProperty.h>
 
+#include <itkObjectFactoryBase.h>
+#include <itkImageIOFactory.h>
+#include <itkMultiThreader.h>
+
+#include <clocale>
+
 MITK_REGISTER_SERIALIZER(SceneReaderV1)
 
+namespace
+{
+  // the readers of all <data> elements, created in the calling thread
+  struct BaseDataLoadingThreadData
+  {
+    std::vector<std::string> filenames;
+    std::vector<mitk::BaseDataSource::Pointer> readers;
+    std::vector<char> errors; // not std::vector<bool>, threads write to different elements
+    std::vector<unsigned int> parallelReaders; // indices of the readers that are updated in parallel
+  };
+
+  std::list<mitk::IOAdapterBase::Pointer> GetIOAdapters()
+  {
+    std::list<mitk::IOAdapterBase::Pointer> ioAdapters;
+    std::list<itk::LightObject::Pointer> allobjects = itk::ObjectFactoryBase::CreateAllInstance("mitkIOAdapter");
+    for ( std::list<itk::LightObject::Pointer>::iterator i = allobjects.begin(); i != allobjects.end(); ++i )
+    {
+      if ( mitk::IOAdapterBase* io = dynamic_cast<mitk::IOAdapterBase*>( i->GetPointer() ) )
+      {
+        ioAdapters.push_back( io );
+      }
+    }
+    return ioAdapters;
+  }
+
+  mitk::BaseDataSource::Pointer CreateBaseDataReader( const std::string& filename, std::list<mitk::IOAdapterBase::Pointer>& ioAdapters )
+  {
+    for ( std::list<mitk::IOAdapterBase::Pointer>::iterator io = ioAdapters.begin(); io != ioAdapters.end(); ++io )
+    {
+      if ( (*io)->CanReadFile( filename, "", "" ) )
+      {
+        return (*io)->CreateIOProcessObject( filename, "", "" ).GetPointer();
+      }
+    }
+    return NULL;
+  }
+
+  void UpdateBaseDataReader( BaseDataLoadingThreadData& data, unsigned int k )
+  {
+    if ( data.readers[k].IsNull() )
+      return;
+
+    try
+    {
+      data.readers[k]->Update();
+    }
+    catch (std::exception& e)
+    {
+      MITK_ERROR << "Error during attempt to read '" << data.filenames[k] << "'. Exception says: " << e.what();
+      data.readers[k] = NULL;
+      data.errors[k] = 1;
+    }
+  }
+
+  ITK_THREAD_RETURN_TYPE LoadBaseDataThreaderCallback( void* arg )
+  {
+    itk::MultiThreader::ThreadInfoStruct* info = static_cast< itk::MultiThreader::ThreadInfoStruct* >( arg );
+    BaseDataLoadingThreadData* data = static_cast< BaseDataLoadingThreadData* >( info->UserData );
+
+    for ( unsigned int k = info->ThreadID; k < data->parallelReaders.size(); k += info->NumberOfThreads )
+    {
+      UpdateBaseDataReader( *data, data->parallelReaders[k] );
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  mitk::DataNode::Pointer CreateNodeFromReader( mitk::BaseDataSource* reader, const std::string& filename )
+  {
+    mitk::BaseData* data = reader->GetNumberOfOutputs() > 0 ? dynamic_cast<mitk::BaseData*>( reader->GetOutputs()[0].GetPointer() ) : NULL;
+    if ( data == NULL )
+      return NULL;
+
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    node->SetData( data );
+
+    // the properties DataNodeFactory would set if it had read the file
+    mitk::DataNodeFactory::Pointer factory = mitk::DataNodeFactory::New();
+    factory->SetFileName( filename );
+    factory->SetDefaultCommonProperties( node );
+    return node;
+  }
+}
+
 bool mitk::SceneReaderV1::LoadScene( TiXmlDocument& document, const std::string& workingDirectory, DataStorage* storage )
 {
   assert(storage);
@@ -41,12 +133,121 @@ bool mitk::SceneReaderV1::LoadScene( TiXmlDocument& document, const std::string&
 
     // create a node for the tag "data" and test if node was created
   typedef std::vector<mitk::DataNode::Pointer> DataNodeVector;
-  DataNodeVector DataNodes;
-  unsigned int listSize = 0;
+  std::vector<TiXmlElement*> dataElements;
   for( TiXmlElement* element = document.FirstChildElement("node"); element != NULL; element = element->NextSiblingElement("node") )
   {
-    ++listSize;
-    DataNodes.push_back( LoadBaseDataFromDataTag( element->FirstChildElement("data"), workingDirectory, error ) );
+    dataElements.push_back( element->FirstChildElement("data") );
+  }
+  unsigned int listSize = dataElements.size();
+  DataNodeVector DataNodes( listSize );
+
+  m_PendingData.clear();
+  if ( m_LoadDataLazily )
+  {
+    // only create placeholder nodes and remember where their data is, the caller reads it on demand
+    for ( unsigned int i = 0; i < listSize; ++i )
+    {
+      DataNodes[i] = DataNode::New();
+      TiXmlElement* dataElement = dataElements[i];
+      const char* filename = dataElement ? dataElement->Attribute("file") : NULL;
+      if ( filename )
+      {
+        PendingData& pending = m_PendingData[ DataNodes[i].GetPointer() ];
+        pending.dataFile = filename;
+        TiXmlElement* baseDataElement = dataElement->FirstChildElement("properties");
+        const char* propertiesFilename = baseDataElement ? baseDataElement->Attribute("file") : NULL;
+        if ( propertiesFilename )
+        {
+          pending.dataPropertiesFile = propertiesFilename;
+        }
+      }
+    }
+  }
+  else
+  {
+    // The object factories and the IO adapters are not thread safe, so all readers are created here.
+    // Images are read in parallel by ItkImageFileReaders whose ImageIO is created here as well.
+    // Other readers may use object factories in their Update(), so they run one after another.
+    BaseDataLoadingThreadData loadingData;
+    loadingData.filenames.resize( listSize );
+    loadingData.readers.resize( listSize );
+    loadingData.errors.resize( listSize, 0 );
+
+    std::list<IOAdapterBase::Pointer> ioAdapters = GetIOAdapters();
+    std::vector<unsigned int> sequentialReaders;
+    for ( unsigned int i = 0; i < listSize; ++i )
+    {
+      const char* filename = dataElements[i] ? dataElements[i]->Attribute("file") : NULL;
+      if ( filename )
+      {
+        loadingData.filenames[i] = workingDirectory + Poco::Path::separator() + filename;
+        loadingData.readers[i] = CreateBaseDataReader( loadingData.filenames[i], ioAdapters );
+
+        ItkImageFileReader* imageReader = dynamic_cast<ItkImageFileReader*>( loadingData.readers[i].GetPointer() );
+        itk::ImageIOBase::Pointer imageIO;
+        if ( imageReader )
+        {
+          imageIO = itk::ImageIOFactory::CreateImageIO( loadingData.filenames[i].c_str(), itk::ImageIOFactory::ReadMode );
+        }
+        if ( imageIO.IsNotNull() )
+        {
+          imageReader->SetImageIO( imageIO );
+          loadingData.parallelReaders.push_back( i );
+        }
+        else
+        {
+          sequentialReaders.push_back( i );
+        }
+      }
+    }
+
+    // The readers switch to the "C" locale unless it is set already. setlocale() changes the
+    // locale of the whole process, so it is set once here instead of in every thread.
+    const std::string currLocale = setlocale( LC_ALL, NULL );
+    setlocale( LC_ALL, "C" );
+    if ( loadingData.parallelReaders.size() > 1 )
+    {
+      itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+      if ( loadingData.parallelReaders.size() < static_cast<unsigned int>( threader->GetNumberOfThreads() ) )
+        threader->SetNumberOfThreads( loadingData.parallelReaders.size() );
+      threader->SetSingleMethod( LoadBaseDataThreaderCallback, &loadingData );
+      threader->SingleMethodExecute();
+    }
+    else if ( loadingData.parallelReaders.size() == 1 )
+    {
+      UpdateBaseDataReader( loadingData, loadingData.parallelReaders.front() );
+    }
+    for ( std::vector<unsigned int>::const_iterator iter = sequentialReaders.begin(); iter != sequentialReaders.end(); ++iter )
+    {
+      UpdateBaseDataReader( loadingData, *iter );
+    }
+    setlocale( LC_ALL, currLocale.c_str() );
+
+    for ( unsigned int i = 0; i < listSize; ++i )
+    {
+      error |= ( loadingData.errors[i] != 0 );
+      if ( loadingData.readers[i].IsNotNull() )
+      {
+        DataNodes[i] = CreateNodeFromReader( loadingData.readers[i], loadingData.filenames[i] );
+        if ( DataNodes[i].IsNull() )
+        {
+          MITK_ERROR << "Error during attempt to read '" << loadingData.filenames[i] << "'. Reader returned NULL object.";
+          error = true;
+        }
+      }
+      else if ( !loadingData.errors[i] )
+      {
+        // no IO adapter for this file (e.g. DICOM), DataNodeFactory knows the remaining cases
+        bool loadingError(false);
+        DataNodes[i] = LoadBaseDataFromDataTag( dataElements[i], workingDirectory, loadingError );
+        error |= loadingError;
+      }
+
+      if ( DataNodes[i].IsNull() )
+      {
+        DataNodes[i] = DataNode::New();
+      }
+    }
   }
 
   OrderedLayers orderedLayers;
@@ -63,7 +264,7 @@ bool mitk::SceneReaderV1::LoadScene( TiXmlDocument& document, const std::string&
     // in case dataXmlElement is valid test whether it containts the "properties" child tag
     // and process further if and only if yes
     TiXmlElement *dataXmlElement = element->FirstChildElement("data");
-    if( dataXmlElement && dataXmlElement->FirstChildElement("properties") )
+    if( dataXmlElement && dataXmlElement->FirstChildElement("properties") && m_PendingData.find( node.GetPointer() ) == m_PendingData.end() )
     {
       TiXmlElement *baseDataElement = dataXmlElement->FirstChildElement("properties");
       if ( node->GetData() )
@@ -17,6 +17,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkBaseDataSerializer.h"
 #include "mitkStandardFileLocations.h"
 #include <itksys/SystemTools.hxx>
+#include <itkSimpleFastMutexLock.h>
+
+namespace
+{
+  // SceneIO runs several serializers in parallel, so the filename counter is shared between threads
+  itk::SimpleFastMutexLock s_FilenameCountMutex;
+}
 
 mitk::BaseDataSerializer::BaseDataSerializer()
 : m_FilenameHint("unnamed")
@@ -42,7 +49,9 @@ std::string mitk::BaseDataSerializer::GetUniqueFilenameInWorkingDirectory()
 {
   // tmpname
   static unsigned long count = 0;
+  s_FilenameCountMutex.Lock();
   unsigned long n = count++;
+  s_FilenameCountMutex.Unlock();
   std::ostringstream name;
   for (int i = 0; i < 6; ++i)
   {
@@ -17,6 +17,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkUSImageVideoSource.h"
 #include "mitkTestingMacros.h"
 
+#include <itkTimeProbe.h>
+
 
 class mitkUSImageVideoSourceTestClass
 {
@@ -47,6 +49,29 @@ public:
     frame = usSource->GetNextImage();
     MITK_TEST_CONDITION_REQUIRED(frame.IsNotNull(), "Fifth frame should not be null.");
   }
+  static void TestFramePool(std::string videoFilePath)
+  {
+    const unsigned int numberOfFrames = 200;
+
+    mitk::USImageVideoSource::Pointer usSource = mitk::USImageVideoSource::New();
+    usSource->SetVideoFileInput(videoFilePath);
+    MITK_TEST_CONDITION_REQUIRED(usSource->GetIsVideoReady(), "USImageVideoSource should have isVideoReady flag set after opening a Video File");
+
+    itk::TimeProbe probe;
+    probe.Start();
+    for (unsigned int i = 0; i < numberOfFrames; ++i)
+    {
+      mitk::USImage::Pointer frame = usSource->GetNextImage();
+      MITK_TEST_CONDITION_REQUIRED(frame.IsNotNull(), "Frame should not be null.");
+    }
+    probe.Stop();
+
+    double allocationsPerFrame = static_cast<double>(usSource->GetNumberOfAllocatedImages()) / numberOfFrames;
+    MITK_INFO << numberOfFrames << " frames: " << numberOfFrames / probe.GetTotal() << " frames per second, "
+              << allocationsPerFrame << " image allocations per frame";
+    MITK_TEST_CONDITION(usSource->GetNumberOfAllocatedImages() <= usSource->GetImagePoolSize(), "Released frames are recycled");
+  }
+
 /** This Test will fail if no device is attached. Since it basically covers the same non-OpenCV Functionality as TestOpenVideoFile, it is ommited
   static void TestOpenDevice()
   {
@@ -71,6 +96,7 @@ int mitkUSImageVideoSourceTest(int argc, char* argv[])
 
   #ifdef WIN32 // Video file compression is currently only supported under windows.
   mitkUSImageVideoSourceTestClass::TestOpenVideoFile(argv[1]);
+  mitkUSImageVideoSourceTestClass::TestFramePool(argv[1]);
   #endif
 
   // This test is commented out since no videodevcie ist steadily connected to the dart clients.
@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 // MITK HEADER
 #include "mitkUSImageVideoSource.h"
 #include "mitkImage.h"
+#include "mitkImageReadAccessor.h"
 
 //OpenCV HEADER
 #include <cv.h>
@@ -34,9 +35,15 @@ m_IsGreyscale(false),
 m_OpenCVToMitkFilter(mitk::OpenCVToMitkImageFilter::New()),
 m_ResolutionOverrideWidth(0),
 m_ResolutionOverrideHeight(0),
-m_ResolutionOverride(false)
+m_ResolutionOverride(false),
+m_ImagePoolSize(4),
+m_NumberOfAllocatedImages(0)
 {
+  // frames are copied into the pooled USImages below, so the converted image may
+  // reference the OpenCV memory; frames which need a conversion are copied into
+  // the recycled images of the filter
   m_OpenCVToMitkFilter->SetCopyBuffer(false);
+  m_OpenCVToMitkFilter->SetUseImagePool(true);
 }
 
 mitk::USImageVideoSource::~USImageVideoSource()
@@ -152,8 +159,40 @@ mitk::USImage::Pointer mitk::USImageVideoSource::GetNextImage()
   this->m_OpenCVToMitkFilter->SetOpenCVImage(&ipl_img);
   this->m_OpenCVToMitkFilter->Update();
 
-  // OpenCVToMitkImageFilter returns a standard mitk::image. We then transform it into an USImage
-  mitk::USImage::Pointer result = mitk::USImage::New(this->m_OpenCVToMitkFilter->GetOutput());
+  // OpenCVToMitkImageFilter returns a standard mitk::image. We then copy it into a recycled USImage
+  // if there is one with the same format, or transform it into a new USImage
+  mitk::Image::Pointer converted = this->m_OpenCVToMitkFilter->GetOutput();
+  mitk::USImage::Pointer result;
+  for (std::vector<mitk::USImage::Pointer>::iterator iter = m_ImagePool.begin(); iter != m_ImagePool.end(); ++iter)
+  {
+    // the pool holds the only reference
+    if ((*iter)->GetReferenceCount() == 1
+        && (*iter)->GetPixelType() == converted->GetPixelType()
+        && (*iter)->GetDimension(0) == converted->GetDimension(0)
+        && (*iter)->GetDimension(1) == converted->GetDimension(1))
+    {
+      result = *iter;
+      mitk::ImageReadAccessor imgA(converted, converted->GetVolumeData(0));
+      result->SetVolume(imgA.GetData());
+      break;
+    }
+  }
+
+  if (result.IsNull())
+  {
+    result = mitk::USImage::New(converted);
+    ++m_NumberOfAllocatedImages;
+
+    if (m_ImagePool.size() >= m_ImagePoolSize && !m_ImagePool.empty())
+    {
+      // the format changed or all images are in use, replace the oldest one
+      m_ImagePool.erase(m_ImagePool.begin());
+    }
+    if (m_ImagePoolSize > 0)
+    {
+      m_ImagePool.push_back(result);
+    }
+  }
 
   // Clean up
   buffer.release();
@@ -162,6 +201,20 @@ mitk::USImage::Pointer mitk::USImageVideoSource::GetNextImage()
   return result;
 }
 
+void mitk::USImageVideoSource::SetImagePoolSize(unsigned int size)
+{
+  m_ImagePoolSize = size;
+  if (m_ImagePool.size() > size)
+  {
+    m_ImagePool.erase(m_ImagePool.begin(), m_ImagePool.begin() + (m_ImagePool.size() - size));
+  }
+}
+
+unsigned long mitk::USImageVideoSource::GetNumberOfAllocatedImages() const
+{
+  return m_NumberOfAllocatedImages;
+}
+
 void mitk::USImageVideoSource::OverrideResolution(int width, int height){
   this->m_ResolutionOverrideHeight = height;
   this->m_ResolutionOverrideWidth = width;
@@ -28,6 +28,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 // OpenCV
 #include <highgui.h>
 
+#include <vector>
+
 namespace mitk {
 
   /**Documentation
@@ -84,6 +86,21 @@ namespace mitk {
     */
     mitk::USImage::Pointer GetNextImage();
 
+    /**
+    * \brief Sets the maximum number of USImages which are recycled by GetNextImage() (default 4).
+    *
+    * A returned image is reused for a later frame as soon as the caller released all references
+    * to it, so streaming does not allocate a new image buffer per frame. If all pooled images are
+    * still in use, a new image is created. A size of 0 disables recycling.
+    */
+    void SetImagePoolSize(unsigned int size);
+    itkGetMacro(ImagePoolSize, unsigned int);
+
+    /**
+    * \brief Returns the number of image buffers allocated for the frames delivered so far.
+    */
+    unsigned long GetNumberOfAllocatedImages() const;
+
     /**
     * \brief This is a workaround for a problem that happens with some video device drivers.
     *
@@ -148,6 +165,13 @@ namespace mitk {
     int  m_ResolutionOverrideHeight;
     bool m_ResolutionOverride;
 
+    /**
+    * \brief Images returned by GetNextImage(), reused once the caller released them.
+    */
+    std::vector<mitk::USImage::Pointer> m_ImagePool;
+    unsigned int m_ImagePoolSize;
+    unsigned long m_NumberOfAllocatedImages;
+
   };
 } // namespace mitk
 #endif /* MITKUSImageVideoSource_H_HEADER_INCLUDED_ */
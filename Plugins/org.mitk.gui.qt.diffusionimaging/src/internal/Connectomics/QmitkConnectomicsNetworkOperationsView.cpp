@@ -35,6 +35,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkConnectomicsSimulatedAnnealingPermutationModularity.h"
 #include "mitkConnectomicsSimulatedAnnealingCostFunctionModularity.h"
 #include <itkConnectomicsNetworkToConnectivityMatrixImageFilter.h>
+#include <itkMultiThreader.h>
 
 // Includes for image casting between ITK and MITK
 #include "mitkImageCast.h"
@@ -387,6 +388,8 @@ void QmitkConnectomicsNetworkOperationsView::OnModularizePushButtonClicked()
         permutation->SetStepSize( stepSize );
 
         manager->SetPermutation( permutation.GetPointer() );
+        // one parallel tempering replica per core
+        manager->SetNumberOfReplicas( itk::MultiThreader::GetGlobalDefaultNumberOfThreads() );
 
         manager->RunSimulatedAnnealing( startTemperature, stepSize );
 
@@ -407,6 +410,8 @@ void QmitkConnectomicsNetworkOperationsView::OnModularizePushButtonClicked()
         MBI_DEBUG << "Cost is " << costFunction->Evaluate( network, &mapping ) ;
         MBI_INFO << "Overall number of modules is " << permutation->getNumberOfModules( &mapping ) ;
         MBI_INFO << "Cost is " << costFunction->Evaluate( network, &mapping ) ;
+        MBI_INFO << "Modularity " << costFunction->CalculateModularity( network, &mapping )
+          << " found in " << manager->GetLastRunTime() << " s using " << manager->GetNumberOfReplicas() << " replicas";
 
         return;
       }
@@ -20,6 +20,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 static std::list<mbilog::BackendBase*> backends;
 
+// one bit per logging level, see mbilogLoggingTypes.h
+static unsigned int enabledLevels = ~0u;
+
 
 namespace mbilog {
 static const std::string NA_STRING = "n/a";
@@ -35,6 +38,19 @@ void mbilog::UnregisterBackend(mbilog::BackendBase* backend)
   backends.remove(backend);
 }
 
+void mbilog::SetLevelEnabled(int level, bool enabled)
+{
+  if(enabled)
+    enabledLevels |= (1u << level);
+  else
+    enabledLevels &= ~(1u << level);
+}
+
+bool mbilog::IsLevelEnabled(int level)
+{
+  return (enabledLevels & (1u << level)) != 0;
+}
+
 void mbilog::DistributeToBackends(mbilog::LogMessage &l)
 {
   //Crop Message
@@ -48,6 +48,15 @@ namespace mbilog {
     */
   void MBILOG_DLL_API DistributeToBackends(LogMessage &l);
 
+  /** \brief Enables/disables all messages of the given level (see mbilogLoggingTypes.h). Messages of a disabled
+   *         level are discarded by the PseudoStream before they are formatted. All levels are enabled by default.
+   */
+  void MBILOG_DLL_API SetLevelEnabled(int level, bool enabled);
+
+  /** \brief Returns whether messages of the given level are processed.
+   */
+  bool MBILOG_DLL_API IsLevelEnabled(int level);
+
   /**
    * \brief An object of this class simulates a std::cout stream. This means messages can be added by
    *        using the bit shift operator (<<). Should only be used by the macros defined in the file mbilog.h
@@ -67,7 +76,7 @@ namespace mbilog {
                     const char* filePath,
                     int lineNumber,
                     const char* functionName)
-                          : disabled(false)
+                          : disabled(!IsLevelEnabled(level))
                           , msg(LogMessage(level,filePath,lineNumber,functionName))
                           , ss(std::stringstream::out)
       {